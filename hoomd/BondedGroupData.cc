@@ -43,7 +43,8 @@ template<unsigned int group_size, typename Group, const char *name, bool has_typ
 BondedGroupData<group_size, Group, name, has_type_mapping>::BondedGroupData(
     std::shared_ptr<ParticleData> pdata,
     unsigned int n_group_types)
-    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true)
+    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true),
+      m_cpu_table_dirty(true)
     {
     m_exec_conf->msg->notice(5) << "Constructing BondedGroupData (" << name<< "s, n=" << group_size << ") "
         << endl;
@@ -85,7 +86,8 @@ template<unsigned int group_size, typename Group, const char *name, bool has_typ
 BondedGroupData<group_size, Group, name, has_type_mapping>::BondedGroupData(
     std::shared_ptr<ParticleData> pdata,
     const Snapshot& snapshot)
-    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true)
+    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true),
+      m_cpu_table_dirty(true)
     {
     m_exec_conf->msg->notice(5) << "Constructing BondedGroupData (" << name << ") " << endl;
 
@@ -160,6 +162,21 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::initialize()
     GPUVector<unsigned int> n_groups(m_exec_conf);
     m_gpu_n_groups.swap(n_groups);
 
+    GPUVector<members_t> cpu_table(m_exec_conf);
+    m_cpu_table.swap(cpu_table);
+
+    GPUVector<unsigned int> cpu_pos_table(m_exec_conf);
+    m_cpu_pos_table.swap(cpu_pos_table);
+
+    GPUVector<unsigned int> cpu_group_idx_table(m_exec_conf);
+    m_cpu_group_idx_table.swap(cpu_group_idx_table);
+
+    GPUVector<unsigned int> cpu_group_entry_table(m_exec_conf);
+    m_cpu_group_entry_table.swap(cpu_group_entry_table);
+
+    GPUVector<unsigned int> cpu_table_offsets(m_exec_conf);
+    m_cpu_table_offsets.swap(cpu_table_offsets);
+
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
@@ -824,6 +841,107 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
         }
     }
 
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildCPUTable()
+    {
+    if (m_prof) m_prof->push("update " + std::string(name) + " CPU table");
+
+    ArrayHandle< unsigned int > h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    unsigned int N = m_pdata->getN()+m_pdata->getNGhosts();
+    unsigned int ngroups_tot = m_n_groups+m_n_ghost;
+
+    m_cpu_table_offsets.resize(N+1);
+    m_cpu_table.resize(ngroups_tot*group_size);
+    m_cpu_pos_table.resize(ngroups_tot*group_size);
+    m_cpu_group_idx_table.resize(ngroups_tot*group_size);
+    m_cpu_group_entry_table.resize(ngroups_tot*group_size);
+
+    ArrayHandle<unsigned int> h_offsets(m_cpu_table_offsets, access_location::host, access_mode::overwrite);
+    ArrayHandle<members_t> h_cpu_table(m_cpu_table, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cpu_pos_table(m_cpu_pos_table, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cpu_group_idx_table(m_cpu_group_idx_table, access_location::host,
+        access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cpu_group_entry_table(m_cpu_group_entry_table, access_location::host,
+        access_mode::overwrite);
+    ArrayHandle<members_t> h_groups(m_groups, access_location::host, access_mode::read);
+    ArrayHandle<typeval_t> h_group_typeval(m_group_typeval, access_location::host, access_mode::read);
+
+    // count the number of bonded groups per particle, shifted by one for the exclusive scan below
+    memset(h_offsets.data, 0, sizeof(unsigned int) * (N+1));
+    for (unsigned int cur_group = 0; cur_group < ngroups_tot; cur_group++)
+        {
+        const members_t& g = h_groups.data[cur_group];
+        for (unsigned int i = 0; i < group_size; ++i)
+            {
+            unsigned int idx = h_rtag.data[g.tag[i]];
+
+            if (idx == NOT_LOCAL)
+                {
+                // incomplete group
+                std::ostringstream oss;
+                oss << name << ".*: " << name << " ";
+                for (unsigned int k = 0; k < group_size; ++k)
+                    oss << g.tag[k] << ((k != group_size - 1) ? ", " : " ");
+                oss << "incomplete!" << std::endl;
+                m_exec_conf->msg->error() << oss.str();
+                throw std::runtime_error("Error building CPU group table.");
+                }
+
+            h_offsets.data[idx+1]++;
+            }
+        }
+
+    // the offset of every particle is the number of entries of all preceding particles
+    for (unsigned int idx = 0; idx < N; idx++)
+        h_offsets.data[idx+1] += h_offsets.data[idx];
+
+    // fill in the entries, using the offsets as insertion cursors
+    for (unsigned int cur_group = 0; cur_group < ngroups_tot; cur_group++)
+        {
+        const members_t& g = h_groups.data[cur_group];
+
+        unsigned int idx[group_size];
+        for (unsigned int i = 0; i < group_size; ++i)
+            idx[i] = h_rtag.data[g.tag[i]];
+
+        for (unsigned int i = 0; i < group_size; ++i)
+            {
+            members_t h;
+
+            if (has_type_mapping)
+                {
+                // last element = type
+                h.idx[group_size-1] = ((typeval_t) h_group_typeval.data[cur_group]).type;
+                }
+            else
+                {
+                // last element = local group idx
+                h.idx[group_size-1] = cur_group;
+                }
+
+            // list all group members j!=i in h.idx
+            unsigned int n = 0;
+            for (unsigned int j = 0; j < group_size; ++j)
+                if (j != i)
+                    h.idx[n++] = idx[j];
+
+            unsigned int entry = h_offsets.data[idx[i]]++;
+            h_cpu_table.data[entry] = h;
+            h_cpu_pos_table.data[entry] = i;
+            h_cpu_group_idx_table.data[entry] = cur_group;
+            h_cpu_group_entry_table.data[cur_group*group_size + i] = entry;
+            }
+        }
+
+    // every cursor now points at the end of its particle's entries, which is the start of the next particle
+    for (unsigned int idx = N; idx > 0; idx--)
+        h_offsets.data[idx] = h_offsets.data[idx-1];
+    h_offsets.data[0] = 0;
+
+    if (m_prof) m_prof->pop();
+    }
+
 #ifdef ENABLE_HIP
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
 void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTableGPU()
@@ -564,6 +564,82 @@ class BondedGroupData
             return m_gpu_n_groups;
             }
 
+        /*
+         * CPU group table
+         */
+
+        //! Return CPU bonded groups list
+        /*! The CPU table stores the same entries as the GPU table (the other members of the group and the group type),
+            but contiguously for each particle: the groups of particle idx are stored at entries
+            getCPUTableOffsets()[idx] to getCPUTableOffsets()[idx+1]-1, in the order of the local group storage. This
+            keeps the groups of nearby particles close in memory after a particle sort.
+         */
+        const GPUVector<members_t>& getCPUTable()
+            {
+            // rebuild lookup table if necessary
+            if (m_cpu_table_dirty)
+                {
+                rebuildCPUTable();
+                m_cpu_table_dirty = false;
+                }
+
+            return m_cpu_table;
+            }
+
+        //! Return CPU list of particle in group position
+        const GPUVector<unsigned int>& getCPUPosTable()
+            {
+            // rebuild lookup table if necessary
+            if (m_cpu_table_dirty)
+                {
+                rebuildCPUTable();
+                m_cpu_table_dirty = false;
+                }
+
+            return m_cpu_pos_table;
+            }
+
+        //! Return CPU list of the local group index of every entry
+        const GPUVector<unsigned int>& getCPUGroupIndexTable()
+            {
+            // rebuild lookup table if necessary
+            if (m_cpu_table_dirty)
+                {
+                rebuildCPUTable();
+                m_cpu_table_dirty = false;
+                }
+
+            return m_cpu_group_idx_table;
+            }
+
+        //! Return CPU list of the table entries of the members of every local group
+        /*! The entry of the member at position pos of local group idx is stored at idx*group_size+pos.
+         */
+        const GPUVector<unsigned int>& getCPUGroupEntryTable()
+            {
+            // rebuild lookup table if necessary
+            if (m_cpu_table_dirty)
+                {
+                rebuildCPUTable();
+                m_cpu_table_dirty = false;
+                }
+
+            return m_cpu_group_entry_table;
+            }
+
+        //! Return offsets of the entries of each particle in the CPU table (N+Nghosts+1 elements)
+        const GPUVector<unsigned int>& getCPUTableOffsets()
+            {
+            // rebuild lookup table if necessary
+            if (m_cpu_table_dirty)
+                {
+                rebuildCPUTable();
+                m_cpu_table_dirty = false;
+                }
+
+            return m_cpu_table_offsets;
+            }
+
         /*
          * add/remove groups globally
          */
@@ -602,17 +678,19 @@ class BondedGroupData
         //! Notify subscribers that groups have been reordered
         void notifyGroupReorder()
             {
-            // set flag to trigger rebuild of GPU table
+            // set flag to trigger rebuild of GPU and CPU tables
             m_groups_dirty = true;
+            m_cpu_table_dirty = true;
 
             // notify subscribers
             m_group_reorder_signal.emit();
             }
 
-        //! Indicate that GPU table needs to be rebuilt
+        //! Indicate that GPU and CPU tables need to be rebuilt
         void setDirty()
             {
             m_groups_dirty = true;
+            m_cpu_table_dirty = true;
             }
 
     protected:
@@ -636,6 +714,11 @@ class BondedGroupData
         GPUVector<unsigned int> m_gpu_pos_table;     //!< Position of particle idx in group table
         Index2D m_gpu_table_indexer;                 //!< Indexer for GPU table
         GPUVector<unsigned int> m_gpu_n_groups;      //!< Number of entries in lookup table per particle
+        GPUVector<members_t> m_cpu_table;            //!< Storage for groups by particle index, contiguous per particle
+        GPUVector<unsigned int> m_cpu_pos_table;     //!< Position of particle idx in group, for every CPU table entry
+        GPUVector<unsigned int> m_cpu_group_idx_table; //!< Local group index of every CPU table entry
+        GPUVector<unsigned int> m_cpu_group_entry_table; //!< CPU table entries of the members of every local group
+        GPUVector<unsigned int> m_cpu_table_offsets; //!< First CPU table entry of every particle
         std::vector<std::string> m_type_mapping;     //!< Mapping of types of bonded groups
 
         unsigned int m_n_groups;                     //!< Number of local groups
@@ -662,6 +745,7 @@ class BondedGroupData
 
     private:
         bool m_groups_dirty;                         //!< Is it necessary to rebuild the lookup-by-index table?
+        bool m_cpu_table_dirty;                      //!< Is it necessary to rebuild the CPU lookup-by-index table?
 
         Nano::Signal<void ()> m_group_num_change_signal; //!< Signal that is triggered when groups are added or deleted (globally)
         Nano::Signal<void ()> m_group_reorder_signal;    //!< Signal that is triggered when groups are added or deleted locally
@@ -675,6 +759,9 @@ class BondedGroupData
         //! Helper function to rebuild lookup by index table
         void rebuildGPUTable();
 
+        //! Helper function to rebuild the contiguous lookup by index table for the CPU
+        void rebuildCPUTable();
+
         //! Resize internal tables
         /*! \param new_size New size of local group tables, new_size = n_local + n_ghost
          */
@@ -1063,6 +1063,7 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_decomposition(decomposition),
             m_is_communicating(false),
             m_force_migrate(false),
+            m_local_sort(false),
             m_nneigh(0),
             m_n_unique_neigh(0),
             m_pos_copybuf(m_exec_conf),
@@ -1132,7 +1133,7 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
         }
 
     // connect to particle sort signal
-    m_pdata->getParticleSortSignal().connect<Communicator, &Communicator::forceMigrate>(this);
+    m_pdata->getParticleSortSignal().connect<Communicator, &Communicator::slotParticleSort>(this);
 
     // connect to particle sort signal
     m_pdata->getGhostParticlesRemovedSignal().connect<Communicator, &Communicator::slotGhostParticlesRemoved>(this);
@@ -1188,12 +1189,12 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
     initializeNeighborArrays();
 
     /* create a type for pdata_element */
-    const int nitems=14;
-    int blocklengths[14] = {4,4,3,1,1,3,1,4,4,3,1,4,4,6};
-    MPI_Datatype types[14] = {MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR,
+    const int nitems=15;
+    int blocklengths[15] = {4,4,3,1,1,3,1,4,4,3,1,1,4,4,6};
+    MPI_Datatype types[15] = {MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR,
         MPI_HOOMD_SCALAR, MPI_INT, MPI_UNSIGNED, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR,
-        MPI_UNSIGNED, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR};
-    MPI_Aint offsets[14];
+        MPI_UNSIGNED, MPI_UNSIGNED, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR};
+    MPI_Aint offsets[15];
 
     offsets[0] = offsetof(pdata_element, pos);
     offsets[1] = offsetof(pdata_element, vel);
@@ -1206,9 +1207,10 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
     offsets[8] = offsetof(pdata_element, angmom);
     offsets[9] = offsetof(pdata_element, inertia);
     offsets[10] = offsetof(pdata_element, tag);
-    offsets[11] = offsetof(pdata_element, net_force);
-    offsets[12] = offsetof(pdata_element, net_torque);
-    offsets[13] = offsetof(pdata_element, net_virial);
+    offsets[11] = offsetof(pdata_element, group_flags);
+    offsets[12] = offsetof(pdata_element, net_force);
+    offsets[13] = offsetof(pdata_element, net_torque);
+    offsets[14] = offsetof(pdata_element, net_virial);
 
     MPI_Datatype tmp;
     MPI_Type_create_struct(nitems, blocklengths, offsets, types, &tmp);
@@ -1223,7 +1225,7 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
 Communicator::~Communicator()
     {
     m_exec_conf->msg->notice(5) << "Destroying Communicator" << std::endl;
-    m_pdata->getParticleSortSignal().disconnect<Communicator, &Communicator::forceMigrate>(this);
+    m_pdata->getParticleSortSignal().disconnect<Communicator, &Communicator::slotParticleSort>(this);
     m_pdata->getGhostParticlesRemovedSignal().disconnect<Communicator, &Communicator::slotGhostParticlesRemoved>(this);
     m_pdata->getNumTypesChangeSignal().disconnect<Communicator, &Communicator::slotNumTypesChanged>(this);
 
@@ -2327,6 +2329,35 @@ void Communicator::exchangeGhosts()
         m_prof->pop();
     }
 
+void Communicator::prepareLocalSort()
+    {
+    // without current ghosts, the sort is followed by a migration anyway
+    if (!m_has_ghost_particles || m_is_communicating)
+        return;
+
+    beginLocalSort();
+    m_local_sort = true;
+
+    m_local_sort_signal.emit();
+    }
+
+/*! A reordering of the particles invalidates the ghost send lists, unless it was announced with
+    prepareLocalSort(). Otherwise, the particles are migrated and the ghosts exchanged again at the next call to
+    communicate().
+ */
+void Communicator::slotParticleSort()
+    {
+    if (m_local_sort)
+        {
+        m_local_sort = false;
+        finishLocalSort();
+        }
+    else
+        {
+        forceMigrate();
+        }
+    }
+
 //! update positions of ghost particles
 void Communicator::beginUpdateGhosts(unsigned int timestep)
     {
@@ -177,6 +177,16 @@ class PYBIND11_EXPORT Communicator
             return m_migrate_requests;
             }
 
+        //! Subscribe to list of functions that are called before a reordering of the local particles
+        /*! The functions are called by prepareLocalSort(), right before the particles are reordered. The following
+         * particle sort signal then belongs to a sort that keeps the ghost particles.
+         * \return A Nano::Signal object reference to be used for connect and disconnect calls.
+         */
+        Nano::Signal<void ()>& getLocalSortSignal()
+            {
+            return m_local_sort_signal;
+            }
+
         //! Subscribe to list of functions that request a minimum ghost layer width
         /*! This method keeps track of all functions that request a minimum ghost layer width
          * The actual ghost layer width is chosen from the max over the inputs
@@ -293,6 +303,13 @@ class PYBIND11_EXPORT Communicator
                 m_force_migrate = true;
             }
 
+        //! Keep the ghost particles across the next reordering of the local particles
+        /*! Call this right before the local particles are reordered in place, with the ghost particles keeping
+         *  their indices. The following particle sort signal then updates the ghost send lists instead of forcing
+         *  a migration, so that the ghosts need not be removed and exchanged again.
+         */
+        void prepareLocalSort();
+
         /*! Exchange positions of ghost particles
          * Using the previously constructed ghost exchange lists, ghost positions are updated on the
          * neighboring processors.
@@ -467,6 +484,7 @@ class PYBIND11_EXPORT Communicator
 
         bool m_is_communicating;               //!< Whether we are currently communicating
         bool m_force_migrate;                  //!< True if particle migration is forced
+        bool m_local_sort;                     //!< True if the next particle sort keeps the ghost particles
 
         unsigned int m_is_at_boundary[6];      //!< Array of flags indicating whether this box lies at a global boundary
 
@@ -532,6 +550,9 @@ class PYBIND11_EXPORT Communicator
         Nano::Signal<bool(unsigned int timestep)>
             m_migrate_requests; //!< List of functions that may request particle migration
 
+        Nano::Signal<void ()>
+            m_local_sort_signal; //!< List of functions that are called before a local particle sort
+
         Nano::Signal<CommFlags(unsigned int timestep) >
             m_requested_flags;  //!< List of functions that may request ghost communication flags
 
@@ -599,6 +620,14 @@ class PYBIND11_EXPORT Communicator
         //! Remove tags of ghost particles
         virtual void removeGhostParticleTags();
 
+        //! Save the particle indices in the ghost send lists before a reordering of the local particles
+        /*! The base class refers to the particles in its send lists by tag, so there is nothing to save
+         */
+        virtual void beginLocalSort() { }
+
+        //! Update the particle indices in the ghost send lists after a reordering of the local particles
+        virtual void finishLocalSort() { }
+
         // check if box is sufficiently large for communication
         void checkBoxSize()
             {
@@ -679,8 +708,12 @@ class PYBIND11_EXPORT Communicator
             {
             removeGhostParticleTags();
             m_has_ghost_particles = false;
+            m_local_sort = false;
             }
 
+        //! Method that is called when the particles are reordered
+        void slotParticleSort();
+
     };
 
 
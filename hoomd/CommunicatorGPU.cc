@@ -157,6 +157,9 @@ void CommunicatorGPU::allocateBuffers()
     GlobalVector<uint2> ghost_idx_adj(m_exec_conf);
     m_ghost_idx_adj.swap(ghost_idx_adj);
 
+    GlobalVector<unsigned int> ghost_sort_tag(m_exec_conf);
+    m_ghost_sort_tag.swap(ghost_sort_tag);
+
     GlobalVector<unsigned int> ghost_neigh(m_exec_conf);
     m_ghost_neigh.swap(ghost_neigh);
 
@@ -1728,6 +1731,40 @@ void CommunicatorGPU::removeGhostParticleTags()
     m_ghosts_added = 0;
     }
 
+void CommunicatorGPU::beginLocalSort()
+    {
+    // the ghost send list refers to particles by index, remember the tags of the local ones
+    m_ghost_sort_tag.resize(m_ghost_idx_adj.size());
+
+    ArrayHandle<uint2> d_ghost_idx_adj(m_ghost_idx_adj, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_ghost_sort_tag(m_ghost_sort_tag, access_location::device, access_mode::overwrite);
+    ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+
+    gpu_ghost_idx_to_tag(m_ghost_idx_adj.size(),
+        m_pdata->getN(),
+        d_ghost_idx_adj.data,
+        d_tag.data,
+        d_ghost_sort_tag.data);
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
+
+void CommunicatorGPU::finishLocalSort()
+    {
+    ArrayHandle<uint2> d_ghost_idx_adj(m_ghost_idx_adj, access_location::device, access_mode::readwrite);
+    ArrayHandle<unsigned int> d_ghost_sort_tag(m_ghost_sort_tag, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
+
+    gpu_ghost_tag_to_idx(m_ghost_idx_adj.size(),
+        d_ghost_idx_adj.data,
+        d_ghost_sort_tag.data,
+        d_rtag.data);
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
+
 //! Build a ghost particle list, exchange ghost particle data with neighboring processors
 void CommunicatorGPU::exchangeGhosts()
     {
@@ -1357,6 +1357,87 @@ void gpu_compute_ghost_rtags(
     thrust::scatter(idx, idx + n_ghost, tag_ptr, rtag_ptr);
     }
 
+//! Kernel to record the tags of the local particles in the ghost send list
+__global__ void gpu_ghost_idx_to_tag_kernel(
+    unsigned int n,
+    unsigned int N,
+    const uint2 *d_ghost_idx_adj,
+    const unsigned int *d_tag,
+    unsigned int *d_ghost_tag)
+    {
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (i >= n) return;
+
+    unsigned int idx = d_ghost_idx_adj[i].x;
+    d_ghost_tag[i] = (idx < N) ? d_tag[idx] : NOT_LOCAL;
+    }
+
+//! Kernel to look up the new indices of the local particles in the ghost send list
+__global__ void gpu_ghost_tag_to_idx_kernel(
+    unsigned int n,
+    uint2 *d_ghost_idx_adj,
+    const unsigned int *d_ghost_tag,
+    const unsigned int *d_rtag)
+    {
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (i >= n) return;
+
+    unsigned int tag = d_ghost_tag[i];
+    if (tag != NOT_LOCAL)
+        d_ghost_idx_adj[i].x = d_rtag[tag];
+    }
+
+/*! \param n Number of entries in the ghost send list
+    \param N Number of local particles
+    \param d_ghost_idx_adj Ghost send list (particle index and adjacency)
+    \param d_tag Particle tags
+    \param d_ghost_tag Output: tag of every local particle in the send list, NOT_LOCAL for ghosts
+
+    Ghost particles that are forwarded in a later stage keep their index, so only local particles are recorded.
+ */
+void gpu_ghost_idx_to_tag(
+    unsigned int n,
+    unsigned int N,
+    const uint2 *d_ghost_idx_adj,
+    const unsigned int *d_tag,
+    unsigned int *d_ghost_tag)
+    {
+    if (n == 0) return;
+
+    unsigned int block_size = 256;
+    unsigned int n_blocks = n/block_size + 1;
+
+    hipLaunchKernelGGL(gpu_ghost_idx_to_tag_kernel, dim3(n_blocks), dim3(block_size), 0, 0, n,
+        N,
+        d_ghost_idx_adj,
+        d_tag,
+        d_ghost_tag);
+    }
+
+/*! \param n Number of entries in the ghost send list
+    \param d_ghost_idx_adj Ghost send list (particle index and adjacency)
+    \param d_ghost_tag Tags recorded by gpu_ghost_idx_to_tag()
+    \param d_rtag Reverse-lookup tags after the reordering
+ */
+void gpu_ghost_tag_to_idx(
+    unsigned int n,
+    uint2 *d_ghost_idx_adj,
+    const unsigned int *d_ghost_tag,
+    const unsigned int *d_rtag)
+    {
+    if (n == 0) return;
+
+    unsigned int block_size = 256;
+    unsigned int n_blocks = n/block_size + 1;
+
+    hipLaunchKernelGGL(gpu_ghost_tag_to_idx_kernel, dim3(n_blocks), dim3(block_size), 0, 0, n,
+        d_ghost_idx_adj,
+        d_ghost_tag,
+        d_rtag);
+    }
+
 /*!
  * Routines for communication of bonded groups
  */
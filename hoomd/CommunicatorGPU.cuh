@@ -190,6 +190,21 @@ void gpu_compute_ghost_rtags(unsigned int first_idx,
      const unsigned int *d_tag,
      unsigned int *d_rtag);
 
+//! Record the tags of the local particles in the ghost send list
+void gpu_ghost_idx_to_tag(
+    unsigned int n,
+    unsigned int N,
+    const uint2 *d_ghost_idx_adj,
+    const unsigned int *d_tag,
+    unsigned int *d_ghost_tag);
+
+//! Update the indices of the local particles in the ghost send list from their tags
+void gpu_ghost_tag_to_idx(
+    unsigned int n,
+    uint2 *d_ghost_idx_adj,
+    const unsigned int *d_ghost_tag,
+    const unsigned int *d_rtag);
+
 //! Reset ghost plans
 void gpu_reset_exchange_plan(
     unsigned int N,
@@ -152,6 +152,12 @@ class PYBIND11_EXPORT CommunicatorGPU : public Communicator
         //! Remove tags of ghost particles
         virtual void removeGhostParticleTags();
 
+        //! Save the particle indices in the ghost send list before a reordering of the local particles
+        virtual void beginLocalSort();
+
+        //! Update the particle indices in the ghost send list after a reordering of the local particles
+        virtual void finishLocalSort();
+
     private:
         /* General communication */
         unsigned int m_max_stages;                     //!< Maximum number of (dependent) communication stages
@@ -225,6 +231,7 @@ class PYBIND11_EXPORT CommunicatorGPU : public Communicator
         GlobalVector<uint2> m_ghost_idx_adj;             //!< Indices and adjacency relationships of ghosts to send
         GlobalVector<unsigned int> m_ghost_neigh;        //!< Neighbor ranks for every ghost particle
         GlobalVector<unsigned int> m_ghost_plan;         //!< Plans for every particle
+        GlobalVector<unsigned int> m_ghost_sort_tag;     //!< Tags of the local particles in m_ghost_idx_adj during a sort
         std::vector<unsigned int> m_idx_offs;         //!< Per-stage offset into ghost idx list
 
         GlobalVector<unsigned int> m_neigh_counts;       //!< List of number of neighbors to send ghost to (temp array)
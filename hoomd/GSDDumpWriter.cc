@@ -19,6 +19,8 @@
 #include <pybind11/stl_bind.h>
 #include <pybind11/numpy.h>
 
+#include <cmath>
+#include <exception>
 #include <string.h>
 #include <stdexcept>
 #include <list>
@@ -44,7 +46,10 @@ GSDDumpWriter::GSDDumpWriter(std::shared_ptr<SystemDefinition> sysdef,
     : Analyzer(sysdef), m_fname(fname), m_overwrite(overwrite),
                         m_truncate(truncate),
                         m_is_initialized(false),
-                        m_group(group)
+                        m_group(group),
+                        m_keyframe_interval(100),
+                        m_frame_pending(false),
+                        m_frame(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing GSDDumpWriter: " << m_fname << " " << overwrite << " " << truncate << endl;
     m_log_writer = pybind11::none();
@@ -111,6 +116,10 @@ void GSDDumpWriter::initFileIO()
     {
     int retval = 0;
 
+    // other GSD readers would read the frame 0 values in place of the quantized chunks and the sparse frames, mark the
+    // file with a schema that they reject
+    const bool encoded = m_quantizers.size() > 0 || (m_sparse.size() > 0 && !m_truncate);
+
     // create the file if it does not exist
     if (m_overwrite || !filesystem::exists(m_fname))
         {
@@ -120,7 +129,7 @@ void GSDDumpWriter::initFileIO()
         m_exec_conf->msg->notice(3) << "dump.gsd: create gsd file " << m_fname << endl;
         retval = gsd_create(m_fname.c_str(),
                             o.str().c_str(),
-                            "hoomd",
+                            encoded ? "hoomd_encoded" : "hoomd",
                             gsd_make_version(1,4));
         checkError(retval);
         }
@@ -134,7 +143,7 @@ void GSDDumpWriter::initFileIO()
     checkError(retval);
 
     // validate schema
-    if (string(m_handle.header.schema) != string("hoomd"))
+    if (string(m_handle.header.schema) != string("hoomd") && string(m_handle.header.schema) != string("hoomd_encoded"))
         {
         m_exec_conf->msg->error() << "dump.gsd: " << "Invalid schema in " << m_fname << endl;
         throw runtime_error("Error opening GSD file");
@@ -144,6 +153,12 @@ void GSDDumpWriter::initFileIO()
         m_exec_conf->msg->error() << "dump.gsd: " << "Invalid schema version in " << m_fname << endl;
         throw runtime_error("Error opening GSD file");
         }
+    if (encoded && string(m_handle.header.schema) != string("hoomd_encoded"))
+        {
+        m_exec_conf->msg->error() << "dump.gsd: " << "Cannot append quantized or sparse frames to " << m_fname
+                                  << ", which was not written with them" << endl;
+        throw runtime_error("Error opening GSD file");
+        }
 
     m_is_initialized = true;
     }
@@ -159,6 +174,16 @@ GSDDumpWriter::~GSDDumpWriter()
 
     if (root && m_is_initialized)
         {
+        // destructors must not throw
+        try
+            {
+            endPendingFrame();
+            }
+        catch (std::exception& e)
+            {
+            m_exec_conf->msg->error() << "dump.gsd: " << e.what() << " - " << m_fname << endl;
+            }
+
         m_exec_conf->msg->notice(5) << "dump.gsd: close gsd file " << m_fname << endl;
         gsd_close(&m_handle);
         }
@@ -168,6 +193,9 @@ GSDDumpWriter::~GSDDumpWriter()
 
     The first call to analyze() will create or overwrite the file and write out the current system configuration
     as frame 0. Subsequent calls will append frames to the file, or keep overwriting frame 0 if m_truncate is true.
+
+    When quantized chunks are written, the frame is left open while they are encoded in the background. It is ended
+    by the next call to analyze() or by flush().
 */
 void GSDDumpWriter::analyze(unsigned int timestep)
     {
@@ -191,6 +219,10 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     if (! m_is_initialized && root)
         initFileIO();
 
+    // complete the previous frame
+    if (root)
+        endPendingFrame();
+
     // truncate the file if requested
     if (m_truncate && root)
         {
@@ -209,6 +241,7 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     #ifdef ENABLE_MPI
     bcast(nframes, 0, m_exec_conf->getMPICommunicator());
     #endif
+    m_frame = nframes;
 
     if (root)
         {
@@ -257,7 +290,18 @@ void GSDDumpWriter::analyze(unsigned int timestep)
         m_log_writer.attr("_write_frame")(this);
         }
 
-    if (root)
+    if (root && m_quantized.size() > 0)
+        {
+        // encode in the background, the quantizers and m_quantized are not accessed until endPendingFrame()
+        m_exec_conf->msg->notice(10) << "dump.gsd: encoding quantized chunks" << endl;
+        m_encoding = std::async(std::launch::async, [this]()
+            {
+            for (auto& chunk : m_quantized)
+                m_quantizers.at(chunk.name).encode(chunk.data, chunk.N, chunk.M, m_frame, false, chunk.encoded);
+            });
+        m_frame_pending = true;
+        }
+    else if (root)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: ending frame" << endl;
         retval = gsd_end_frame(&m_handle);
@@ -268,6 +312,275 @@ void GSDDumpWriter::analyze(unsigned int timestep)
         m_prof->pop();
     }
 
+/*! \param name Name of the chunk to quantize
+    \param precision Absolute precision of the stored values
+
+    Subsequent frames store \a name in the chunk GSDQuantizer::getChunkName(\a name) instead of \a name.
+*/
+void GSDDumpWriter::setPrecision(const std::string& name, Scalar precision)
+    {
+    if (name != "particles/position" && name != "particles/orientation" && name != "particles/velocity")
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Cannot quantize " << name << endl;
+        throw runtime_error("Error setting GSD precision");
+        }
+    if (!(precision > Scalar(0.0)))
+        {
+        m_exec_conf->msg->error() << "dump.gsd: The precision of " << name << " must be positive" << endl;
+        throw runtime_error("Error setting GSD precision");
+        }
+
+    // the quantizers are in use while a frame is pending
+    flush();
+
+    m_quantizers.erase(name);
+    m_quantizers.emplace(name, GSDQuantizer(precision, m_keyframe_interval));
+    }
+
+pybind11::dict GSDDumpWriter::getPrecision()
+    {
+    pybind11::dict result;
+    for (auto& quantizer : m_quantizers)
+        result[quantizer.first.c_str()] = quantizer.second.getPrecision();
+    return result;
+    }
+
+/*! \param name Name of the chunk to write sparsely
+    \param tolerance Particles with values that differ by more than \a tolerance from the last key frame are written
+*/
+void GSDDumpWriter::setSparse(const std::string& name, Scalar tolerance)
+    {
+    if (name != "particles/position" && name != "particles/orientation" && name != "particles/velocity"
+        && name != "particles/angmom")
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Cannot write " << name << " sparsely" << endl;
+        throw runtime_error("Error setting GSD sparse chunk");
+        }
+    if (!(tolerance >= Scalar(0.0)))
+        {
+        m_exec_conf->msg->error() << "dump.gsd: The tolerance of " << name << " must not be negative" << endl;
+        throw runtime_error("Error setting GSD sparse chunk");
+        }
+
+    SparseChunk sparse;
+    sparse.tolerance = tolerance;
+    sparse.has_keyframe = false;
+    sparse.frame = 0;
+    sparse.M = 0;
+    m_sparse[name] = sparse;
+    }
+
+pybind11::dict GSDDumpWriter::getSparse()
+    {
+    pybind11::dict result;
+    for (auto& sparse : m_sparse)
+        result[sparse.first.c_str()] = sparse.second.tolerance;
+    return result;
+    }
+
+/*! \param keyframe_interval Number of frames between key frames
+
+    Applies to the sparse and the quantized chunks.
+*/
+void GSDDumpWriter::setKeyframeInterval(unsigned int keyframe_interval)
+    {
+    if (keyframe_interval == 0)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: The key frame interval must be positive" << endl;
+        throw runtime_error("Error setting GSD key frame interval");
+        }
+
+    // the quantizers are in use while a frame is pending
+    flush();
+
+    m_keyframe_interval = keyframe_interval;
+    for (auto& quantizer : m_quantizers)
+        quantizer.second = GSDQuantizer(quantizer.second.getPrecision(), m_keyframe_interval);
+    }
+
+void GSDDumpWriter::flush()
+    {
+    bool root=true;
+    #ifdef ENABLE_MPI
+    root = m_exec_conf->isRoot();
+    #endif
+
+    if (root && m_is_initialized)
+        endPendingFrame();
+    }
+
+/*! Wait for the background task, write the encoded chunks, and end the frame.
+
+    When the encoder fails, the chunks are written unquantized so that the frame is complete, the frame is ended, and
+    the error is rethrown. The next frame of each quantized chunk is then a key frame.
+*/
+void GSDDumpWriter::endPendingFrame()
+    {
+    if (!m_frame_pending)
+        return;
+
+    m_frame_pending = false;
+
+    // the encoder works on m_quantized, wait for it before taking the chunks
+    std::exception_ptr error;
+    try
+        {
+        m_encoding.get();
+        }
+    catch (...)
+        {
+        error = std::current_exception();
+        }
+
+    std::vector<QuantizedChunk> chunks;
+    chunks.swap(m_quantized);
+
+    if (error)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Error encoding quantized chunks, writing them unquantized - "
+                                  << m_fname << endl;
+
+        // the quantizers may hold values of chunks that are not written
+        for (auto& quantizer : m_quantizers)
+            quantizer.second.reset();
+        }
+
+    for (auto& chunk : chunks)
+        {
+        int retval;
+        if (error)
+            {
+            m_exec_conf->msg->notice(10) << "dump.gsd: writing " << chunk.name << endl;
+            retval = gsd_write_chunk(&m_handle, chunk.name.c_str(), GSD_TYPE_FLOAT, chunk.N, chunk.M, 0,
+                                     (void *)&chunk.data[0]);
+            }
+        else
+            {
+            std::string name = GSDQuantizer::getChunkName(chunk.name);
+            m_exec_conf->msg->notice(10) << "dump.gsd: writing " << name << endl;
+            retval = gsd_write_chunk(&m_handle, name.c_str(), GSD_TYPE_UINT8, chunk.encoded.size(), 1, 0,
+                                     (void *)&chunk.encoded[0]);
+            }
+        checkError(retval);
+        }
+
+    m_exec_conf->msg->notice(10) << "dump.gsd: ending frame" << endl;
+    int retval = gsd_end_frame(&m_handle);
+    checkError(retval);
+
+    if (error)
+        std::rethrow_exception(error);
+    }
+
+/*! \param name Name of the chunk
+    \param data N*M values to write, left empty when the chunk is quantized
+    \param N Number of elements
+    \param M Number of values per element
+
+    Sparse chunks are written by writeSparseChunk() unless this frame becomes their key frame. Quantized chunks are
+    queued for the background task started at the end of analyze().
+*/
+void GSDDumpWriter::writeFloatChunk(const std::string& name, std::vector<float>& data, uint32_t N, uint32_t M)
+    {
+    auto sparse = m_sparse.find(name);
+    if (sparse != m_sparse.end())
+        {
+        if (writeSparseChunk(name, data, N, M))
+            return;
+
+        // write a key frame
+        sparse->second.has_keyframe = true;
+        sparse->second.frame = m_frame;
+        sparse->second.M = M;
+        sparse->second.data = data;
+        sparse->second.tags.resize(N);
+        for (unsigned int group_idx = 0; group_idx < N; group_idx++)
+            sparse->second.tags[group_idx] = m_group->getMemberTag(group_idx);
+        }
+
+    if (m_quantizers.count(name) == 0)
+        {
+        m_exec_conf->msg->notice(10) << "dump.gsd: writing " << name << endl;
+        int retval = gsd_write_chunk(&m_handle, name.c_str(), GSD_TYPE_FLOAT, N, M, 0, (void *)&data[0]);
+        checkError(retval);
+        }
+    else
+        {
+        QuantizedChunk chunk;
+        chunk.name = name;
+        chunk.data.swap(data);
+        chunk.N = N;
+        chunk.M = M;
+        m_quantized.push_back(std::move(chunk));
+        }
+    }
+
+/*! \param name Name of the chunk
+    \param data N*M values in the current frame
+    \param N Number of elements
+    \param M Number of values per element
+
+    \returns false when a key frame must be written instead
+*/
+bool GSDDumpWriter::writeSparseChunk(const std::string& name, const std::vector<float>& data, uint32_t N, uint32_t M)
+    {
+    const SparseChunk& sparse = m_sparse.at(name);
+
+    if (m_truncate || !sparse.has_keyframe || sparse.M != M || sparse.tags.size() != N || m_frame <= sparse.frame
+        || m_frame - sparse.frame >= m_keyframe_interval)
+        {
+        return false;
+        }
+
+    // the values are stored by the index of the particle in the frame
+    for (unsigned int group_idx = 0; group_idx < N; group_idx++)
+        {
+        if (m_group->getMemberTag(group_idx) != sparse.tags[group_idx])
+            return false;
+        }
+
+    std::vector<uint32_t> index;
+    std::vector<float> values;
+    for (unsigned int group_idx = 0; group_idx < N; group_idx++)
+        {
+        bool changed = false;
+        for (unsigned int j = 0; j < M; j++)
+            {
+            if (!(std::abs(data[group_idx*M+j] - sparse.data[group_idx*M+j]) <= sparse.tolerance))
+                changed = true;
+            }
+
+        if (changed)
+            {
+            index.push_back(group_idx);
+            values.insert(values.end(), data.begin() + group_idx*M, data.begin() + (group_idx+1)*M);
+            }
+        }
+
+    // a key frame is smaller
+    if (index.size()*2 > N)
+        return false;
+
+    const std::string base = std::string("sparse/") + name;
+    m_exec_conf->msg->notice(10) << "dump.gsd: writing " << base << " (" << index.size() << " particles)" << endl;
+    uint64_t keyframe = sparse.frame;
+    int retval = gsd_write_chunk(&m_handle, (base + "/keyframe").c_str(), GSD_TYPE_UINT64, 1, 1, 0,
+                                 (void *)&keyframe);
+    checkError(retval);
+
+    if (index.size() > 0)
+        {
+        retval = gsd_write_chunk(&m_handle, (base + "/index").c_str(), GSD_TYPE_UINT32, index.size(), 1, 0,
+                                 (void *)&index[0]);
+        checkError(retval);
+        retval = gsd_write_chunk(&m_handle, (base + "/value").c_str(), GSD_TYPE_FLOAT, index.size(), M, 0,
+                                 (void *)&values[0]);
+        checkError(retval);
+        }
+
+    return true;
+    }
+
 
 void GSDDumpWriter::writeTypeMapping(std::string chunk, std::vector< std::string > type_mapping)
     {
@@ -522,7 +835,6 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
 void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map)
     {
     uint32_t N = m_group->getNumMembersGlobal();
-    int retval;
     uint64_t nframes = gsd_get_nframes(&m_handle);
 
         {
@@ -542,9 +854,7 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
             data[group_idx*3+2] = float(snapshot.pos[it->second].z);
             }
 
-        m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/position" << endl;
-        retval = gsd_write_chunk(&m_handle, "particles/position", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-        checkError(retval);
+        writeFloatChunk("particles/position", data, N, 3);
         }
 
         {
@@ -576,9 +886,7 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/orientation"]))
             {
-            m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/orientation" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/orientation", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
-            checkError(retval);
+            writeFloatChunk("particles/orientation", data, N, 4);
             if (nframes == 0)
                 m_nondefault["particles/orientation"] = true;
             }
@@ -622,9 +930,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/velocity"]))
             {
-            m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/velocity" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/velocity", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-            checkError(retval);
+            writeFloatChunk("particles/velocity", data, N, 3);
             if (nframes == 0)
                 m_nondefault["particles/velocity"] = true;
             }
@@ -659,9 +965,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/angmom"]))
             {
-            m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/angmom" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/angmom", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
-            checkError(retval);
+            writeFloatChunk("particles/angmom", data, N, 4);
             if (nframes == 0)
                 m_nondefault["particles/angmom"] = true;
             }
@@ -978,7 +1282,7 @@ void GSDDumpWriter::populateNonDefault()
         }
 
     // validate schema
-    if (string(m_handle.header.schema) != string("hoomd"))
+    if (string(m_handle.header.schema) != string("hoomd") && string(m_handle.header.schema) != string("hoomd_encoded"))
         {
         m_exec_conf->msg->error() << "dump.gsd: " << "Invalid schema in " << m_fname << endl;
         throw runtime_error("Error opening GSD file");
@@ -1003,6 +1307,8 @@ void GSDDumpWriter::populateNonDefault()
     for (auto const& chunk : chunks)
         {
         const gsd_index_entry *entry = gsd_find_chunk(&m_handle, 0, chunk.c_str());
+        if (entry == nullptr)
+            entry = gsd_find_chunk(&m_handle, 0, GSDQuantizer::getChunkName(chunk).c_str());
         m_nondefault[chunk] = (entry != nullptr);
         }
 
@@ -1021,6 +1327,13 @@ void export_GSDDumpWriter(py::module& m)
         .def("setWriteMomentum", &GSDDumpWriter::setWriteMomentum)
         .def("setWriteTopology", &GSDDumpWriter::setWriteTopology)
         .def("writeLogQuantities", &GSDDumpWriter::writeLogQuantities)
+        .def("setPrecision", &GSDDumpWriter::setPrecision)
+        .def("setSparse", &GSDDumpWriter::setSparse)
+        .def_property("keyframe_interval", &GSDDumpWriter::getKeyframeInterval,
+                      &GSDDumpWriter::setKeyframeInterval)
+        .def_property_readonly("sparse", &GSDDumpWriter::getSparse)
+        .def("flush", &GSDDumpWriter::flush)
+        .def_property_readonly("precision", &GSDDumpWriter::getPrecision)
         .def_property("log_writer", &GSDDumpWriter::getLogWriter, &GSDDumpWriter::setLogWriter)
         .def_property_readonly("filename", &GSDDumpWriter::getFilename)
         .def_property_readonly("overwrite", &GSDDumpWriter::getOverwrite)
@@ -4,9 +4,11 @@
 #pragma once
 
 #include "Analyzer.h"
+#include "GSDQuantizer.h"
 #include "ParticleGroup.h"
 #include "SharedSignal.h"
 
+#include <future>
 #include <string>
 #include <memory>
 #include "hoomd/extern/gsd.h"
@@ -29,6 +31,18 @@
     On the first call to analyze() \a fname is created with a dcd header. If it already
     exists, append to the file (unless the user specifies overwrite=True).
 
+    particles/position, particles/orientation, and particles/velocity can be stored with a fixed precision
+    (see setPrecision() and GSDQuantizer). The quantized chunks are encoded in a background task while the
+    simulation continues, and the frame is completed at the beginning of the next call to analyze(), in flush(),
+    or when the writer is detached or destroyed.
+
+    particles/position, orientation, velocity, and angmom can also be written sparsely (see setSparse()). A key frame
+    stores the chunk in full. The following frames store only the particles whose values differ from the last key
+    frame by more than a tolerance, in the chunks sparse/<name>/index (uint32 index of the particle in the frame),
+    sparse/<name>/value (the values of these particles), and sparse/<name>/keyframe (uint64 index of the key frame).
+    A key frame is written every m_keyframe_interval frames, when the particles in the frame change, or when more
+    than half of the particles changed.
+
     \ingroup analyzers
 */
 class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
@@ -106,6 +120,36 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
         //! Write out the data for the current timestep
         void analyze(unsigned int timestep);
 
+        //! Store a chunk quantized with the given precision
+        void setPrecision(const std::string& name, Scalar precision);
+
+        //! Get the precision of the quantized chunks
+        pybind11::dict getPrecision();
+
+        //! Write a chunk sparsely with the given tolerance
+        void setSparse(const std::string& name, Scalar tolerance);
+
+        //! Get the tolerance of the sparse chunks
+        pybind11::dict getSparse();
+
+        //! Set the number of frames between key frames
+        void setKeyframeInterval(unsigned int keyframe_interval);
+
+        //! Get the number of frames between key frames
+        unsigned int getKeyframeInterval()
+            {
+            return m_keyframe_interval;
+            }
+
+        //! Complete the last frame
+        void flush();
+
+        //! Complete the last frame when the analyzer is removed from the simulation
+        virtual void notifyDetach()
+            {
+            flush();
+            }
+
         hoomd::detail::SharedSignal<int (gsd_handle&)>& getWriteSignal() { return m_write_signal; }
 
         /// Write a logged quantities
@@ -156,6 +200,44 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
 
         hoomd::detail::SharedSignal<int (gsd_handle&)> m_write_signal;
 
+        //! A quantized chunk waiting to be encoded and written
+        struct QuantizedChunk
+            {
+            std::string name;                   //!< Name of the chunk
+            std::vector<float> data;            //!< Values to encode
+            uint64_t N;                         //!< Number of elements
+            uint32_t M;                         //!< Number of values per element
+            std::vector<uint8_t> encoded;       //!< Encoded chunk
+            };
+
+        //! Key frame of a sparse chunk
+        struct SparseChunk
+            {
+            Scalar tolerance;                   //!< Values that differ by more than this from the key frame are written
+            bool has_keyframe;                  //!< True when the fields below hold a key frame
+            uint64_t frame;                     //!< Index of the key frame
+            uint32_t M;                         //!< Number of values per element
+            std::vector<float> data;            //!< Values in the key frame
+            std::vector<unsigned int> tags;     //!< Tags of the particles in the key frame
+            };
+
+        std::map<std::string, SparseChunk> m_sparse;        //!< Key frames of the sparse chunks, by chunk name
+        unsigned int m_keyframe_interval;                   //!< Number of frames between key frames
+        std::map<std::string, GSDQuantizer> m_quantizers;   //!< Quantizers of the quantized chunks, by chunk name
+        std::vector<QuantizedChunk> m_quantized;            //!< Quantized chunks of the pending frame
+        std::future<void> m_encoding;                       //!< Background task encoding m_quantized
+        bool m_frame_pending;                               //!< True when the last frame has not been ended
+        uint64_t m_frame;                                   //!< Index of the frame being written
+
+        //! Write a float chunk, or queue it for encoding when it is quantized
+        void writeFloatChunk(const std::string& name, std::vector<float>& data, uint32_t N, uint32_t M);
+
+        //! Write the changed particles of a sparse chunk
+        bool writeSparseChunk(const std::string& name, const std::vector<float>& data, uint32_t N, uint32_t M);
+
+        //! Write the quantized chunks and end the pending frame
+        void endPendingFrame();
+
         //! Write a type mapping out to the file
         void writeTypeMapping(std::string chunk, std::vector< std::string > type_mapping);
 
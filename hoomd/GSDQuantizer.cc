@@ -0,0 +1,253 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file GSDQuantizer.cc
+    \brief Defines the GSDQuantizer class
+*/
+
+#include "GSDQuantizer.h"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+//! Version of the encoding
+const uint32_t gsd_quantizer_version = 1;
+
+//! Size of the chunk header in bytes
+const size_t gsd_quantizer_header_size = 32;
+
+//! Encoding modes
+enum gsd_quantizer_mode
+    {
+    gsd_quantizer_keyframe = 0,
+    gsd_quantizer_delta = 1
+    };
+
+//! Append a value to the byte stream
+template<class T>
+static void put(std::vector<uint8_t>& out, T value)
+    {
+    size_t offset = out.size();
+    out.resize(offset + sizeof(T));
+    memcpy(&out[offset], &value, sizeof(T));
+    }
+
+//! Read a value from the byte stream
+template<class T>
+static T get(const std::vector<uint8_t>& in, size_t offset)
+    {
+    T value;
+    memcpy(&value, &in[offset], sizeof(T));
+    return value;
+    }
+
+//! Append a signed integer as a zig-zag mapped variable length byte sequence
+static void putVarint(std::vector<uint8_t>& out, int64_t value)
+    {
+    uint64_t u = (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+    while (u >= 0x80)
+        {
+        out.push_back(uint8_t(u | 0x80));
+        u >>= 7;
+        }
+    out.push_back(uint8_t(u));
+    }
+
+//! Read a signed integer written by putVarint
+/*! \returns false if the byte stream ends before the integer
+*/
+static bool getVarint(const std::vector<uint8_t>& in, size_t& offset, int64_t& value)
+    {
+    uint64_t u = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+        {
+        if (offset >= in.size())
+            return false;
+
+        uint8_t b = in[offset++];
+        u |= uint64_t(b & 0x7f) << shift;
+        if ((b & 0x80) == 0)
+            {
+            value = int64_t(u >> 1) ^ -int64_t(u & 1);
+            return true;
+            }
+        }
+    return false;
+    }
+
+/*! \param precision Absolute precision of the stored values
+    \param keyframe_interval Number of frames between key frames
+*/
+GSDQuantizer::GSDQuantizer(double precision, unsigned int keyframe_interval)
+    : m_precision(precision), m_keyframe_interval(keyframe_interval), m_has_previous(false), m_previous_frame(0),
+      m_previous_N(0), m_previous_M(0)
+    {
+    if (!(precision > 0))
+        throw runtime_error("The quantization precision must be positive");
+    if (keyframe_interval == 0)
+        throw runtime_error("The key frame interval must be positive");
+    }
+
+/*! \param data N*M values to encode
+    \param N Number of elements
+    \param M Number of values per element
+    \param frame Index of the frame in the file
+    \param keyframe Set to true to force a key frame
+    \param out Encoded chunk (output)
+
+    The frame is encoded as the difference to the last encoded frame when it immediately precedes \a frame and has
+    the same shape.
+*/
+void GSDQuantizer::encode(const std::vector<float>& data,
+                          uint64_t N,
+                          uint32_t M,
+                          uint64_t frame,
+                          bool keyframe,
+                          std::vector<uint8_t>& out)
+    {
+    size_t n_values = N*M;
+    if (data.size() < n_values)
+        throw runtime_error("Not enough values to encode");
+
+    keyframe = keyframe || !m_has_previous || m_previous_frame + 1 != frame || m_previous_N != N
+        || m_previous_M != M || frame % m_keyframe_interval == 0;
+
+    out.clear();
+    // most differences take one or two bytes
+    out.reserve(gsd_quantizer_header_size + 2*n_values);
+    put<uint32_t>(out, gsd_quantizer_version);
+    put<uint32_t>(out, keyframe ? gsd_quantizer_keyframe : gsd_quantizer_delta);
+    put<uint64_t>(out, N);
+    put<uint32_t>(out, M);
+    put<uint32_t>(out, 0);
+    put<double>(out, m_precision);
+
+    m_previous.resize(n_values);
+    const double inv_precision = 1.0/m_precision;
+    for (size_t i = 0; i < n_values; i++)
+        {
+        double scaled = std::round(double(data[i])*inv_precision);
+        if (!(std::fabs(scaled) < 4.0e18))
+            {
+            m_has_previous = false;
+            ostringstream s;
+            s << "Cannot quantize the value " << data[i] << " with precision " << m_precision;
+            throw runtime_error(s.str());
+            }
+
+        int64_t q = int64_t(scaled);
+        putVarint(out, keyframe ? q : q - m_previous[i]);
+        m_previous[i] = q;
+        }
+
+    m_has_previous = true;
+    m_previous_frame = frame;
+    m_previous_N = N;
+    m_previous_M = M;
+    }
+
+/*! \param handle Handle to the open file
+    \param frame Frame to read
+    \param name Name of the chunk (without the quantized prefix)
+    \param data Decoded values (output)
+    \param N Number of elements (output)
+    \param M Number of values per element (output)
+
+    \returns false when the quantized chunk is not present in \a frame
+
+    Reads the chunks of all frames back to the previous key frame.
+*/
+bool GSDQuantizer::read(gsd_handle& handle,
+                        uint64_t frame,
+                        const std::string& name,
+                        std::vector<float>& data,
+                        uint64_t& N,
+                        uint32_t& M)
+    {
+    const std::string chunk_name = getChunkName(name);
+
+    // walk back to the key frame
+    std::vector<const gsd_index_entry*> entries;
+    uint64_t cur_frame = frame;
+    std::vector<uint8_t> buf;
+    while (true)
+        {
+        const gsd_index_entry* entry = gsd_find_chunk(&handle, cur_frame, chunk_name.c_str());
+        if (entry == NULL)
+            {
+            if (entries.size() == 0)
+                return false;
+
+            throw runtime_error("Missing chunk " + chunk_name + " in the frame preceding a difference frame");
+            }
+
+        if (entry->type != GSD_TYPE_UINT8 || entry->M != 1 || entry->N < gsd_quantizer_header_size)
+            throw runtime_error("Invalid quantized chunk " + chunk_name);
+
+        // gsd reads whole chunks, the data is read again when decoding forward
+        buf.resize(entry->N);
+        int retval = gsd_read_chunk(&handle, &buf[0], entry);
+        if (retval != GSD_SUCCESS)
+            throw runtime_error("Error reading chunk " + chunk_name);
+
+        if (get<uint32_t>(buf, 0) != gsd_quantizer_version)
+            throw runtime_error("Unsupported version of the quantized chunk " + chunk_name);
+
+        entries.push_back(entry);
+        if (get<uint32_t>(buf, 4) == gsd_quantizer_keyframe)
+            break;
+
+        if (cur_frame == 0)
+            throw runtime_error("Difference frame without a key frame in " + chunk_name);
+        cur_frame--;
+        }
+
+    // decode forward from the key frame
+    std::vector<int64_t> q;
+    double precision = 0;
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+        {
+        buf.resize((*it)->N);
+        int retval = gsd_read_chunk(&handle, &buf[0], *it);
+        if (retval != GSD_SUCCESS)
+            throw runtime_error("Error reading chunk " + chunk_name);
+
+        uint32_t mode = get<uint32_t>(buf, 4);
+        uint64_t cur_N = get<uint64_t>(buf, 8);
+        uint32_t cur_M = get<uint32_t>(buf, 16);
+        double cur_precision = get<double>(buf, 24);
+        size_t n_values = cur_N*cur_M;
+
+        if (mode == gsd_quantizer_keyframe)
+            {
+            q.assign(n_values, 0);
+            }
+        else if (mode != gsd_quantizer_delta || n_values != q.size() || cur_precision != precision)
+            {
+            throw runtime_error("Inconsistent difference frame in " + chunk_name);
+            }
+
+        size_t offset = gsd_quantizer_header_size;
+        for (size_t i = 0; i < n_values; i++)
+            {
+            int64_t d;
+            if (!getVarint(buf, offset, d))
+                throw runtime_error("Truncated quantized chunk " + chunk_name);
+            q[i] += d;
+            }
+
+        N = cur_N;
+        M = cur_M;
+        precision = cur_precision;
+        }
+
+    data.resize(q.size());
+    for (size_t i = 0; i < q.size(); i++)
+        data[i] = float(double(q[i])*precision);
+
+    return true;
+    }
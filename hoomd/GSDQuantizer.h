@@ -0,0 +1,98 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file GSDQuantizer.h
+    \brief Declares the GSDQuantizer class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "hoomd/extern/gsd.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+#ifndef __GSD_QUANTIZER_H__
+#define __GSD_QUANTIZER_H__
+
+//! Encodes and decodes quantized GSD data chunks
+/*! GSDQuantizer stores a float chunk of N x M values with a fixed absolute precision p. Each value x is stored as
+    the integer q = round(x / p). In a key frame, the integers are stored directly. In the other frames, each integer
+    is stored as the difference to the integer of the same element in the previous frame, which is small for
+    trajectories written at short intervals. The integers are zig-zag mapped to unsigned integers and written as
+    variable length byte sequences of 7 bits per byte, so that small values take a single byte.
+
+    The encoded bytes are written to the chunk prefix + name (e.g. quantized/particles/position) as a uint8 chunk.
+    It starts with a fixed size header:
+    \code
+    uint32 version
+    uint32 mode          (0: key frame, 1: difference to the previous frame)
+    uint64 N
+    uint32 M
+    uint32 reserved
+    float64 precision
+    \endcode
+
+    Decoding a frame that is not a key frame requires the chunks of all frames back to the previous key frame. The
+    quantizer writes a key frame every keyframe_interval frames to bound the cost of random access, and whenever the
+    previous frame in the file was not encoded by the same quantizer.
+
+    A GSDQuantizer instance holds the integers of the last encoded frame. It is not thread safe, but different
+    instances may be used concurrently.
+*/
+class PYBIND11_EXPORT GSDQuantizer
+    {
+    public:
+        //! Construct a quantizer
+        GSDQuantizer(double precision, unsigned int keyframe_interval=100);
+
+        //! Encode a frame of a chunk
+        void encode(const std::vector<float>& data,
+                    uint64_t N,
+                    uint32_t M,
+                    uint64_t frame,
+                    bool keyframe,
+                    std::vector<uint8_t>& out);
+
+        //! Make the next encoded frame a key frame
+        void reset()
+            {
+            m_has_previous = false;
+            }
+
+        //! Get the precision
+        double getPrecision() const
+            {
+            return m_precision;
+            }
+
+        //! Read and decode a quantized chunk
+        static bool read(gsd_handle& handle,
+                         uint64_t frame,
+                         const std::string& name,
+                         std::vector<float>& data,
+                         uint64_t& N,
+                         uint32_t& M);
+
+        //! Get the name of the quantized chunk that stores \a name
+        static std::string getChunkName(const std::string& name)
+            {
+            return std::string("quantized/") + name;
+            }
+
+    private:
+        double m_precision;                 //!< Absolute precision of the stored values
+        unsigned int m_keyframe_interval;   //!< Number of frames between key frames
+        bool m_has_previous;                //!< True when m_previous holds the last encoded frame
+        uint64_t m_previous_frame;          //!< Frame index of the last encoded frame
+        uint64_t m_previous_N;              //!< N of the last encoded frame
+        uint32_t m_previous_M;              //!< M of the last encoded frame
+        std::vector<int64_t> m_previous;    //!< Quantized values of the last encoded frame
+    };
+
+#endif
@@ -9,6 +9,7 @@
 */
 
 #include "GSDReader.h"
+#include "GSDQuantizer.h"
 #include "SnapshotSystemData.h"
 #include "ExecutionConfiguration.h"
 #include "hoomd/extern/gsd.h"
@@ -50,7 +51,7 @@ GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
     checkError(retval);
 
     // validate schema
-    if (string(m_handle.header.schema) != string("hoomd"))
+    if (string(m_handle.header.schema) != string("hoomd") && string(m_handle.header.schema) != string("hoomd_encoded"))
         {
         m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Invalid schema in " << name << endl;
         throw runtime_error("Error opening GSD file");
@@ -103,14 +104,37 @@ GSDReader::~GSDReader()
 
     Per the GSD spec, keep the default when the frame 0 N does not match the current N.
 
+    Chunks written by GSDDumpWriter with a set precision are found and decoded from their quantized chunk
+    (see GSDQuantizer). Chunks written sparsely are reconstructed from their key frame.
+
     Return true if data is actually read from the file.
 */
 bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n)
     {
     const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, frame, name);
+    if (entry == NULL && readEncodedChunk(data, frame, name, expected_size, cur_n))
+        return true;
     if (entry == NULL && frame != 0)
+        {
         entry = gsd_find_chunk(&m_handle, 0, name);
+        if (entry == NULL && readEncodedChunk(data, 0, name, expected_size, cur_n))
+            return true;
+        }
+
+    return readEntry(data, entry, name, expected_size, cur_n);
+    }
 
+/*! \param data Pointer to data to read into
+    \param entry Index entry of the chunk (may be NULL)
+    \param name Name of the data chunk
+    \param expected_size Expected size of the data chunk in bytes.
+    \param cur_n N in the current frame.
+
+    Return true if data is actually read from the file.
+*/
+bool GSDReader::readEntry(void *data, const gsd_index_entry* entry, const char *name, size_t expected_size,
+                          unsigned int cur_n)
+    {
     if (entry == NULL || (cur_n != 0 && entry->N != cur_n))
         {
         m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
@@ -132,6 +156,141 @@ bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t e
         }
     }
 
+/*! \param data Pointer to data to read into
+    \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param expected_size Expected size of the data chunk in bytes.
+    \param cur_n N in the current frame.
+
+    Return true if \a name is stored quantized or sparsely at \a frame and has been decoded into \a data.
+*/
+bool GSDReader::readEncodedChunk(void *data, uint64_t frame, const char *name, size_t expected_size,
+                                 unsigned int cur_n)
+    {
+    return readQuantizedChunk(data, frame, name, expected_size, cur_n)
+        || readSparseChunk(data, frame, name, expected_size, cur_n);
+    }
+
+/*! \param data Pointer to data to read into
+    \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param expected_size Expected size of the data chunk in bytes.
+    \param cur_n N in the current frame.
+
+    Return true if the quantized chunk for \a name is present at \a frame and has been decoded into \a data.
+*/
+bool GSDReader::readQuantizedChunk(void *data, uint64_t frame, const char *name, size_t expected_size,
+                                   unsigned int cur_n)
+    {
+    std::vector<float> values;
+    uint64_t N;
+    uint32_t M;
+    try
+        {
+        if (!GSDQuantizer::read(m_handle, frame, name, values, N, M))
+            return false;
+        }
+    catch (std::exception& e)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << e.what() << " - " << m_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    if (cur_n != 0 && N != cur_n)
+        {
+        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
+        return false;
+        }
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: decoding chunk " << name << endl;
+    size_t actual_size = values.size()*sizeof(float);
+    if (actual_size != expected_size)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << expected_size << " bytes in " << name << " but found " << actual_size << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+    memcpy(data, &values[0], actual_size);
+    return true;
+    }
+
+/*! \param data Pointer to data to read into
+    \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param expected_size Expected size of the data chunk in bytes.
+    \param cur_n N in the current frame.
+
+    Return true if \a name is stored sparsely at \a frame and has been reconstructed into \a data from the key frame
+    and the particles written in \a frame.
+*/
+bool GSDReader::readSparseChunk(void *data, uint64_t frame, const char *name, size_t expected_size,
+                                unsigned int cur_n)
+    {
+    const std::string base = std::string("sparse/") + name;
+    uint64_t keyframe = 0;
+    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, frame, (base + "/keyframe").c_str());
+    if (entry == NULL)
+        return false;
+
+    readEntry(&keyframe, entry, (base + "/keyframe").c_str(), 8);
+    if (keyframe >= frame)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Invalid key frame " << keyframe << " in " << base
+                                  << " - " << m_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    // the full chunk in the key frame
+    entry = gsd_find_chunk(&m_handle, keyframe, name);
+    bool found;
+    if (entry != NULL)
+        found = readEntry(data, entry, name, expected_size, cur_n);
+    else if (gsd_find_chunk(&m_handle, keyframe, GSDQuantizer::getChunkName(name).c_str()) != NULL)
+        found = readQuantizedChunk(data, keyframe, name, expected_size, cur_n);
+    else
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Missing key frame " << keyframe << " of " << base
+                                  << " - " << m_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    // the key frame has a different N
+    if (!found)
+        return false;
+
+    // apply the particles that changed
+    const struct gsd_index_entry* index_entry = gsd_find_chunk(&m_handle, frame, (base + "/index").c_str());
+    const struct gsd_index_entry* value_entry = gsd_find_chunk(&m_handle, frame, (base + "/value").c_str());
+    if (index_entry == NULL && value_entry == NULL)
+        return true;
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading chunk " << base << endl;
+    size_t value_size = expected_size / (cur_n == 0 ? 1 : cur_n);
+    if (index_entry == NULL || value_entry == NULL || value_entry->N != index_entry->N
+        || value_entry->M*sizeof(float) != value_size || value_entry->type != GSD_TYPE_FLOAT)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Invalid sparse chunk " << base
+                                  << " - " << m_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    std::vector<uint32_t> index(index_entry->N);
+    std::vector<char> values(value_entry->N * value_size);
+    readEntry(&index[0], index_entry, (base + "/index").c_str(), index.size()*4);
+    readEntry(&values[0], value_entry, (base + "/value").c_str(), values.size());
+    for (size_t i = 0; i < index.size(); i++)
+        {
+        if (size_t(index[i]+1) * value_size > expected_size)
+            {
+            m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Invalid index in " << base
+                                      << " - " << m_name << endl;
+            throw runtime_error("Error reading GSD file");
+            }
+        memcpy((char *)data + index[i]*value_size, &values[i*value_size], value_size);
+        }
+
+    return true;
+    }
+
 /*! \param frame Frame index to read from
     \param name Name of the data chunk
 
@@ -364,7 +523,7 @@ GSDStateReader::GSDStateReader(const std::string &name, const int64_t frame)
     checkError(retval);
 
     // validate schema
-    if (string(m_handle.header.schema) != string("hoomd"))
+    if (string(m_handle.header.schema) != string("hoomd") && string(m_handle.header.schema) != string("hoomd_encoded"))
         {
         ostringstream s;
         s << "Error opening GSD file " << m_name << ": Invalid schema.";
@@ -430,19 +589,38 @@ std::vector<std::string> GSDStateReader::getAvailableChunks(const std::string& b
     return result;
     }
 
+/*! Chunks stored with a set precision are decoded and returned as float32 arrays. Chunks written sparsely are
+    reconstructed from their key frame.
+*/
 pybind11::array GSDStateReader::readChunk(const std::string& name)
     {
     pybind11::array result;
     const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, m_frame, name.c_str());
+    if (entry == NULL && readEncodedChunk(name, m_frame, result))
+        {
+        return result;
+        }
     if (entry == NULL && m_frame != 0)
         {
         entry = gsd_find_chunk(&m_handle, 0, name.c_str());
+        if (entry == NULL && readEncodedChunk(name, 0, result))
+            {
+            return result;
+            }
         }
     if (entry == NULL)
         {
         throw runtime_error("Could not find GSD chunk: " + name);
         }
 
+    return readEntry(entry);
+    }
+
+/*! \param entry Index entry of the chunk to read
+*/
+pybind11::array GSDStateReader::readEntry(const gsd_index_entry* entry)
+    {
+    pybind11::array result;
     std::vector<size_t> dims;
     dims.push_back(entry->N);
     if (entry->M > 1)
@@ -501,6 +679,122 @@ pybind11::array GSDStateReader::readChunk(const std::string& name)
     return result;
     }
 
+/*! \param name Name of the chunk
+    \param frame Frame index to read from
+    \param result The decoded chunk (output)
+
+    \returns false when the quantized chunk is not present at \a frame
+*/
+bool GSDStateReader::readQuantizedChunk(const std::string& name, uint64_t frame, pybind11::array& result)
+    {
+    std::vector<float> values;
+    uint64_t N;
+    uint32_t M;
+    try
+        {
+        if (!GSDQuantizer::read(m_handle, frame, name, values, N, M))
+            return false;
+        }
+    catch (std::exception& e)
+        {
+        throw runtime_error("Error reading GSD file:" + m_name + " - " + e.what());
+        }
+
+    std::vector<size_t> dims;
+    dims.push_back(N);
+    if (M > 1)
+        {
+        dims.push_back(M);
+        }
+    result = pybind11::array(pybind11::dtype::of<float>(), dims, values.data());
+    return true;
+    }
+
+/*! \param name Name of the chunk
+    \param frame Frame index to read from
+    \param result The decoded chunk (output)
+
+    \returns false when \a name is not stored quantized or sparsely at \a frame
+*/
+bool GSDStateReader::readEncodedChunk(const std::string& name, uint64_t frame, pybind11::array& result)
+    {
+    return readQuantizedChunk(name, frame, result) || readSparseChunk(name, frame, result);
+    }
+
+/*! \param name Name of the chunk
+    \param frame Frame index to read from
+    \param result The reconstructed chunk (output)
+
+    \returns false when \a name is not stored sparsely at \a frame
+*/
+bool GSDStateReader::readSparseChunk(const std::string& name, uint64_t frame, pybind11::array& result)
+    {
+    const std::string base = "sparse/" + name;
+    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, frame, (base + "/keyframe").c_str());
+    if (entry == NULL)
+        {
+        return false;
+        }
+
+    uint64_t keyframe = 0;
+    if (entry->type != GSD_TYPE_UINT64 || entry->N != 1 || entry->M != 1)
+        {
+        throw runtime_error("Error reading GSD file:" + m_name + " - Invalid chunk " + base + "/keyframe.");
+        }
+    int retval = gsd_read_chunk(&m_handle, &keyframe, entry);
+    checkError(retval);
+    if (keyframe >= frame)
+        {
+        throw runtime_error("Error reading GSD file:" + m_name + " - Invalid key frame in " + base + ".");
+        }
+
+    // the full chunk in the key frame
+    entry = gsd_find_chunk(&m_handle, keyframe, name.c_str());
+    if (entry != NULL && entry->type == GSD_TYPE_FLOAT)
+        {
+        result = readEntry(entry);
+        }
+    else if (entry != NULL || !readQuantizedChunk(name, keyframe, result))
+        {
+        throw runtime_error("Error reading GSD file:" + m_name + " - Missing key frame of " + base + ".");
+        }
+
+    // apply the particles that changed
+    const struct gsd_index_entry* index_entry = gsd_find_chunk(&m_handle, frame, (base + "/index").c_str());
+    const struct gsd_index_entry* value_entry = gsd_find_chunk(&m_handle, frame, (base + "/value").c_str());
+    if (index_entry == NULL && value_entry == NULL)
+        {
+        return true;
+        }
+
+    size_t N = result.shape(0);
+    size_t M = result.ndim() > 1 ? result.shape(1) : 1;
+    if (index_entry == NULL || value_entry == NULL || index_entry->type != GSD_TYPE_UINT32
+        || value_entry->type != GSD_TYPE_FLOAT || value_entry->N != index_entry->N || value_entry->M != M)
+        {
+        throw runtime_error("Error reading GSD file:" + m_name + " - Invalid sparse chunk " + base + ".");
+        }
+
+    std::vector<uint32_t> index(index_entry->N);
+    std::vector<float> values(value_entry->N * M);
+    retval = gsd_read_chunk(&m_handle, &index[0], index_entry);
+    checkError(retval);
+    retval = gsd_read_chunk(&m_handle, &values[0], value_entry);
+    checkError(retval);
+
+    float *data = static_cast<float *>(result.mutable_data());
+    for (size_t i = 0; i < index.size(); i++)
+        {
+        if (index[i] >= N)
+            {
+            throw runtime_error("Error reading GSD file:" + m_name + " - Invalid index in " + base + ".");
+            }
+        std::copy(values.begin() + i*M, values.begin() + (i+1)*M, data + size_t(index[i])*M);
+        }
+
+    return true;
+    }
+
 void GSDStateReader::checkError(int retval)
     {
     // checkError prints errors and then throws exceptions for common gsd error codes
@@ -94,6 +94,22 @@ class PYBIND11_EXPORT GSDReader
         std::shared_ptr< SnapshotSystemData<float> > m_snapshot;   //!< The snapshot to read
         gsd_handle m_handle;                                         //!< Handle to the file
 
+        //! Helper function to read a quantity from an index entry
+        bool readEntry(void *data, const gsd_index_entry* entry, const char *name, size_t expected_size,
+                       unsigned int cur_n=0);
+
+        //! Helper function to read a quantity from a quantized or sparse chunk
+        bool readEncodedChunk(void *data, uint64_t frame, const char *name, size_t expected_size,
+                              unsigned int cur_n);
+
+        //! Helper function to read a quantity from a quantized chunk
+        bool readQuantizedChunk(void *data, uint64_t frame, const char *name, size_t expected_size,
+                                unsigned int cur_n);
+
+        //! Helper function to read a quantity from a sparse chunk
+        bool readSparseChunk(void *data, uint64_t frame, const char *name, size_t expected_size,
+                             unsigned int cur_n);
+
         //! Helper function to read a type list from the file
         std::vector<std::string> readTypes(uint64_t frame, const char *name);
 
@@ -140,6 +156,18 @@ class PYBIND11_EXPORT GSDStateReader
         /// Handle to the file
         gsd_handle m_handle;
 
+        /// Read a chunk from its index entry
+        pybind11::array readEntry(const gsd_index_entry* entry);
+
+        /// Read a quantized or sparse chunk
+        bool readEncodedChunk(const std::string& name, uint64_t frame, pybind11::array& result);
+
+        /// Read a quantized chunk
+        bool readQuantizedChunk(const std::string& name, uint64_t frame, pybind11::array& result);
+
+        /// Read a sparse chunk
+        bool readSparseChunk(const std::string& name, uint64_t frame, pybind11::array& result);
+
         /// Check and raise an exception if an error occurs
         void checkError(int retval);
     };
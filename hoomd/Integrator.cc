@@ -302,6 +302,7 @@ Scalar Integrator::computeTotalMomentum(unsigned int timestep)
 
 /** @param timestep Current time step of the simulation
     \post All added force computes in \a m_forces are computed and totaled up in \a m_net_force and \a m_net_virial
+    \post The sums of the net energy and virial over the local particles are passed to ParticleData::setNetForceSums()
     \note The summation step is performed <b>on the CPU</b> and will result in a lot of data traffic back and forth
           if the forces and/or integrator are on the GPU. Call computeNetForcesGPU() to sum the forces on the GPU
 */
@@ -319,6 +320,11 @@ void Integrator::computeNetForce(unsigned int timestep)
 
     Scalar external_virial[6];
     Scalar external_energy;
+
+    // sums of the potential energy and virial over the local particles, for ComputeThermo
+    double energy_sum = 0.0;
+    double virial_sum[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    const unsigned int n_local = m_pdata->getN();
         {
         // access the net force and virial arrays
         const GlobalArray<Scalar4>& net_force  = m_pdata->getNetForce();
@@ -327,6 +333,8 @@ void Integrator::computeNetForce(unsigned int timestep)
         ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::overwrite);
         ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::overwrite);
         ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
         // start by zeroing the net force and virial arrays
         memset((void *)h_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
@@ -378,6 +386,14 @@ void Integrator::computeNetForce(unsigned int timestep)
                     {
                     h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
                     }
+
+                // ignore rigid body constituent particles in the sums, as ComputeThermo does
+                if (j < n_local && (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j]))
+                    {
+                    energy_sum += (double)h_force.data[j].w;
+                    for (unsigned int k = 0; k < 6; k++)
+                        virial_sum[k] += (double)h_virial.data[k*virial_pitch+j];
+                    }
                 }
 
             for (unsigned int k = 0; k < 6; k++)
@@ -391,6 +407,7 @@ void Integrator::computeNetForce(unsigned int timestep)
         m_pdata->setExternalVirial(k, external_virial[k]);
 
     m_pdata->setExternalEnergy(external_energy);
+    m_pdata->setNetForceSums(energy_sum, virial_sum);
 
     if (m_prof)
         {
@@ -430,6 +447,8 @@ void Integrator::computeNetForce(unsigned int timestep)
         ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
         unsigned int net_virial_pitch = net_virial.getPitch();
 
         // now, add up the net forces
@@ -464,6 +483,13 @@ void Integrator::computeNetForce(unsigned int timestep)
 
                 for (unsigned int k = 0; k < 6; k++)
                     h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
+
+                if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+                    {
+                    energy_sum += (double)h_force.data[j].w;
+                    for (unsigned int k = 0; k < 6; k++)
+                        virial_sum[k] += (double)h_virial.data[k*virial_pitch+j];
+                    }
                 }
             for (unsigned int k = 0; k < 6; k++)
                 external_virial[k] += (*force_constraint)->getExternalVirial(k);
@@ -476,6 +502,7 @@ void Integrator::computeNetForce(unsigned int timestep)
         m_pdata->setExternalVirial(k, external_virial[k]);
 
     m_pdata->setExternalEnergy(external_energy);
+    m_pdata->setNetForceSums(energy_sum, virial_sum);
 
     if (m_prof)
         {
@@ -497,6 +524,9 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         throw runtime_error("Error computing accelerations");
         }
 
+    // the sums for ComputeThermo are only accumulated on the CPU
+    m_pdata->invalidateNetForceSums();
+
     // compute all the normal forces first
 
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
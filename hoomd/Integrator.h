@@ -150,7 +150,7 @@ class PYBIND11_EXPORT Integrator : public Updater
         virtual void setCommunicator(std::shared_ptr<Communicator> comm);
 
         /// Callback for pre-computing the forces
-        void computeCallback(unsigned int timestep);
+        virtual void computeCallback(unsigned int timestep);
         #endif
 
     protected:
@@ -179,11 +179,11 @@ class PYBIND11_EXPORT Integrator : public Updater
 
 #ifdef ENABLE_MPI
         /// helper function to determine the ghost communication flags
-        CommFlags determineFlags(unsigned int timestep);
+        virtual CommFlags determineFlags(unsigned int timestep);
 #endif
 
         /// Helper function to determine (an-)isotropic integration mode
-        bool getAnisotropic();
+        virtual bool getAnisotropic();
 
     private:
         #ifdef ENABLE_MPI
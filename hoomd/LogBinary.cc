@@ -0,0 +1,555 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file LogBinary.cc
+    \brief Defines the LogBinary class
+*/
+
+#include "LogBinary.h"
+#include "Filesystem.h"
+
+#include <pybind11/numpy.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace py = pybind11;
+
+using namespace std;
+
+/*! \param sysdef Specified for LogMatrix, but not used directly by LogBinary
+    \param fname File name to write
+    \param buffer_size Number of rows buffered in memory before they are written
+    \param overwrite Set to true to overwrite the file, false to append to it if it exists
+*/
+LogBinary::LogBinary(std::shared_ptr<SystemDefinition> sysdef,
+                     const std::string& fname,
+                     unsigned int buffer_size,
+                     bool overwrite)
+    : LogMatrix(sysdef), m_filename(fname), m_buffer_size(buffer_size), m_overwrite(overwrite),
+      m_accessors_valid(false), m_header_written(false), m_pending_full(false), m_stop(false),
+      m_write_error(false)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing LogBinary: " << fname << " " << buffer_size << " "
+                                << overwrite << endl;
+
+    if (buffer_size == 0)
+        {
+        m_exec_conf->msg->error() << "write.binary: The buffer size must be positive" << endl;
+        throw runtime_error("Error initializing LogBinary");
+        }
+
+    m_block.n_rows = 0;
+    m_pending.n_rows = 0;
+    }
+
+LogBinary::~LogBinary()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying LogBinary" << endl;
+
+    try
+        {
+        flush();
+        }
+    catch (const std::exception&)
+        {
+        // the error has already been reported, nothing more can be done in a destructor
+        }
+
+    if (m_writer.joinable())
+        {
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            }
+        m_cv.notify_all();
+        m_writer.join();
+        }
+    }
+
+/*! \param compute The Compute to register
+*/
+void LogBinary::registerCompute(std::shared_ptr<Compute> compute)
+    {
+    LogMatrix::registerCompute(compute);
+    m_accessors_valid = false;
+    }
+
+/*! \param updater The Updater to register
+*/
+void LogBinary::registerUpdater(std::shared_ptr<Updater> updater)
+    {
+    LogMatrix::registerUpdater(updater);
+    m_accessors_valid = false;
+    }
+
+/*! \param name Name of the quantity
+    \param callback Python callback that produces the quantity
+*/
+void LogBinary::registerCallback(std::string name, pybind11::handle callback)
+    {
+    LogMatrix::registerCallback(name, callback);
+    m_accessors_valid = false;
+    }
+
+/*! \param name Name of the matrix quantity
+    \param callback Python callback that produces the quantity
+*/
+void LogBinary::registerMatrixCallback(std::string name, pybind11::object callback)
+    {
+    LogMatrix::registerMatrixCallback(name, callback);
+    m_accessors_valid = false;
+    }
+
+/*! \param name Name of the logged quantity
+    \param compute Compute that provides the quantity
+    \param quantity Name of the quantity in the log quantities of \a compute
+
+    The quantity is evaluated with Compute::getLogValue() directly. It takes precedence over the computes, updaters,
+    and callbacks registered for \a name.
+*/
+void LogBinary::registerComputeQuantity(const std::string& name,
+                                        std::shared_ptr<Compute> compute,
+                                        const std::string& quantity)
+    {
+    std::vector< std::string > provided = compute->getProvidedLogQuantities();
+    if (std::find(provided.begin(), provided.end(), quantity) == provided.end())
+        {
+        m_exec_conf->msg->error() << "write.binary: " << quantity << " is not a log quantity of the compute for "
+                                  << name << endl;
+        throw runtime_error("Error registering log quantity");
+        }
+
+    m_direct_quantities[name] = std::make_pair(compute, quantity);
+    m_accessors_valid = false;
+    }
+
+void LogBinary::removeAll()
+    {
+    LogMatrix::removeAll();
+    m_direct_quantities.clear();
+    m_accessors_valid = false;
+    }
+
+/*! \param quantities A list of quantities to log
+*/
+void LogBinary::setLoggedQuantities(const std::vector< std::string >& quantities)
+    {
+    if (m_header_written && quantities != m_logged_quantities)
+        checkLayoutChange();
+
+    LogMatrix::setLoggedQuantities(quantities);
+    m_accessors_valid = false;
+    }
+
+/*! \param quantities A list of matrix quantities to log
+*/
+void LogBinary::setLoggedMatrixQuantities(const std::vector< std::string >& quantities)
+    {
+    if (m_header_written && quantities != m_logged_matrix_quantities)
+        checkLayoutChange();
+
+    LogMatrix::setLoggedMatrixQuantities(quantities);
+    m_accessors_valid = false;
+    }
+
+void LogBinary::checkLayoutChange()
+    {
+    m_exec_conf->msg->error() << "write.binary: The logged quantities cannot be changed after the first row has "
+                              << "been written to " << m_filename << endl;
+    throw runtime_error("Error changing logged quantities");
+    }
+
+/*! Looks up the source of every logged quantity once, so that analyze() calls the sources directly.
+*/
+void LogBinary::resolveAccessors()
+    {
+    m_accessors.clear();
+    for (const auto& quantity : m_logged_quantities)
+        {
+        Accessor accessor;
+        accessor.name = quantity;
+        accessor.quantity = quantity;
+        accessor.type = source::none;
+
+        auto direct = m_direct_quantities.find(quantity);
+        if (direct != m_direct_quantities.end())
+            {
+            accessor.type = source::compute;
+            accessor.compute = direct->second.first;
+            accessor.quantity = direct->second.second;
+            }
+        else if (quantity == "time")
+            {
+            accessor.type = source::time;
+            }
+        else if (m_compute_quantities.count(quantity))
+            {
+            accessor.type = source::compute;
+            accessor.compute = m_compute_quantities[quantity];
+            }
+        else if (m_updater_quantities.count(quantity))
+            {
+            accessor.type = source::updater;
+            accessor.updater = m_updater_quantities[quantity];
+            }
+        else if (m_callback_quantities.count(quantity))
+            {
+            accessor.type = source::callback;
+            accessor.callback = py::reinterpret_borrow<py::object>(m_callback_quantities[quantity]);
+            }
+        else
+            {
+            m_exec_conf->msg->warning() << "write.binary: Log quantity " << quantity
+                                        << " is not registered, logging a value of 0" << endl;
+            }
+
+        m_accessors.push_back(accessor);
+        }
+
+    m_matrix_accessors.clear();
+    for (const auto& quantity : m_logged_matrix_quantities)
+        {
+        Accessor accessor;
+        accessor.name = quantity;
+        accessor.quantity = quantity;
+        accessor.type = source::none;
+
+        if (m_compute_matrix_quantities.count(quantity))
+            {
+            accessor.type = source::compute;
+            accessor.compute = m_compute_matrix_quantities[quantity];
+            }
+        else if (m_updater_matrix_quantities.count(quantity))
+            {
+            accessor.type = source::updater;
+            accessor.updater = m_updater_matrix_quantities[quantity];
+            }
+        else if (m_callback_matrix_quantities.count(quantity))
+            {
+            accessor.type = source::callback;
+            accessor.callback = m_callback_matrix_quantities[quantity];
+            }
+        else
+            {
+            m_exec_conf->msg->warning() << "write.binary: Log matrix quantity " << quantity
+                                        << " is not registered, logging an empty matrix" << endl;
+            }
+
+        m_matrix_accessors.push_back(accessor);
+        }
+
+    m_accessors_valid = true;
+    }
+
+/*! \param accessor Resolved quantity
+    \param timestep Time step to compute value for (needed for Compute classes)
+*/
+Scalar LogBinary::evaluate(const Accessor& accessor, unsigned int timestep)
+    {
+    switch (accessor.type)
+        {
+        case source::time:
+            return Scalar(double(m_clk.getTime())/1e9);
+        case source::compute:
+            accessor.compute->compute(timestep);
+            return accessor.compute->getLogValue(accessor.quantity, timestep);
+        case source::updater:
+            return accessor.updater->getLogValue(accessor.quantity, timestep);
+        case source::callback:
+            try
+                {
+                return accessor.callback(timestep).cast<Scalar>();
+                }
+            catch (const py::cast_error&)
+                {
+                m_exec_conf->msg->warning() << "write.binary: Log callback " << accessor.name
+                                            << " returned invalid value, logging 0." << endl;
+                return Scalar(0.0);
+                }
+        default:
+            return Scalar(0.0);
+        }
+    }
+
+/*! \param accessor Resolved matrix quantity
+    \param timestep Time step to compute value for (needed for Compute classes)
+*/
+py::array LogBinary::evaluateMatrix(const Accessor& accessor, unsigned int timestep)
+    {
+    switch (accessor.type)
+        {
+        case source::compute:
+            accessor.compute->compute(timestep);
+            return accessor.compute->getLogMatrix(accessor.quantity, timestep);
+        case source::updater:
+            return accessor.updater->getLogMatrix(accessor.quantity, timestep);
+        case source::callback:
+            return accessor.callback(timestep);
+        default:
+            return py::array();
+        }
+    }
+
+/*! \param timestep Time step to write out data for
+
+    Evaluates all logged quantities and appends them as a row to the current block. Full blocks are handed to the
+    writer thread.
+*/
+void LogBinary::analyze(unsigned int timestep)
+    {
+    if (m_prof) m_prof->push("LogBinary");
+
+    if (!m_accessors_valid)
+        resolveAccessors();
+
+    // evaluate the quantities on all ranks, computes may need to communicate
+    for (unsigned int i = 0; i < m_accessors.size(); i++)
+        m_cached_quantities[i] = evaluate(m_accessors[i], timestep);
+    m_cached_timestep = timestep;
+
+    std::vector< py::array_t<double, py::array::c_style | py::array::forcecast> > matrices;
+    for (unsigned int i = 0; i < m_matrix_accessors.size(); i++)
+        {
+        py::array matrix = evaluateMatrix(m_matrix_accessors[i], timestep);
+        if (!matrix)
+            matrix = py::array_t<double>(0);
+        m_cached_matrix_quantities[i] = matrix;
+        matrices.push_back(py::array_t<double, py::array::c_style | py::array::forcecast>::ensure(matrix));
+        if (!matrices.back())
+            {
+            m_exec_conf->msg->error() << "write.binary: Log matrix quantity " << m_matrix_accessors[i].name
+                                      << " is not a numeric array" << endl;
+            throw runtime_error("Error writing binary log");
+            }
+        }
+
+    if (!m_exec_conf->isRoot())
+        {
+        if (m_prof) m_prof->pop();
+        return;
+        }
+
+    if (!m_header_written)
+        {
+        // the first row fixes the shape of the matrix columns
+        m_matrix_shapes.clear();
+        for (const auto& matrix : matrices)
+            m_matrix_shapes.push_back(std::vector<size_t>(matrix.shape(), matrix.shape() + matrix.ndim()));
+
+        writeHeader();
+        }
+
+    // append the row
+    const unsigned int row = m_block.n_rows;
+    m_block.timesteps[row] = timestep;
+
+    for (unsigned int i = 0; i < m_accessors.size(); i++)
+        m_block.values[m_column_offset[i] + row] = m_cached_quantities[i];
+
+    for (unsigned int i = 0; i < matrices.size(); i++)
+        {
+        unsigned int column = (unsigned int)m_accessors.size() + i;
+        size_t size = m_column_size[column];
+        if ((size_t)matrices[i].size() != size)
+            {
+            m_exec_conf->msg->error() << "write.binary: The shape of log matrix quantity "
+                                      << m_matrix_accessors[i].name << " changed" << endl;
+            throw runtime_error("Error writing binary log");
+            }
+
+        const double *data = matrices[i].data();
+        std::copy(data, data + size, m_block.values.begin() + m_column_offset[column] + row*size);
+        }
+
+    m_block.n_rows++;
+    if (m_block.n_rows == m_buffer_size)
+        submitBlock();
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! Fixes the column layout, opens the file, writes or checks the header, and starts the writer thread.
+*/
+void LogBinary::writeHeader()
+    {
+    // one column per scalar quantity followed by one column per matrix quantity
+    m_column_size.assign(m_accessors.size(), 1);
+    for (const auto& shape : m_matrix_shapes)
+        {
+        size_t size = 1;
+        for (auto dim : shape)
+            size *= dim;
+        m_column_size.push_back(size);
+        }
+
+    m_column_offset.resize(m_column_size.size() + 1);
+    m_column_offset[0] = 0;
+    for (unsigned int i = 0; i < m_column_size.size(); i++)
+        m_column_offset[i+1] = m_column_offset[i] + m_buffer_size*m_column_size[i];
+
+    for (Block* block : {&m_block, &m_pending})
+        {
+        block->n_rows = 0;
+        block->timesteps.resize(m_buffer_size);
+        block->values.resize(m_column_offset.back());
+        }
+
+    const uint16_t byte_order_test = 1;
+    const bool little_endian = *reinterpret_cast<const uint8_t*>(&byte_order_test) == 1;
+
+    ostringstream header;
+    header << "HOOMD-blue binary log" << "\n";
+    header << "version 1" << "\n";
+    header << "byte_order " << (little_endian ? "little" : "big") << "\n";
+    header << "column timestep uint64" << "\n";
+    for (const auto& quantity : m_logged_quantities)
+        header << "column " << quantity << " float64" << "\n";
+    for (unsigned int i = 0; i < m_logged_matrix_quantities.size(); i++)
+        {
+        header << "column " << m_logged_matrix_quantities[i] << " float64";
+        for (auto dim : m_matrix_shapes[i])
+            header << " " << dim;
+        header << "\n";
+        }
+    header << "end_header" << "\n";
+
+    // when appending, the existing file must have the same columns
+    bool append = false;
+    if (!m_overwrite && filesystem::exists(m_filename))
+        {
+        ifstream existing(m_filename.c_str(), ios_base::in | ios_base::binary);
+        ostringstream existing_header;
+        string line;
+        while (getline(existing, line))
+            {
+            existing_header << line << "\n";
+            if (line == "end_header")
+                break;
+            }
+
+        if (existing_header.str().size() > 0)
+            {
+            if (existing_header.str() != header.str())
+                {
+                m_exec_conf->msg->error() << "write.binary: The quantities logged in " << m_filename
+                                          << " do not match, cannot append" << endl;
+                throw runtime_error("Error opening binary log file");
+                }
+            append = true;
+            }
+        }
+
+    m_exec_conf->msg->notice(3) << "write.binary: " << (append ? "Appending to " : "Creating ") << m_filename
+                                << endl;
+    m_file.open(m_filename.c_str(), ios_base::out | ios_base::binary | (append ? ios_base::app : ios_base::trunc));
+    if (!m_file.good())
+        {
+        m_exec_conf->msg->error() << "write.binary: Error opening file " << m_filename << endl;
+        throw runtime_error("Error opening binary log file");
+        }
+
+    if (!append)
+        m_file << header.str();
+
+    m_writer = std::thread(&LogBinary::writerLoop, this);
+    m_header_written = true;
+    }
+
+/*! Waits until the writer thread has finished the previous block and swaps the current block in.
+*/
+void LogBinary::submitBlock()
+    {
+    waitForWriter();
+
+        {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(m_block, m_pending);
+        m_pending_full = true;
+        }
+    m_cv.notify_all();
+
+    m_block.n_rows = 0;
+    }
+
+void LogBinary::waitForWriter()
+    {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return !m_pending_full; });
+
+    if (m_write_error)
+        {
+        m_write_error = false;
+        m_exec_conf->msg->error() << "write.binary: Error writing to " << m_filename << endl;
+        throw runtime_error("Error writing binary log");
+        }
+    }
+
+/*! The rows of a block that is not full yet are written as a shorter block.
+*/
+void LogBinary::flush()
+    {
+    if (!m_header_written)
+        return;
+
+    if (m_block.n_rows > 0)
+        submitBlock();
+
+    waitForWriter();
+    m_file.flush();
+    }
+
+void LogBinary::writerLoop()
+    {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+        {
+        m_cv.wait(lock, [this] { return m_pending_full || m_stop; });
+
+        if (m_pending_full)
+            {
+            // the main thread does not touch m_pending until m_pending_full is reset
+            lock.unlock();
+            writeBlock(m_pending);
+            bool good = m_file.good();
+            lock.lock();
+
+            if (!good)
+                m_write_error = true;
+            m_pending_full = false;
+            m_cv.notify_all();
+            }
+        else
+            {
+            break;
+            }
+        }
+    }
+
+/*! \param block Block to write
+*/
+void LogBinary::writeBlock(const Block& block)
+    {
+    uint64_t n_rows = block.n_rows;
+    m_file.write(reinterpret_cast<const char*>(&n_rows), sizeof(uint64_t));
+    m_file.write(reinterpret_cast<const char*>(block.timesteps.data()), sizeof(uint64_t)*n_rows);
+
+    for (unsigned int i = 0; i < m_column_size.size(); i++)
+        {
+        m_file.write(reinterpret_cast<const char*>(block.values.data() + m_column_offset[i]),
+                     sizeof(double)*m_column_size[i]*n_rows);
+        }
+    }
+
+void export_LogBinary(py::module& m)
+    {
+    py::class_<LogBinary, LogMatrix, std::shared_ptr<LogBinary> >(m,"LogBinary")
+        .def(py::init< std::shared_ptr<SystemDefinition>, const std::string&, unsigned int, bool >())
+        .def("registerComputeQuantity", &LogBinary::registerComputeQuantity)
+        .def("flush", &LogBinary::flush)
+        .def_property_readonly("filename", &LogBinary::getFilename)
+        .def_property_readonly("buffer_size", &LogBinary::getBufferSize)
+        .def_property_readonly("overwrite", &LogBinary::getOverwrite)
+        ;
+    }
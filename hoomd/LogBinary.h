@@ -0,0 +1,210 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file LogBinary.h
+    \brief Declares the LogBinary class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "LogMatrix.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef __LOGBINARY_H__
+#define __LOGBINARY_H__
+
+//! Logs registered scalar and matrix quantities to a columnar binary file
+/*! LogBinary collects the same quantities as LogMatrix, but it resolves every logged quantity once to the compute,
+    updater, or callback that provides it instead of looking the name up on every call to analyze(). A quantity can
+    also be registered under its own name with the compute and the compute's log quantity that provide it, so that
+    it is evaluated without calling back into python. Rows are buffered in memory in blocks of a fixed number of rows.
+    Full blocks are written by a background thread while the simulation continues, so that logging does not wait for
+    the file system.
+
+    The file starts with a plain text header that describes the columns:
+    \code
+    HOOMD-blue binary log
+    version 1
+    byte_order little
+    column timestep uint64
+    column <name> float64 [<dim> ...]
+    end_header
+    \endcode
+    A scalar column has no dimensions, a matrix column lists the shape of the matrix. The header is followed by
+    blocks. Each block starts with the number of rows n in the block (uint64), followed by the values of each column
+    in the order of the header, n values (or n matrices in row major order) at a time.
+
+    The shape of the matrix quantities is fixed by the first row. The logged quantities cannot be changed after the
+    header has been written. When appending to an existing file, its header must match.
+
+    Only the root rank writes the file.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT LogBinary : public LogMatrix
+    {
+    public:
+        //! Constructs the logger
+        LogBinary(std::shared_ptr<SystemDefinition> sysdef,
+                  const std::string& fname,
+                  unsigned int buffer_size,
+                  bool overwrite=false);
+
+        //! Destructor
+        virtual ~LogBinary();
+
+        //! Registers a compute
+        virtual void registerCompute(std::shared_ptr<Compute> compute);
+
+        //! Registers an updater
+        virtual void registerUpdater(std::shared_ptr<Updater> updater);
+
+        //! Register a callback
+        virtual void registerCallback(std::string name, pybind11::handle callback);
+
+        //! Register a callback for matrix quantities
+        virtual void registerMatrixCallback(std::string name, pybind11::object callback);
+
+        //! Register a quantity provided by a compute under a given name
+        void registerComputeQuantity(const std::string& name,
+                                     std::shared_ptr<Compute> compute,
+                                     const std::string& quantity);
+
+        //! Clears all registered computes and updaters
+        virtual void removeAll();
+
+        //! Selects which quantities to log
+        virtual void setLoggedQuantities(const std::vector< std::string >& quantities);
+
+        //! Selects which matrix quantities to log
+        virtual void setLoggedMatrixQuantities(const std::vector< std::string >& quantities);
+
+        //! Buffer the data for the current timestep
+        virtual void analyze(unsigned int timestep);
+
+        //! Write all buffered rows to the file
+        void flush();
+
+        //! Write the buffered rows when the analyzer is removed from the simulation
+        virtual void notifyDetach()
+            {
+            flush();
+            }
+
+        //! Get the file name
+        std::string getFilename()
+            {
+            return m_filename;
+            }
+
+        //! Get the number of rows in a block
+        unsigned int getBufferSize()
+            {
+            return m_buffer_size;
+            }
+
+        //! Get the overwrite flag
+        bool getOverwrite()
+            {
+            return m_overwrite;
+            }
+
+    protected:
+        //! Source of a logged quantity
+        enum class source
+            {
+            none,
+            time,
+            compute,
+            updater,
+            callback
+            };
+
+        //! Logged quantity resolved to its source
+        struct Accessor
+            {
+            source type;                        //!< Kind of the source
+            std::string name;                   //!< Name of the logged quantity
+            std::string quantity;               //!< Name of the quantity passed on to getLogValue()
+            std::shared_ptr<Compute> compute;   //!< Compute providing the quantity
+            std::shared_ptr<Updater> updater;   //!< Updater providing the quantity
+            pybind11::object callback;          //!< Python callback providing the quantity
+            };
+
+        //! A block of rows stored column by column
+        struct Block
+            {
+            unsigned int n_rows;                //!< Number of valid rows
+            std::vector<uint64_t> timesteps;    //!< Time step of each row
+            std::vector<double> values;         //!< Column i occupies m_column_offset[i] ... m_column_offset[i+1]
+            };
+
+        std::string m_filename;                 //!< The output file name
+        unsigned int m_buffer_size;             //!< Number of rows in a block
+        bool m_overwrite;                       //!< True if the file is overwritten
+
+        //! Computes and their quantity names registered with registerComputeQuantity(), by logged name
+        std::map< std::string, std::pair< std::shared_ptr<Compute>, std::string > > m_direct_quantities;
+
+        bool m_accessors_valid;                 //!< True when the accessors match the logged quantities
+        std::vector<Accessor> m_accessors;      //!< Accessors of the scalar quantities
+        std::vector<Accessor> m_matrix_accessors;   //!< Accessors of the matrix quantities
+
+        bool m_header_written;                      //!< True once the column layout is fixed
+        std::vector< std::vector<size_t> > m_matrix_shapes; //!< Shape of each matrix quantity
+        std::vector<size_t> m_column_size;          //!< Number of values per row in each column
+        std::vector<size_t> m_column_offset;        //!< Offset of each column in Block::values
+
+        Block m_block;                          //!< Block being filled
+        Block m_pending;                        //!< Block handed to the writer thread
+
+        std::ofstream m_file;                   //!< The output file (root rank only)
+        std::thread m_writer;                   //!< Background thread writing m_pending
+        std::mutex m_mutex;                     //!< Protects the fields below
+        std::condition_variable m_cv;           //!< Signals changes of m_pending_full and m_stop
+        bool m_pending_full;                    //!< True while m_pending waits to be written
+        bool m_stop;                            //!< Tells the writer thread to exit
+        bool m_write_error;                     //!< True if the writer thread failed to write
+
+        //! Resolve the logged quantities to their sources
+        void resolveAccessors();
+
+        //! Evaluate a scalar quantity
+        Scalar evaluate(const Accessor& accessor, unsigned int timestep);
+
+        //! Evaluate a matrix quantity
+        pybind11::array evaluateMatrix(const Accessor& accessor, unsigned int timestep);
+
+        //! Fix the column layout and write the header
+        void writeHeader();
+
+        //! Hand the current block to the writer thread
+        void submitBlock();
+
+        //! Wait until the writer thread is done with the pending block
+        void waitForWriter();
+
+        //! Body of the writer thread
+        void writerLoop();
+
+        //! Write a block to the file
+        void writeBlock(const Block& block);
+
+        //! Error out if the logged quantities change after the header has been written
+        void checkLayoutChange();
+    };
+
+//! Exports the LogBinary class to python
+void export_LogBinary(pybind11::module& m);
+
+#endif
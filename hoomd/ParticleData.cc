@@ -64,7 +64,8 @@ ParticleData::ParticleData(unsigned int N, const BoxDim &global_box, unsigned in
           m_nglobal(0),
           m_accel_set(false),
           m_resize_factor(9./8.),
-          m_arrays_allocated(false)
+          m_arrays_allocated(false),
+          m_group_flags_used(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing ParticleData" << endl;
 
@@ -120,6 +121,7 @@ ParticleData::ParticleData(unsigned int N, const BoxDim &global_box, unsigned in
         m_external_virial[i] = Scalar(0.0);
 
     m_external_energy = Scalar(0.0);
+    m_net_force_sums_valid = false;
 
     // zero the origin
     m_origin = make_scalar3(0,0,0);
@@ -145,7 +147,8 @@ ParticleData::ParticleData(const SnapshotParticleData<Real>& snapshot,
       m_nglobal(0),
       m_accel_set(false),
       m_resize_factor(9./8.),
-      m_arrays_allocated(false)
+      m_arrays_allocated(false),
+      m_group_flags_used(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing ParticleData" << endl;
 
@@ -184,6 +187,7 @@ ParticleData::ParticleData(const SnapshotParticleData<Real>& snapshot,
         m_external_virial[i] = Scalar(0.0);
 
     m_external_energy = Scalar(0.0);
+    m_net_force_sums_valid = false;
 
     // default constructed shared ptr is null as desired
     m_prof = std::shared_ptr<Profiler>();
@@ -257,6 +261,9 @@ void ParticleData::notifyParticleSort()
         }
     #endif
 
+    // the net force arrays have been rearranged
+    m_net_force_sums_valid = false;
+
     m_sort_signal.emit();
     }
 
@@ -376,6 +383,11 @@ void ParticleData::allocate(unsigned int N)
     m_body.swap(body);
     TAG_ALLOCATION(m_body);
 
+    // distributed group membership
+    GlobalArray< unsigned int > group_flags(N, m_exec_conf);
+    m_group_flags.swap(group_flags);
+    TAG_ALLOCATION(m_group_flags);
+
     GlobalArray< Scalar4 > net_force(N, m_exec_conf);
     m_net_force.swap(net_force);
     TAG_ALLOCATION(m_net_force);
@@ -427,14 +439,25 @@ void ParticleData::allocate(unsigned int N)
             cudaMemAdvise(m_image.get(), sizeof(int3)*m_image.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             cudaMemAdvise(m_tag.get(), sizeof(unsigned int)*m_tag.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             cudaMemAdvise(m_body.get(), sizeof(unsigned int)*m_body.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            cudaMemAdvise(m_group_flags.get(), sizeof(unsigned int)*m_group_flags.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             cudaMemAdvise(m_orientation.get(), sizeof(Scalar4)*m_orientation.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             }
         CHECK_CUDA_ERROR();
         }
     #endif
 
-    // allocate alternate particle data arrays (for swapping in-out)
-    allocateAlternateArrays(N);
+    // allocate alternate particle data arrays (for swapping in-out), only the GPU code paths reorder through them
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        allocateAlternateArrays(N);
+        }
+    else
+        {
+        // the MPCD collision rules swap in the alternate velocities on the CPU as well
+        GlobalArray< Scalar4 > vel_alt(N, m_exec_conf);
+        m_vel_alt.swap(vel_alt);
+        TAG_ALLOCATION(m_vel_alt);
+        }
 
     // notify observers
     m_max_particle_num_signal.emit();
@@ -488,6 +511,11 @@ void ParticleData::allocateAlternateArrays(unsigned int N)
     m_body_alt.swap(body_alt);
     TAG_ALLOCATION(m_body_alt);
 
+    // distributed group membership
+    GlobalArray< unsigned int > group_flags_alt(N, m_exec_conf);
+    m_group_flags_alt.swap(group_flags_alt);
+    TAG_ALLOCATION(m_group_flags_alt);
+
     // orientation
     GlobalArray< Scalar4 > orientation_alt(N, m_exec_conf);
     m_orientation_alt.swap(orientation_alt);
@@ -543,6 +571,7 @@ void ParticleData::allocateAlternateArrays(unsigned int N)
             cudaMemAdvise(m_image_alt.get(), sizeof(int3)*m_image_alt.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             cudaMemAdvise(m_tag_alt.get(), sizeof(unsigned int)*m_tag_alt.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             cudaMemAdvise(m_body_alt.get(), sizeof(unsigned int)*m_body_alt.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            cudaMemAdvise(m_group_flags_alt.get(), sizeof(unsigned int)*m_group_flags_alt.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             cudaMemAdvise(m_orientation_alt.get(), sizeof(Scalar4)*m_orientation_alt.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             }
         CHECK_CUDA_ERROR();
@@ -646,6 +675,7 @@ void ParticleData::reallocate(unsigned int max_n)
     m_image.resize(max_n);
     m_tag.resize(max_n);
     m_body.resize(max_n);
+    m_group_flags.resize(max_n);
 
     m_net_force.resize(max_n);
     m_net_virial.resize(max_n,6);
@@ -681,13 +711,19 @@ void ParticleData::reallocate(unsigned int max_n)
             cudaMemAdvise(m_image.get(), sizeof(int3)*m_image.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             cudaMemAdvise(m_tag.get(), sizeof(unsigned int)*m_tag.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             cudaMemAdvise(m_body.get(), sizeof(unsigned int)*m_body.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            cudaMemAdvise(m_group_flags.get(), sizeof(unsigned int)*m_group_flags.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             cudaMemAdvise(m_orientation.get(), sizeof(Scalar4)*m_orientation.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             }
         CHECK_CUDA_ERROR();
         }
     #endif
 
-    if (! m_pos_alt.isNull())
+    if (m_pos_alt.isNull() && ! m_vel_alt.isNull())
+        {
+        // only the alternate velocities are allocated for CPU execution
+        m_vel_alt.resize(max_n);
+        }
+    else if (! m_pos_alt.isNull())
         {
         // reallocate alternate arrays
         m_pos_alt.resize(max_n);
@@ -698,6 +734,7 @@ void ParticleData::reallocate(unsigned int max_n)
         m_image_alt.resize(max_n);
         m_tag_alt.resize(max_n);
         m_body_alt.resize(max_n);
+        m_group_flags_alt.resize(max_n);
         m_orientation_alt.resize(max_n);
         m_angmom_alt.resize(max_n);
         m_inertia_alt.resize(max_n);
@@ -731,6 +768,7 @@ void ParticleData::reallocate(unsigned int max_n)
                 cudaMemAdvise(m_image_alt.get(), sizeof(int3)*m_image_alt.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
                 cudaMemAdvise(m_tag_alt.get(), sizeof(unsigned int)*m_tag_alt.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
                 cudaMemAdvise(m_body_alt.get(), sizeof(unsigned int)*m_body_alt.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+                cudaMemAdvise(m_group_flags_alt.get(), sizeof(unsigned int)*m_group_flags_alt.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
                 cudaMemAdvise(m_orientation_alt.get(), sizeof(Scalar4)*m_orientation_alt.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
                 }
             CHECK_CUDA_ERROR();
@@ -818,6 +856,38 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
     // remove all ghost particles
     removeAllGhostParticles();
 
+    // the snapshot does not carry the membership flags of distributed groups, save them by tag so that the
+    // particles keep their flags
+    std::vector<unsigned int> group_flags_by_tag;
+    if (m_group_flags_used)
+        {
+        std::vector<unsigned int> tag_flags;
+            {
+            ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_group_flags(m_group_flags, access_location::host, access_mode::read);
+            for (unsigned int idx = 0; idx < m_nparticles; idx++)
+                {
+                tag_flags.push_back(h_tag.data[idx]);
+                tag_flags.push_back(h_group_flags.data[idx]);
+                }
+            }
+
+        #ifdef ENABLE_MPI
+        if (m_decomposition)
+            {
+            std::vector< std::vector<unsigned int> > tag_flags_proc;
+            gather_v(tag_flags, tag_flags_proc, 0, m_exec_conf->getMPICommunicator());
+            tag_flags.clear();
+            for (auto& v : tag_flags_proc)
+                tag_flags.insert(tag_flags.end(), v.begin(), v.end());
+            }
+        #endif
+
+        group_flags_by_tag.resize(m_rtag.size(), 0);
+        for (unsigned int i = 0; i < tag_flags.size(); i += 2)
+            group_flags_by_tag[tag_flags[i]] = tag_flags[i+1];
+        }
+
     // check that all fields in the snapshot have correct length
     if (m_exec_conf->getRank() == 0 && ! snapshot.validate())
         {
@@ -856,6 +926,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         std::vector< std::vector<Scalar4> > angmom_proc;           // Angular momenta of every processor
         std::vector< std::vector<Scalar3> > inertia_proc;           // Angular momenta of every processor
         std::vector< std::vector<unsigned int > > tag_proc;         // Global tags of every processor
+        std::vector< std::vector<unsigned int > > group_flags_proc; // Group flags of every processor
         std::vector< unsigned int > N_proc;                        // Number of particles on every processor
 
 
@@ -877,6 +948,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         angmom_proc.resize(size);
         inertia_proc.resize(size);
         tag_proc.resize(size);
+        group_flags_proc.resize(size);
         N_proc.resize(size,0);
 
         if (my_rank == 0)
@@ -973,6 +1045,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
                 orientation_proc[rank].push_back(quat_to_scalar4(snapshot.orientation[snap_idx]));
                 angmom_proc[rank].push_back(quat_to_scalar4(snapshot.angmom[snap_idx]));
                 inertia_proc[rank].push_back(vec_to_scalar3(snapshot.inertia[snap_idx]));
+                group_flags_proc[rank].push_back(nglobal < group_flags_by_tag.size() ? group_flags_by_tag[nglobal] : 0);
                 tag_proc[rank].push_back(nglobal++);
                 N_proc[rank]++;
                 }
@@ -1010,6 +1083,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         std::vector<Scalar4> angmom;
         std::vector<Scalar3> inertia;
         std::vector<unsigned int> tag;
+        std::vector<unsigned int> group_flags;
 
         // distribute particle data
         scatter_v(pos_proc,pos,root, mpi_comm);
@@ -1025,6 +1099,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         scatter_v(angmom_proc, angmom, root, mpi_comm);
         scatter_v(inertia_proc, inertia, root, mpi_comm);
         scatter_v(tag_proc, tag, root, mpi_comm);
+        scatter_v(group_flags_proc, group_flags, root, mpi_comm);
 
         // distribute number of particles
         scatter_v(N_proc, m_nparticles, root, mpi_comm);
@@ -1065,6 +1140,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         ArrayHandle< Scalar3 > h_inertia(m_inertia, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_comm_flag(m_comm_flags, access_location::host, access_mode::overwrite);
+        ArrayHandle< unsigned int > h_group_flags(m_group_flags, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::readwrite);
 
         for (unsigned int idx = 0; idx < m_nparticles; idx++)
@@ -1083,6 +1159,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
             h_inertia.data[idx] = inertia[idx];
 
             h_comm_flag.data[idx] = 0; // initialize with zero
+            h_group_flags.data[idx] = group_flags[idx];
             }
         }
     else
@@ -1115,6 +1192,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         ArrayHandle< Scalar4 > h_angmom(m_angmom, access_location::host, access_mode::overwrite);
         ArrayHandle< Scalar3 > h_inertia(m_inertia, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::overwrite);
+        ArrayHandle< unsigned int > h_group_flags(m_group_flags, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::readwrite);
 
         for (unsigned int snap_idx = 0; snap_idx < snapshot.size; snap_idx++)
@@ -1143,6 +1221,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
             h_orientation.data[nglobal] = quat_to_scalar4(snapshot.orientation[snap_idx]);
             h_angmom.data[nglobal] = quat_to_scalar4(snapshot.angmom[snap_idx]);
             h_inertia.data[nglobal] = vec_to_scalar3(snapshot.inertia[snap_idx]);
+            h_group_flags.data[nglobal] = nglobal < group_flags_by_tag.size() ? group_flags_by_tag[nglobal] : 0;
             nglobal++;
             }
 
@@ -1167,6 +1246,9 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
     // set global number of particles
     setNGlobal(nglobal);
 
+    // the net force sums no longer match the local particles
+    invalidateNetForceSums();
+
     // notify listeners about resorting of local particles
     notifyParticleSort();
 
@@ -2285,6 +2367,7 @@ unsigned int ParticleData::addParticle(unsigned int type)
         ArrayHandle<Scalar4> h_orientation(getOrientationArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flag(m_comm_flags, access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_group_flags(m_group_flags, access_location::host, access_mode::readwrite);
 
         unsigned int idx = old_nparticles;
 
@@ -2301,6 +2384,7 @@ unsigned int ParticleData::addParticle(unsigned int type)
         h_orientation.data[idx] = make_scalar4(1.0,0.0,0.0,0.0);
         h_tag.data[idx] = tag;
         h_comm_flag.data[idx] = 0;
+        h_group_flags.data[idx] = 0;
         }
 
     // update global number of particles
@@ -2388,6 +2472,7 @@ void ParticleData::removeParticle(unsigned int tag)
             ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
             ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
             ArrayHandle<unsigned int> h_comm_flag(m_comm_flags, access_location::host, access_mode::readwrite);
+            ArrayHandle<unsigned int> h_group_flags(m_group_flags, access_location::host, access_mode::readwrite);
 
             h_pos.data[idx] = h_pos.data[size-1];
             h_vel.data[idx] = h_vel.data[size-1];
@@ -2399,6 +2484,7 @@ void ParticleData::removeParticle(unsigned int tag)
             h_orientation.data[idx] = h_orientation.data[size-1];
             h_tag.data[idx] = h_tag.data[size-1];
             h_comm_flag.data[idx] = h_comm_flag.data[size-1];
+            h_group_flags.data[idx] = h_group_flags.data[size-1];
 
             unsigned int last_tag = h_tag.data[size-1];
             h_rtag.data[last_tag] = idx;
@@ -2442,6 +2528,42 @@ unsigned int ParticleData::getNthTag(unsigned int n)
     return m_cached_tag_set[n];
     }
 
+/*! \returns The bit in the group flags that is assigned to the caller
+
+    The flag is cleared on all local particles. Every rank assigns the bits in the same order, so a group that is
+    constructed collectively is assigned the same bit on every rank.
+*/
+unsigned int ParticleData::allocateGroupFlag()
+    {
+    const unsigned int n_flags = sizeof(unsigned int)*8;
+    unsigned int flag = 0;
+    while (flag < n_flags && (m_group_flags_used & (1u << flag)))
+        flag++;
+
+    if (flag == n_flags)
+        {
+        m_exec_conf->msg->error() << "At most " << n_flags << " distributed particle groups may exist at the same time"
+                                  << std::endl;
+        throw std::runtime_error("Error allocating group flag");
+        }
+
+    m_group_flags_used |= 1u << flag;
+
+    ArrayHandle<unsigned int> h_group_flags(m_group_flags, access_location::host, access_mode::readwrite);
+    for (unsigned int idx = 0; idx < getN(); ++idx)
+        h_group_flags.data[idx] &= ~(1u << flag);
+
+    return flag;
+    }
+
+/*! \param flag Bit in the group flags previously returned by allocateGroupFlag()
+*/
+void ParticleData::releaseGroupFlag(unsigned int flag)
+    {
+    assert(m_group_flags_used & (1u << flag));
+    m_group_flags_used &= ~(1u << flag);
+    }
+
 void export_BoxDim(py::module& m)
     {
     void (BoxDim::*wrap_overload)(Scalar3&, int3&, char3) const = &BoxDim::wrap;
@@ -2698,26 +2820,12 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
         ArrayHandle<Scalar> h_net_virial(getNetVirial(), access_location::host, access_mode::readwrite);
 
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_group_flags(getGroupFlags(), access_location::host, access_mode::readwrite);
 
-        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
 
         ArrayHandle<unsigned int> h_comm_flags(getCommFlags(), access_location::host, access_mode::readwrite);
 
-        ArrayHandle<Scalar4> h_pos_alt(m_pos_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_vel_alt(m_vel_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar3> h_accel_alt(m_accel_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_charge_alt(m_charge_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_diameter_alt(m_diameter_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<int3> h_image_alt(m_image_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<unsigned int> h_body_alt(m_body_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_orientation_alt(m_orientation_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_angmom_alt(m_angmom_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar3> h_inertia_alt(m_inertia_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_net_force_alt(m_net_force_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_net_torque_alt(m_net_torque_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_net_virial_alt(m_net_virial_alt, access_location::host, access_mode::overwrite);
-        ArrayHandle<unsigned int> h_tag_alt(m_tag_alt, access_location::host, access_mode::overwrite);
-
         unsigned int n =0;
         unsigned int m = 0;
         unsigned int net_virial_pitch = m_net_virial.getPitch();
@@ -2726,22 +2834,26 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
             unsigned int tag = h_tag.data[i];
             if (h_rtag.data[tag] != NOT_LOCAL)
                 {
-                // copy over to alternate pdata arrays
-                h_pos_alt.data[n] = h_pos.data[i];
-                h_vel_alt.data[n] = h_vel.data[i];
-                h_accel_alt.data[n] = h_accel.data[i];
-                h_charge_alt.data[n] = h_charge.data[i];
-                h_diameter_alt.data[n] = h_diameter.data[i];
-                h_image_alt.data[n] = h_image.data[i];
-                h_body_alt.data[n] = h_body.data[i];
-                h_orientation_alt.data[n] = h_orientation.data[i];
-                h_angmom_alt.data[n] = h_angmom.data[i];
-                h_inertia_alt.data[n] = h_inertia.data[i];
-                h_net_force_alt.data[n] = h_net_force.data[i];
-                h_net_torque_alt.data[n] = h_net_torque.data[i];
-                for (unsigned int j = 0; j < 6; ++j)
-                    h_net_virial_alt.data[net_virial_pitch*j+n] = h_net_virial.data[net_virial_pitch*j+i];
-                h_tag_alt.data[n] = h_tag.data[i];
+                // compact the particle data in place, n <= i so that unread particles are not overwritten
+                if (n != i)
+                    {
+                    h_pos.data[n] = h_pos.data[i];
+                    h_vel.data[n] = h_vel.data[i];
+                    h_accel.data[n] = h_accel.data[i];
+                    h_charge.data[n] = h_charge.data[i];
+                    h_diameter.data[n] = h_diameter.data[i];
+                    h_image.data[n] = h_image.data[i];
+                    h_body.data[n] = h_body.data[i];
+                    h_orientation.data[n] = h_orientation.data[i];
+                    h_angmom.data[n] = h_angmom.data[i];
+                    h_inertia.data[n] = h_inertia.data[i];
+                    h_net_force.data[n] = h_net_force.data[i];
+                    h_net_torque.data[n] = h_net_torque.data[i];
+                    for (unsigned int j = 0; j < 6; ++j)
+                        h_net_virial.data[net_virial_pitch*j+n] = h_net_virial.data[net_virial_pitch*j+i];
+                    h_tag.data[n] = h_tag.data[i];
+                    h_group_flags.data[n] = h_group_flags.data[i];
+                    }
                 ++n;
                 }
             else
@@ -2763,6 +2875,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
                 for (unsigned int j = 0; j < 6; ++j)
                     p.net_virial[j] = h_net_virial.data[net_virial_pitch*j+i];
                 p.tag = h_tag.data[i];
+                p.group_flags = h_group_flags.data[i];
                 out[m++] = p;
                 }
             }
@@ -2773,27 +2886,6 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
 
         // reset communication flags to zero
         std::fill(h_comm_flags.data, h_comm_flags.data + new_nparticles, 0);
-        }
-
-    // swap particle data arrays
-    swapPositions();
-    swapVelocities();
-    swapAccelerations();
-    swapCharges();
-    swapDiameters();
-    swapImages();
-    swapBodies();
-    swapOrientations();
-    swapAngularMomenta();
-    swapMomentsOfInertia();
-    swapNetForce();
-    swapNetTorque();
-    swapNetVirial();
-    swapTags();
-
-        {
-        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
-        ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::read);
 
         // recompute rtags (particles have moved)
         for (unsigned int idx = 0; idx < m_nparticles; ++idx)
@@ -2807,6 +2899,9 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
 
     if (m_prof) m_prof->pop();
 
+    // the net force sums no longer match the local particles
+    invalidateNetForceSums();
+
     // notify subscribers that particle data order has been changed
     notifyParticleSort();
     }
@@ -2840,6 +2935,7 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
         ArrayHandle<Scalar4> h_net_torque(getNetTorqueArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar> h_net_virial(getNetVirial(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_group_flags(getGroupFlags(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
 
@@ -2864,6 +2960,7 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
             for (unsigned int j = 0; j < 6; ++j)
                 h_net_virial.data[net_virial_pitch*j+n] = p.net_virial[j];
             h_tag.data[n] = p.tag;
+            h_group_flags.data[n] = p.group_flags;
             n++;
             }
 
@@ -2882,6 +2979,9 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
 
     if (m_prof) m_prof->pop();
 
+    // the net force sums no longer match the local particles
+    invalidateNetForceSums();
+
     // notify subscribers that particle data order has been changed
     notifyParticleSort();
     }
@@ -2933,6 +3033,7 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
         ArrayHandle<Scalar4> d_net_torque(getNetTorqueArray(), access_location::device, access_mode::read);
         ArrayHandle<Scalar> d_net_virial(getNetVirial(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_tag(getTags(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_group_flags(getGroupFlags(), access_location::device, access_mode::read);
 
         // access alternate particle data arrays to write to
         ArrayHandle<Scalar4> d_pos_alt(m_pos_alt, access_location::device, access_mode::overwrite);
@@ -2949,6 +3050,7 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
         ArrayHandle<Scalar4> d_net_torque_alt(m_net_torque_alt, access_location::device, access_mode::overwrite);
         ArrayHandle<Scalar> d_net_virial_alt(m_net_virial_alt, access_location::device, access_mode::overwrite);
         ArrayHandle<unsigned int> d_tag_alt(m_tag_alt, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_group_flags_alt(m_group_flags_alt, access_location::device, access_mode::overwrite);
 
         ArrayHandle<unsigned int> d_comm_flags(getCommFlags(), access_location::device, access_mode::readwrite);
 
@@ -2982,6 +3084,7 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
                            getNetVirial().getPitch(),
                            d_tag.data,
                            d_rtag.data,
+                           d_group_flags.data,
                            d_pos_alt.data,
                            d_vel_alt.data,
                            d_accel_alt.data,
@@ -2996,6 +3099,7 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
                            d_net_torque_alt.data,
                            d_net_virial_alt.data,
                            d_tag_alt.data,
+                           d_group_flags_alt.data,
                            d_out.data,
                            d_comm_flags.data,
                            d_comm_flags_out.data,
@@ -3039,6 +3143,10 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
     swapNetTorque();
     swapNetVirial();
     swapTags();
+    swapGroupFlags();
+
+    // the net force sums no longer match the local particles
+    invalidateNetForceSums();
 
     // notify subscribers
     notifyParticleSort();
@@ -3075,6 +3183,7 @@ void ParticleData::addParticlesGPU(const GlobalVector<pdata_element>& in)
         ArrayHandle<Scalar> d_net_virial(getNetVirial(), access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_tag(getTags(), access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_rtag(getRTags(), access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_group_flags(getGroupFlags(), access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_comm_flags(getCommFlags(), access_location::device, access_mode::readwrite);
 
         // Access input array
@@ -3100,6 +3209,7 @@ void ParticleData::addParticlesGPU(const GlobalVector<pdata_element>& in)
             getNetVirial().getPitch(),
             d_tag.data,
             d_rtag.data,
+            d_group_flags.data,
             d_in.data,
             d_comm_flags.data);
 
@@ -3107,6 +3217,9 @@ void ParticleData::addParticlesGPU(const GlobalVector<pdata_element>& in)
             CHECK_CUDA_ERROR();
         }
 
+    // the net force sums no longer match the local particles
+    invalidateNetForceSums();
+
     // notify subscribers
     notifyParticleSort();
 
@@ -3149,6 +3262,7 @@ void ParticleData::setGPUAdvice()
             cudaMemAdvise(m_image.get()+range.first, sizeof(int3)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
             cudaMemAdvise(m_tag.get()+range.first, sizeof(unsigned int)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
             cudaMemAdvise(m_body.get()+range.first, sizeof(unsigned int)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+            cudaMemAdvise(m_group_flags.get()+range.first, sizeof(unsigned int)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
             cudaMemAdvise(m_orientation.get()+range.first, sizeof(Scalar4)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
             cudaMemAdvise(m_angmom.get()+range.first, sizeof(Scalar4)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
             cudaMemAdvise(m_inertia.get()+range.first, sizeof(Scalar3)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
@@ -3166,6 +3280,7 @@ void ParticleData::setGPUAdvice()
             cudaMemPrefetchAsync(m_image.get()+range.first, sizeof(int3)*nelem, gpu_map[idev]);
             cudaMemPrefetchAsync(m_tag.get()+range.first, sizeof(unsigned int)*nelem, gpu_map[idev]);
             cudaMemPrefetchAsync(m_body.get()+range.first, sizeof(unsigned int)*nelem, gpu_map[idev]);
+            cudaMemPrefetchAsync(m_group_flags.get()+range.first, sizeof(unsigned int)*nelem, gpu_map[idev]);
             cudaMemPrefetchAsync(m_orientation.get()+range.first, sizeof(Scalar4)*nelem, gpu_map[idev]);
             cudaMemPrefetchAsync(m_angmom.get()+range.first, sizeof(Scalar4)*nelem, gpu_map[idev]);
             cudaMemPrefetchAsync(m_inertia.get()+range.first, sizeof(Scalar3)*nelem, gpu_map[idev]);
@@ -3194,6 +3309,7 @@ void ParticleData::setGPUAdvice()
                 cudaMemAdvise(m_image_alt.get()+range.first, sizeof(int3)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
                 cudaMemAdvise(m_tag_alt.get()+range.first, sizeof(unsigned int)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
                 cudaMemAdvise(m_body_alt.get()+range.first, sizeof(unsigned int)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+                cudaMemAdvise(m_group_flags_alt.get()+range.first, sizeof(unsigned int)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
                 cudaMemAdvise(m_orientation_alt.get()+range.first, sizeof(Scalar4)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
                 cudaMemAdvise(m_angmom_alt.get()+range.first, sizeof(Scalar4)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
                 cudaMemAdvise(m_inertia_alt.get()+range.first, sizeof(Scalar3)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
@@ -3210,6 +3326,7 @@ void ParticleData::setGPUAdvice()
                 cudaMemPrefetchAsync(m_image_alt.get()+range.first, sizeof(int3)*nelem, gpu_map[idev]);
                 cudaMemPrefetchAsync(m_tag_alt.get()+range.first, sizeof(unsigned int)*nelem, gpu_map[idev]);
                 cudaMemPrefetchAsync(m_body_alt.get()+range.first, sizeof(unsigned int)*nelem, gpu_map[idev]);
+                cudaMemPrefetchAsync(m_group_flags_alt.get()+range.first, sizeof(unsigned int)*nelem, gpu_map[idev]);
                 cudaMemPrefetchAsync(m_orientation_alt.get()+range.first, sizeof(Scalar4)*nelem, gpu_map[idev]);
                 cudaMemPrefetchAsync(m_angmom_alt.get()+range.first, sizeof(Scalar4)*nelem, gpu_map[idev]);
                 cudaMemPrefetchAsync(m_inertia_alt.get()+range.first, sizeof(Scalar3)*nelem, gpu_map[idev]);
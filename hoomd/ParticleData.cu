@@ -38,6 +38,7 @@ __global__ void gpu_scatter_particle_data_kernel(
     unsigned int net_virial_pitch,
     const unsigned int *d_tag,
     unsigned int *d_rtag,
+    const unsigned int *d_group_flags,
     Scalar4 *d_pos_alt,
     Scalar4 *d_vel_alt,
     Scalar3 *d_accel_alt,
@@ -52,6 +53,7 @@ __global__ void gpu_scatter_particle_data_kernel(
     Scalar4 *d_net_torque_alt,
     Scalar *d_net_virial_alt,
     unsigned int *d_tag_alt,
+    unsigned int *d_group_flags_alt,
     pdata_element *d_out,
     unsigned int *d_comm_flags,
     unsigned int *d_comm_flags_out,
@@ -85,6 +87,7 @@ __global__ void gpu_scatter_particle_data_kernel(
         for (unsigned int j = 0; j < 6; ++j)
             p.net_virial[j] = d_net_virial[j*net_virial_pitch+idx];
         p.tag = d_tag[idx];
+        p.group_flags = d_group_flags[idx];
         d_out[scan_remove] = p;
         d_comm_flags_out[scan_remove] = d_comm_flags[idx];
 
@@ -112,6 +115,7 @@ __global__ void gpu_scatter_particle_data_kernel(
             d_net_virial_alt[j*net_virial_pitch+scan_keep] = d_net_virial[j*net_virial_pitch+idx];
         unsigned int tag = d_tag[idx];
         d_tag_alt[scan_keep] = tag;
+        d_group_flags_alt[scan_keep] = d_group_flags[idx];
 
         // update rtag
         d_rtag[tag] = scan_keep;
@@ -147,6 +151,7 @@ __global__ void gpu_select_sent_particles(
     \param net_virial_pitch Pitch of net virial array
     \param d_tag Device array of particle tags
     \param d_rtag Device array for reverse-lookup table
+    \param d_group_flags Device array of group membership flags
     \param d_pos_alt Device array of particle positions (output)
     \param d_vel_alt Device array of particle velocities (output)
     \param d_accel_alt Device array of particle accelerations (output)
@@ -154,6 +159,7 @@ __global__ void gpu_select_sent_particles(
     \param d_diameter_alt Device array of particle diameters (output)
     \param d_image_alt Device array of particle images (output)
     \param d_body_alt Device array of particle body tags (output)
+    \param d_group_flags_alt Device array of group membership flags (output)
     \param d_orientation_alt Device array of particle orientations (output)
     \param d_angmom_alt Device array of particle angular momenta (output)
     \param d_inertia Device array of particle moments of inertia (output)
@@ -182,6 +188,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                     unsigned int net_virial_pitch,
                     const unsigned int *d_tag,
                     unsigned int *d_rtag,
+                    const unsigned int *d_group_flags,
                     Scalar4 *d_pos_alt,
                     Scalar4 *d_vel_alt,
                     Scalar3 *d_accel_alt,
@@ -196,6 +203,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                     Scalar4 *d_net_torque_alt,
                     Scalar *d_net_virial_alt,
                     unsigned int *d_tag_alt,
+                    unsigned int *d_group_flags_alt,
                     pdata_element *d_out,
                     unsigned int *d_comm_flags,
                     unsigned int *d_comm_flags_out,
@@ -221,6 +229,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
     assert(d_net_virial);
     assert(d_tag);
     assert(d_rtag);
+    assert(d_group_flags);
     assert(d_pos_alt);
     assert(d_vel_alt);
     assert(d_accel_alt);
@@ -235,6 +244,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
     assert(d_net_torque_alt);
     assert(d_net_virial_alt);
     assert(d_tag_alt);
+    assert(d_group_flags_alt);
     assert(d_out);
     assert(d_comm_flags);
     assert(d_comm_flags_out);
@@ -318,6 +328,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                 net_virial_pitch,
                 d_tag,
                 d_rtag,
+                d_group_flags,
                 d_pos_alt,
                 d_vel_alt,
                 d_accel_alt,
@@ -332,6 +343,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                 d_net_torque_alt,
                 d_net_virial_alt,
                 d_tag_alt,
+                d_group_flags_alt,
                 d_out,
                 d_comm_flags,
                 d_comm_flags_out,
@@ -366,6 +378,7 @@ __global__ void gpu_pdata_add_particles_kernel(unsigned int old_nparticles,
                     unsigned int net_virial_pitch,
                     unsigned int *d_tag,
                     unsigned int *d_rtag,
+                    unsigned int *d_group_flags,
                     const pdata_element *d_in,
                     unsigned int *d_comm_flags)
     {
@@ -392,6 +405,7 @@ __global__ void gpu_pdata_add_particles_kernel(unsigned int old_nparticles,
         d_net_virial[j*net_virial_pitch+add_idx] = p.net_virial[j];
     d_tag[add_idx] = p.tag;
     d_rtag[p.tag] = add_idx;
+    d_group_flags[add_idx] = p.group_flags;
     d_comm_flags[add_idx] = 0;
     }
 
@@ -412,6 +426,7 @@ __global__ void gpu_pdata_add_particles_kernel(unsigned int old_nparticles,
     \param d_net_virial Net virial
     \param d_tag Device array of particle tags
     \param d_rtag Device array for reverse-lookup table
+    \param d_group_flags Device array of group membership flags
     \param d_in Device array of packed input particle data
     \param d_comm_flags Device array of communication flags (pdata)
 */
@@ -433,6 +448,7 @@ void gpu_pdata_add_particles(const unsigned int old_nparticles,
                     unsigned int net_virial_pitch,
                     unsigned int *d_tag,
                     unsigned int *d_rtag,
+                    unsigned int *d_group_flags,
                     const pdata_element *d_in,
                     unsigned int *d_comm_flags)
     {
@@ -451,6 +467,7 @@ void gpu_pdata_add_particles(const unsigned int old_nparticles,
     assert(d_net_virial);
     assert(d_tag);
     assert(d_rtag);
+    assert(d_group_flags);
     assert(d_in);
 
     unsigned int block_size = 256;
@@ -475,6 +492,7 @@ void gpu_pdata_add_particles(const unsigned int old_nparticles,
         net_virial_pitch,
         d_tag,
         d_rtag,
+        d_group_flags,
         d_in,
         d_comm_flags);
     }
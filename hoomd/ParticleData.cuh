@@ -42,6 +42,7 @@ struct pdata_element
     Scalar4 angmom;            //!< Angular momentum
     Scalar3 inertia;           //!< Moments of inertia
     unsigned int tag;          //!< global tag
+    unsigned int group_flags;  //!< Membership flags of distributed particle groups
     Scalar4 net_force;         //!< net force
     Scalar4 net_torque;        //!< net torque
     Scalar net_virial[6];      //!< net virial
@@ -69,6 +70,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                     unsigned int net_virial_pitch,
                     const unsigned int *d_tag,
                     unsigned int *d_rtag,
+                    const unsigned int *d_group_flags,
                     Scalar4 *d_pos_alt,
                     Scalar4 *d_vel_alt,
                     Scalar3 *d_accel_alt,
@@ -83,6 +85,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                     Scalar4 *d_net_torque_alt,
                     Scalar *d_net_virial_alt,
                     unsigned int *d_tag_alt,
+                    unsigned int *d_group_flags_alt,
                     pdata_element *d_out,
                     unsigned int *d_comm_flags,
                     unsigned int *d_comm_flags_out,
@@ -110,6 +113,7 @@ void gpu_pdata_add_particles(const unsigned int old_nparticles,
                     unsigned int net_virial_pitch,
                     unsigned int *d_tag,
                     unsigned int *d_rtag,
+                    unsigned int *d_group_flags,
                     const pdata_element *d_in,
                     unsigned int *d_comm_flags);
 #endif
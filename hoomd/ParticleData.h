@@ -261,6 +261,7 @@ struct pdata_element
     Scalar4 angmom;            //!< Angular momentum
     Scalar3 inertia;           //!< Principal moments of inertia
     unsigned int tag;          //!< global tag
+    unsigned int group_flags;  //!< Membership flags of distributed particle groups
     Scalar4 net_force;         //!< net force
     Scalar4 net_torque;        //!< net torque
     Scalar net_virial[6];      //!< net virial
@@ -611,9 +612,25 @@ class PYBIND11_EXPORT ParticleData
         //! Return body ids
         const GlobalArray< unsigned int >& getBodies() const { return m_body; }
 
+        //! Return the membership flags of the distributed particle groups
+        /*! Bit i of the flags of a particle is set if it is a member of the distributed ParticleGroup that has been
+            assigned flag i with allocateGroupFlag(). The flags migrate with the particles.
+        */
+        const GlobalArray< unsigned int >& getGroupFlags() const { return m_group_flags; }
+
+        //! Reserve a bit in the group flags for a distributed ParticleGroup
+        unsigned int allocateGroupFlag();
+
+        //! Release a bit in the group flags
+        void releaseGroupFlag(unsigned int flag);
+
         /*!
          * Access methods to stand-by arrays for fast swapping in of reordered particle data
          *
+         * The stand-by arrays are only allocated when executing on the GPU. The CPU code paths
+         * reorder particle data in place. The alternate velocities are always allocated, since
+         * the MPCD collision rules use them as scratch space.
+         *
          * \warning An array that is swapped in has to be completely initialized.
          *          In parallel simulations, the ghost data needs to be initialized as well,
          *          or all ghosts need to be removed and re-initialized before and after reordering.
@@ -680,6 +697,12 @@ class PYBIND11_EXPORT ParticleData
         //! Swap in bodies
         inline void swapBodies() { m_body.swap(m_body_alt); }
 
+        //! Return group flags (alternate array)
+        const GlobalArray< unsigned int >& getAltGroupFlags() const { return m_group_flags_alt; }
+
+        //! Swap in group flags
+        inline void swapGroupFlags() { m_group_flags.swap(m_group_flags_alt); }
+
         //! Get the net force array (alternate array)
         const GlobalArray< Scalar4 >& getAltNetForce() const { return m_net_force_alt; }
 
@@ -989,6 +1012,38 @@ class PYBIND11_EXPORT ParticleData
             return m_external_energy;
             }
 
+        //! Set the sums of the net potential energy and virial over the local particles
+        /*! The sums exclude rigid body constituent particles. The integrator accumulates them while it sums up the
+            net force, so that ComputeThermo does not need another pass over the net force and virial arrays.
+        */
+        void setNetForceSums(double energy, const double *virial)
+            {
+            m_net_energy_sum = energy;
+            for (unsigned int i = 0; i < 6; i++)
+                m_net_virial_sum[i] = virial[i];
+            m_net_force_sums_valid = true;
+            }
+
+        //! Get the sums of the net potential energy and virial over the local particles
+        /*! \returns false if the net force and virial arrays have changed since the sums were set
+        */
+        bool getNetForceSums(double& energy, double *virial) const
+            {
+            if (!m_net_force_sums_valid)
+                return false;
+
+            energy = m_net_energy_sum;
+            for (unsigned int i = 0; i < 6; i++)
+                virial[i] = m_net_virial_sum[i];
+            return true;
+            }
+
+        //! Invalidate the sums of the net potential energy and virial
+        void invalidateNetForceSums()
+            {
+            m_net_force_sums_valid = false;
+            }
+
         //! Remove the given flag
         void removeFlag(pdata_flag::Enum flag) { m_flags[flag] = false; }
 
@@ -1161,6 +1216,7 @@ class PYBIND11_EXPORT ParticleData
         GlobalArray<unsigned int> m_tag;               //!< particle tags
         GlobalVector<unsigned int> m_rtag;             //!< reverse lookup tags
         GlobalArray<unsigned int> m_body;              //!< rigid body ids
+        GlobalArray<unsigned int> m_group_flags;       //!< membership flags of distributed particle groups
         GlobalArray< Scalar4 > m_orientation;          //!< Orientation quaternion for each particle (ignored if not anisotropic)
         GlobalArray< Scalar4 > m_angmom;               //!< Angular momementum quaternion for each particle
         GlobalArray< Scalar3 > m_inertia;              //!< Principal moments of inertia for each particle
@@ -1179,6 +1235,9 @@ class PYBIND11_EXPORT ParticleData
            array and copying to the main particle data subsequently, the re-ordered particle
            data can be written to the alternate arrays, which are then swapped in for
            the real particle data at effectively zero cost.
+
+           They double the memory per particle, so they are only allocated for GPU execution.
+           The alternate velocities are the exception, they are always allocated.
          */
         GlobalArray<Scalar4> m_pos_alt;                //!< particle positions and type (swap-in)
         GlobalArray<Scalar4> m_vel_alt;                //!< particle velocities and masses (swap-in)
@@ -1188,6 +1247,7 @@ class PYBIND11_EXPORT ParticleData
         GlobalArray<int3> m_image_alt;                 //!< particle images (swap-in)
         GlobalArray<unsigned int> m_tag_alt;           //!< particle tags (swap-in)
         GlobalArray<unsigned int> m_body_alt;          //!< rigid body ids (swap-in)
+        GlobalArray<unsigned int> m_group_flags_alt;   //!< group membership flags (swap-in)
         GlobalArray<Scalar4> m_orientation_alt;        //!< orientations (swap-in)
         GlobalArray<Scalar4> m_angmom_alt;             //!< angular momenta (swap-in)
         GlobalArray<Scalar3> m_inertia_alt;             //!< Principal moments of inertia for each particle (swap-in)
@@ -1203,6 +1263,9 @@ class PYBIND11_EXPORT ParticleData
 
         Scalar m_external_virial[6];                 //!< External potential contribution to the virial
         Scalar m_external_energy;                    //!< External potential energy
+        bool m_net_force_sums_valid;                 //!< True if the net energy and virial sums are valid
+        double m_net_energy_sum;                     //!< Sum of the net potential energy over the local particles
+        double m_net_virial_sum[6];                  //!< Sum of the net virial over the local particles
         const float m_resize_factor;                 //!< The numerical factor with which the particle data arrays are resized
         PDataFlags m_flags;                          //!< Flags identifying which optional fields are valid
 
@@ -1210,6 +1273,7 @@ class PYBIND11_EXPORT ParticleData
         int3 m_o_image;                              //!< Tracks the origin image
 
         bool m_arrays_allocated;                     //!< True if arrays have been initialized
+        unsigned int m_group_flags_used;             //!< Bits of the group flags that are assigned to a group
 
         #ifdef ENABLE_HIP
         GPUPartition m_gpu_partition;                //!< The partition of the local number of particles across GPUs
@@ -213,12 +213,15 @@ std::vector<unsigned int> ParticleFilterCuboid::getSelectedTags(std::shared_ptr<
 /*! \param sysdef System definition to build the group from
     \param selector ParticleFilter used to choose the group members
     \param update_tags If true, update tags whenever global particle number changes
+    \param distributed If true, store the membership in the group flags of the local particles instead of a global
+           list of member tags
 
     Particles where criteria falls within the range [min,max] (inclusive) are added to the group.
 */
 ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef,
     std::shared_ptr<ParticleFilter> selector,
-    bool update_tags)
+    bool update_tags,
+    bool distributed)
     : m_sysdef(sysdef),
       m_pdata(sysdef->getParticleData()),
       m_exec_conf(m_pdata->getExecConf()),
@@ -228,13 +231,23 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef,
       m_global_ptl_num_change(false),
       m_selector(selector),
       m_update_tags(update_tags),
-      m_warning_printed(false)
+      m_warning_printed(false),
+      m_distributed(distributed)
     {
     #ifdef ENABLE_HIP
     if (m_pdata->getExecConf()->isCUDAEnabled())
         m_gpu_partition = GPUPartition(m_exec_conf->getGPUIds());
     #endif
 
+    if (m_distributed)
+        {
+        // copies of the group share the flag, it is released with the last one
+        m_group_flag = m_pdata->allocateGroupFlag();
+        std::shared_ptr<ParticleData> pdata = m_pdata;
+        unsigned int flag = m_group_flag;
+        m_group_flag_owner = std::shared_ptr<void>(nullptr, [pdata, flag](void *) { pdata->releaseGroupFlag(flag); });
+        }
+
     // update member tag arrays
     updateMemberTags(true);
 
@@ -367,6 +380,37 @@ void ParticleGroup::updateMemberTags(bool force_update) const
         m_warning_printed = true;
         }
 
+    if (m_distributed)
+        {
+        // a static group keeps its members, because the flags migrate with the particles
+        if (m_selector && (m_update_tags || force_update))
+            updateGroupFlags();
+
+        GlobalArray<unsigned int> is_member(m_pdata->getMaxN(), m_pdata->getExecConf());
+        m_is_member.swap(is_member);
+        TAG_ALLOCATION(m_is_member);
+
+        GlobalArray<unsigned int> member_idx(m_pdata->getMaxN(), m_pdata->getExecConf());
+        m_member_idx.swap(member_idx);
+        TAG_ALLOCATION(m_member_idx);
+
+        rebuildIndexList();
+
+        // count the members on all ranks
+        m_num_global_members = m_num_local_members;
+        #ifdef ENABLE_MPI
+        if (m_pdata->getDomainDecomposition())
+            {
+            MPI_Allreduce(MPI_IN_PLACE, &m_num_global_members, 1, MPI_UNSIGNED, MPI_SUM,
+                m_exec_conf->getMPICommunicator());
+            }
+        #endif
+
+        // the member tags are gathered again when they are requested
+        m_member_tags_gathered = false;
+        return;
+        }
+
     if (m_selector && (m_update_tags || force_update))
         {
         // notice message
@@ -433,10 +477,84 @@ void ParticleGroup::updateMemberTags(bool force_update) const
     rebuildIndexList();
     }
 
+/*! The bit of the group is set on the local particles selected by the filter, and cleared on all others.
+ */
+void ParticleGroup::updateGroupFlags() const
+    {
+    // the filter may also select particles that are not local
+    vector<unsigned int> member_tags = m_selector->getSelectedTags(m_sysdef);
+
+    ArrayHandle<unsigned int> h_group_flags(m_pdata->getGroupFlags(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    const unsigned int mask = 1u << m_group_flag;
+    const unsigned int nparticles = m_pdata->getN();
+    const unsigned int n_tags = m_pdata->getRTags().size();
+    for (unsigned int idx = 0; idx < nparticles; ++idx)
+        h_group_flags.data[idx] &= ~mask;
+
+    for (unsigned int tag : member_tags)
+        {
+        if (tag < n_tags && h_rtag.data[tag] < nparticles)
+            h_group_flags.data[h_rtag.data[tag]] |= mask;
+        }
+    }
+
+/*! The sorted list of member tags of a distributed group is gathered from all ranks into m_member_tags, if it has
+    changed since the last call. This is a collective call.
+ */
+void ParticleGroup::gatherMemberTags() const
+    {
+    if (!m_distributed || m_member_tags_gathered)
+        return;
+
+    vector<unsigned int> member_tags(m_num_local_members);
+        {
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < m_num_local_members; ++i)
+            member_tags[i] = h_tag.data[h_member_idx.data[i]];
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        // combine lists from all processors, every particle is a member on at most one rank
+        std::vector< std::vector<unsigned int> > member_tags_proc(m_exec_conf->getNRanks());
+        all_gather_v(member_tags, member_tags_proc, m_exec_conf->getMPICommunicator());
+
+        member_tags.clear();
+        member_tags.reserve(m_num_global_members);
+        for (unsigned int irank = 0; irank < m_exec_conf->getNRanks(); ++irank)
+            member_tags.insert(member_tags.end(), member_tags_proc[irank].begin(), member_tags_proc[irank].end());
+        }
+    #endif
+
+    std::sort(member_tags.begin(), member_tags.end());
+
+    GlobalArray<unsigned int> member_tags_array(member_tags.size(), m_pdata->getExecConf());
+    m_member_tags.swap(member_tags_array);
+    TAG_ALLOCATION(m_member_tags);
+
+        {
+        ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::overwrite);
+        std::copy(member_tags.begin(), member_tags.end(), h_member_tags.data);
+        }
+
+    m_member_tags_gathered = true;
+    }
+
 void ParticleGroup::reallocate() const
     {
     m_is_member.resize(m_pdata->getMaxN());
 
+    if (m_distributed)
+        {
+        // the index list holds at most all local particles, and there is no lookup table by tag
+        m_member_idx.resize(m_pdata->getMaxN());
+        return;
+        }
+
     if (m_is_member_tag.getNumElements() != m_pdata->getRTags().size())
         {
         // reallocate if necessary
@@ -518,8 +636,8 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupUnion(std::shared_ptr<Particl
         unsigned int n_b = b->getNumMembersGlobal();
 
         // make the union
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_members_a(a->getMemberTagArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_members_b(b->getMemberTagArray(), access_location::host, access_mode::read);
 
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
         set_union(h_members_a.data,
@@ -534,7 +652,7 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupUnion(std::shared_ptr<Particl
 
         // If the two arguments are the same, just return a copy of the whole group (we cannot
         // acquire the member_tags array twice)
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_members_a(a->getMemberTagArray(), access_location::host, access_mode::read);
 
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
         std::copy(h_members_a.data,
@@ -569,8 +687,8 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupIntersection(std::shared_ptr<
         unsigned int n_b = b->getNumMembersGlobal();
 
         // make the intersection
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_members_a(a->getMemberTagArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_members_b(b->getMemberTagArray(), access_location::host, access_mode::read);
 
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
         set_intersection(h_members_a.data,
@@ -584,7 +702,7 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupIntersection(std::shared_ptr<
         unsigned int n_a = a->getNumMembersGlobal();
         // If the two arguments are the same, just return a copy of the whole group (we cannot
         // acquire the member_tags array twice)
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_members_a(a->getMemberTagArray(), access_location::host, access_mode::read);
 
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
         std::copy(h_members_a.data,
@@ -616,8 +734,8 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupDifference(std::shared_ptr<Pa
         unsigned int n_a = a->getNumMembersGlobal();
         unsigned int n_b = b->getNumMembersGlobal();
         // make the difference
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_members_a(a->getMemberTagArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_members_b(b->getMemberTagArray(), access_location::host, access_mode::read);
 
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
         set_difference(h_members_a.data,
@@ -674,6 +792,28 @@ void ParticleGroup::rebuildIndexList() const
         }
     else
     #endif
+    if (m_distributed)
+        {
+        // read the membership from the group flags of the particles
+        ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_group_flags(m_pdata->getGroupFlags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
+        unsigned int nparticles = m_pdata->getN();
+        unsigned int cur_member = 0;
+        for (unsigned int idx = 0; idx < nparticles; idx ++)
+            {
+            unsigned int is_member = (h_group_flags.data[idx] >> m_group_flag) & 1;
+            h_is_member.data[idx] = is_member;
+            if (is_member)
+                {
+                h_member_idx.data[cur_member] = idx;
+                cur_member++;
+                }
+            }
+
+        m_num_local_members = cur_member;
+        }
+    else
         {
 
         // rebuild the membership flags for the  indices in the group and construct member list
@@ -742,6 +882,33 @@ void ParticleGroup::updateGPUAdvice() const
 //! rebuild index list on the GPU
 void ParticleGroup::rebuildIndexListGPU() const
     {
+    if (m_distributed)
+        {
+        ArrayHandle<unsigned int> d_is_member(m_is_member, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_member_idx(m_member_idx, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_group_flags(m_pdata->getGroupFlags(), access_location::device, access_mode::read);
+
+        // get temporary buffer
+        ScopedAllocation<unsigned int> d_tmp(m_pdata->getExecConf()->getCachedAllocator(), m_pdata->getN());
+
+        gpu_rebuild_index_list_flags(m_pdata->getN(),
+                           d_group_flags.data,
+                           m_group_flag,
+                           d_is_member.data);
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+
+        gpu_compact_index_list(m_pdata->getN(),
+                           d_is_member.data,
+                           d_member_idx.data,
+                           m_num_local_members,
+                           d_tmp.data,
+                           m_pdata->getExecConf()->getCachedAllocator());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        return;
+        }
+
     ArrayHandle<unsigned int> d_is_member(m_is_member, access_location::device, access_mode::overwrite);
     ArrayHandle<unsigned int> d_is_member_tag(m_is_member_tag, access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_member_idx(m_member_idx, access_location::device, access_mode::overwrite);
@@ -890,12 +1057,14 @@ void ParticleGroup::thermalizeParticleMomenta(Scalar kT, unsigned int seed, unsi
 void export_ParticleGroup(py::module& m)
     {
     py::class_<ParticleGroup, std::shared_ptr<ParticleGroup> >(m,"ParticleGroup")
+            .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleFilter>, bool, bool >())
             .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleFilter>, bool >())
             .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleFilter> >())
             .def(py::init<std::shared_ptr<SystemDefinition>, const std::vector<unsigned int>& >())
             .def(py::init<>())
             .def("getNumMembersGlobal", &ParticleGroup::getNumMembersGlobal)
             .def("getMemberTag", &ParticleGroup::getMemberTag)
+            .def("isDistributed", &ParticleGroup::isDistributed)
             .def("getTotalMass", &ParticleGroup::getTotalMass)
             .def("getCenterOfMass", &ParticleGroup::getCenterOfMass)
             .def("groupUnion", &ParticleGroup::groupUnion)
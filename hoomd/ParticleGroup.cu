@@ -31,6 +31,19 @@ __global__ void gpu_rebuild_index_list_kernel(unsigned int N,
     d_is_member[idx] = d_is_member_tag[tag];
     }
 
+//! GPU kernel to translate the membership flags of the particles into the local membership lookup table
+__global__ void gpu_rebuild_index_list_flags_kernel(unsigned int N,
+                                                    const unsigned int *d_group_flags,
+                                                    unsigned int flag,
+                                                    unsigned int *d_is_member)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (idx >= N) return;
+
+    d_is_member[idx] = (d_group_flags[idx] >> flag) & 1;
+    }
+
 __global__ void gpu_scatter_member_indices(unsigned int N,
     const unsigned int *d_scan,
     const unsigned int *d_is_member,
@@ -72,6 +85,31 @@ hipError_t gpu_rebuild_index_list(unsigned int N,
     return hipSuccess;
     }
 
+//! GPU method for rebuilding the index list of a distributed ParticleGroup
+/*! \param N number of local particles
+    \param d_group_flags Membership flags of the particles
+    \param flag Bit in the membership flags assigned to the group
+    \param d_is_member Array of membership flags (output)
+*/
+hipError_t gpu_rebuild_index_list_flags(unsigned int N,
+                                         const unsigned int *d_group_flags,
+                                         unsigned int flag,
+                                         unsigned int *d_is_member)
+    {
+    assert(d_group_flags);
+    assert(d_is_member);
+
+    unsigned int block_size = 256;
+    unsigned int n_blocks = N/block_size + 1;
+
+    hipLaunchKernelGGL(gpu_rebuild_index_list_flags_kernel, dim3(n_blocks), dim3(block_size), 0, 0,
+         N,
+         d_group_flags,
+         flag,
+         d_is_member);
+    return hipSuccess;
+    }
+
 //! GPU method for compacting the group member indices
 /*! \param N number of local particles
     \param d_is_member_tag Global lookup table for tag -> group membership
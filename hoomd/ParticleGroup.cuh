@@ -17,6 +17,12 @@ hipError_t gpu_rebuild_index_list(unsigned int N,
                                    unsigned int *d_is_member,
                                    unsigned int *d_tag);
 
+//! GPU method for rebuilding the index list of a distributed ParticleGroup
+hipError_t gpu_rebuild_index_list_flags(unsigned int N,
+                                         const unsigned int *d_group_flags,
+                                         unsigned int flag,
+                                         unsigned int *d_is_member);
+
 //! GPU method for compacting the group member indices
 /*! \param N number of local particles
     \param d_is_member_tag Global lookup table for tag -> group membership
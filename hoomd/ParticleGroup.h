@@ -137,6 +137,16 @@ class PYBIND11_EXPORT ParticleFilterRigidCenter : public ParticleFilter
     For that it needs a list of indices of all the particles in the group. To facilitates this, the list of indices
     in the group will be stored in a GPUArray.
 
+    <b>Distributed groups</b>
+
+    With domain decomposition, every rank holds the complete list of member tags, which costs O(N_global) memory and
+    an all-gather every time the group is updated. A group constructed with \a distributed = true instead marks its
+    local members with a bit in the group flags of the ParticleData (see ParticleData::getGroupFlags()), which migrate
+    with the particles between ranks. The index list is rebuilt from these flags, and the global number of members is
+    obtained by a reduction. The list of member tags is only gathered on demand, by getMemberTag() and the combination
+    methods. Distributed groups must be constructed and destroyed in the same order on all ranks, and at most 32 may
+    exist at the same time.
+
     \ingroup data_structs
 */
 class PYBIND11_EXPORT ParticleGroup
@@ -150,7 +160,7 @@ class PYBIND11_EXPORT ParticleGroup
 
         //! Constructs a particle group of all particles that meet the given selection
         ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleFilter> selector,
-            bool update_tags = true);
+            bool update_tags = true, bool distributed = false);
 
         //! Constructs a particle group given a list of tags
         ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, const std::vector<unsigned int>& member_tags);
@@ -177,6 +187,9 @@ class PYBIND11_EXPORT ParticleGroup
             {
             checkRebuild();
 
+            if (m_distributed)
+                return m_num_global_members;
+
             return (unsigned int)m_member_tags.getNumElements();
             }
 
@@ -193,10 +206,13 @@ class PYBIND11_EXPORT ParticleGroup
         //! Get a member from the group
         /*! \param i Index from 0 to getNumMembersGlobal()-1 of the group member to get
             \returns Tag of the member at index \a i
+            \note For a distributed group, this method gathers the member tags from all ranks when they have changed,
+                  and must then be called collectively. It accesses the particle data tag array in that case.
         */
         unsigned int getMemberTag(unsigned int i) const
             {
             checkRebuild();
+            gatherMemberTags();
 
             assert(i < getNumMembersGlobal());
             ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
@@ -236,6 +252,12 @@ class PYBIND11_EXPORT ParticleGroup
             return h_handle.data[idx] == 1;
             }
 
+        //! Test if the group is distributed
+        bool isDistributed() const
+            {
+            return m_distributed;
+            }
+
         //! Direct access to the index list
         /*! \returns A GPUArray for directly accessing the index list, intended for use in using groups on the GPU
             \note The caller \b must \b not write to or change the array.
@@ -346,6 +368,12 @@ class PYBIND11_EXPORT ParticleGroup
         bool m_update_tags;                             //!< True if tags should be updated when global number of particles changes
         mutable bool m_warning_printed;                         //!< True if warning about static groups has been printed
 
+        bool m_distributed=false;                       //!< True if membership is stored in the particle group flags
+        unsigned int m_group_flag=0;                    //!< Bit in the particle group flags assigned to a distributed group
+        std::shared_ptr<void> m_group_flag_owner;       //!< Releases m_group_flag when the last copy of the group is destroyed
+        mutable unsigned int m_num_global_members=0;    //!< Number of members on all ranks (distributed groups only)
+        mutable bool m_member_tags_gathered=false;      //!< True if m_member_tags lists the members of a distributed group
+
         #ifdef ENABLE_HIP
         mutable GPUPartition m_gpu_partition;           //!< A handy struct to store load balancing info for this group's local members
         #endif
@@ -413,6 +441,20 @@ class PYBIND11_EXPORT ParticleGroup
         //! Helper function to build the 1:1 hash for tag membership
         void buildTagHash() const;
 
+        //! Helper function to set the group flags of the local members of a distributed group
+        void updateGroupFlags() const;
+
+        //! Helper function to gather the member tags of a distributed group from all ranks
+        void gatherMemberTags() const;
+
+        //! Helper function to access the member tags, gathering them first for a distributed group
+        const GlobalArray<unsigned int>& getMemberTagArray() const
+            {
+            checkRebuild();
+            gatherMemberTags();
+            return m_member_tags;
+            }
+
 #ifdef ENABLE_HIP
         //! Helper function to rebuild the index lists after the particles have been sorted
         void rebuildIndexListGPU() const;
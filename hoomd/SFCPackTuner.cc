@@ -66,6 +66,9 @@ SFCPackTuner::~SFCPackTuner()
     \note In an updater list, this sort should be done first, before anyone else
     gets ahold of the particle data
 
+    With MPI, only the local particles are reordered. The ghost particles keep their indices and the communicator
+    updates its ghost send lists, so that the ghosts are not removed and exchanged again.
+
     \param timestep Current timestep of the simulation
  */
 void SFCPackTuner::update(unsigned int timestep)
@@ -75,12 +78,8 @@ void SFCPackTuner::update(unsigned int timestep)
     #ifdef ENABLE_MPI
     if (m_comm)
         {
-        // make sure all particles that need to be local are
-        m_comm->forceMigrate();
-        m_comm->communicate(timestep);
-
-        // remove all ghost particles
-        m_pdata->removeAllGhostParticles();
+        // the sort signal below updates the ghost send lists instead of forcing a migration
+        m_comm->prepareLocalSort();
         }
     #endif
 
@@ -95,18 +94,33 @@ void SFCPackTuner::update(unsigned int timestep)
     // apply that sort order to the particles
     applySortOrder();
 
-    // trigger sort signal (this also forces particle migration)
+    // trigger sort signal
     m_pdata->notifyParticleSort();
 
-    #ifdef ENABLE_MPI
-    if (m_comm)
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+/*! \param data Per-particle array to reorder
+    \param cycles Particle indices i_0, i_1, ... of the cycles of the sort order, where i_{k+1} = order[i_k]
+    \param cycle_offsets Start of each cycle in \a cycles, followed by the total length
+
+    Rotating each cycle by one element makes data[i] the old data[order[i]], using a single temporary value
+    instead of a copy of the whole array.
+*/
+template<class T>
+static void permuteInPlace(T *data, const std::vector<unsigned int>& cycles,
+    const std::vector<unsigned int>& cycle_offsets)
+    {
+    for (unsigned int c = 0; c+1 < cycle_offsets.size(); c++)
         {
-        // restore ghosts
-        m_comm->communicate(timestep);
-        }
-    #endif
+        const unsigned int begin = cycle_offsets[c];
+        const unsigned int end = cycle_offsets[c+1];
 
-    if (m_prof) m_prof->pop(m_exec_conf);
+        T first = data[cycles[begin]];
+        for (unsigned int k = begin; k+1 < end; k++)
+            data[cycles[k]] = data[cycles[k+1]];
+        data[cycles[end-1]] = first;
+        }
     }
 
 void SFCPackTuner::applySortOrder()
@@ -123,54 +137,51 @@ void SFCPackTuner::applySortOrder()
     ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_group_flags(m_pdata->getGroupFlags(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
 
-    // construct a temporary holding array for the sorted data
-    Scalar4 *scal4_tmp = new Scalar4[m_pdata->getN()];
+    // decompose the sort order into cycles, so that all arrays can be permuted in place
+    const unsigned int N = m_pdata->getN();
+    std::vector<unsigned int> cycles;
+    std::vector<unsigned int> cycle_offsets;
+    std::vector<bool> visited(N, false);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        // particles that stay in place need no work
+        if (visited[i] || m_sort_order[i] == i)
+            continue;
+
+        cycle_offsets.push_back(cycles.size());
+        unsigned int j = i;
+        do
+            {
+            visited[j] = true;
+            cycles.push_back(j);
+            j = m_sort_order[j];
+            } while (j != i);
+        }
+    cycle_offsets.push_back(cycles.size());
 
     // sort positions and types
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_pos.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_pos.data[i] = scal4_tmp[i];
+    permuteInPlace(h_pos.data, cycles, cycle_offsets);
 
     // sort velocities and mass
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_vel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_vel.data[i] = scal4_tmp[i];
+    permuteInPlace(h_vel.data, cycles, cycle_offsets);
 
-    Scalar3 *scal3_tmp = new Scalar3[m_pdata->getN()];
     // sort accelerations
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_accel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_accel.data[i] = scal3_tmp[i];
+    permuteInPlace(h_accel.data, cycles, cycle_offsets);
 
-    Scalar *scal_tmp  = new Scalar[m_pdata->getN()];
     // sort charge
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_charge.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_charge.data[i] = scal_tmp[i];
+    permuteInPlace(h_charge.data, cycles, cycle_offsets);
 
     // sort diameter
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_diameter.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_diameter.data[i] = scal_tmp[i];
+    permuteInPlace(h_diameter.data, cycles, cycle_offsets);
 
     // sort angular momentum
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_angmom.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_angmom.data[i] = scal4_tmp[i];
+    permuteInPlace(h_angmom.data, cycles, cycle_offsets);
 
     // sort moment of inertia
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_inertia.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_inertia.data[i] = scal3_tmp[i];
+    permuteInPlace(h_inertia.data, cycles, cycle_offsets);
 
     // in case anyone access it from frame to frame, sort the net virial
         {
@@ -178,74 +189,42 @@ void SFCPackTuner::applySortOrder()
         unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
 
         for (unsigned int j = 0; j < 6; j++)
-            {
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                scal_tmp[i] = h_net_virial.data[j*virial_pitch+m_sort_order[i]];
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                h_net_virial.data[j*virial_pitch+i] = scal_tmp[i];
-            }
+            permuteInPlace(h_net_virial.data + j*virial_pitch, cycles, cycle_offsets);
         }
 
     // sort net force, net torque, and orientation
         {
         ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_force.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_force.data[i] = scal4_tmp[i];
+        permuteInPlace(h_net_force.data, cycles, cycle_offsets);
         }
 
         {
         ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_torque.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_torque.data[i] = scal4_tmp[i];
+        permuteInPlace(h_net_torque.data, cycles, cycle_offsets);
         }
 
         {
         ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_orientation.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_orientation.data[i] = scal4_tmp[i];
+        permuteInPlace(h_orientation.data, cycles, cycle_offsets);
         }
 
     // sort image
-    int3 *int3_tmp = new int3[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        int3_tmp[i] = h_image.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_image.data[i] = int3_tmp[i];
+    permuteInPlace(h_image.data, cycles, cycle_offsets);
 
     // sort body
-    unsigned int *uint_tmp = new unsigned int[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_body.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_body.data[i] = uint_tmp[i];
+    permuteInPlace(h_body.data, cycles, cycle_offsets);
+
+    // sort group membership flags
+    permuteInPlace(h_group_flags.data, cycles, cycle_offsets);
 
     // sort global tag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_tag.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_tag.data[i] = uint_tmp[i];
+    permuteInPlace(h_tag.data, cycles, cycle_offsets);
 
     // rebuild global rtag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    for (unsigned int i = 0; i < N; i++)
         {
         h_rtag.data[h_tag.data[i]] = i;
         }
-
-    delete[] scal_tmp;
-    delete[] scal4_tmp;
-    delete[] scal3_tmp;
-    delete[] uint_tmp;
-    delete[] int3_tmp;
-
     }
 
 //! x walking table for the hilbert curve
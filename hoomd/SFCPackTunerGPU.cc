@@ -149,6 +149,7 @@ void SFCPackTunerGPU::applySortOrder()
         ArrayHandle<int3> d_image_alt(m_pdata->getAltImages(), access_location::device, access_mode::overwrite);
         ArrayHandle<unsigned int> d_body_alt(m_pdata->getAltBodies(), access_location::device, access_mode::overwrite);
         ArrayHandle<unsigned int> d_tag_alt(m_pdata->getAltTags(), access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_group_flags_alt(m_pdata->getAltGroupFlags(), access_location::device, access_mode::overwrite);
         ArrayHandle<Scalar4> d_orientation_alt(m_pdata->getAltOrientationArray(), access_location::device, access_mode::overwrite);
 
         ArrayHandle<Scalar4> d_angmom_alt(m_pdata->getAltAngularMomentumArray(), access_location::device, access_mode::overwrite);
@@ -166,6 +167,7 @@ void SFCPackTunerGPU::applySortOrder()
         ArrayHandle<int3> d_image(m_pdata->getImages(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_group_flags(m_pdata->getGroupFlags(), access_location::device, access_mode::read);
         ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::read);
         ArrayHandle<Scalar4> d_angmom(m_pdata->getAngularMomentumArray(), access_location::device, access_mode::read);
         ArrayHandle<Scalar3> d_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::device, access_mode::read);
@@ -200,6 +202,8 @@ void SFCPackTunerGPU::applySortOrder()
             d_body_alt.data,
             d_tag.data,
             d_tag_alt.data,
+            d_group_flags.data,
+            d_group_flags_alt.data,
             d_orientation.data,
             d_orientation_alt.data,
             d_angmom.data,
@@ -227,6 +231,7 @@ void SFCPackTunerGPU::applySortOrder()
     m_pdata->swapImages();
     m_pdata->swapBodies();
     m_pdata->swapTags();
+    m_pdata->swapGroupFlags();
     m_pdata->swapOrientations();
     m_pdata->swapAngularMomenta();
     m_pdata->swapMomentsOfInertia();
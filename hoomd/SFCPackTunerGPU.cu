@@ -133,6 +133,8 @@ __global__ void gpu_apply_sorted_order_kernel(
         unsigned int *d_body_alt,
         const unsigned int *d_tag,
         unsigned int *d_tag_alt,
+        const unsigned int *d_group_flags,
+        unsigned int *d_group_flags_alt,
         const Scalar4 *d_orientation,
         Scalar4 *d_orientation_alt,
         const Scalar4 *d_angmom,
@@ -165,6 +167,7 @@ __global__ void gpu_apply_sorted_order_kernel(
     d_body_alt[idx] = d_body[old_idx];
     unsigned int tag = d_tag[old_idx];
     d_tag_alt[idx] = tag;
+    d_group_flags_alt[idx] = d_group_flags[old_idx];
     d_orientation_alt[idx] = d_orientation[old_idx];
     d_angmom_alt[idx] = d_angmom[old_idx];
     d_inertia_alt[idx] = d_inertia[old_idx];
@@ -204,6 +207,8 @@ void gpu_apply_sorted_order(
         unsigned int *d_body_alt,
         const unsigned int *d_tag,
         unsigned int *d_tag_alt,
+        const unsigned int *d_group_flags,
+        unsigned int *d_group_flags_alt,
         const Scalar4 *d_orientation,
         Scalar4 *d_orientation_alt,
         const Scalar4 *d_angmom,
@@ -242,6 +247,8 @@ void gpu_apply_sorted_order(
         d_body_alt,
         d_tag,
         d_tag_alt,
+        d_group_flags,
+        d_group_flags_alt,
         d_orientation,
         d_orientation_alt,
         d_angmom,
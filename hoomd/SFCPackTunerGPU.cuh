@@ -47,6 +47,8 @@ void gpu_apply_sorted_order(
         unsigned int *d_body_alt,
         const unsigned int *d_tag,
         unsigned int *d_tag_alt,
+        const unsigned int *d_group_flags,
+        unsigned int *d_group_flags_alt,
         const Scalar4 *d_orientation,
         Scalar4 *d_orientation_alt,
         const Scalar4 *d_angmom,
@@ -16,6 +16,7 @@
 #endif
 
 // #include <pybind11/pybind11.h>
+#include <algorithm>
 #include <stdexcept>
 #include <time.h>
 #include <pybind11/cast.h>
@@ -128,9 +129,48 @@ void System::run(unsigned int nsteps, bool write_at_start)
             }
         }
 
+    // quit if Ctrl-C was pressed
+    auto check_interrupt = []()
+        {
+        if (g_sigint_recvd)
+            {
+            g_sigint_recvd = 0;
+            PyErr_SetString(PyExc_KeyboardInterrupt, "");
+            throw pybind11::error_already_set();
+            }
+        };
+
     // run the steps
     for ( ; m_cur_tstep < m_end_tstep; m_cur_tstep++)
         {
+        // the steps before the next tuner, updater or analyzer only need the integrator
+        uint64_t next_event = std::min(nextEventStep(m_cur_tstep), uint64_t(m_end_tstep));
+        if (next_event > m_cur_tstep)
+            {
+            PDataFlags flags = m_default_flags;
+            if (m_integrator)
+                flags |= m_integrator->getRequestedPDataFlags();
+
+            for ( ; m_cur_tstep < next_event; m_cur_tstep++)
+                {
+                // the last step of the batch prepares the flags for the next event
+                if (m_cur_tstep+1 < next_event)
+                    m_sysdef->getParticleData()->setFlags(flags);
+                else
+                    m_sysdef->getParticleData()->setFlags(determineFlags(m_cur_tstep+1));
+
+                if (m_integrator)
+                    m_integrator->update(m_cur_tstep);
+
+                check_interrupt();
+                }
+
+            updateTPS();
+
+            if (m_cur_tstep >= m_end_tstep)
+                break;
+            }
+
         for (auto &tuner: m_tuners)
             {
             if ((*tuner->getTrigger())(m_cur_tstep))
@@ -161,14 +201,7 @@ void System::run(unsigned int nsteps, bool write_at_start)
 
         updateTPS();
 
-        // quit if Ctrl-C was pressed
-        if (g_sigint_recvd)
-            {
-            g_sigint_recvd = 0;
-            PyErr_SetString(PyExc_KeyboardInterrupt, "");
-            throw pybind11::error_already_set();
-            return;
-            }
+        check_interrupt();
         }
 
     #ifdef ENABLE_MPI
@@ -330,6 +363,30 @@ PDataFlags System::determineFlags(unsigned int tstep)
     return flags;
     }
 
+/*! \param tstep First time step to consider
+    \returns The first step at or after \a tstep on which a tuner or updater may run, or after which an analyzer
+              may run. The steps before it only execute the integrator.
+*/
+uint64_t System::nextEventStep(uint64_t tstep)
+    {
+    uint64_t next = Trigger::never;
+
+    for (auto &tuner: m_tuners)
+        next = std::min(next, tuner->getTrigger()->nextFiringStep(tstep));
+
+    for (auto &updater_trigger_pair: m_updaters)
+        next = std::min(next, updater_trigger_pair.second->nextFiringStep(tstep));
+
+    // analyzers for step t+1 run at the end of step t
+    for (auto &analyzer_trigger_pair: m_analyzers)
+        {
+        uint64_t next_analyze = analyzer_trigger_pair.second->nextFiringStep(tstep+1);
+        next = std::min(next, next_analyze - 1);
+        }
+
+    return next;
+    }
+
 void export_System(py::module& m)
     {
     py::bind_vector<std::vector<std::pair<std::shared_ptr<Analyzer>,
@@ -201,6 +201,9 @@ class PYBIND11_EXPORT System
         //! Get the flags needed for a particular step
         PDataFlags determineFlags(unsigned int tstep);
 
+        /// Get the first step at or after tstep that runs more than the integrator
+        uint64_t nextEventStep(uint64_t tstep);
+
         /// Record the initial time of the last run
         int64_t m_initial_time=0;
 
@@ -0,0 +1,84 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file ThreadLocalArray.h
+    \brief Defines the ThreadLocalArray class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __THREAD_LOCAL_ARRAY_H__
+#define __THREAD_LOCAL_ARRAY_H__
+
+#ifdef ENABLE_TBB
+
+#include <tbb/enumerable_thread_specific.h>
+#include <vector>
+
+//! Per-thread accumulation arrays that are kept between computes
+/*! Threaded CPU computes that add to the forces of neighbors accumulate into one array per thread and sum the arrays
+    up at the end. ThreadLocalArray keeps these arrays as members of the compute, so that memory is only allocated when
+    the number of elements or the number of threads grows.
+
+    Call reset() before the parallel loop to zero the first \a n elements of the array of every thread that already
+    has one. local() returns the array of the calling thread, creating and zeroing it on first use. Iterating over a
+    ThreadLocalArray visits the arrays of all threads, each of which holds at least \a n elements.
+
+    \tparam T Element type, a value initialized T is zero
+*/
+template<class T>
+class ThreadLocalArray
+    {
+    public:
+        typedef typename tbb::enumerable_thread_specific< std::vector<T> >::const_iterator const_iterator;
+
+        //! Construct an empty set of arrays
+        ThreadLocalArray()
+            : m_n(0)
+            {
+            }
+
+        //! Zero the first n elements of the array of every thread
+        /*! \param n Number of elements used in the next compute
+        */
+        void reset(unsigned int n)
+            {
+            m_n = n;
+            for (auto& array : m_arrays)
+                {
+                // assign does not reallocate when the capacity suffices
+                array.assign(n, T());
+                }
+            }
+
+        //! Get the array of the calling thread
+        T* local()
+            {
+            std::vector<T>& array = m_arrays.local();
+            if (array.size() != m_n)
+                array.assign(m_n, T());
+            return array.data();
+            }
+
+        //! Iterate over the arrays of all threads
+        const_iterator begin() const
+            {
+            return m_arrays.begin();
+            }
+
+        //! End of the arrays of all threads
+        const_iterator end() const
+            {
+            return m_arrays.end();
+            }
+
+    private:
+        unsigned int m_n;                                           //!< Number of elements in use
+        tbb::enumerable_thread_specific< std::vector<T> > m_arrays; //!< One array per thread
+    };
+
+#endif // ENABLE_TBB
+
+#endif // __THREAD_LOCAL_ARRAY_H__
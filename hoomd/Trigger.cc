@@ -7,12 +7,20 @@
 
 PYBIND11_MAKE_OPAQUE(std::vector<std::shared_ptr<Trigger> >);
 
+constexpr uint64_t Trigger::never;
+
 //* Method to enable unit testing of C++ trigger calls from pytest
 bool testTriggerCall(std::shared_ptr<Trigger> t, uint64_t step)
     {
     return (*t)(step);
     }
 
+//* Method to enable unit testing of C++ look ahead calls from pytest
+uint64_t testTriggerNextFiringStep(std::shared_ptr<Trigger> t, uint64_t step)
+    {
+    return t->nextFiringStep(step);
+    }
+
 //* Trampoline for classes inherited in python
 class TriggerPy : public Trigger
     {
@@ -29,6 +37,17 @@ class TriggerPy : public Trigger
                                    timestep      // Argument(s)
                               );
             }
+
+        // trampoline method, optional in python
+        uint64_t nextFiringStep(uint64_t timestep) override
+            {
+            PYBIND11_OVERLOAD_NAME(uint64_t,            // Return type
+                                   Trigger,             // Parent class
+                                   "next_firing_step",  // Name in python
+                                   nextFiringStep,
+                                   timestep             // Argument(s)
+                              );
+            }
     };
 
 void export_Trigger(pybind11::module& m)
@@ -37,6 +56,7 @@ void export_Trigger(pybind11::module& m)
         .def(pybind11::init<>())
         .def("__call__", &Trigger::operator())
         .def("compute", &Trigger::compute)
+        .def("next_firing_step", &Trigger::nextFiringStep)
         ;
 
     pybind11::class_<PeriodicTrigger, Trigger,
@@ -104,4 +124,5 @@ void export_Trigger(pybind11::module& m)
         ;
 
     m.def("_test_trigger_call", &testTriggerCall);
+    m.def("_test_trigger_next_firing_step", &testTriggerNextFiringStep);
     }
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <pybind11/pybind11.h>
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 #include <pybind11/iostream.h>
@@ -17,6 +18,10 @@
  *  (in python) to implement custom behavior.
  *
  *  A Trigger may store internal staten and perform complex calculations to determine when it
+ *
+ *  Triggers can also look ahead: nextFiringStep() returns a time step before which the trigger
+ *  certainly does not fire. System uses this to run the steps in between without evaluating every
+ *  trigger on every step. The base implementation makes no prediction.
 */
 class PYBIND11_EXPORT Trigger
     {
@@ -47,6 +52,23 @@ class PYBIND11_EXPORT Trigger
 
         virtual bool compute(uint64_t timestep) = 0;
 
+        /** Look ahead to the next time step on which the trigger may fire
+         *
+         *  @param timestep First time step to consider
+         *  @returns A time step `next >= timestep` such that the trigger does not fire on any step in
+         *           `[timestep, next)`, or `never` when it will not fire again.
+         *
+         *  Returning `timestep` is always correct, and is what triggers that cannot predict their
+         *  future do.
+        */
+        virtual uint64_t nextFiringStep(uint64_t timestep)
+            {
+            return timestep;
+            }
+
+        /// Value of nextFiringStep() for triggers that never fire again
+        static constexpr uint64_t never = std::numeric_limits<uint64_t>::max();
+
     private:
             /// Caches the last time step at which the trigger was computed
             uint64_t m_last_timestep;
@@ -77,6 +99,21 @@ class PYBIND11_EXPORT PeriodicTrigger : public Trigger
             return (timestep - m_phase) % m_period == 0;
             }
 
+        uint64_t nextFiringStep(uint64_t timestep)
+            {
+            // steps to the next multiple of the period, in the same wrapped arithmetic as compute()
+            uint64_t offset = (m_period - (timestep - m_phase) % m_period) % m_period;
+
+            // before the phase, (timestep - m_phase) wraps around to 0 at m_phase
+            if (timestep < m_phase && offset >= m_phase - timestep)
+                return m_phase;
+
+            if (offset > never - timestep)
+                return never;
+
+            return timestep + offset;
+            }
+
         /// Set the period
         void setPeriod(uint64_t period)
             {
@@ -123,6 +160,11 @@ class PYBIND11_EXPORT BeforeTrigger : public Trigger
         return timestep < m_timestep;
         }
 
+    uint64_t nextFiringStep(uint64_t timestep)
+        {
+        return timestep < m_timestep ? timestep : never;
+        }
+
     /// Get the timestep before which the trigger is active.
     uint64_t getTimestep() {return m_timestep;}
 
@@ -148,6 +190,11 @@ class PYBIND11_EXPORT OnTrigger : public Trigger
         return timestep == m_timestep;
         }
 
+    uint64_t nextFiringStep(uint64_t timestep)
+        {
+        return timestep <= m_timestep ? m_timestep : never;
+        }
+
     /// Get the timestep when the trigger is active.
     uint64_t getTimestep() {return m_timestep;}
 
@@ -173,6 +220,13 @@ class PYBIND11_EXPORT AfterTrigger : public Trigger
         return timestep > m_timestep;
         }
 
+    uint64_t nextFiringStep(uint64_t timestep)
+        {
+        if (timestep > m_timestep)
+            return timestep;
+        return m_timestep == never ? never : m_timestep + 1;
+        }
+
     /// Get the timestep after which the trigger is active.
     uint64_t getTimestep() {return m_timestep;}
 
@@ -198,6 +252,14 @@ class PYBIND11_EXPORT NotTrigger : public Trigger
             return !(m_trigger->operator()(timestep));
             }
 
+        uint64_t nextFiringStep(uint64_t timestep)
+            {
+            // the negation fires wherever the wrapped trigger does not, so only the current step is known
+            if (!m_trigger->operator()(timestep))
+                return timestep;
+            return timestep == never ? never : timestep + 1;
+            }
+
         /// Get the trigger that is negated
         std::shared_ptr<Trigger> getTrigger() {return m_trigger;}
 
@@ -237,6 +299,24 @@ class PYBIND11_EXPORT AndTrigger : public Trigger
                     });
             }
 
+        uint64_t nextFiringStep(uint64_t timestep)
+            {
+            // no step before the latest of the next firing steps fires all triggers, search forward a
+            // few times from there and stop with a lower bound when the triggers do not line up
+            uint64_t next = timestep;
+            for (unsigned int i = 0; i < max_search; ++i)
+                {
+                uint64_t latest = next;
+                for (auto& t : m_triggers)
+                    latest = std::max(latest, t->nextFiringStep(next));
+
+                if (latest == next || latest == never)
+                    return latest;
+                next = latest;
+                }
+            return next;
+            }
+
         std::vector<std::shared_ptr<Trigger> >& getTriggers()
             {
             return m_triggers;
@@ -245,6 +325,9 @@ class PYBIND11_EXPORT AndTrigger : public Trigger
     protected:
         /// Vector of triggers to do a n-way AND
         std::vector<std::shared_ptr<Trigger> > m_triggers;
+
+        /// Number of times nextFiringStep() tries to line up the triggers
+        static constexpr unsigned int max_search = 16;
     };
 
 /** Or trigger
@@ -276,6 +359,14 @@ class PYBIND11_EXPORT OrTrigger : public Trigger
                     });
             }
 
+        uint64_t nextFiringStep(uint64_t timestep)
+            {
+            uint64_t next = never;
+            for (auto& t : m_triggers)
+                next = std::min(next, t->nextFiringStep(timestep));
+            return next;
+            }
+
         std::vector<std::shared_ptr<Trigger> >& getTriggers()
             {
             return m_triggers;
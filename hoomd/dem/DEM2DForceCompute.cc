@@ -17,6 +17,11 @@
 #include <omp.h>
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 /*! \file DEM2DForceCompute.cc
   \brief Defines the DEM2DForceCompute class
 */
@@ -35,7 +40,7 @@ DEM2DForceCompute<Real, Real4, Potential>::DEM2DForceCompute(
     std::shared_ptr<NeighborList> nlist,
     Real r_cut, Potential potential)
     : ForceCompute(sysdef), m_nlist(nlist), m_r_cut(r_cut),
-      m_evaluator(potential), m_shapes()
+      m_evaluator(potential), m_shapes(), m_typeRadius(), m_featureCulling(true)
     {
     m_exec_conf->msg->notice(5) << "Constructing DEM2DForceCompute" << endl;
 
@@ -146,7 +151,10 @@ void DEM2DForceCompute<Real, Real4, Potential>::setParams(
         }
 
     for(int i(type - m_shapes.size()); i >= 0; --i)
+        {
         m_shapes.push_back(vector<vec2<Real> >(0));
+        m_typeRadius.push_back(Real(0));
+        }
 
     // build a vector of points
     vector<vec2<Real> > points;
@@ -165,6 +173,12 @@ void DEM2DForceCompute<Real, Real4, Potential>::setParams(
         }
 
     m_shapes[type] = points;
+
+    // all features of the shape lie within the circle through its outermost vertex
+    Real radius(0);
+    for(size_t i(0); i < points.size(); ++i)
+        radius = std::max(radius, Real(sqrt(dot(points[i], points[i]))));
+    m_typeRadius[type] = radius;
     }
 
 /*! DEM2DForceCompute provides
@@ -246,18 +260,35 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
     // create a temporary copy of r_cut squared
     Scalar r_cut_sq = m_r_cut * m_r_cut;
 
-    // tally up the number of forces calculated
-    int64_t n_calc = 0;
-
-    // for each particle
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    const unsigned int N = m_pdata->getN();
+    const bool cull = m_featureCulling;
+    const Real feature_rcutsq = m_evaluator.getRcutSq();
+
+    /* Compute all feature interactions of particle i with its neighbors. The contributions to i are
+       added to h_force/h_torque/h_virial, which only the caller processing i touches. Third-law
+       contributions to the neighbors go to force_k/torque_k/virial_k. The evaluator carries per-pair
+       state (diameters, relative velocity) and must not be shared between threads.
+    */
+    auto compute_particle = [&](unsigned int i, DEMEvaluator<Real, Real4, Potential>& evaluator,
+        Scalar4 *force_k, Scalar4 *torque_k, Scalar *virial_k, unsigned int pitch_k)
         {
+        // true if a feature at distance dist from the center of a shape with bounding radius radius
+        // cannot interact with any feature of that shape. The features are at least dist - radius apart,
+        // so they are out of range when that distance exceeds the contact shift of the potential (set
+        // by the diameters for SWCA) by more than the feature cutoff.
+        auto out_of_range = [&](Real dist, Real radius) -> bool
+            {
+            const Real gap(dist - radius - evaluator.getShift());
+            return cull && gap > Real(0) && gap*gap >= feature_rcutsq;
+            };
+
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
         vec3<Scalar> pi(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
         quat<Scalar> quati(h_orientation.data[i]);
         unsigned int typei = __scalar_as_int(h_pos.data[i].w);
         // sanity check
         assert(typei < m_pdata->getNTypes());
+        const Real radiusi(m_typeRadius[typei]);
 
         // initialize current particle force, potential energy, and virial to 0
         vec2<Real> fi;
@@ -284,14 +315,14 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
             vertIter != vertices_i.end(); ++vertIter)
             *vertIter = rotate(quati, *vertIter);
 
+        // storage for the rotated vertices of the neighbors, reused for every neighbor
+        vector<vec2<Real> > vertices_j;
+
         // loop over all of the neighbors of this particle
         const unsigned int myHead = h_head_list.data[i];
         const unsigned int size = (unsigned int)h_n_neigh.data[i];
         for (unsigned int j = 0; j < size; j++)
             {
-            // increment our calculation counter
-            n_calc++;
-
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
             unsigned int k = h_nlist.data[myHead + j];
             // sanity check
@@ -306,6 +337,7 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
             unsigned int typej = __scalar_as_int(h_pos.data[k].w);
             // sanity check
             assert(typej < m_pdata->getNTypes());
+            const Real radiusj(m_typeRadius[typej]);
 
             // apply periodic boundary conditions (FLOPS: 9 (worst case: first branch is missed, the 2nd is taken and the add is done)
             dx3 = vec3<Scalar>(box.minImage(vec_to_scalar3(dx3)));
@@ -318,25 +350,26 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
             if (Potential::needsDiameter())
                 {
                 dj = h_diameter.data[k];
-                m_evaluator.setDiameter(di,dj);
+                evaluator.setDiameter(di,dj);
                 }
 
             if(Potential::needsVelocity())
-                m_evaluator.setVelocity(vi - vec3<Scalar>(h_velocity.data[k]));
+                evaluator.setVelocity(vi - vec3<Scalar>(h_velocity.data[k]));
 
             // start computing the force
             // calculate r squared (FLOPS: 5)
             Scalar rsq = dot(dx, dx);
 
             // only compute the force if the particles are closer than the cutoff (FLOPS: 1)
-            if (m_evaluator.withinCutoff(rsq,r_cut_sq))
+            // and, when culling, if their bounding circles are close enough to interact at all
+            if (evaluator.withinCutoff(rsq,r_cut_sq) && !out_of_range(sqrt(rsq), radiusi + radiusj))
                 {
                 // local forces and torques for particles i and j
                 vec2<Real> forceij, forceji;
                 Real torqueij(0), torqueji(0), potentialij(0);
 
                 // Make a local copy for the rotated vertices for particle j
-                vector<vec2<Real> > vertices_j(m_shapes[typej]);
+                vertices_j.assign(m_shapes[typej].begin(), m_shapes[typej].end());
                 for(typename vector<vec2<Real> >::iterator vertIter(vertices_j.begin());
                     vertIter != vertices_j.end(); ++vertIter)
                     *vertIter = rotate(quatj, *vertIter);
@@ -347,11 +380,16 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                     for(typename vector<vec2<Real> >::const_iterator viIter(vertices_i.begin());
                         viIter != vertices_i.end(); ++viIter)
                         {
+                        // skip vertices that are too far from the bounding circle of j
+                        const vec2<Real> rvj(*viIter - dx);
+                        if (out_of_range(sqrt(dot(rvj, rvj)), radiusj))
+                            continue;
+
                         // iterate over each edge of particle j
                         for(typename vector<vec2<Real> >::const_iterator vjIter(vertices_j.begin());
                             vjIter + 1 != vertices_j.end(); ++vjIter)
                             {
-                            m_evaluator.vertexEdge(dx, *viIter, *vjIter, *(vjIter + 1),
+                            evaluator.vertexEdge(dx, *viIter, *vjIter, *(vjIter + 1),
                                 potentialij, forceij, torqueij,
                                 forceji, torqueji);
                             }
@@ -359,7 +397,7 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                         // didn't just evaluate that edge (i.e. the
                         // shape isn't a spherocylinder)
                         if(vertices_j.size() > 2)
-                            m_evaluator.vertexEdge(dx, *viIter, vertices_j.back(), vertices_j.front(),
+                            evaluator.vertexEdge(dx, *viIter, vertices_j.back(), vertices_j.front(),
                                 potentialij, forceij, torqueij,
                                 forceji, torqueji);
                         }
@@ -370,11 +408,16 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                     for(typename vector<vec2<Real> >::const_iterator vjIter(vertices_j.begin());
                         vjIter != vertices_j.end(); ++vjIter)
                         {
+                        // skip vertices that are too far from the bounding circle of i
+                        const vec2<Real> rvi(*vjIter + dx);
+                        if (out_of_range(sqrt(dot(rvi, rvi)), radiusi))
+                            continue;
+
                         // iterate over each edge of particle i
                         for(typename vector<vec2<Real> >::const_iterator viIter(vertices_i.begin());
                             viIter + 1 != vertices_i.end(); ++viIter)
                             {
-                            m_evaluator.vertexEdge(-dx, *vjIter, *viIter, *(viIter + 1),
+                            evaluator.vertexEdge(-dx, *vjIter, *viIter, *(viIter + 1),
                                 potentialij, forceji, torqueji,
                                 forceij, torqueij);
                             }
@@ -382,7 +425,7 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                         // didn't just evaluate that edge (i.e. the
                         // shape isn't a spherocylinder)
                         if(vertices_i.size() > 2)
-                            m_evaluator.vertexEdge(-dx, *vjIter, vertices_i.back(), vertices_i.front(),
+                            evaluator.vertexEdge(-dx, *vjIter, vertices_i.back(), vertices_i.front(),
                                 potentialij, forceji, torqueji,
                                 forceij, torqueij);
                         }
@@ -391,7 +434,7 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                 // edges, both are disks
                 else if(vertices_j.size() <= 1)
                     {
-                    m_evaluator.vertexVertex(dx, vertices_i[0], dx + vertices_j[0],
+                    evaluator.vertexVertex(dx, vertices_i[0], dx + vertices_j[0],
                         potentialij, forceij, torqueij,
                         forceji, torqueji);
                     }
@@ -416,15 +459,15 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                 viriali[3] += pair_virial[3];
 
                 // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
-                if (third_law && k < m_pdata->getN())
+                if (third_law && k < N)
                     {
-                    h_force.data[k].x  += forceji.x;
-                    h_force.data[k].y  += forceji.y;
-                    h_force.data[k].w  += potentialij;
-                    h_torque.data[k].z += torqueji;
-                    h_virial.data[0*virial_pitch + k] += pair_virial[0];
-                    h_virial.data[1*virial_pitch + k] += pair_virial[1];
-                    h_virial.data[3*virial_pitch + k] += pair_virial[3];
+                    force_k[k].x  += forceji.x;
+                    force_k[k].y  += forceji.y;
+                    force_k[k].w  += potentialij;
+                    torque_k[k].z += torqueji;
+                    virial_k[0*pitch_k + k] += pair_virial[0];
+                    virial_k[1*pitch_k + k] += pair_virial[1];
+                    virial_k[3*pitch_k + k] += pair_virial[3];
                     }
                 }
 
@@ -439,13 +482,78 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
         h_virial.data[0*virial_pitch + i] += viriali[0];
         h_virial.data[1*virial_pitch + i] += viriali[1];
         h_virial.data[3*virial_pitch + i] += viriali[3];
+        };
+
+    #ifdef ENABLE_TBB
+    if (third_law)
+        {
+        // contributions to neighbors are accumulated per thread and summed up afterwards
+        m_force_thread.reset(N);
+        m_torque_thread.reset(N);
+        m_virial_thread.reset(6*N);
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            DEMEvaluator<Real, Real4, Potential> evaluator(m_evaluator);
+            Scalar4 *local_force = m_force_thread.local();
+            Scalar4 *local_torque = m_torque_thread.local();
+            Scalar *local_virial = m_virial_thread.local();
+            for (unsigned int i = range.begin(); i != range.end(); ++i)
+                compute_particle(i, evaluator, local_force, local_torque, local_virial, N);
+            });
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            for (const auto& local_force : m_force_thread)
+                for (unsigned int i = range.begin(); i != range.end(); ++i)
+                    {
+                    h_force.data[i].x += local_force[i].x;
+                    h_force.data[i].y += local_force[i].y;
+                    h_force.data[i].w += local_force[i].w;
+                    }
+            for (const auto& local_torque : m_torque_thread)
+                for (unsigned int i = range.begin(); i != range.end(); ++i)
+                    h_torque.data[i].z += local_torque[i].z;
+            for (const auto& local_virial : m_virial_thread)
+                for (unsigned int i = range.begin(); i != range.end(); ++i)
+                    {
+                    h_virial.data[0*virial_pitch + i] += local_virial[0*N + i];
+                    h_virial.data[1*virial_pitch + i] += local_virial[1*N + i];
+                    h_virial.data[3*virial_pitch + i] += local_virial[3*N + i];
+                    }
+            });
         }
+    else
+        {
+        // with a full neighbor list, every particle only writes its own output
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            DEMEvaluator<Real, Real4, Potential> evaluator(m_evaluator);
+            for (unsigned int i = range.begin(); i != range.end(); ++i)
+                compute_particle(i, evaluator, h_force.data, h_torque.data, h_virial.data, virial_pitch);
+            });
+        }
+    #else
+    for (unsigned int i = 0; i < N; i++)
+        compute_particle(i, m_evaluator, h_force.data, h_torque.data, h_virial.data, virial_pitch);
+    #endif
 
-    int64_t flops = m_pdata->getN() * 5 + n_calc * (3+5+9+1+14+6+8);
-    if (third_law) flops += n_calc * 8;
-    int64_t mem_transfer = m_pdata->getN() * (5+4+10)*sizeof(Scalar) + n_calc * (1+3+1)*sizeof(Scalar);
-    if (third_law) mem_transfer += n_calc*10*sizeof(Scalar);
-    if (m_prof) m_prof->pop(flops, mem_transfer);
+    if (m_prof)
+        {
+        // tally up the number of forces calculated
+        int64_t n_calc = 0;
+        for (unsigned int i = 0; i < N; i++)
+            n_calc += h_n_neigh.data[i];
+
+        int64_t flops = m_pdata->getN() * 5 + n_calc * (3+5+9+1+14+6+8);
+        if (third_law) flops += n_calc * 8;
+        int64_t mem_transfer = m_pdata->getN() * (5+4+10)*sizeof(Scalar) + n_calc * (1+3+1)*sizeof(Scalar);
+        if (third_law) mem_transfer += n_calc*10*sizeof(Scalar);
+        m_prof->pop(flops, mem_transfer);
+        }
     }
 
 #ifdef WIN32
@@ -4,6 +4,7 @@
 // Maintainer: mspells
 
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ThreadLocalArray.h"
 #include "hoomd/md/NeighborList.h"
 
 #include <iterator>
@@ -36,6 +37,11 @@
   Forces can be computed directly by calling compute() and then retrieved with a call to acquire(), but
   a more typical usage will be to add the force compute to NVEUpdater or NVTUpdater.
 
+  On the CPU, particles are processed in parallel when TBB is enabled. With a half neighbor list, the
+  contributions to neighbors are summed in per-thread buffers. Unless disabled with setFeatureCulling(),
+  vertices of one shape that cannot reach the bounding circle of the other shape are skipped before their
+  vertex/edge interactions are evaluated.
+
   \ingroup computes
 */
 template<typename Real, typename Real4, typename Potential>
@@ -56,6 +62,9 @@ class DEM2DForceCompute : public ForceCompute
 
         virtual void setRcut(Real r_cut) {m_r_cut = r_cut;}
 
+        //! Enable or disable skipping of feature pairs whose bounding circles are out of range
+        void setFeatureCulling(bool enable) {m_featureCulling = enable;}
+
         //! Returns a list of log quantities this compute calculates
         virtual std::vector< std::string > getProvidedLogQuantities();
 
@@ -99,6 +108,14 @@ class DEM2DForceCompute : public ForceCompute
         Real m_r_cut;         //!< Cutoff radius beyond which the force is set to 0
         DEMEvaluator<Real, Real4, Potential> m_evaluator; //!< Object holding parameters and computation method for the potential
         std::vector<std::vector<vec2<Real> > > m_shapes; //!< Vertices for each type
+        std::vector<Real> m_typeRadius; //!< type->radius of the bounding circle of the vertices
+        bool m_featureCulling; //!< True if feature pairs are pre-culled by their bounding circles
+
+        #ifdef ENABLE_TBB
+        ThreadLocalArray<Scalar4> m_force_thread;  //!< Per-thread forces on neighbors (half list)
+        ThreadLocalArray<Scalar4> m_torque_thread; //!< Per-thread torques on neighbors (half list)
+        ThreadLocalArray<Scalar> m_virial_thread;  //!< Per-thread virials on neighbors (half list)
+        #endif
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
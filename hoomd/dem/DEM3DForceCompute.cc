@@ -21,6 +21,11 @@
 #include <omp.h>
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 /*! \file DEM3DForceCompute.cc
   \brief Defines the DEM3DForceCompute class
 */
@@ -46,7 +51,8 @@ DEM3DForceCompute<Real, Real4, Potential>::DEM3DForceCompute(
       m_numTypeEdges(0, this->m_exec_conf), m_numTypeFaces(0, this->m_exec_conf),
       m_vertexConnectivity(0, this->m_exec_conf), m_edges(0, this->m_exec_conf),
       m_faceRcutSq(0, this->m_exec_conf), m_edgeRcutSq(0, this->m_exec_conf),
-      m_verts(0, this->m_exec_conf), m_shapes(), m_facesVec()
+      m_verts(0, this->m_exec_conf), m_shapes(), m_facesVec(), m_typeRadius(),
+      m_featureCulling(true)
     {
     m_exec_conf->msg->notice(5) << "Constructing DEM3DForceCompute" << endl;
 
@@ -161,6 +167,7 @@ void DEM3DForceCompute<Real, Real4, Potential>::setParams(
         {
         m_shapes.push_back(vector<vec3<Real> >(0));
         m_facesVec.push_back(vector<vector<unsigned int> >(0));
+        m_typeRadius.push_back(Real(0));
         }
 
     // build a vector of points
@@ -203,6 +210,12 @@ void DEM3DForceCompute<Real, Real4, Potential>::setParams(
     m_shapes[type] = points;
     m_facesVec[type] = faces;
 
+    // all features of the shape lie within the sphere through its outermost vertex
+    Real radius(0);
+    for(size_t i(0); i < points.size(); ++i)
+        radius = std::max(radius, Real(sqrt(dot(points[i], points[i]))));
+    m_typeRadius[type] = radius;
+
     createGeometry();
     }
 
@@ -649,18 +662,36 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
     // create a temporary copy of r_cut squared
     Scalar r_cut_sq = m_r_cut * m_r_cut;
 
-    // tally up the number of forces calculated
-    int64_t n_calc = 0;
-
-    // for each particle
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    const unsigned int N = m_pdata->getN();
+    const bool cull = m_featureCulling;
+    const Real feature_rcutsq = m_evaluator.getRcutSq();
+
+    /* Compute all feature interactions of particle i with its neighbors. The contributions to i are
+       added to h_force/h_torque/h_virial, which only the caller processing i touches. Third-law
+       contributions to the neighbors go to force_k/torque_k/virial_k. The evaluator is passed by
+       reference because it carries per-pair state (diameters, relative velocity) and thus must not be
+       shared between threads.
+    */
+    auto compute_particle = [&](unsigned int i, DEMEvaluator<Real, Real4, Potential>& evaluator,
+        Scalar4 *force_k, Scalar4 *torque_k, Scalar *virial_k, unsigned int pitch_k)
         {
+        // true if a feature at distance dist from the center of a shape with bounding radius radius
+        // cannot interact with any feature of that shape. The features are at least dist - radius apart,
+        // so they are out of range when that distance exceeds the contact shift of the potential (set
+        // by the diameters for SWCA) by more than the feature cutoff.
+        auto out_of_range = [&](Real dist, Real radius) -> bool
+            {
+            const Real gap(dist - radius - evaluator.getShift());
+            return cull && gap > Real(0) && gap*gap >= feature_rcutsq;
+            };
+
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
         vec3<Scalar> pi(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
         quat<Scalar> quati(h_orientation.data[i]);
         unsigned int typei = __scalar_as_int(h_pos.data[i].w);
         // sanity check
         assert(typei < m_pdata->getNTypes());
+        const Real radiusi(m_typeRadius[typei]);
 
         // initialize current particle force, potential energy, and virial to 0
         vec3<Real> fi;
@@ -687,9 +718,6 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
         const unsigned int size = (unsigned int)h_n_neigh.data[i];
         for (unsigned int j = 0; j < size; j++)
             {
-            // increment our calculation counter
-            n_calc++;
-
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
             unsigned int k = h_nlist.data[myHead + j];
             // sanity check
@@ -704,6 +732,7 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
             unsigned int typej = __scalar_as_int(h_pos.data[k].w);
             // sanity check
             assert(typej < m_pdata->getNTypes());
+            const Real radiusj(m_typeRadius[typej]);
 
             // apply periodic boundary conditions (FLOPS: 9 (worst case: first branch is missed, the 2nd is taken and the add is done)
             dxScalar = vec3<Scalar>(box.minImage(vec_to_scalar3(dxScalar)));
@@ -716,18 +745,19 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
             if (Potential::needsDiameter())
                 {
                 dj = h_diameter.data[k];
-                m_evaluator.setDiameter(di,dj);
+                evaluator.setDiameter(di,dj);
                 }
 
             if(Potential::needsVelocity())
-                m_evaluator.setVelocity(vi - vec3<Scalar>(h_velocity.data[k]));
+                evaluator.setVelocity(vi - vec3<Scalar>(h_velocity.data[k]));
 
             // start computing the force
             // calculate r squared (FLOPS: 5)
             Real rsq = dot(dx, dx);
 
             // only compute the force if the particles are closer than the cutoff (FLOPS: 1)
-            if (m_evaluator.withinCutoff(rsq,r_cut_sq))
+            // and, when culling, if their bounding spheres are close enough to interact at all
+            if (evaluator.withinCutoff(rsq,r_cut_sq) && !out_of_range(sqrt(rsq), radiusi + radiusj))
                 {
                 // local forces and torques for particles i and j
                 vec3<Real> forceij, forceji;
@@ -740,13 +770,18 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                     const vec3<Real> vertex0(
                         rotate(quati, vec3<Real>(h_verts.data[h_firstTypeVert.data[typei] + vertIndex])));
 
+                    // skip vertices that are too far from the bounding sphere of j
+                    const vec3<Real> rvj(vertex0 - dx);
+                    if (out_of_range(sqrt(dot(rvj, rvj)), radiusj))
+                        continue;
+
                     // iterate over each face in particle j
                     size_t faceIndex(typej);
                     if(h_numTypeFaces.data[typej] > 0)
                         {
                         do
                             {
-                            m_evaluator.vertexFace(dx, vertex0, quatj,
+                            evaluator.vertexFace(dx, vertex0, quatj,
                                 h_verts.data,
                                 h_realVertIndex.data,
                                 h_nextFaceVert.data,
@@ -769,7 +804,7 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                             p10 = rotate(quatj, p10);
                             p11 = rotate(quatj, p11);
 
-                            m_evaluator.vertexEdge(dx, vertex0, p10, p11,
+                            evaluator.vertexEdge(dx, vertex0, p10, p11,
                                 potentialij, forceij, torqueij,
                                 forceji, torqueji);
                             }
@@ -783,7 +818,7 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                             vec3<Real> vertex1(h_verts.data[h_firstTypeVert.data[typej] + vertj]);
                             vertex1 = rotate(quatj, vertex1);
 
-                            m_evaluator.vertexVertex(dx, vertex0, dx + vertex1,
+                            evaluator.vertexVertex(dx, vertex0, dx + vertex1,
                                 potentialij, forceij, torqueij,
                                 forceji, torqueji);
                             }
@@ -796,13 +831,18 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                     const vec3<Real> vertex0(
                         rotate(quatj, vec3<Real>(h_verts.data[h_firstTypeVert.data[typej] + vertIndex])));
 
+                    // skip vertices that are too far from the bounding sphere of i
+                    const vec3<Real> rvi(vertex0 + dx);
+                    if (out_of_range(sqrt(dot(rvi, rvi)), radiusi))
+                        continue;
+
                     // iterate over each face in particle i
                     size_t faceIndex(typei);
                     if(h_numTypeFaces.data[typei] > 0)
                         {
                         do
                             {
-                            m_evaluator.vertexFace(-dx, vertex0, quati,
+                            evaluator.vertexFace(-dx, vertex0, quati,
                                 h_verts.data,
                                 h_realVertIndex.data,
                                 h_nextFaceVert.data,
@@ -825,7 +865,7 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                             p10 = rotate(quati, p10);
                             p11 = rotate(quati, p11);
 
-                            m_evaluator.vertexEdge(-dx, vertex0, p10, p11,
+                            evaluator.vertexEdge(-dx, vertex0, p10, p11,
                                 potentialij, forceji, torqueji,
                                 forceij, torqueij);
                             }
@@ -843,6 +883,15 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                     p00 = rotate(quati, p00);
                     p01 = rotate(quati, p01);
 
+                    // skip edges whose bounding sphere is too far from the bounding sphere of j
+                    if (cull)
+                        {
+                        const vec3<Real> half_edge(Real(0.5)*(p01 - p00));
+                        const vec3<Real> rej(p00 + half_edge - dx);
+                        if (out_of_range(sqrt(dot(rej, rej)), radiusj + sqrt(dot(half_edge, half_edge))))
+                            continue;
+                        }
+
                     // iterate over all edges of j
                     for(size_t edgej(0); edgej < h_numTypeEdges.data[typej]; ++edgej)
                         {
@@ -851,7 +900,7 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                         p10 = rotate(quatj, p10);
                         p11 = rotate(quatj, p11);
 
-                        m_evaluator.edgeEdge(dx, p00, p01, dx + p10, dx + p11, potentialij, forceij, torqueij, forceji, torqueji);
+                        evaluator.edgeEdge(dx, p00, p01, dx + p10, dx + p11, potentialij, forceij, torqueij, forceji, torqueji);
                         }
                     }
 
@@ -880,21 +929,21 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                 viriali[5] += pair_virial[5];
 
                 // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
-                if (third_law && k < m_pdata->getN())
+                if (third_law && k < N)
                     {
-                    h_force.data[k].x  += forceji.x;
-                    h_force.data[k].y  += forceji.y;
-                    h_force.data[k].z  += forceji.z;
-                    h_force.data[k].w  += potentialij;
-                    h_torque.data[k].x += torqueji.x;
-                    h_torque.data[k].y += torqueji.y;
-                    h_torque.data[k].z += torqueji.z;
-                    h_virial.data[0*virial_pitch + k] += pair_virial[0];
-                    h_virial.data[1*virial_pitch + k] += pair_virial[1];
-                    h_virial.data[2*virial_pitch + k] += pair_virial[2];
-                    h_virial.data[3*virial_pitch + k] += pair_virial[3];
-                    h_virial.data[4*virial_pitch + k] += pair_virial[4];
-                    h_virial.data[5*virial_pitch + k] += pair_virial[5];
+                    force_k[k].x  += forceji.x;
+                    force_k[k].y  += forceji.y;
+                    force_k[k].z  += forceji.z;
+                    force_k[k].w  += potentialij;
+                    torque_k[k].x += torqueji.x;
+                    torque_k[k].y += torqueji.y;
+                    torque_k[k].z += torqueji.z;
+                    virial_k[0*pitch_k + k] += pair_virial[0];
+                    virial_k[1*pitch_k + k] += pair_virial[1];
+                    virial_k[2*pitch_k + k] += pair_virial[2];
+                    virial_k[3*pitch_k + k] += pair_virial[3];
+                    virial_k[4*pitch_k + k] += pair_virial[4];
+                    virial_k[5*pitch_k + k] += pair_virial[5];
                     }
                 }
 
@@ -915,13 +964,80 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
         h_virial.data[3*virial_pitch + i] += viriali[3];
         h_virial.data[4*virial_pitch + i] += viriali[4];
         h_virial.data[5*virial_pitch + i] += viriali[5];
+        };
+
+    #ifdef ENABLE_TBB
+    if (third_law)
+        {
+        // contributions to neighbors are accumulated per thread and summed up afterwards
+        m_force_thread.reset(N);
+        m_torque_thread.reset(N);
+        m_virial_thread.reset(6*N);
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            DEMEvaluator<Real, Real4, Potential> evaluator(m_evaluator);
+            Scalar4 *local_force = m_force_thread.local();
+            Scalar4 *local_torque = m_torque_thread.local();
+            Scalar *local_virial = m_virial_thread.local();
+            for (unsigned int i = range.begin(); i != range.end(); ++i)
+                compute_particle(i, evaluator, local_force, local_torque, local_virial, N);
+            });
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            for (const auto& local_force : m_force_thread)
+                for (unsigned int i = range.begin(); i != range.end(); ++i)
+                    {
+                    h_force.data[i].x += local_force[i].x;
+                    h_force.data[i].y += local_force[i].y;
+                    h_force.data[i].z += local_force[i].z;
+                    h_force.data[i].w += local_force[i].w;
+                    }
+            for (const auto& local_torque : m_torque_thread)
+                for (unsigned int i = range.begin(); i != range.end(); ++i)
+                    {
+                    h_torque.data[i].x += local_torque[i].x;
+                    h_torque.data[i].y += local_torque[i].y;
+                    h_torque.data[i].z += local_torque[i].z;
+                    }
+            for (const auto& local_virial : m_virial_thread)
+                for (unsigned int l = 0; l < 6; ++l)
+                    for (unsigned int i = range.begin(); i != range.end(); ++i)
+                        h_virial.data[l*virial_pitch + i] += local_virial[l*N + i];
+            });
         }
+    else
+        {
+        // with a full neighbor list, every particle only writes its own output
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            DEMEvaluator<Real, Real4, Potential> evaluator(m_evaluator);
+            for (unsigned int i = range.begin(); i != range.end(); ++i)
+                compute_particle(i, evaluator, h_force.data, h_torque.data, h_virial.data, virial_pitch);
+            });
+        }
+    #else
+    for (unsigned int i = 0; i < N; i++)
+        compute_particle(i, m_evaluator, h_force.data, h_torque.data, h_virial.data, virial_pitch);
+    #endif
 
-    int64_t flops = m_pdata->getN() * 5 + n_calc * (3+5+9+1+14+6+8);
-    if (third_law) flops += n_calc * 8;
-    int64_t mem_transfer = m_pdata->getN() * (5+4+10)*sizeof(Real) + n_calc * (1+3+1)*sizeof(Real);
-    if (third_law) mem_transfer += n_calc*10*sizeof(Real);
-    if (m_prof) m_prof->pop(flops, mem_transfer);
+    if (m_prof)
+        {
+        // tally up the number of forces calculated
+        int64_t n_calc = 0;
+        for (unsigned int i = 0; i < N; i++)
+            n_calc += h_n_neigh.data[i];
+
+        int64_t flops = m_pdata->getN() * 5 + n_calc * (3+5+9+1+14+6+8);
+        if (third_law) flops += n_calc * 8;
+        int64_t mem_transfer = m_pdata->getN() * (5+4+10)*sizeof(Real) + n_calc * (1+3+1)*sizeof(Real);
+        if (third_law) mem_transfer += n_calc*10*sizeof(Real);
+        m_prof->pop(flops, mem_transfer);
+        }
     }
 
 #ifdef WIN32
@@ -4,6 +4,7 @@
 // Maintainer: mspells
 
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ThreadLocalArray.h"
 #include "hoomd/md/NeighborList.h"
 
 #include <pybind11/pybind11.h>
@@ -57,6 +58,11 @@
   - Vertices (3D points) are stored consecutively for a shape
   - Edges (pairs of vertex indices) are stored consecutively for a shape
 
+  On the CPU, particles are processed in parallel when TBB is enabled. With a half neighbor list, the
+  contributions to neighbors are summed in per-thread buffers. Unless disabled with setFeatureCulling(),
+  vertices and edges of one shape that cannot reach the bounding sphere of the other shape (the sphere through
+  its outermost vertex) are skipped before the individual feature pairs are evaluated.
+
   \ingroup computes
 */
 template<typename Real, typename Real4, typename Potential>
@@ -78,6 +84,9 @@ class DEM3DForceCompute : public ForceCompute
 
         virtual void setRcut(Real r_cut) {m_r_cut = r_cut;}
 
+        //! Enable or disable skipping of feature pairs whose bounding spheres are out of range
+        void setFeatureCulling(bool enable) {m_featureCulling = enable;}
+
         //! Returns a list of log quantities this compute calculates
         virtual std::vector< std::string > getProvidedLogQuantities();
 
@@ -151,6 +160,14 @@ class DEM3DForceCompute : public ForceCompute
         GPUArray<Real4> m_verts; //! Vertices for each real index
         std::vector<std::vector<vec3<Real> > > m_shapes; //!< Vertices for each type
         std::vector<std::vector<std::vector<unsigned int> > > m_facesVec; //!< Faces for each type
+        std::vector<Real> m_typeRadius; //!< type->radius of the bounding sphere of the vertices
+        bool m_featureCulling; //!< True if feature pairs are pre-culled by their bounding spheres
+
+        #ifdef ENABLE_TBB
+        ThreadLocalArray<Scalar4> m_force_thread;  //!< Per-thread forces on neighbors (half list)
+        ThreadLocalArray<Scalar4> m_torque_thread; //!< Per-thread torques on neighbors (half list)
+        ThreadLocalArray<Scalar> m_virial_thread;  //!< Per-thread virials on neighbors (half list)
+        #endif
 
         //! Re-send the list of vertices and links to the GPU
         void createGeometry();
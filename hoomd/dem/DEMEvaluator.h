@@ -113,6 +113,9 @@ class DEMEvaluator
         DEVICE inline void setDiameter(const Real di,const Real dj)
             {m_potential.setDiameter(di, dj);}
 
+        DEVICE inline Real getShift() const
+            {return m_potential.getShift();}
+
         DEVICE inline void swapij() {m_potential.swapij();}
 
         DEVICE static bool needsVelocity() {return Potential::needsVelocity();}
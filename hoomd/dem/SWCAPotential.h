@@ -43,6 +43,9 @@ class SWCAPotential
             m_rcutsq(radius*radius*4*pow(2.0, 1./3)),
             m_frictionParams(frictionParams) {}
 
+        // Get this potential's cutoff radius
+        Real getRcutSq() const {return m_rcutsq;}
+
         // Get this potential's rounding radius
         Real getRadius() const {return m_radius;}
 
@@ -73,6 +76,8 @@ class SWCAPotential
         //! Test if potential needs the diameter
         DEVICE static bool needsDiameter() {return true;}
         DEVICE void setDiameter(Real di, Real dj) {m_delta = 0.5*(di+dj) - 1;}
+        //! Shift of the contact distance by the diameters set in setDiameter()
+        DEVICE inline Real getShift() const {return m_delta;}
 
         //! Swap the sense of particle i and j for the friction params
         DEVICE inline void swapij() {m_frictionParams.swapij();}
@@ -82,6 +82,9 @@ class WCAPotential
         /*! Dummy function to set diameter*/
         DEVICE inline void setDiameter(const Real di,const Real dj) {}
 
+        /*! Shift of the contact distance by the diameters (none for WCA) */
+        DEVICE inline Real getShift() const {return 0;}
+
         //! Swap the sense of particle i and j for the friction params
         DEVICE inline void swapij() {m_frictionParams.swapij();}
 
@@ -140,6 +140,23 @@ class _DEMBase:
         ret = [ json.loads(json_string) for json_string in type_shapes ];
         return ret;
 
+    def setFeatureCulling(self, enable):
+        R"""Enable or disable the bounding sphere pre-cull of feature pairs.
+
+        Args:
+            enable (bool): When True (the default), vertices and edges of one shape that are out of
+                interaction range of the bounding sphere (circle in 2D) of the other shape are skipped
+                before their pairwise interactions are evaluated. The computed forces are the same
+                either way; disabling the cull is only useful for benchmarking. Only the CPU
+                implementation culls feature pairs.
+
+        Examples::
+
+            shapes.setFeatureCulling(False)
+
+        """
+        self.cpp_force.setFeatureCulling(bool(enable));
+
 class WCA(hoomd.md.force._force, _DEMBase):
     R"""Specify a purely repulsive Weeks-Chandler-Andersen DEM force with a constant rounding radius.
 
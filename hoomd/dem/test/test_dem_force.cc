@@ -0,0 +1,287 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <functional>
+#include <random>
+
+#include "hoomd/dem/DEMEvaluator.h"
+#include "hoomd/dem/NoFriction.h"
+#include "hoomd/dem/WCAPotential.h"
+#include "hoomd/dem/SWCAPotential.h"
+#include "hoomd/dem/DEM2DForceCompute.h"
+#include "hoomd/dem/DEM3DForceCompute.h"
+#include "hoomd/md/NeighborListTree.h"
+
+#include <pybind11/embed.h>
+namespace py = pybind11;
+
+using namespace std;
+
+#include "hoomd/test/upp11_config.h"
+#include "hoomd/test/thread_compare.h"
+
+HOOMD_UP_MAIN();
+
+/*! \file test_dem_force.cc
+    \brief Implements unit tests for DEM2DForceCompute and DEM3DForceCompute
+    \ingroup unit_tests
+*/
+
+typedef WCAPotential<Scalar, Scalar4, NoFriction<Scalar> > WCA;
+typedef SWCAPotential<Scalar, Scalar4, NoFriction<Scalar> > SWCA;
+
+//! Place n^dim large squares or cubes on a jittered lattice with the given spacing and diameter
+std::shared_ptr<SystemDefinition> create_lattice(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                                 unsigned int dim,
+                                                 Scalar spacing,
+                                                 Scalar diameter)
+    {
+    const unsigned int n = 4;
+    const unsigned int N = dim == 2 ? n*n : n*n*n;
+    const Scalar L = n*spacing;
+    BoxDim box = dim == 2 ? BoxDim(L, L, 1.0) : BoxDim(L);
+
+    auto sysdef = std::make_shared<SystemDefinition>(N, box, 1, 0, 0, 0, 0, exec_conf);
+    sysdef->setNDimensions(dim);
+    auto pdata = sysdef->getParticleData();
+    pdata->setFlags(PDataFlags().set(pdata_flag::pressure_tensor));
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<Scalar> u(-0.05, 0.05);
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar> h_diameter(pdata->getDiameters(), access_location::host, access_mode::overwrite);
+    const Scalar lo = -Scalar(0.5)*L + Scalar(0.5)*spacing;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        h_pos.data[i] = make_scalar4(lo + spacing*(i % n) + u(rng),
+                                     lo + spacing*((i / n) % n) + u(rng),
+                                     dim == 2 ? Scalar(0.0) : lo + spacing*(i / (n*n)) + u(rng),
+                                     __int_as_scalar(0));
+        h_diameter.data[i] = diameter;
+        }
+
+    return sysdef;
+    }
+
+//! Create a neighbor list with the given cutoff and storage mode
+std::shared_ptr<NeighborList> create_nlist(std::shared_ptr<SystemDefinition> sysdef,
+                                           Scalar r_cut,
+                                           NeighborList::storageMode mode)
+    {
+    auto nlist = std::make_shared<NeighborListTree>(sysdef, r_cut, Scalar(0.3));
+    auto r_cut_matrix = std::make_shared< GlobalArray<Scalar> >(nlist->getTypePairIndexer().getNumElements(),
+                                                                 sysdef->getParticleData()->getExecConf());
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut_matrix, access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < r_cut_matrix->getNumElements(); i++)
+            h_r_cut.data[i] = r_cut;
+        }
+    nlist->addRCutMatrix(r_cut_matrix);
+    nlist->setStorageMode(mode);
+    return nlist;
+    }
+
+//! Compute the forces, torques and virials of a DEM force compute with feature culling enabled or disabled
+template<class Force>
+std::vector<Scalar> compute_dem(std::shared_ptr<Force> dem,
+                                std::shared_ptr<ParticleData> pdata,
+                                bool cull,
+                                unsigned int timestep)
+    {
+    dem->setFeatureCulling(cull);
+    dem->compute(timestep);
+
+    std::vector<Scalar> result;
+    append_force_arrays(result, dem, pdata->getN());
+    return result;
+    }
+
+//! Check that feature culling does not change the forces, for half and full neighbor lists
+/*! \param sysdef System to compute the forces on
+    \param create Creates the DEM force compute with the shapes set for a neighbor list
+    \param r_cut Cutoff of the neighbor list
+*/
+template<class Force>
+void dem_culling_test(std::shared_ptr<SystemDefinition> sysdef,
+                      std::function<std::shared_ptr<Force> (std::shared_ptr<NeighborList>)> create,
+                      Scalar r_cut)
+    {
+    auto pdata = sysdef->getParticleData();
+
+    for (auto mode : {NeighborList::half, NeighborList::full})
+        {
+        auto dem = create(create_nlist(sysdef, r_cut, mode));
+
+        std::vector<Scalar> ref = compute_dem(dem, pdata, false, 0);
+        std::vector<Scalar> culled = compute_dem(dem, pdata, true, 1);
+
+        // the shapes must interact for the comparison to mean anything
+        Scalar max_force(0);
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            max_force = std::max(max_force, std::abs(ref[13*i]));
+        UP_ASSERT(max_force > Scalar(1.0));
+
+        for (unsigned int i = 0; i < ref.size(); i++)
+            MY_CHECK_SMALL(culled[i] - ref[i], tol_small);
+        }
+    }
+
+//! Check that the forces do not depend on the number of threads, for half and full neighbor lists
+/*! \param exec_conf Execution configuration of the system
+    \param sysdef System to compute the forces on
+    \param create Creates the DEM force compute with the shapes set for a neighbor list
+    \param r_cut Cutoff of the neighbor list
+*/
+template<class Force>
+void dem_threads_test(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                      std::shared_ptr<SystemDefinition> sysdef,
+                      std::function<std::shared_ptr<Force> (std::shared_ptr<NeighborList>)> create,
+                      Scalar r_cut)
+    {
+    auto pdata = sysdef->getParticleData();
+
+    for (auto mode : {NeighborList::half, NeighborList::full})
+        {
+        compare_threads(exec_conf, [&]()
+            {
+            auto dem = create(create_nlist(sysdef, r_cut, mode));
+            return compute_dem(dem, pdata, true, 0);
+            });
+        }
+    }
+
+//! Vertices of a square with half width 4
+py::list square_vertices()
+    {
+    py::list vertices;
+    vertices.append(py::make_tuple(-4.0, -4.0));
+    vertices.append(py::make_tuple(4.0, -4.0));
+    vertices.append(py::make_tuple(4.0, 4.0));
+    vertices.append(py::make_tuple(-4.0, 4.0));
+    return vertices;
+    }
+
+//! Set up culling or thread tests of 2D squares with the potential P
+template<class P>
+void dem2d_test(P potential, Scalar spacing, Scalar diameter, Scalar r_cut, bool threads)
+    {
+    typedef DEM2DForceCompute<Scalar, Scalar4, P> Force;
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = create_lattice(exec_conf, 2, spacing, diameter);
+    auto create = [&](std::shared_ptr<NeighborList> nlist)
+        {
+        auto dem = std::make_shared<Force>(sysdef, nlist, r_cut, potential);
+        dem->setParams(0, square_vertices());
+        return dem;
+        };
+
+    if (threads)
+        dem_threads_test<Force>(exec_conf, sysdef, create, r_cut);
+    else
+        dem_culling_test<Force>(sysdef, create, r_cut);
+    }
+
+//! Set up culling or thread tests of 3D cubes with the potential P
+template<class P>
+void dem3d_test(P potential, Scalar spacing, Scalar diameter, Scalar r_cut, bool threads)
+    {
+    typedef DEM3DForceCompute<Scalar, Scalar4, P> Force;
+
+    py::list vertices;
+    const int corners[8][3] = {{-1, -1, -1}, {1, -1, -1}, {1, 1, -1}, {-1, 1, -1},
+                               {-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1}};
+    for (unsigned int i = 0; i < 8; i++)
+        vertices.append(py::make_tuple(4.0*corners[i][0], 4.0*corners[i][1], 4.0*corners[i][2]));
+
+    py::list faces;
+    const unsigned int face_vertices[6][4] = {{0, 3, 2, 1}, {4, 5, 6, 7}, {0, 1, 5, 4},
+                                              {2, 3, 7, 6}, {1, 2, 6, 5}, {0, 4, 7, 3}};
+    for (unsigned int i = 0; i < 6; i++)
+        {
+        py::list face;
+        for (unsigned int j = 0; j < 4; j++)
+            face.append(face_vertices[i][j]);
+        faces.append(face);
+        }
+
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = create_lattice(exec_conf, 3, spacing, diameter);
+    auto create = [&](std::shared_ptr<NeighborList> nlist)
+        {
+        auto dem = std::make_shared<Force>(sysdef, nlist, r_cut, potential);
+        dem->setParams(0, vertices, faces);
+        return dem;
+        };
+
+    if (threads)
+        dem_threads_test<Force>(exec_conf, sysdef, create, r_cut);
+    else
+        dem_culling_test<Force>(sysdef, create, r_cut);
+    }
+
+/* The shapes have a half width of 4 and a rounding radius of 0.5, so that the features interact up to a distance of
+   2^(1/6) plus the SWCA shift. For WCA, neighbors along the axes are 0.9 apart and diagonal neighbors are culled. For
+   SWCA, the diameters shift the contact distance by 2.5 (2D) or 5.5 (3D), and neighbors along the axes are 1.0 more
+   than that apart. They interact even though the gap between their bounding circles (spheres) is smaller than the
+   shift.
+*/
+
+//! Feature culling with WCA in 2D
+UP_TEST( dem2d_wca_culling )
+    {
+    py::scoped_interpreter guard{};
+    dem2d_test(WCA(0.5, NoFriction<Scalar>()), Scalar(8.9), Scalar(1.0), Scalar(13.0), false);
+    }
+
+//! Feature culling with SWCA in 2D
+UP_TEST( dem2d_swca_culling )
+    {
+    py::scoped_interpreter guard{};
+    dem2d_test(SWCA(0.5, NoFriction<Scalar>()), Scalar(11.5), Scalar(3.5), Scalar(17.0), false);
+    }
+
+//! Feature culling with WCA in 3D
+UP_TEST( dem3d_wca_culling )
+    {
+    py::scoped_interpreter guard{};
+    dem3d_test(WCA(0.5, NoFriction<Scalar>()), Scalar(8.9), Scalar(1.0), Scalar(13.0), false);
+    }
+
+//! Feature culling with SWCA in 3D
+UP_TEST( dem3d_swca_culling )
+    {
+    py::scoped_interpreter guard{};
+    dem3d_test(SWCA(0.5, NoFriction<Scalar>()), Scalar(14.5), Scalar(7.5), Scalar(21.0), false);
+    }
+
+//! Four threads against one thread with WCA in 2D
+UP_TEST( dem2d_wca_threads )
+    {
+    py::scoped_interpreter guard{};
+    dem2d_test(WCA(0.5, NoFriction<Scalar>()), Scalar(8.9), Scalar(1.0), Scalar(13.0), true);
+    }
+
+//! Four threads against one thread with SWCA in 2D
+UP_TEST( dem2d_swca_threads )
+    {
+    py::scoped_interpreter guard{};
+    dem2d_test(SWCA(0.5, NoFriction<Scalar>()), Scalar(11.5), Scalar(3.5), Scalar(17.0), true);
+    }
+
+//! Four threads against one thread with WCA in 3D
+UP_TEST( dem3d_wca_threads )
+    {
+    py::scoped_interpreter guard{};
+    dem3d_test(WCA(0.5, NoFriction<Scalar>()), Scalar(8.9), Scalar(1.0), Scalar(13.0), true);
+    }
+
+//! Four threads against one thread with SWCA in 3D
+UP_TEST( dem3d_swca_threads )
+    {
+    py::scoped_interpreter guard{};
+    dem3d_test(SWCA(0.5, NoFriction<Scalar>()), Scalar(14.5), Scalar(7.5), Scalar(21.0), true);
+    }
@@ -25,12 +25,19 @@
 
 #include <pybind11/pybind11.h>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+#endif
 
 namespace hpmc
 {
 
 //! Template class for a free volume integration analyzer
-/*!
+/*! Test depletants are inserted independently, in parallel with TBB when it is available. With a relative
+    tolerance set, the samples are taken in batches and the integration stops as soon as the relative standard
+    error of the free volume falls below the tolerance; the number of samples is then an upper bound.
+
     \ingroup hpmc_integrators
 */
 template< class Shape >
@@ -52,6 +59,17 @@ class ComputeFreeVolume : public Compute
             m_n_sample = n_sample;
             }
 
+        //! Set the relative standard error at which the integration stops (0 to always take all samples)
+        void setRelativeTolerance(Scalar rel_tol)
+            {
+            if (rel_tol > Scalar(0.0) && m_exec_conf->isCUDAEnabled())
+                {
+                m_exec_conf->msg->error() << "compute.free_volume: tolerance is not supported on the GPU" << std::endl;
+                throw std::runtime_error("Error setting free volume tolerance");
+                }
+            m_rel_tol = rel_tol;
+            }
+
         //! Set the type of depletant particle
         void setTestParticleType(unsigned int type)
             {
@@ -84,6 +102,8 @@ class ComputeFreeVolume : public Compute
 
         unsigned int m_type;                                     //!< Type of depletant particle to generate
         unsigned int m_n_sample;                                 //!< Number of sampling depletants to generate
+        unsigned int m_n_sample_total;                           //!< Number of depletants sampled in the last integration
+        Scalar m_rel_tol;                                        //!< Relative standard error to stop at (0 if disabled)
         unsigned int m_seed;                                     //!< The RNG seed
         const std::string m_suffix;                              //!< Log suffix
 
@@ -97,7 +117,8 @@ ComputeFreeVolume< Shape >::ComputeFreeVolume(std::shared_ptr<SystemDefinition>
                                                     std::shared_ptr<CellList> cl,
                                                     unsigned int seed,
                                                     std::string suffix)
-    : Compute(sysdef), m_mc(mc), m_cl(cl), m_type(0), m_n_sample(0), m_seed(seed), m_suffix(suffix)
+    : Compute(sysdef), m_mc(mc), m_cl(cl), m_type(0), m_n_sample(0), m_n_sample_total(0), m_rel_tol(0.0),
+      m_seed(seed), m_suffix(suffix)
     {
     this->m_exec_conf->msg->notice(5) << "Constructing ComputeFreeVolume" << std::endl;
 
@@ -135,7 +156,7 @@ template<class Shape>
 void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
     {
     unsigned int overlap_count = 0;
-    unsigned int err_count = 0;
+    unsigned int n_sample_total = 0;
     unsigned int ndim = this->m_sysdef->getNDimensions();
 
     this->m_exec_conf->msg->notice(5) << "HPMC computing free volume " << timestep << std::endl;
@@ -148,8 +169,7 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
 
     if (m_prof) m_prof->push("Free volume");
 
-    // only check if AABB tree is populated
-    if (m_pdata->getN() + m_pdata->getNGhosts())
+    // every rank takes part in the sampling, so that the sample counts can be reduced after every batch
         {
         // access particle data and system box
         ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
@@ -166,10 +186,15 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
         unsigned int n_sample = m_n_sample;
 
         #ifdef ENABLE_MPI
-        n_sample /= this->m_exec_conf->getNRanks();
+        if (m_pdata->getDomainDecomposition())
+            {
+            // distribute the samples according to the volume of the local domain
+            n_sample = (unsigned int)(Scalar(m_n_sample)*box.getVolume()/m_pdata->getGlobalBox().getVolume()+Scalar(0.5));
+            }
         #endif
 
-        for (unsigned int i = 0; i < n_sample; i++)
+        // test a single random depletant for overlaps
+        auto test_sample = [&](unsigned int i, unsigned int& err_count)->bool
             {
             // select a random particle coordinate in the box
             hoomd::RandomGenerator rng_i(hoomd::RNGIdentifier::ComputeFreeVolume, m_seed, m_exec_conf->getRank(), i, timestep);
@@ -248,25 +273,80 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
                     break;
                 } // end loop over images
 
-            if (overlap)
+            return overlap;
+            };
+
+        // only check if AABB tree is populated, the tree is not rebuilt without particles and may be stale
+        const bool has_particles = m_pdata->getN() + m_pdata->getNGhosts() > 0;
+
+        // count the overlapping depletants among samples [begin, end)
+        auto count_samples = [&](unsigned int begin, unsigned int end)->unsigned int
+            {
+            // all samples are free on a rank without particles
+            if (!has_particles)
+                return 0u;
+
+            #ifdef ENABLE_TBB
+            return tbb::parallel_reduce(tbb::blocked_range<unsigned int>(begin, end),
+                0u,
+                [&](const tbb::blocked_range<unsigned int>& r, unsigned int count)->unsigned int {
+                unsigned int err_count = 0;
+                for (unsigned int i = r.begin(); i != r.end(); ++i)
+                    {
+                    if (test_sample(i, err_count))
+                        count++;
+                    }
+                return count;
+                }, [](unsigned int x, unsigned int y)->unsigned int { return x+y; } );
+            #else
+            unsigned int count = 0;
+            unsigned int err_count = 0;
+            for (unsigned int i = begin; i < end; i++)
                 {
-                overlap_count++;
+                if (test_sample(i, err_count))
+                    count++;
                 }
-            } // end loop through all particles
+            return count;
+            #endif
+            };
 
-        } // end lexical scope
+        // with a tolerance, check the error after every 1/16th of the samples
+        const unsigned int n_batch = (m_rel_tol > Scalar(0.0)) ? 16 : 1;
 
-    #ifdef ENABLE_MPI
-    if (m_comm)
-        {
-        MPI_Allreduce(MPI_IN_PLACE, &overlap_count, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
-        }
-    #endif
+        unsigned int overlap_count_rank = 0;
+        for (unsigned int batch = 0; batch < n_batch; ++batch)
+            {
+            unsigned int begin = (unsigned int)((unsigned long)n_sample*batch/n_batch);
+            unsigned int end = (unsigned int)((unsigned long)n_sample*(batch+1)/n_batch);
+            overlap_count_rank += count_samples(begin, end);
+
+            overlap_count = overlap_count_rank;
+            n_sample_total = end;
+
+            #ifdef ENABLE_MPI
+            if (m_comm)
+                {
+                MPI_Allreduce(MPI_IN_PLACE, &overlap_count, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+                MPI_Allreduce(MPI_IN_PLACE, &n_sample_total, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+                }
+            #endif
+
+            // relative standard error of the binomial estimate of the free volume fraction
+            if (n_batch > 1 && n_sample_total > overlap_count)
+                {
+                Scalar f_free = Scalar(n_sample_total-overlap_count)/Scalar(n_sample_total);
+                Scalar rel_err = sqrt((Scalar(1.0)-f_free)/(f_free*Scalar(n_sample_total)));
+                if (rel_err < m_rel_tol)
+                    break;
+                }
+            }
+        } // end lexical scope
 
     if (m_prof) m_prof->pop();
 
     ArrayHandle<unsigned int> h_n_overlap_all(m_n_overlap_all, access_location::host, access_mode::overwrite);
     *h_n_overlap_all.data = overlap_count;
+    m_n_sample_total = n_sample_total;
     }
 
 /*! \param quantity Name of the log quantity to get
@@ -284,14 +364,10 @@ Scalar ComputeFreeVolume<Shape>::getLogValue(const std::string& quantity, unsign
         // access counters
         ArrayHandle<unsigned int> h_n_overlap_all(m_n_overlap_all, access_location::host, access_mode::read);
 
-        // generate n_sample random test depletants in the global box
-        unsigned int n_sample = m_n_sample;
-
-        #ifdef ENABLE_MPI
-        // in MPI, for small n_sample we can encounter round-off issues
-        unsigned int n_ranks = this->m_exec_conf->getNRanks();
-        n_sample = (n_sample/n_ranks)*n_ranks;
-        #endif
+        // number of test depletants actually generated in the global box
+        unsigned int n_sample = m_n_sample_total;
+        if (n_sample == 0)
+            return Scalar(0.0);
 
 
         // total free volume
@@ -317,6 +393,7 @@ template < class Shape > void export_ComputeFreeVolume(pybind11::module& m, cons
                 std::string >())
         .def("setNumSamples", &ComputeFreeVolume<Shape>::setNumSamples)
         .def("setTestParticleType", &ComputeFreeVolume<Shape>::setTestParticleType)
+        .def("setRelativeTolerance", &ComputeFreeVolume<Shape>::setRelativeTolerance)
         ;
     }
 
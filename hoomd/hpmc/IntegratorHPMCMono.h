@@ -12,6 +12,10 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
 
 #include "hoomd/Integrator.h"
 #include "HPMCPrecisionSetup.h"
@@ -453,6 +457,9 @@ class IntegratorHPMCMono : public IntegratorHPMC
         unsigned int m_aabbs_capacity;              //!< Capacity of m_aabbs list
         bool m_aabb_tree_invalid;                   //!< Flag if the aabb tree has been invalidated
 
+        std::vector<OverlapReal> m_overlap_gap;     //!< Smallest circumsphere gap of each particle (by tag) in the last overlap count
+        std::vector<unsigned int> m_overlap_order;  //!< Order in which particles are checked in countOverlaps
+
         Scalar m_extra_image_width;                 //! Extra width to extend the image list
 
         Index2D m_overlap_idx;                      //!!< Indexer for interaction matrix
@@ -1203,12 +1210,13 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
 /*! \param timestep current step
     \param early_exit exit at first overlap found if true
     \returns number of overlaps if early_exit=false, 1 if early_exit=true
+
+    Errors in the overlap checks are added to the overlap_err_count counter.
 */
 template <class Shape>
 unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
     {
     unsigned int overlap_count = 0;
-    unsigned int err_count = 0;
 
     // build an up to date AABB tree
     buildAABBTree();
@@ -1225,15 +1233,45 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
     // access parameters and interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
-    // Loop over all particles
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    const unsigned int N = m_pdata->getN();
+
+    // particles that were closest to a neighbor at the last check are the most likely to overlap now, check them first
+    m_overlap_gap.resize(m_pdata->getMaximumTag()+1, OverlapReal(0.0));
+    m_overlap_order.resize(N);
+    std::iota(m_overlap_order.begin(), m_overlap_order.end(), 0);
+    if (early_exit)
+        {
+        auto smaller_gap = [&](unsigned int a, unsigned int b)
+            {
+            return m_overlap_gap[h_tag.data[a]] < m_overlap_gap[h_tag.data[b]];
+            };
+
+        // only order the few most likely candidates, the rest are checked in index order
+        const unsigned int n_first = std::min(N, 256u);
+        std::nth_element(m_overlap_order.begin(), m_overlap_order.begin() + n_first, m_overlap_order.end(),
+                         smaller_gap);
+        std::sort(m_overlap_order.begin(), m_overlap_order.begin() + n_first, smaller_gap);
+        }
+
+    // set when an overlap is found in early exit mode, so that all threads stop
+    std::atomic<bool> found_overlap(false);
+
+    // errors encountered by the overlap checks in all threads
+    std::atomic<unsigned int> overlap_err_count(0);
+
+    // count the overlaps of particle i and record its smallest circumsphere gap to a neighbor
+    auto count_particle = [&](unsigned int i, unsigned int& err_count)->unsigned int
         {
+        unsigned int count = 0;
+
         // read in the current position and orientation
         Scalar4 postype_i = h_postype.data[i];
         Scalar4 orientation_i = h_orientation.data[i];
         unsigned int typ_i = __scalar_as_int(postype_i.w);
         Shape shape_i(quat<Scalar>(orientation_i), m_params[typ_i]);
         vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+        OverlapReal R_i = shape_i.getCircumsphereDiameter()*OverlapReal(0.5);
+        OverlapReal gap_i = std::numeric_limits<OverlapReal>::max();
 
         // Check particle against AABB tree for neighbors
         detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
@@ -1270,13 +1308,19 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
                             unsigned int typ_j = __scalar_as_int(postype_j.w);
                             Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
 
+                            if (!h_overlaps.data[m_overlap_idx(typ_i,typ_j)])
+                                continue;
+
+                            OverlapReal gap = fast::sqrt(OverlapReal(dot(r_ij,r_ij))) - R_i
+                                - shape_j.getCircumsphereDiameter()*OverlapReal(0.5);
+                            gap_i = std::min(gap_i, gap);
+
                             if (h_tag.data[i] <= h_tag.data[j]
-                                && h_overlaps.data[m_overlap_idx(typ_i,typ_j)]
                                 && check_circumsphere_overlap(r_ij, shape_i, shape_j)
                                 && test_overlap(r_ij, shape_i, shape_j, err_count)
                                 && test_overlap(-r_ij, shape_j, shape_i, err_count))
                                 {
-                                overlap_count++;
+                                count++;
                                 if (early_exit)
                                     {
                                     // exit early from loop over neighbor particles
@@ -1292,23 +1336,67 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
                     cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
                     }
 
-                if (overlap_count && early_exit)
+                if (early_exit && (count || found_overlap.load(std::memory_order_relaxed)))
                     {
                     break;
                     }
                 } // end loop over AABB nodes
 
-            if (overlap_count && early_exit)
+            if (early_exit && (count || found_overlap.load(std::memory_order_relaxed)))
                 {
                 break;
                 }
             } // end loop over images
 
+        if (count && early_exit)
+            {
+            found_overlap.store(true, std::memory_order_relaxed);
+
+            // an overlapping particle is the first to check next time
+            gap_i = -std::numeric_limits<OverlapReal>::max();
+            }
+
+        // a check that was cut short by another thread keeps the old gap
+        if (!early_exit || count || !found_overlap.load(std::memory_order_relaxed))
+            m_overlap_gap[h_tag.data[i]] = gap_i;
+
+        return count;
+        };
+
+    // Loop over all particles
+    #ifdef ENABLE_TBB
+    overlap_count = tbb::parallel_reduce(tbb::blocked_range<unsigned int>(0, N),
+        0u,
+        [&](const tbb::blocked_range<unsigned int>& r, unsigned int count)->unsigned int {
+        unsigned int err_count = 0;
+        for (unsigned int k = r.begin(); k != r.end(); ++k)
+            {
+            if (early_exit && found_overlap.load(std::memory_order_relaxed))
+                break;
+
+            count += count_particle(m_overlap_order[k], err_count);
+            }
+        overlap_err_count += err_count;
+        return count;
+        }, [](unsigned int x, unsigned int y)->unsigned int { return x+y; } );
+    #else
+    unsigned int err_count = 0;
+    for (unsigned int k = 0; k < N; k++)
+        {
+        overlap_count += count_particle(m_overlap_order[k], err_count);
+
         if (overlap_count && early_exit)
             {
             break;
             }
         } // end loop over particles
+    overlap_err_count = err_count;
+    #endif
+
+        {
+        ArrayHandle<hpmc_counters_t> h_counters(m_count_total, access_location::host, access_mode::readwrite);
+        h_counters.data[0].overlap_err_count += overlap_err_count;
+        }
 
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
 
@@ -21,12 +21,16 @@ class free_volume(Compute):
         type (str): Type of particle to use for integration
         nsample (int): Number of samples to use in MC integration
         suffix (str): Suffix to use for log quantity
+        tolerance (float): Relative standard error at which to stop the integration early (**optional**, CPU only)
 
     :py:class`free_volume` computes the free volume of a particle assembly using stochastic integration with a test particle type.
     It works together with an HPMC integrator, which defines the particle types used in the simulation.
     As parameters it requires the number of MC integration samples (*nsample*), and the type of particle (*test_type*)
     to use for the integration.
 
+    When *tolerance* is set, the samples are taken in batches and the integration stops once the relative
+    standard error of the free volume falls below *tolerance*, so that *nsample* is the maximum number of samples.
+
     Once initialized, the compute provides a log quantity
     called **hpmc_free_volume**, that can be logged via ``hoomd.analyze.log``.
     If a suffix is specified, the log quantities name will be
@@ -39,7 +43,7 @@ class free_volume(Compute):
         log = analyze.log(quantities=['hpmc_free_volume'], period=100, filename='log.dat', overwrite=True)
 
     """
-    def __init__(self, mc, seed, suffix='', test_type=None, nsample=None):
+    def __init__(self, mc, seed, suffix='', test_type=None, nsample=None, tolerance=None):
 
         # initialize base class
         _compute.__init__(self);
@@ -124,6 +128,8 @@ class free_volume(Compute):
             self.cpp_compute.setTestParticleType(itype)
         if nsample is not None:
             self.cpp_compute.setNumSamples(int(nsample))
+        if tolerance is not None:
+            self.cpp_compute.setRelativeTolerance(float(tolerance))
 
         hoomd.context.current.system.addCompute(self.cpp_compute, self.compute_name)
         self.enabled = True
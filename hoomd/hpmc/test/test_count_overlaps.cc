@@ -0,0 +1,175 @@
+
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/BoxDim.h"
+#include "hoomd/SystemDefinition.h"
+
+#include "hoomd/hpmc/IntegratorHPMCMono.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+
+#include <iostream>
+#include <random>
+
+#include <pybind11/pybind11.h>
+#include <memory>
+
+using namespace std;
+using namespace hpmc;
+
+//! Count the overlapping pairs of spheres of diameter d by checking all pairs
+unsigned int count_pairs(std::shared_ptr<ParticleData> pdata, Scalar d)
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    const BoxDim& box = pdata->getBox();
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        for (unsigned int j = i+1; j < pdata->getN(); j++)
+            {
+            vec3<Scalar> r_ij = vec3<Scalar>(box.minImage(make_scalar3(h_pos.data[j].x - h_pos.data[i].x,
+                                                                       h_pos.data[j].y - h_pos.data[i].y,
+                                                                       h_pos.data[j].z - h_pos.data[i].z)));
+            if (dot(r_ij, r_ij) < d*d)
+                count++;
+            }
+    return count;
+    }
+
+//! Place N spheres at random positions in a cubic box of side L
+std::shared_ptr<SystemDefinition> random_system(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                                unsigned int N,
+                                                Scalar L)
+    {
+    auto sysdef = std::make_shared<SystemDefinition>(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf);
+    auto pdata = sysdef->getParticleData();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<Scalar> u(-L/Scalar(2.0), L/Scalar(2.0));
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    for (unsigned int i = 0; i < N; i++)
+        h_pos.data[i] = make_scalar4(u(rng), u(rng), u(rng), __int_as_scalar(0));
+
+    return sysdef;
+    }
+
+//! Test that the overlap count matches a check of all pairs for different numbers of threads
+UP_TEST( count_overlaps_all_pairs )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = random_system(exec_conf, 1000, Scalar(15.0));
+
+    auto mc = std::make_shared< IntegratorHPMCMono<ShapeSphere> >(sysdef, 1);
+    SphereParams par;
+    par.radius = 0.25;
+    par.ignore = 0;
+    par.isOriented = false;
+    mc->setParam(0, par);
+
+    unsigned int expected = count_pairs(sysdef->getParticleData(), Scalar(0.5));
+    UP_ASSERT(expected > 0);
+
+    #ifdef ENABLE_TBB
+    for (unsigned int num_threads : {1, 4})
+        {
+        exec_conf->setNumThreads(num_threads);
+    #endif
+        UP_ASSERT_EQUAL(mc->countOverlaps(false), expected);
+
+        // early exit reports at least one overlap, and does not change the next full count
+        UP_ASSERT(mc->countOverlaps(true) >= 1);
+        UP_ASSERT(mc->countOverlaps(true) >= 1);
+        UP_ASSERT_EQUAL(mc->countOverlaps(false), expected);
+    #ifdef ENABLE_TBB
+        }
+    #endif
+    }
+
+//! Test that early exit reports no overlaps when there are none
+UP_TEST( count_overlaps_none )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = random_system(exec_conf, 1000, Scalar(15.0));
+
+    // shrink the spheres until they do not overlap
+    auto mc = std::make_shared< IntegratorHPMCMono<ShapeSphere> >(sysdef, 1);
+    SphereParams par;
+    par.radius = 0.01;
+    par.ignore = 0;
+    par.isOriented = false;
+    mc->setParam(0, par);
+
+    UP_ASSERT_EQUAL(count_pairs(sysdef->getParticleData(), Scalar(0.02)), 0u);
+
+    #ifdef ENABLE_TBB
+    for (unsigned int num_threads : {1, 4})
+        {
+        exec_conf->setNumThreads(num_threads);
+    #endif
+        UP_ASSERT_EQUAL(mc->countOverlaps(false), 0u);
+        UP_ASSERT_EQUAL(mc->countOverlaps(true), 0u);
+    #ifdef ENABLE_TBB
+        }
+    #endif
+    }
+
+//! Test that early exit finds an overlap of particles outside of the candidates it checks first
+UP_TEST( count_overlaps_new_overlap )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = random_system(exec_conf, 1000, Scalar(15.0));
+    auto pdata = sysdef->getParticleData();
+
+    auto mc = std::make_shared< IntegratorHPMCMono<ShapeSphere> >(sysdef, 1);
+    SphereParams par;
+    par.radius = 0.01;
+    par.ignore = 0;
+    par.isOriented = false;
+    mc->setParam(0, par);
+
+    // record the gaps of the overlap free system
+    UP_ASSERT_EQUAL(mc->countOverlaps(true), 0u);
+
+    // the two particles with the largest gaps are checked last
+    unsigned int i = 0, j = 1;
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        const BoxDim& box = pdata->getBox();
+        std::vector<Scalar> gap(pdata->getN(), std::numeric_limits<Scalar>::max());
+        for (unsigned int a = 0; a < pdata->getN(); a++)
+            for (unsigned int b = 0; b < pdata->getN(); b++)
+                {
+                if (a == b)
+                    continue;
+                vec3<Scalar> r_ab = vec3<Scalar>(box.minImage(make_scalar3(h_pos.data[b].x - h_pos.data[a].x,
+                                                                           h_pos.data[b].y - h_pos.data[a].y,
+                                                                           h_pos.data[b].z - h_pos.data[a].z)));
+                gap[a] = std::min(gap[a], dot(r_ab, r_ab));
+                }
+        for (unsigned int a = 0; a < pdata->getN(); a++)
+            {
+            if (gap[a] > gap[i])
+                {
+                j = i;
+                i = a;
+                }
+            else if (a != i && gap[a] > gap[j])
+                j = a;
+            }
+        }
+
+    // move them on top of each other
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[j].x = h_pos.data[i].x + Scalar(0.005);
+        h_pos.data[j].y = h_pos.data[i].y;
+        h_pos.data[j].z = h_pos.data[i].z;
+        }
+    mc->invalidateAABBTree();
+
+    UP_ASSERT_EQUAL(mc->countOverlaps(true), 1u);
+    UP_ASSERT_EQUAL(mc->countOverlaps(false), 1u);
+    UP_ASSERT_EQUAL(mc->countOverlaps(true), 1u);
+    }
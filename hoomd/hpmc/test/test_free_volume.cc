@@ -0,0 +1,100 @@
+
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/CellList.h"
+#include "hoomd/Communicator.h"
+#include "hoomd/SystemDefinition.h"
+
+#include "hoomd/hpmc/ComputeFreeVolume.h"
+#include "hoomd/hpmc/IntegratorHPMCMono.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+
+#include <iostream>
+
+#include <pybind11/pybind11.h>
+#include <memory>
+
+using namespace std;
+using namespace hpmc;
+
+//! Test the free volume when one rank loses all of its particles
+/*! 64 spheres of radius 0.5 are placed on a lattice in the whole box and then moved into the domain of the first
+    rank. The free volume of a point particle is the box volume minus the volume of the spheres, in both cases.
+*/
+UP_TEST( free_volume_empty_rank )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    const Scalar L = 20.0;
+    const unsigned int n = 4;
+    const unsigned int N = n*n*n;
+
+    auto sysdef = std::make_shared<SystemDefinition>(N, BoxDim(L), 2, 0, 0, 0, 0, exec_conf);
+    auto pdata = sysdef->getParticleData();
+
+    // spread the spheres over the whole box
+    for (unsigned int i = 0; i < n; i++)
+        for (unsigned int j = 0; j < n; j++)
+            for (unsigned int k = 0; k < n; k++)
+                {
+                unsigned int tag = i*n*n + j*n + k;
+                pdata->setPosition(tag, make_scalar3(-7.5 + 5.0*i, -7.5 + 5.0*j, -7.5 + 5.0*k), false);
+                }
+
+    // split the box along x
+    SnapshotParticleData<Scalar> snap(N);
+    pdata->takeSnapshot(snap);
+    auto decomposition = std::make_shared<DomainDecomposition>(exec_conf, pdata->getBox().getL(), 2, 1, 1);
+    auto comm = std::make_shared<Communicator>(sysdef, decomposition);
+    pdata->setDomainDecomposition(decomposition);
+    pdata->initializeFromSnapshot(snap);
+
+    auto mc = std::make_shared< IntegratorHPMCMono<ShapeSphere> >(sysdef, 1);
+    SphereParams sphere;
+    sphere.radius = 0.5;
+    sphere.ignore = 0;
+    sphere.isOriented = false;
+    mc->setParam(0, sphere);
+    SphereParams point = sphere;
+    point.radius = 0.0;
+    mc->setParam(1, point);
+    mc->setCommunicator(comm);
+
+    auto free_volume = std::make_shared< ComputeFreeVolume<ShapeSphere> >(sysdef, mc, std::make_shared<CellList>(sysdef), 7, "");
+    free_volume->setCommunicator(comm);
+    free_volume->setTestParticleType(1);
+    free_volume->setNumSamples(400000);
+
+    // the statistical error is about 0.8
+    const Scalar expected = L*L*L - Scalar(N)*Scalar(4.0/3.0*M_PI)*sphere.radius*sphere.radius*sphere.radius;
+    Scalar V_free = free_volume->getLogValue("hpmc_free_volume", 0);
+    UP_ASSERT(std::abs(V_free - expected) < 4.0);
+
+    // move all spheres to the domain of the first rank, away from the domain boundaries
+    std::vector<Scalar4> old_pos;
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        old_pos.assign(h_pos.data, h_pos.data + pdata->getN());
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        for (unsigned int idx = 0; idx < pdata->getN(); idx++)
+            h_pos.data[idx].x = -7.0 + Scalar(h_tag.data[idx] / (n*n));
+        }
+    mc->communicate(true);
+    UP_ASSERT_EQUAL(pdata->getNGlobal(), N);
+    if (exec_conf->getRank() == 1)
+        UP_ASSERT_EQUAL(pdata->getN(), 0u);
+
+    // the entries past the local and ghost particles are not particle data, fill them with the old positions so that
+    // they are counted if they are read
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        for (unsigned int idx = pdata->getN() + pdata->getNGhosts(); idx < old_pos.size(); idx++)
+            h_pos.data[idx] = old_pos[idx];
+        }
+
+    V_free = free_volume->getLogValue("hpmc_free_volume", 1);
+    UP_ASSERT(std::abs(V_free - expected) < 4.0);
+    }
@@ -11,6 +11,11 @@
 
 #include <vector>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 using namespace hoomd;
 namespace py = pybind11;
@@ -34,7 +39,7 @@ ActiveForceCompute::ActiveForceCompute(std::shared_ptr<SystemDefinition> sysdef,
                                         Scalar ry,
                                         Scalar rz)
         : ForceCompute(sysdef), m_group(group),
-            m_rotationDiff(rotation_diff), m_P(P), m_rx(rx), m_ry(ry), m_rz(rz)
+            m_rotationDiff(rotation_diff), m_P(P), m_rx(rx), m_ry(ry), m_rz(rz), last_computed(0xffffffff)
     {
 
     // In case of MPI run, every rank should be initialized with the same seed.
@@ -189,6 +194,10 @@ pybind11::tuple ActiveForceCompute::getActiveTorque(const std::string& type_name
     }
 
 /*! This function sets appropriate active forces on all active particles.
+
+    The scaled per-type force and torque vectors are computed once up front, so that the loop over the group only
+    rotates them into the frame of each particle. Every iteration writes only to its own particle, so the group is
+    split across threads when TBB is enabled.
 */
 void ActiveForceCompute::setForces()
     {
@@ -200,6 +209,7 @@ void ActiveForceCompute::setForces()
     ArrayHandle<Scalar4> h_torque(m_torque,access_location::host,access_mode::overwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
 
     // sanity check
     assert(h_f_actVec.data != NULL);
@@ -211,26 +221,48 @@ void ActiveForceCompute::setForces()
     memset(h_force.data, 0, sizeof(Scalar4) * m_force.getNumElements());
     memset(h_torque.data, 0, sizeof(Scalar4) * m_force.getNumElements());
 
-    for (unsigned int i = 0; i < m_group->getNumMembers(); i++)
+    // active force and torque of each type in the particle frame
+    unsigned int ntypes = m_pdata->getNTypes();
+    std::vector< vec3<Scalar> > f_type(ntypes);
+    std::vector< vec3<Scalar> > t_type(ntypes);
+    for (unsigned int type = 0; type < ntypes; type++)
+        {
+        f_type[type] = h_f_actVec.data[type].w*vec3<Scalar>(h_f_actVec.data[type]);
+        t_type[type] = h_t_actVec.data[type].w*vec3<Scalar>(h_t_actVec.data[type]);
+        }
+
+    auto set_force = [&](unsigned int i)
         {
-        unsigned int idx = m_group->getMemberIndex(i);
+        unsigned int idx = h_index.data[i];
         unsigned int type = __scalar_as_int(h_pos.data[idx].w);
 
-        vec3<Scalar> f(h_f_actVec.data[type].w*h_f_actVec.data[type].x, h_f_actVec.data[type].w*h_f_actVec.data[type].y, h_f_actVec.data[type].w*h_f_actVec.data[type].z);
         quat<Scalar> quati(h_orientation.data[idx]);
-        vec3<Scalar> fi = rotate(quati, f);
-        h_force.data[idx] = vec_to_scalar4(fi, 0);
-
-        vec3<Scalar> t(h_t_actVec.data[type].w*h_t_actVec.data[type].x, h_t_actVec.data[type].w*h_t_actVec.data[type].y, h_t_actVec.data[type].w*h_t_actVec.data[type].z);
-        vec3<Scalar> ti = rotate(quati, t);
-        h_torque.data[idx] = vec_to_scalar4(ti, 0);
-        }
+        h_force.data[idx] = vec_to_scalar4(rotate(quati, f_type[type]), 0);
+        h_torque.data[idx] = vec_to_scalar4(rotate(quati, t_type[type]), 0);
+        };
+
+    unsigned int group_size = m_group->getNumMembers();
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, group_size),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            set_force(i);
+        });
+    #else
+    for (unsigned int i = 0; i < group_size; i++)
+        set_force(i);
+    #endif
     }
 
 
 /*! This function applies rotational diffusion to the orientations of all active particles. The orientation of any torque vector
  * relative to the force vector is preserved
     \param timestep Current timestep
+
+    Each particle draws its random numbers from its own stream, seeded by its tag and the time step. The result is
+    therefore independent of the order in which the particles are processed, of the number of threads, and of the
+    domain decomposition.
 */
 void ActiveForceCompute::rotationalDiffusion(unsigned int timestep)
     {
@@ -239,15 +271,20 @@ void ActiveForceCompute::rotationalDiffusion(unsigned int timestep)
     ArrayHandle<Scalar4> h_pos(m_pdata -> getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
 
     assert(h_f_actVec.data != NULL);
     assert(h_pos.data != NULL);
     assert(h_orientation.data != NULL);
     assert(h_tag.data != NULL);
 
-    for (unsigned int i = 0; i < m_group->getNumMembers(); i++)
+    const bool two_d = m_sysdef->getNDimensions() == 2;
+    const bool constrained = m_rx != 0;
+    EvaluatorConstraintEllipsoid Ellipsoid(m_P, m_rx, m_ry, m_rz);
+
+    auto diffuse = [&](unsigned int i)
         {
-        unsigned int idx = m_group->getMemberIndex(i);
+        unsigned int idx = h_index.data[i];
         unsigned int type = __scalar_as_int(h_pos.data[idx].w);
         unsigned int ptag = h_tag.data[idx];
         hoomd::RandomGenerator rng(hoomd::RNGIdentifier::ActiveForceCompute, m_seed, ptag, timestep);
@@ -255,7 +292,7 @@ void ActiveForceCompute::rotationalDiffusion(unsigned int timestep)
         quat<Scalar> quati(h_orientation.data[idx]);
 
 
-        if (m_sysdef->getNDimensions() == 2) // 2D
+        if (two_d) // 2D
             {
             Scalar delta_theta; // rotational diffusion angle
             delta_theta = hoomd::NormalDistribution<Scalar>(m_rotationConst)(rng);
@@ -273,7 +310,7 @@ void ActiveForceCompute::rotationalDiffusion(unsigned int timestep)
             }
         else // 3D: Following Stenhammar, Soft Matter, 2014
             {
-            if (m_rx == 0) // if no constraint
+            if (!constrained) // if no constraint
                 {
                 hoomd::SpherePointGenerator<Scalar> unit_vec;
                 vec3<Scalar> rand_vec;
@@ -300,8 +337,6 @@ void ActiveForceCompute::rotationalDiffusion(unsigned int timestep)
                 }
             else // if constraint exists
                 {
-                EvaluatorConstraintEllipsoid Ellipsoid(m_P, m_rx, m_ry, m_rz);
-
                 Scalar3 current_pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
                 Scalar3 norm_scalar3 = Ellipsoid.evalNormal(current_pos); // the normal vector to which the particles are confined.
 
@@ -316,7 +351,20 @@ void ActiveForceCompute::rotationalDiffusion(unsigned int timestep)
                 h_orientation.data[idx] = quat_to_scalar4(quati);
                 }
             }
-        }
+        };
+
+    unsigned int group_size = m_group->getNumMembers();
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, group_size),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            diffuse(i);
+        });
+    #else
+    for (unsigned int i = 0; i < group_size; i++)
+        diffuse(i);
+    #endif
     }
 
 /*! This function sets an ellipsoid surface constraint for all active particles. Torque is not considered here
@@ -329,14 +377,15 @@ void ActiveForceCompute::setConstraint()
     ArrayHandle<Scalar4> h_f_actVec(m_f_activeVec, access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata -> getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
 
     assert(h_f_actVec.data != NULL);
     assert(h_pos.data != NULL);
     assert(h_orientation.data != NULL);
 
-    for (unsigned int i = 0; i < m_group->getNumMembers(); i++)
+    auto constrain = [&](unsigned int i)
         {
-        unsigned int idx = m_group->getMemberIndex(i);
+        unsigned int idx = h_index.data[i];
         unsigned int type = __scalar_as_int(h_pos.data[idx].w);
 
         Scalar3 current_pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
@@ -376,7 +425,20 @@ void ActiveForceCompute::setConstraint()
         quati = rot_quat*quati;
 
         h_orientation.data[idx] = quat_to_scalar4(quati);
-        }
+        };
+
+    unsigned int group_size = m_group->getNumMembers();
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, group_size),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            constrain(i);
+        });
+    #else
+    for (unsigned int i = 0; i < group_size; i++)
+        constrain(i);
+    #endif
     }
 
 /*! This function applies constraints, rotational diffusion, and sets forces for all active particles
@@ -104,7 +104,7 @@ class PYBIND11_EXPORT ActiveForceCompute : public ForceCompute
 
         GlobalVector<Scalar4> m_t_activeVec; //! active torque unit vectors and magnitudes for each particle type
 
-        unsigned int last_computed;
+        unsigned int last_computed;           //!< Last time step the orientations were updated
     };
 
 //! Exports the ActiveForceComputeClass to python
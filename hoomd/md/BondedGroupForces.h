@@ -0,0 +1,210 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/BondedGroupData.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+/*! \file BondedGroupForces.h
+    \brief Defines a helper that sums the forces of bonded groups on the CPU
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __BONDED_GROUP_FORCES_H__
+#define __BONDED_GROUP_FORCES_H__
+
+//! Force, energy and virial of a bonded group on one of its members
+struct bonded_entry_forces
+    {
+    Scalar4 force;      //!< Force on the member (x,y,z) and energy share (w)
+    Scalar virial[6];   //!< Virial share of the member
+    };
+
+//! Sum the forces, energies and virials of bonded groups on the particles
+/*! \param group_data Bonded groups to evaluate
+    \param n_particles Forces are summed for the particles with index 0 to n_particles-1 (N, or N+Nghosts)
+    \param h_force Force array, zeroed by the caller
+    \param h_virial Virial array, zeroed by the caller
+    \param virial_pitch Pitch of the virial array
+    \param compute_group Functor that evaluates a single group
+    \param entry_forces Buffer for the group forces, kept by the caller between computes
+
+    The groups are visited through the CPU table of \a group_data, which lists the groups of every particle
+    contiguously in particle index order. compute_group is called as
+    \code
+    bool compute_group(const unsigned int *idx, unsigned int type, Scalar3 *force, Scalar& energy, Scalar *virial)
+    \endcode
+    with the particle indices of the group members in group order. It sets the force on every member, and the
+    energy and virial share of each member (the same for all members), and returns false if the group could not be
+    evaluated.
+
+    Every group is evaluated once, by its first member, in particle index order. With TBB, the group forces are
+    evaluated in parallel and stored in \a entry_forces at the CPU table entries of the members, so that every
+    particle then sums its own contiguous entries and no two threads write to the same particle. \a entry_forces
+    is only grown, and not cleared, because every entry is overwritten. Without TBB, the forces are scattered
+    directly to all members and \a entry_forces is not used.
+
+    \returns true if all groups were evaluated successfully
+*/
+template<class GroupData, class Functor>
+bool computeBondedGroupForces(std::shared_ptr<GroupData> group_data,
+                              unsigned int n_particles,
+                              Scalar4 *h_force,
+                              Scalar *h_virial,
+                              unsigned int virial_pitch,
+                              const Functor& compute_group,
+                              std::vector<bonded_entry_forces>& entry_forces)
+    {
+    const unsigned int group_size = GroupData::size;
+
+    ArrayHandle<typename GroupData::members_t> h_table(group_data->getCPUTable(), access_location::host,
+        access_mode::read);
+    ArrayHandle<unsigned int> h_pos_table(group_data->getCPUPosTable(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_offsets(group_data->getCPUTableOffsets(), access_location::host, access_mode::read);
+
+    // number of local and ghost particles in the table
+    const unsigned int n_rows = group_data->getCPUTableOffsets().size() - 1;
+
+    // the members of an entry in group order, with particle i at position pos
+    auto get_members = [&](unsigned int i, unsigned int entry, unsigned int *idx)
+        {
+        const typename GroupData::members_t& g = h_table.data[entry];
+        const unsigned int pos = h_pos_table.data[entry];
+        for (unsigned int j = 0, n = 0; j < group_size; ++j)
+            idx[j] = (j == pos) ? i : g.idx[n++];
+        };
+
+    #ifdef ENABLE_TBB
+    std::atomic<bool> success(true);
+
+    ArrayHandle<unsigned int> h_group_idx_table(group_data->getCPUGroupIndexTable(), access_location::host,
+        access_mode::read);
+    ArrayHandle<unsigned int> h_group_entry_table(group_data->getCPUGroupEntryTable(), access_location::host,
+        access_mode::read);
+
+    const unsigned int n_entries = h_offsets.data[n_rows];
+    if (entry_forces.size() < n_entries)
+        entry_forces.resize(n_entries);
+
+    // evaluate every group once, at its first member
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_rows),
+        [&](const tbb::blocked_range<unsigned int>& range)
+        {
+        for (unsigned int i = range.begin(); i != range.end(); ++i)
+            {
+            for (unsigned int entry = h_offsets.data[i]; entry < h_offsets.data[i+1]; ++entry)
+                {
+                if (h_pos_table.data[entry] != 0)
+                    continue;
+
+                unsigned int idx[group_size];
+                get_members(i, entry, idx);
+
+                Scalar3 group_force[group_size];
+                Scalar group_energy(0.0);
+                Scalar group_virial[6];
+                if (!compute_group(idx, h_table.data[entry].idx[group_size-1], group_force, group_energy,
+                                   group_virial))
+                    {
+                    success = false;
+                    for (unsigned int j = 0; j < group_size; ++j)
+                        group_force[j] = make_scalar3(0.0, 0.0, 0.0);
+                    group_energy = Scalar(0.0);
+                    for (unsigned int k = 0; k < 6; ++k)
+                        group_virial[k] = Scalar(0.0);
+                    }
+
+                // store the share of every member at its own entry
+                const unsigned int *member_entries = h_group_entry_table.data
+                    + h_group_idx_table.data[entry]*group_size;
+                for (unsigned int j = 0; j < group_size; ++j)
+                    {
+                    bonded_entry_forces& e = entry_forces[member_entries[j]];
+                    e.force = make_scalar4(group_force[j].x, group_force[j].y, group_force[j].z, group_energy);
+                    for (unsigned int k = 0; k < 6; ++k)
+                        e.virial[k] = group_virial[k];
+                    }
+                }
+            }
+        });
+
+    // sum the forces of the groups of every particle
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_particles),
+        [&](const tbb::blocked_range<unsigned int>& range)
+        {
+        for (unsigned int i = range.begin(); i != range.end(); ++i)
+            {
+            Scalar4 f = make_scalar4(0.0, 0.0, 0.0, 0.0);
+            Scalar v[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+            for (unsigned int entry = h_offsets.data[i]; entry < h_offsets.data[i+1]; ++entry)
+                {
+                const bonded_entry_forces& e = entry_forces[entry];
+                f.x += e.force.x;
+                f.y += e.force.y;
+                f.z += e.force.z;
+                f.w += e.force.w;
+                for (unsigned int k = 0; k < 6; ++k)
+                    v[k] += e.virial[k];
+                }
+
+            h_force[i] = f;
+            for (unsigned int k = 0; k < 6; ++k)
+                h_virial[k*virial_pitch+i] = v[k];
+            }
+        });
+
+    return success;
+    #else
+    bool success = true;
+
+    // every group is evaluated once, at its first member
+    for (unsigned int i = 0; i < n_rows; ++i)
+        {
+        for (unsigned int entry = h_offsets.data[i]; entry < h_offsets.data[i+1]; ++entry)
+            {
+            if (h_pos_table.data[entry] != 0)
+                continue;
+
+            unsigned int idx[group_size];
+            get_members(i, entry, idx);
+
+            Scalar3 group_force[group_size];
+            Scalar group_energy(0.0);
+            Scalar group_virial[6];
+            if (!compute_group(idx, h_table.data[entry].idx[group_size-1], group_force, group_energy, group_virial))
+                {
+                success = false;
+                continue;
+                }
+
+            for (unsigned int j = 0; j < group_size; ++j)
+                {
+                if (idx[j] >= n_particles)
+                    continue;
+
+                h_force[idx[j]].x += group_force[j].x;
+                h_force[idx[j]].y += group_force[j].y;
+                h_force[idx[j]].z += group_force[j].z;
+                h_force[idx[j]].w += group_energy;
+                for (unsigned int k = 0; k < 6; ++k)
+                    h_virial[k*virial_pitch+idx[j]] += group_virial[k];
+                }
+            }
+        }
+
+    return success;
+    #endif
+    }
+
+#endif
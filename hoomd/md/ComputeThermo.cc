@@ -28,7 +28,8 @@ using namespace std;
 ComputeThermo::ComputeThermo(std::shared_ptr<SystemDefinition> sysdef,
                              std::shared_ptr<ParticleGroup> group,
                              const std::string& suffix)
-    : Compute(sysdef), m_group(group), m_logging_enabled(true)
+    : Compute(sysdef), m_group(group), m_logging_enabled(true), m_kinetic_sums_valid(false),
+      m_use_kinetic_sums(false), m_kinetic_sums_timestep(0), m_has_ke_rot_sum(false), m_ke_rot_sum(0.0)
     {
     m_exec_conf->msg->notice(5) << "Constructing ComputeThermo" << endl;
 
@@ -79,14 +80,20 @@ ComputeThermo::~ComputeThermo()
 
 /*! Calls computeProperties if the properties need updating
     \param timestep Current time step of the simulation
+
+    Kinetic sums provided with setKineticSums() for \a timestep are used once and then discarded.
 */
 void ComputeThermo::compute(unsigned int timestep)
     {
     if (shouldCompute(timestep))
         {
+        m_use_kinetic_sums = m_kinetic_sums_valid && m_kinetic_sums_timestep == timestep;
         computeProperties();
         m_computed_flags = m_pdata->getFlags();
         }
+
+    m_kinetic_sums_valid = false;
+    m_use_kinetic_sums = false;
     }
 
 std::vector< std::string > ComputeThermo::getProvidedLogQuantities()
@@ -184,6 +191,10 @@ Scalar ComputeThermo::getLogValue(const std::string& quantity, unsigned int time
     }
 
 /*! Computes all thermodynamic properties of the system in one fell swoop.
+
+    The kinetic part is taken from the sums provided by the integration method when they are valid for this time
+    step. The potential energy and virial are taken from the sums that the integrator accumulated with the net force
+    when the group contains all particles. Only the remaining parts require a pass over the group members.
 */
 void ComputeThermo::computeProperties()
     {
@@ -220,7 +231,22 @@ void ComputeThermo::computeProperties()
     double pressure_kinetic_yz = 0.0;
     double pressure_kinetic_zz = 0.0;
 
-    if (flags[pdata_flag::pressure_tensor])
+    if (m_use_kinetic_sums)
+        {
+        if (flags[pdata_flag::pressure_tensor])
+            {
+            pressure_kinetic_xx = m_ke_tensor_sum[0];
+            pressure_kinetic_xy = m_ke_tensor_sum[1];
+            pressure_kinetic_xz = m_ke_tensor_sum[2];
+            pressure_kinetic_yy = m_ke_tensor_sum[3];
+            pressure_kinetic_yz = m_ke_tensor_sum[4];
+            pressure_kinetic_zz = m_ke_tensor_sum[5];
+            }
+
+        // kinetic energy = 1/2 trace of kinetic part of pressure tensor
+        ke_trans_total = Scalar(0.5)*(m_ke_tensor_sum[0] + m_ke_tensor_sum[3] + m_ke_tensor_sum[5]);
+        }
+    else if (flags[pdata_flag::pressure_tensor])
         {
         // Calculate kinetic part of pressure tensor
         for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
@@ -262,7 +288,11 @@ void ComputeThermo::computeProperties()
     // total rotational kinetic energy
     double ke_rot_total = 0.0;
 
-    if (flags[pdata_flag::rotational_kinetic_energy])
+    if (flags[pdata_flag::rotational_kinetic_energy] && m_use_kinetic_sums && m_has_ke_rot_sum)
+        {
+        ke_rot_total = m_ke_rot_sum;
+        }
+    else if (flags[pdata_flag::rotational_kinetic_energy])
         {
         // Calculate rotational part of kinetic energy
         ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
@@ -299,16 +329,29 @@ void ComputeThermo::computeProperties()
         ke_rot_total /= Scalar(2.0);
         }
 
+    // the sums over all local particles from the integrator apply if the group contains all particles
+    double net_energy_sum;
+    double net_virial_sum[6];
+    bool use_net_force_sums = m_group->getNumMembersGlobal() == m_pdata->getNGlobal()
+        && m_pdata->getNetForceSums(net_energy_sum, net_virial_sum);
+
     // total potential energy
     double pe_total = 0.0;
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    if (use_net_force_sums)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-
-        // ignore rigid body constituent particles in the sum
-        if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+        pe_total = net_energy_sum;
+        }
+    else
+        {
+        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
             {
-            pe_total += (double)h_net_force.data[j].w;
+            unsigned int j = m_group->getMemberIndex(group_idx);
+
+            // ignore rigid body constituent particles in the sum
+            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+                {
+                pe_total += (double)h_net_force.data[j].w;
+                }
             }
         }
 
@@ -322,7 +365,19 @@ void ComputeThermo::computeProperties()
     double virial_yz = m_pdata->getExternalVirial(4);
     double virial_zz = m_pdata->getExternalVirial(5);
 
-    if (flags[pdata_flag::pressure_tensor])
+    if (flags[pdata_flag::pressure_tensor] && use_net_force_sums)
+        {
+        virial_xx += net_virial_sum[0];
+        virial_xy += net_virial_sum[1];
+        virial_xz += net_virial_sum[2];
+        virial_yy += net_virial_sum[3];
+        virial_yz += net_virial_sum[4];
+        virial_zz += net_virial_sum[5];
+
+        // isotropic virial = 1/3 trace of virial tensor
+        W = Scalar(1./3.) * (virial_xx + virial_yy + virial_zz);
+        }
+    else if (flags[pdata_flag::pressure_tensor])
         {
         // Calculate upper triangular virial tensor
         unsigned int virial_pitch = net_virial.getPitch();
@@ -295,6 +295,26 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
         //! Calculates the requested log value and returns it
         virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
 
+        //! Provide the kinetic energy sums of the local group members for the next computation
+        /*! \param timestep Time step at which the sums are valid
+            \param ke_tensor Sums of m*v_a*v_b over the local members (xx, xy, xz, yy, yz, zz)
+            \param has_rotational True if \a ke_rot is valid
+            \param ke_rot Rotational kinetic energy of the local members
+
+            Integration methods call this after they update the velocities of the group of this compute, so that
+            compute() at \a timestep does not make another pass over the particle data. Like the properties computed
+            in a pass, the sums exclude rigid body constituent particles.
+        */
+        void setKineticSums(unsigned int timestep, const double *ke_tensor, bool has_rotational, double ke_rot)
+            {
+            m_kinetic_sums_timestep = timestep;
+            for (unsigned int i = 0; i < 6; i++)
+                m_ke_tensor_sum[i] = ke_tensor[i];
+            m_has_ke_rot_sum = has_rotational;
+            m_ke_rot_sum = ke_rot;
+            m_kinetic_sums_valid = true;
+            }
+
         //! Control the enable_logging flag
         /*! Set this flag to false to prevent this compute from providing logged quantities.
             This is useful for internal computes that should not appear in the logs.
@@ -315,6 +335,13 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
         /// Store the particle data flags used during the last computation
         PDataFlags m_computed_flags;
 
+        bool m_kinetic_sums_valid;              //!< True if kinetic sums have been provided
+        bool m_use_kinetic_sums;                //!< True if computeProperties() may use the kinetic sums
+        unsigned int m_kinetic_sums_timestep;   //!< Time step of the kinetic sums
+        double m_ke_tensor_sum[6];              //!< Sums of m*v_a*v_b over the local members
+        bool m_has_ke_rot_sum;                  //!< True if the rotational kinetic energy has been provided
+        double m_ke_rot_sum;                    //!< Rotational kinetic energy of the local members
+
         //! Does the actual computation
         virtual void computeProperties();
 
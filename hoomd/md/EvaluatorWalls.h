@@ -12,12 +12,16 @@
 #define __EVALUATOR_WALLS_H__
 
 #ifndef __HIPCC__
+#include <algorithm>
 #include <string>
+#include <vector>
 #endif
 
 #include "hoomd/BoxDim.h"
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/VectorMath.h"
+#include "hoomd/Index1D.h"
+#include "hoomd/ManagedArray.h"
 #include "WallData.h"
 
 #undef DEVICE
@@ -27,18 +31,42 @@
 #define DEVICE
 #endif
 
-// sets the max numbers for each wall geometry type
-const unsigned int MAX_N_SWALLS=20;
-const unsigned int MAX_N_CWALLS=20;
-const unsigned int MAX_N_PWALLS=60;
+//! Maximum number of wall culling cells along each box direction
+const unsigned int MAX_WALL_CELL_DIM=32;
 
+//! Extra distance added to the wall culling distance, relative to the culling distance
+/*! The wall culling cells remain valid while no point of the box moves farther than this from where it was when the
+    cells were built, so that they are not rebuilt on every box change.
+*/
+const Scalar WALL_CELL_BUFFER=0.1;
+
+//! Wall geometries applied by EvaluatorWalls
+/*! The walls are stored in variable length arrays, so there is no limit on the number of walls of each geometry.
+
+    A uniform grid of cells spanning the global box is used to cull walls that are out of range of a particle. Each
+    cell lists the walls (spheres first, then cylinders, then planes, each in increasing order) whose surface is within
+    \a r_cull of any point in the cell. The list is stored in CSR format, \a cell_walls[cell_head[c]:cell_head[c+1]]
+    gives the walls for cell \a c. Walls are identified by a single index: sphere \a k is \a k, cylinder \a k is
+    \a numSpheres + \a k, and plane \a k is \a numSpheres + \a numCylinders + \a k.
+
+    A cell grid with zero elements disables culling. See buildWallCellIndex().
+*/
 struct wall_type{
     unsigned int     numSpheres; // these data types come first, since the structs are aligned already
     unsigned int     numCylinders;
     unsigned int     numPlanes;
-    SphereWall       Spheres[MAX_N_SWALLS];
-    CylinderWall     Cylinders[MAX_N_CWALLS];
-    PlaneWall        Planes[MAX_N_PWALLS];
+    ManagedArray<SphereWall>    Spheres;
+    ManagedArray<CylinderWall>  Cylinders;
+    ManagedArray<PlaneWall>     Planes;
+
+    Index3D                     cell_indexer;   //!< Indexes the wall culling cells
+    ManagedArray<unsigned int>  cell_head;      //!< Offset of the first wall of each cell in cell_walls
+    ManagedArray<unsigned int>  cell_walls;     //!< Walls in range of each cell
+    BoxDim                      cell_box;       //!< Box the cells were built for
+    Scalar                      r_cull;         //!< Culling distance the cells were built for
+    Scalar                      r_buff;         //!< Box displacement the cells tolerate before they are rebuilt
+
+    wall_type() : numSpheres(0), numCylinders(0), numPlanes(0), cell_box(1.0), r_cull(-1.0), r_buff(0.0) {}
 };
 
 //! Applys a wall force from all walls in the field parameter
@@ -60,6 +88,23 @@ class EvaluatorWalls
         //! Constructs the external wall potential evaluator
         DEVICE EvaluatorWalls(Scalar3 pos, const BoxDim& box, const param_type& p, const field_type& f) : m_pos(pos), m_field(f), m_params(p)
             {
+            // find the culling cell, walls are only culled in normal mode
+            m_cell = NO_WALL_CELL;
+            if (m_field.cell_indexer.getNumElements() > 0 && m_params.rextrap <= Scalar(0.0))
+                {
+                Scalar3 frac = box.makeFraction(pos);
+                int ib = (int)(frac.x * m_field.cell_indexer.getW());
+                int jb = (int)(frac.y * m_field.cell_indexer.getH());
+                int kb = (int)(frac.z * m_field.cell_indexer.getD());
+
+                // particles outside of the box fall back to checking all walls
+                if (ib >= 0 && ib < (int)m_field.cell_indexer.getW() &&
+                    jb >= 0 && jb < (int)m_field.cell_indexer.getH() &&
+                    kb >= 0 && kb < (int)m_field.cell_indexer.getD())
+                    {
+                    m_cell = m_field.cell_indexer(ib, jb, kb);
+                    }
+                }
             }
 
         //! Test if evaluator needs Diameter
@@ -264,6 +309,25 @@ class EvaluatorWalls
                         }
                     }
                 }
+            else if (m_cell != NO_WALL_CELL) //normal mode, only walls in range of the cell
+                {
+                const unsigned int n_sphere_cyl = m_field.numSpheres + m_field.numCylinders;
+                for (unsigned int cur = m_field.cell_head[m_cell]; cur < m_field.cell_head[m_cell+1]; cur++)
+                    {
+                    unsigned int k = m_field.cell_walls[cur];
+                    if (k < m_field.numSpheres)
+                        drv = vecPtToWall(m_field.Spheres[k], position, inside);
+                    else if (k < n_sphere_cyl)
+                        drv = vecPtToWall(m_field.Cylinders[k - m_field.numSpheres], position, inside);
+                    else
+                        drv = vecPtToWall(m_field.Planes[k - n_sphere_cyl], position, inside);
+
+                    if (inside)
+                        {
+                        callEvaluator(F, energy, drv);
+                        }
+                    }
+                }
             else //normal mode
                 {
                 for (unsigned int k = 0; k < m_field.numSpheres; k++)
@@ -318,6 +382,10 @@ class EvaluatorWalls
         param_type  m_params;
         Scalar      di;
         Scalar      qi;
+        unsigned int m_cell;              //!< Wall culling cell of the particle
+
+        //! Flags a particle that is not in a culling cell
+        static const unsigned int NO_WALL_CELL = 0xffffffff;
     };
 
 template < class evaluator >
@@ -330,4 +398,150 @@ typename EvaluatorWalls<evaluator>::param_type make_wall_params(typename evaluat
     return params;
     }
 
+#ifndef __HIPCC__
+//! Build the cell index used to cull walls that are out of range
+/*! \param field Walls to index
+    \param box Global simulation box
+    \param r_cull Maximum distance from a wall at which a particle interacts with it
+    \param managed True if the index should be allocated in managed memory
+
+    The box is divided into cells of width at least \a r_cull, up to MAX_WALL_CELL_DIM cells along each direction.
+    A wall is listed for a cell when the distance from the cell center to the wall surface is within \a r_cull plus
+    the circumradius of the cell plus a buffer of WALL_CELL_BUFFER * \a r_cull. The cells are in fractional
+    coordinates, so the buffer keeps them valid while the box changes by less than the buffer (see
+    wallCellsValid()). A negative \a r_cull disables culling.
+*/
+inline void buildWallCellIndex(wall_type& field, const BoxDim& box, Scalar r_cull, bool managed)
+    {
+    field.cell_box = box;
+    field.r_cull = r_cull;
+    field.r_buff = WALL_CELL_BUFFER*r_cull;
+
+    const unsigned int n_walls = field.numSpheres + field.numCylinders + field.numPlanes;
+    if (r_cull < Scalar(0.0) || n_walls == 0)
+        {
+        field.cell_indexer = Index3D(0);
+        field.cell_head = ManagedArray<unsigned int>();
+        field.cell_walls = ManagedArray<unsigned int>();
+        return;
+        }
+
+    // size the cells by the perpendicular box widths
+    const Scalar3 L_perp = box.getNearestPlaneDistance();
+    unsigned int dim[3];
+    const Scalar L[3] = {L_perp.x, L_perp.y, L_perp.z};
+    for (unsigned int d = 0; d < 3; ++d)
+        {
+        dim[d] = MAX_WALL_CELL_DIM;
+        if (r_cull > Scalar(0.0) && L[d] / r_cull < Scalar(MAX_WALL_CELL_DIM))
+            dim[d] = (unsigned int)(L[d] / r_cull);
+        if (dim[d] == 0)
+            dim[d] = 1;
+        }
+    field.cell_indexer = Index3D(dim[0], dim[1], dim[2]);
+    const unsigned int n_cells = field.cell_indexer.getNumElements();
+
+    // every point of a cell lies within this distance of its center
+    const vec3<Scalar> a(box.getLatticeVector(0)), b(box.getLatticeVector(1)), c(box.getLatticeVector(2));
+    const Scalar cell_radius = Scalar(0.5)*(fast::sqrt(dot(a,a))/Scalar(dim[0])
+                                            + fast::sqrt(dot(b,b))/Scalar(dim[1])
+                                            + fast::sqrt(dot(c,c))/Scalar(dim[2]));
+    const Scalar r_max = r_cull + cell_radius + field.r_buff;
+
+    // list the walls in range of each cell
+    std::vector<unsigned int> head(n_cells+1, 0);
+    std::vector<unsigned int> walls;
+    for (unsigned int cell = 0; cell < n_cells; ++cell)
+        {
+        head[cell] = walls.size();
+
+        uint3 t = field.cell_indexer.getTriple(cell);
+        Scalar3 f = make_scalar3((Scalar(t.x)+Scalar(0.5))/Scalar(dim[0]),
+                                 (Scalar(t.y)+Scalar(0.5))/Scalar(dim[1]),
+                                 (Scalar(t.z)+Scalar(0.5))/Scalar(dim[2]));
+        vec3<Scalar> center(box.makeCoordinates(f));
+
+        for (unsigned int k = 0; k < field.numSpheres; ++k)
+            {
+            if (fabs(distWall(field.Spheres[k], center)) <= r_max)
+                walls.push_back(k);
+            }
+        for (unsigned int k = 0; k < field.numCylinders; ++k)
+            {
+            if (fabs(distWall(field.Cylinders[k], center)) <= r_max)
+                walls.push_back(field.numSpheres + k);
+            }
+        for (unsigned int k = 0; k < field.numPlanes; ++k)
+            {
+            if (fabs(distWall(field.Planes[k], center)) <= r_max)
+                walls.push_back(field.numSpheres + field.numCylinders + k);
+            }
+        }
+    head[n_cells] = walls.size();
+
+    field.cell_head = ManagedArray<unsigned int>(n_cells+1, managed);
+    std::copy(head.begin(), head.end(), field.cell_head.get());
+    field.cell_walls = ManagedArray<unsigned int>(walls.size(), managed);
+    std::copy(walls.begin(), walls.end(), field.cell_walls.get());
+    }
+
+//! Test if the wall culling cells are still valid in a box
+/*! \param field Walls with a cell index
+    \param box Current global simulation box
+
+    A point with fractional coordinates f is displaced by box.makeCoordinates(f) - field.cell_box.makeCoordinates(f).
+    The displacement is affine in f, so its largest magnitude is found at a corner of the box. The cells remain valid
+    while it does not exceed the buffer they were built with.
+*/
+inline bool wallCellsValid(const wall_type& field, const BoxDim& box)
+    {
+    // without cells, the walls are not culled in any box
+    if (box == field.cell_box || field.cell_indexer.getNumElements() == 0)
+        return true;
+
+    Scalar max_dr_sq(0.0);
+    for (unsigned int corner = 0; corner < 8; ++corner)
+        {
+        Scalar3 frac = make_scalar3(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+        vec3<Scalar> dr = vec3<Scalar>(box.makeCoordinates(frac)) - vec3<Scalar>(field.cell_box.makeCoordinates(frac));
+        max_dr_sq = std::max(max_dr_sq, dot(dr, dr));
+        }
+    return max_dr_sq <= field.r_buff*field.r_buff;
+    }
+
+//! Update the wall culling index when the box or the interaction range changes
+/*! \param field Walls to index
+    \param box Global simulation box
+    \param params Per-type wall parameters
+    \param n_types Number of particle types
+    \param d_max Maximum particle diameter (only used by evaluators that need the diameter)
+    \param managed True if the index should be allocated in managed memory
+    \param force Rebuild even when the box and range are unchanged
+    \tparam evaluator EvaluatorWalls instantiation applying the walls
+
+    Types with an extrapolated potential interact with walls at any distance, so they are excluded from the culling
+    distance and evaluate all walls.
+*/
+template<class evaluator, class param_type>
+void updateExternalField(wall_type& field, const BoxDim& box, const param_type *params,
+                         unsigned int n_types, Scalar d_max, bool managed, bool force)
+    {
+    Scalar r_cull = Scalar(-1.0);
+    for (unsigned int i = 0; i < n_types; ++i)
+        {
+        if (params[i].rextrap > Scalar(0.0))
+            continue;
+
+        Scalar r_cut = fast::sqrt(params[i].rcutsq);
+        // diameter shifted potentials extend the range by up to half the diameter
+        if (evaluator::needsDiameter())
+            r_cut += Scalar(0.5)*d_max;
+        r_cull = std::max(r_cull, r_cut);
+        }
+
+    if (force || r_cull != field.r_cull || !wallCellsValid(field, box))
+        buildWallCellIndex(field, box, r_cull, managed);
+    }
+#endif
+
 #endif //__EVALUATOR__WALLS_H__
@@ -7,8 +7,15 @@
 #include "ForceComposite.h"
 #include "hoomd/VectorMath.h"
 
+#include <atomic>
+#include <limits>
 #include <map>
 #include <string.h>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
 namespace py = pybind11;
 
 /*! \file ForceComposite.cc
@@ -21,6 +28,7 @@ ForceComposite::ForceComposite(std::shared_ptr<SystemDefinition> sysdef)
         : MolecularForceCompute(sysdef), m_bodies_changed(false), m_ptls_added_removed(false),
          m_global_max_d(0.0),
          m_memory_initialized(false),
+         m_body_frame_dirty(true),
          #ifdef ENABLE_MPI
          m_comm_ghost_layer_connected(false),
          #endif
@@ -206,6 +214,7 @@ void ForceComposite::setParam(unsigned int body_typeid,
                 }
             }
         m_bodies_changed = true;
+        m_body_frame_dirty = true;
         assert(m_d_max_changed.size() > body_typeid);
 
         // make sure central particle will be communicated
@@ -285,6 +294,7 @@ void ForceComposite::slotNumTypesChange()
     m_body_idx = Index2D(m_body_pos.getPitch(), height);
 
     m_body_len.resize(new_ntypes);
+    m_body_frame_dirty = true;
 
     // reset newly added elements to zero
     ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::readwrite);
@@ -755,9 +765,50 @@ CommFlags ForceComposite::getRequestedCommFlags(unsigned int timestep)
     }
 #endif
 
+/*! The body frame constituent positions are stored in m_body_pos with a pitch over body types, so that the
+    constituents of a single body are strided in memory. The CPU kernels instead read them from contiguous per-type
+    x, y and z arrays.
+*/
+void ForceComposite::updateBodyFrameCache()
+    {
+    if (!m_body_frame_dirty)
+        return;
+
+    lazyInitMem();
+
+    ArrayHandle<Scalar3> h_body_pos(m_body_pos, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::read);
+
+    unsigned int ntypes = m_pdata->getNTypes();
+    m_body_frame_offset.resize(ntypes+1);
+    m_body_frame_offset[0] = 0;
+    for (unsigned int type = 0; type < ntypes; ++type)
+        m_body_frame_offset[type+1] = m_body_frame_offset[type] + h_body_len.data[type];
+
+    unsigned int n_total = m_body_frame_offset[ntypes];
+    m_body_frame_x.resize(n_total);
+    m_body_frame_y.resize(n_total);
+    m_body_frame_z.resize(n_total);
+
+    for (unsigned int type = 0; type < ntypes; ++type)
+        {
+        for (unsigned int j = 0; j < h_body_len.data[type]; ++j)
+            {
+            Scalar3 dr = h_body_pos.data[m_body_idx(type, j)];
+            m_body_frame_x[m_body_frame_offset[type]+j] = dr.x;
+            m_body_frame_y[m_body_frame_offset[type]+j] = dr.y;
+            m_body_frame_z[m_body_frame_offset[type]+j] = dr.z;
+            }
+        }
+
+    m_body_frame_dirty = false;
+    }
+
 //! Compute the forces and torques on the central particle
 void ForceComposite::computeForces(unsigned int timestep)
     {
+    updateBodyFrameCache();
+
     // access local molecule data
     // need to move this on top because of scoping issues
     Index2D molecule_indexer = getMoleculeIndexer();
@@ -784,7 +835,6 @@ void ForceComposite::computeForces(unsigned int timestep)
     ArrayHandle<Scalar> h_virial(m_virial, access_location::host, access_mode::overwrite);
 
     // access rigid body definition
-    ArrayHandle<Scalar3> h_body_pos(m_body_pos, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::read);
 
     // reset constraint forces and torques
@@ -792,6 +842,7 @@ void ForceComposite::computeForces(unsigned int timestep)
     memset(h_torque.data,0, sizeof(Scalar4)*m_pdata->getN());
     memset(h_virial.data,0, sizeof(Scalar)*m_virial.getNumElements());
 
+    unsigned int N = m_pdata->getN();
     unsigned int nptl_local = m_pdata->getN() + m_pdata->getNGhosts();
     unsigned int net_virial_pitch = m_pdata->getNetVirial().getPitch();
 
@@ -802,8 +853,12 @@ void ForceComposite::computeForces(unsigned int timestep)
         compute_virial = true;
         }
 
-    // loop over all molecules, also incomplete ones
-    for (unsigned int ibody = 0; ibody < nmol; ibody++)
+    // tag of a body found to be incomplete, the error is raised outside of the (threaded) loop
+    const unsigned int no_error = std::numeric_limits<unsigned int>::max();
+    std::atomic<unsigned int> incomplete_tag(no_error);
+
+    // every molecule only writes to its own central and constituent particles, so molecules are independent
+    auto compute_molecule = [&](unsigned int ibody)
         {
         unsigned int len = h_molecule_length.data[ibody];
 
@@ -817,18 +872,39 @@ void ForceComposite::computeForces(unsigned int timestep)
         assert(central_tag <= m_pdata->getMaximumTag());
         unsigned int central_idx = h_rtag.data[central_tag];
 
-        if (central_idx >= nptl_local) continue;
+        if (central_idx >= nptl_local) return;
 
         // the central ptl must be present
         assert(central_tag == h_tag.data[first_idx]);
 
         // central ptl position and orientation
         Scalar4 postype = h_postype.data[central_idx];
-        quat<Scalar> orientation(h_orientation.data[central_idx]);
 
         // body type
         unsigned int type = __scalar_as_int(postype.w);
 
+        // only add forces for local central particles
+        bool local = central_idx < N;
+
+        if (local && len > 1 && len != h_body_len.data[type] + 1)
+            {
+            // if the central particle is local, the molecule should be complete
+            incomplete_tag.store(central_tag);
+            return;
+            }
+
+        // rotation into the space frame, shared by all constituents
+        rotmat3<Scalar> rot(quat<Scalar>(h_orientation.data[central_idx]));
+        const Scalar *body_x = m_body_frame_x.data() + m_body_frame_offset[type];
+        const Scalar *body_y = m_body_frame_y.data() + m_body_frame_offset[type];
+        const Scalar *body_z = m_body_frame_z.data() + m_body_frame_offset[type];
+
+        // accumulate in registers, the central particle is written once
+        vec3<Scalar> force_sum(0,0,0);
+        Scalar energy_sum(0.0);
+        vec3<Scalar> torque_sum(0,0,0);
+        Scalar virial_sum[6] = {0,0,0,0,0,0};
+
         // sum up forces and torques from constituent particles
         for (unsigned int jptl = 0; jptl < len; ++jptl)
             {
@@ -848,61 +924,34 @@ void ForceComposite::computeForces(unsigned int timestep)
             h_net_force.data[idxj] = make_scalar4(0.0,0.0,0.0,0.0);
             h_net_torque.data[idxj] = make_scalar4(0.0,0.0,0.0,0.0);
 
-            // only add forces for local central particles
-            if (central_idx < m_pdata->getN())
+            if (local)
                 {
-                // if the central particle is local, the molecule should be complete
-                if (len != h_body_len.data[type] + 1)
-                    {
-                    m_exec_conf->msg->errorAllRanks() << "constrain.rigid(): Composite particle with body tag "
-                                                      << central_tag << " incomplete" << std::endl << std::endl;
-                    throw std::runtime_error("Error computing composite particle forces.\n");
-                    }
-
                 // sum up center of mass force
-                h_force.data[central_idx].x += f.x;
-                h_force.data[central_idx].y += f.y;
-                h_force.data[central_idx].z += f.z;
+                force_sum += f;
 
                 // sum up energy
-                h_force.data[central_idx].w += net_force.w;
+                energy_sum += net_force.w;
 
-                // fetch relative position from rigid body definition
-                vec3<Scalar> dr(h_body_pos.data[m_body_idx(type, jptl - 1)]);
-
-                // rotate into space frame
-                vec3<Scalar> dr_space = rotate(orientation, dr);
+                // fetch relative position from rigid body definition and rotate into space frame
+                vec3<Scalar> dr_space = rot*vec3<Scalar>(body_x[jptl-1], body_y[jptl-1], body_z[jptl-1]);
 
                 // torque = r x f
-                vec3<Scalar> delta_torque(cross(dr_space,f));
-                h_torque.data[central_idx].x += delta_torque.x;
-                h_torque.data[central_idx].y += delta_torque.y;
-                h_torque.data[central_idx].z += delta_torque.z;
+                torque_sum += cross(dr_space,f);
 
                 /* from previous rigid body implementation: Access Torque elements from a single particle. Right now I will am assuming that the particle
                     and rigid body reference frames are the same. Probably have to rotate first.
                  */
-                h_torque.data[central_idx].x += net_torque.x;
-                h_torque.data[central_idx].y += net_torque.y;
-                h_torque.data[central_idx].z += net_torque.z;
+                torque_sum += vec3<Scalar>(net_torque);
 
                 if (compute_virial)
                     {
-                    // sum up virial
-                    Scalar virialxx = h_net_virial.data[0*net_virial_pitch+idxj];
-                    Scalar virialxy = h_net_virial.data[1*net_virial_pitch+idxj];
-                    Scalar virialxz = h_net_virial.data[2*net_virial_pitch+idxj];
-                    Scalar virialyy = h_net_virial.data[3*net_virial_pitch+idxj];
-                    Scalar virialyz = h_net_virial.data[4*net_virial_pitch+idxj];
-                    Scalar virialzz = h_net_virial.data[5*net_virial_pitch+idxj];
-
-                    // subtract intra-body virial prt
-                    h_virial.data[0*m_virial_pitch+central_idx] += virialxx - f.x*dr_space.x;
-                    h_virial.data[1*m_virial_pitch+central_idx] += virialxy - f.x*dr_space.y;
-                    h_virial.data[2*m_virial_pitch+central_idx] += virialxz - f.x*dr_space.z;
-                    h_virial.data[3*m_virial_pitch+central_idx] += virialyy - f.y*dr_space.y;
-                    h_virial.data[4*m_virial_pitch+central_idx] += virialyz - f.y*dr_space.z;
-                    h_virial.data[5*m_virial_pitch+central_idx] += virialzz - f.z*dr_space.z;
+                    // sum up virial, subtracting the intra-body part
+                    virial_sum[0] += h_net_virial.data[0*net_virial_pitch+idxj] - f.x*dr_space.x;
+                    virial_sum[1] += h_net_virial.data[1*net_virial_pitch+idxj] - f.x*dr_space.y;
+                    virial_sum[2] += h_net_virial.data[2*net_virial_pitch+idxj] - f.x*dr_space.z;
+                    virial_sum[3] += h_net_virial.data[3*net_virial_pitch+idxj] - f.y*dr_space.y;
+                    virial_sum[4] += h_net_virial.data[4*net_virial_pitch+idxj] - f.y*dr_space.z;
+                    virial_sum[5] += h_net_virial.data[5*net_virial_pitch+idxj] - f.z*dr_space.z;
                     }
                 }
 
@@ -914,36 +963,69 @@ void ForceComposite::computeForces(unsigned int timestep)
             h_net_virial.data[4*net_virial_pitch+idxj] = 0.0;
             h_net_virial.data[5*net_virial_pitch+idxj] = 0.0;
             }
+
+        if (local)
+            {
+            h_force.data[central_idx] = make_scalar4(force_sum.x, force_sum.y, force_sum.z, energy_sum);
+            h_torque.data[central_idx] = make_scalar4(torque_sum.x, torque_sum.y, torque_sum.z, Scalar(0.0));
+
+            if (compute_virial)
+                {
+                for (unsigned int k = 0; k < 6; ++k)
+                    h_virial.data[k*m_virial_pitch+central_idx] = virial_sum[k];
+                }
+            }
+        };
+
+    // loop over all molecules, also incomplete ones
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nmol),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int ibody = r.begin(); ibody != r.end(); ++ibody)
+            compute_molecule(ibody);
+        });
+    #else
+    for (unsigned int ibody = 0; ibody < nmol; ibody++)
+        compute_molecule(ibody);
+    #endif
+
+    if (incomplete_tag.load() != no_error)
+        {
+        m_exec_conf->msg->errorAllRanks() << "constrain.rigid(): Composite particle with body tag "
+                                          << incomplete_tag.load() << " incomplete" << std::endl << std::endl;
+        throw std::runtime_error("Error computing composite particle forces.\n");
         }
     }
 
 /* Set position and velocity of constituent particles in rigid bodies in the 1st or second half of integration on the CPU
     based on the body center of mass and particle relative position in each body frame.
+
+    Molecules are processed independently, each one reading its central particle once and writing only to its own
+    constituent particles.
 */
 
 void ForceComposite::updateCompositeParticles(unsigned int timestep)
     {
-    // access molecule order (this needs to be on top because of ArrayHandle scope)
+    updateBodyFrameCache();
+
+    // access molecule data (this needs to be on top because of ArrayHandle scope)
+    Index2D molecule_indexer = getMoleculeIndexer();
+    unsigned int nmol = molecule_indexer.getH();
+
     ArrayHandle<unsigned int> h_molecule_order(getMoleculeOrder(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_molecule_len(getMoleculeLengths(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_molecule_idx(getMoleculeIndex(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_molecule_list(getMoleculeList(), access_location::host, access_mode::read);
 
     // access the particle data arrays
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
 
-    /*
-    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-    */
-
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
-    // access body positions and orientations
-    ArrayHandle<Scalar3> h_body_pos(m_body_pos, access_location::host, access_mode::read);
+    // access body orientations
     ArrayHandle<Scalar4> h_body_orientation(m_body_orientation, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::read);
 
@@ -951,35 +1033,47 @@ void ForceComposite::updateCompositeParticles(unsigned int timestep)
     const BoxDim& global_box = m_pdata->getGlobalBox();
 
     // we need to update both local and ghost particles
-    unsigned int nptl = m_pdata->getN() + m_pdata->getNGhosts();
+    unsigned int N = m_pdata->getN();
 
-    for (unsigned int iptl = 0; iptl < nptl; iptl++)
+    // tags of bodies that cannot be updated, the errors are raised outside of the (threaded) loop
+    const unsigned int no_error = std::numeric_limits<unsigned int>::max();
+    std::atomic<unsigned int> missing_tag(no_error);
+    std::atomic<unsigned int> incomplete_tag(no_error);
+
+    auto update_molecule = [&](unsigned int imol)
         {
-        unsigned int central_tag = h_body.data[iptl];
+        unsigned int len = h_molecule_len.data[imol];
+        assert(len > 0);
+
+        // body tag equals tag for central ptl
+        unsigned int first_idx = h_molecule_list.data[molecule_indexer(0,imol)];
+        unsigned int central_tag = h_body.data[first_idx];
 
         if (central_tag >= MIN_FLOPPY)
-            continue;
+            return;
 
-        // body tag equals tag for central ptl
         assert(central_tag <= m_pdata->getMaximumTag());
         unsigned int central_idx = h_rtag.data[central_tag];
 
-        if (central_idx == NOT_LOCAL && iptl >= m_pdata->getN())
-            continue;
+        // an incomplete molecule is only an error if it has local constituents, otherwise we must ignore it
+        bool has_local_constituent = false;
+        for (unsigned int jptl = 0; jptl < len; ++jptl)
+            {
+            unsigned int idxj = h_molecule_list.data[molecule_indexer(jptl,imol)];
+            if (idxj < N && idxj != central_idx)
+                has_local_constituent = true;
+            }
 
         if (central_idx == NOT_LOCAL)
             {
-            m_exec_conf->msg->errorAllRanks() << "constrain.rigid(): Missing central particle tag " << central_tag
-                                              << "!" << std::endl << std::endl;
-            throw std::runtime_error("Error updating composite particles.\n");
+            if (has_local_constituent)
+                missing_tag.store(central_tag);
+            return;
             }
 
         // central ptl position and orientation
         assert(central_idx <= m_pdata->getN() + m_pdata->getNGhosts());
 
-        // do not overwrite the central ptl
-        if (iptl == central_idx) continue;
-
         Scalar4 postype = h_postype.data[central_idx];
         vec3<Scalar> pos(postype);
         quat<Scalar> orientation(h_orientation.data[central_idx]);
@@ -988,46 +1082,77 @@ void ForceComposite::updateCompositeParticles(unsigned int timestep)
         unsigned int type = __scalar_as_int(postype.w);
 
         unsigned int body_len = h_body_len.data[type];
-        unsigned int mol_idx = h_molecule_idx.data[iptl];
-        if (body_len != h_molecule_len.data[mol_idx] - 1)
+        if (body_len != len - 1)
             {
-            if (iptl < m_pdata->getN())
-                {
-                // if the molecule is incomplete and has local members, this is an error
-                m_exec_conf->msg->errorAllRanks() << "constrain.rigid(): Composite particle with body tag "
-                                                  << central_tag << " incomplete" << std::endl << std::endl;
-                throw std::runtime_error("Error while updating constituent particles.\n");
-                }
-
-            // otherwise we must ignore it
-            continue;
+            if (has_local_constituent)
+                incomplete_tag.store(central_tag);
+            return;
             }
 
         int3 img = h_image.data[central_idx];
 
-        // fetch relative index in body from molecule list
-        assert(h_molecule_order.data[iptl] > 0);
-        unsigned int idx_in_body = h_molecule_order.data[iptl] - 1;
+        rotmat3<Scalar> rot(orientation);
+        const Scalar *body_x = m_body_frame_x.data() + m_body_frame_offset[type];
+        const Scalar *body_y = m_body_frame_y.data() + m_body_frame_offset[type];
+        const Scalar *body_z = m_body_frame_z.data() + m_body_frame_offset[type];
+
+        for (unsigned int jptl = 0; jptl < len; ++jptl)
+            {
+            unsigned int iptl = h_molecule_list.data[molecule_indexer(jptl,imol)];
+
+            // do not overwrite the central ptl
+            if (iptl == central_idx) continue;
 
-        vec3<Scalar> local_pos(h_body_pos.data[m_body_idx(type,idx_in_body)]);
-        vec3<Scalar> dr_space = rotate(orientation, local_pos);
+            // in a complete molecule, the position in the molecule list is the relative index in the body
+            assert(h_molecule_order.data[iptl] == jptl);
+            unsigned int idx_in_body = jptl - 1;
 
-        // update position and orientation
-        vec3<Scalar> updated_pos(pos);
-        quat<Scalar> local_orientation(h_body_orientation.data[m_body_idx(type, idx_in_body)]);
+            vec3<Scalar> dr_space = rot*vec3<Scalar>(body_x[idx_in_body], body_y[idx_in_body], body_z[idx_in_body]);
 
-        updated_pos += dr_space;
-        quat<Scalar> updated_orientation = orientation*local_orientation;
+            // update position and orientation
+            vec3<Scalar> updated_pos(pos);
+            quat<Scalar> local_orientation(h_body_orientation.data[m_body_idx(type, idx_in_body)]);
 
-        // this runs before the ForceComputes,
-        // wrap into box, allowing rigid bodies to span multiple images
-        int3 imgi = box.getImage(vec_to_scalar3(updated_pos));
-        int3 negimgi = make_int3(-imgi.x,-imgi.y,-imgi.z);
-        updated_pos = global_box.shift(updated_pos, negimgi);
+            updated_pos += dr_space;
+            quat<Scalar> updated_orientation = orientation*local_orientation;
 
-        h_postype.data[iptl] = make_scalar4(updated_pos.x, updated_pos.y, updated_pos.z, h_postype.data[iptl].w);
-        h_orientation.data[iptl] = quat_to_scalar4(updated_orientation);
-        h_image.data[iptl] = img+imgi;
+            // this runs before the ForceComputes,
+            // wrap into box, allowing rigid bodies to span multiple images
+            int3 imgi = box.getImage(vec_to_scalar3(updated_pos));
+            int3 negimgi = make_int3(-imgi.x,-imgi.y,-imgi.z);
+            updated_pos = global_box.shift(updated_pos, negimgi);
+
+            h_postype.data[iptl] = make_scalar4(updated_pos.x, updated_pos.y, updated_pos.z, h_postype.data[iptl].w);
+            h_orientation.data[iptl] = quat_to_scalar4(updated_orientation);
+            h_image.data[iptl] = img+imgi;
+            }
+        };
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nmol),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int imol = r.begin(); imol != r.end(); ++imol)
+            update_molecule(imol);
+        });
+    #else
+    for (unsigned int imol = 0; imol < nmol; ++imol)
+        update_molecule(imol);
+    #endif
+
+    if (missing_tag.load() != no_error)
+        {
+        m_exec_conf->msg->errorAllRanks() << "constrain.rigid(): Missing central particle tag " << missing_tag.load()
+                                          << "!" << std::endl << std::endl;
+        throw std::runtime_error("Error updating composite particles.\n");
+        }
+
+    if (incomplete_tag.load() != no_error)
+        {
+        // if the molecule is incomplete and has local members, this is an error
+        m_exec_conf->msg->errorAllRanks() << "constrain.rigid(): Composite particle with body tag "
+                                          << incomplete_tag.load() << " incomplete" << std::endl << std::endl;
+        throw std::runtime_error("Error while updating constituent particles.\n");
         }
     }
 
@@ -93,6 +93,15 @@ class PYBIND11_EXPORT ForceComposite : public MolecularForceCompute
 
         bool m_memory_initialized;                  //!< True if arrays are allocated
 
+        std::vector<unsigned int> m_body_frame_offset; //!< Offset of each body type into the body frame cache
+        std::vector<Scalar> m_body_frame_x;            //!< Cached constituent x offsets, contiguous per body type
+        std::vector<Scalar> m_body_frame_y;            //!< Cached constituent y offsets, contiguous per body type
+        std::vector<Scalar> m_body_frame_z;            //!< Cached constituent z offsets, contiguous per body type
+        bool m_body_frame_dirty;                       //!< True if the body frame cache needs to be rebuilt
+
+        //! Rebuild the SoA cache of body frame constituent positions
+        void updateBodyFrameCache();
+
         //! Helper function to be called when the number of types changes
         void slotNumTypesChange();
 
@@ -7,6 +7,12 @@
 #include "ForceDistanceConstraint.h"
 
 #include <string.h>
+#include <algorithm>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
 using namespace Eigen;
 namespace py = pybind11;
 
@@ -21,7 +27,7 @@ ForceDistanceConstraint::ForceDistanceConstraint(std::shared_ptr<SystemDefinitio
           m_cmatrix(m_exec_conf), m_cvec(m_exec_conf), m_lagrange(m_exec_conf),
           m_rel_tol(1e-3), m_constraint_violated(m_exec_conf), m_condition(m_exec_conf),
           m_sparse_idxlookup(m_exec_conf), m_constraint_reorder(true), m_constraints_added_removed(true),
-          m_d_max(0.0)
+          m_iterative(false), m_solver_tol(1e-10), m_coupling_changed(true), m_d_max(0.0)
     {
     m_constraint_violated.resetFlags(0);
 
@@ -94,19 +100,36 @@ void ForceDistanceConstraint::computeForces(unsigned int timestep)
         throw std::runtime_error("Error computing constraints.\n");
         }
 
-    // reallocate through amortized resizin
     unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
-    m_cmatrix.resize(n_constraint*n_constraint);
-    m_cvec.resize(n_constraint);
+    if (m_iterative)
+        {
+        // only the nonzero couplings are stored
+        m_cvec.resize(n_constraint);
 
-    // populate the terms in the matrix vector equation
-    fillMatrixVector(timestep);
+        // populate the terms in the sparse matrix vector equation
+        fillSparseMatrixVector(timestep);
 
-    // check violations
-    checkConstraints(timestep);
+        // check violations
+        checkConstraints(timestep);
+
+        // solve the matrix vector equation starting from the last solution
+        solveConstraintsIterative(timestep);
+        }
+    else
+        {
+        // reallocate through amortized resizin
+        m_cmatrix.resize(n_constraint*n_constraint);
+        m_cvec.resize(n_constraint);
 
-    // solve the matrix vector equation
-    solveConstraints(timestep);
+        // populate the terms in the matrix vector equation
+        fillMatrixVector(timestep);
+
+        // check violations
+        checkConstraints(timestep);
+
+        // solve the matrix vector equation
+        solveConstraints(timestep);
+        }
 
     // compute forces
     computeConstraintForces(timestep);
@@ -405,6 +428,256 @@ void ForceDistanceConstraint::solveConstraints(unsigned int timestep)
         m_prof->pop();
     }
 
+/*! \param iterative True to solve the constraint equation with warm-started BiCGSTAB, false for sparse LU
+*/
+void ForceDistanceConstraint::setIterativeSolver(bool iterative)
+    {
+    if (iterative && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "constrain.distance(): The iterative solver is only available on the CPU." << std::endl;
+        throw std::runtime_error("Error setting constraint solver");
+        }
+
+    if (iterative != m_iterative)
+        {
+        // the structures of the other solver are stale, so rebuild them from scratch
+        m_constraint_reorder = true;
+        m_coupling_changed = true;
+        m_condition.resetFlags(1);
+        }
+    m_iterative = iterative;
+    }
+
+/*! The row of each constraint holds the constraints that share one of its particles (including itself).
+    This only needs to be rebuilt when the constraints are reordered, since sorting particles does not change
+    which constraints are coupled.
+*/
+void ForceDistanceConstraint::buildSparseRows()
+    {
+    const unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
+    const unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
+
+    // reverse lookup from particle index to the constraints it participates in
+    std::vector<unsigned int> ptl_head(max_local+1, 0);
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        ++ptl_head[m_constraint_idx[n].x+1];
+        ++ptl_head[m_constraint_idx[n].y+1];
+        }
+    for (unsigned int i = 0; i < max_local; ++i)
+        ptl_head[i+1] += ptl_head[i];
+
+    std::vector<unsigned int> ptl_constraints(ptl_head[max_local]);
+    std::vector<unsigned int> ptl_fill(ptl_head.begin(), ptl_head.end()-1);
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        ptl_constraints[ptl_fill[m_constraint_idx[n].x]++] = n;
+        ptl_constraints[ptl_fill[m_constraint_idx[n].y]++] = n;
+        }
+
+    // the sparsity pattern is set with explicit zeros, and the values are filled every step
+    std::vector< Eigen::Triplet<double> > triplets;
+    triplets.reserve(4*n_constraint);
+    std::vector<unsigned int> row;
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        row.clear();
+        for (unsigned int p : {m_constraint_idx[n].x, m_constraint_idx[n].y})
+            {
+            for (unsigned int k = ptl_head[p]; k < ptl_head[p+1]; ++k)
+                row.push_back(ptl_constraints[k]);
+            }
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+
+        for (unsigned int m : row)
+            triplets.push_back(Eigen::Triplet<double>(n, m, 0.0));
+        }
+
+    m_sparse_rows.resize(n_constraint, n_constraint);
+    m_sparse_rows.setFromTriplets(triplets.begin(), triplets.end());
+    m_sparse_rows.makeCompressed();
+
+    m_coupling_changed = false;
+    }
+
+void ForceDistanceConstraint::fillSparseMatrixVector(unsigned int timestep)
+    {
+    unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
+
+    // access particle data
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::read);
+    ArrayHandle<double> h_cvec(m_cvec, access_location::host, access_mode::overwrite);
+
+    const BoxDim& box = m_pdata->getBox();
+
+    // look up the particles and separation of every constraint once
+    m_constraint_idx.resize(n_constraint);
+    m_constraint_r.resize(n_constraint);
+    unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        const ConstraintData::members_t constraint = m_cdata->getMembersByIndex(n);
+        assert(constraint.tag[0] <= m_pdata->getMaximumTag());
+        assert(constraint.tag[1] <= m_pdata->getMaximumTag());
+
+        unsigned int idx_a = h_rtag.data[constraint.tag[0]];
+        unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+
+        if (idx_a >= max_local || idx_b >= max_local)
+            {
+            this->m_exec_conf->msg->error() << "constrain.distance(): constraint " <<
+                constraint.tag[0] << " " << constraint.tag[1] << " incomplete." << std::endl << std::endl;
+            throw std::runtime_error("Error in constraint calculation");
+            }
+
+        vec3<Scalar> rn = box.minImage(vec3<Scalar>(h_pos.data[idx_a])-vec3<Scalar>(h_pos.data[idx_b]));
+        m_constraint_idx[n] = make_uint2(idx_a, idx_b);
+        m_constraint_r[n] = rn;
+
+        // check distance violation
+        Scalar d = m_cdata->getValueByIndex(n);
+        if (fast::sqrt(dot(rn,rn))-d >= m_rel_tol*d || std::isnan(dot(rn,rn)))
+            {
+            m_constraint_violated.resetFlags(n+1);
+            }
+        }
+
+    if (m_coupling_changed || (unsigned int)m_sparse_rows.rows() != n_constraint)
+        buildSparseRows();
+
+    const int *outer = m_sparse_rows.outerIndexPtr();
+    const int *inner = m_sparse_rows.innerIndexPtr();
+    double *values = m_sparse_rows.valuePtr();
+
+    // each row only depends on its own constraint and the constraints it is coupled to
+    auto fill_row = [&](unsigned int n)
+        {
+        const unsigned int idx_a = m_constraint_idx[n].x;
+        const unsigned int idx_b = m_constraint_idx[n].y;
+        const vec3<Scalar> rn = m_constraint_r[n];
+
+        vec3<Scalar> va(h_vel.data[idx_a]);
+        Scalar ma(h_vel.data[idx_a].w);
+        vec3<Scalar> vb(h_vel.data[idx_b]);
+        Scalar mb(h_vel.data[idx_b].w);
+
+        vec3<Scalar> rndot(va-vb);
+        vec3<Scalar> qn(rn+rndot*m_deltaT);
+
+        for (int k = outer[n]; k < outer[n+1]; ++k)
+            {
+            const unsigned int m = inner[k];
+            const unsigned int idx_m_a = m_constraint_idx[m].x;
+            const unsigned int idx_m_b = m_constraint_idx[m].y;
+            const vec3<Scalar> rm = m_constraint_r[m];
+
+            double delta(0.0);
+            if (idx_m_a == idx_a)
+                {
+                delta += double(4.0)*dot(qn,rm)/ma;
+                }
+            if (idx_m_b == idx_a)
+                {
+                delta -= double(4.0)*dot(qn,rm)/ma;
+                }
+            if (idx_m_a == idx_b)
+                {
+                delta -= double(4.0)*dot(qn,rm)/mb;
+                }
+            if (idx_m_b == idx_b)
+                {
+                delta += double(4.0)*dot(qn,rm)/mb;
+                }
+            values[k] = delta;
+            }
+
+        // fill vector component
+        Scalar d = m_cdata->getValueByIndex(n);
+        h_cvec.data[n] = (dot(qn,qn)-d*d)/m_deltaT/m_deltaT;
+        h_cvec.data[n] += double(2.0)*dot(qn,vec3<Scalar>(h_netforce.data[idx_a])/ma
+              -vec3<Scalar>(h_netforce.data[idx_b])/mb);
+        };
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_constraint),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int n = r.begin(); n != r.end(); ++n)
+            fill_row(n);
+        });
+    #else
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        fill_row(n);
+    #endif
+    }
+
+void ForceDistanceConstraint::solveConstraintsIterative(unsigned int timestep)
+    {
+    typedef Matrix<double, Dynamic, 1> vec_t;
+    typedef Map<vec_t> vec_map_t;
+
+    unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
+
+    // reallocate array of constraint forces
+    m_lagrange.resize(n_constraint);
+
+    // skip if zero constraints
+    if (n_constraint == 0) return;
+
+    if (m_prof)
+        m_prof->push("solve");
+
+    ArrayHandle<unsigned int> h_group_tag(m_cdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<double> h_cvec(m_cvec, access_location::host, access_mode::read);
+    ArrayHandle<double> h_lagrange(m_lagrange, access_location::host, access_mode::overwrite);
+    vec_map_t map_vec(h_cvec.data, n_constraint, 1);
+    vec_map_t map_lagrange(h_lagrange.data, n_constraint, 1);
+
+    // start from the multipliers of the last step, which are tracked by tag since constraints are reordered
+    m_lagrange_tag.resize(m_cdata->getMaximumTag()+1, 0.0);
+    vec_t guess(n_constraint);
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        guess[n] = m_lagrange_tag[h_group_tag.data[n]];
+        }
+
+    m_iterative_solver.setTolerance(m_solver_tol);
+    m_iterative_solver.compute(m_sparse_rows);
+    map_lagrange = m_iterative_solver.solveWithGuess(map_vec, guess);
+
+    if (m_iterative_solver.info() != Eigen::Success)
+        {
+        m_exec_conf->msg->notice(6) << "ForceDistanceConstraint: iterative solver did not converge after "
+            << m_iterative_solver.iterations() << " iterations. Solving with LU" << std::endl;
+
+        m_sparse = m_sparse_rows;
+        m_sparse_solver.analyzePattern(m_sparse);
+        m_sparse_solver.factorize(m_sparse);
+
+        if (m_sparse_solver.info())
+            {
+            m_exec_conf->msg->error() << "Could not solve linear system of constraint equations." << std::endl;
+            throw std::runtime_error("Error evaluating constraint forces.\n");
+            }
+        map_lagrange = m_sparse_solver.solve(map_vec);
+
+        // the dense path needs to rebuild its own sparse structure if it is used again
+        m_condition.resetFlags(1);
+        }
+
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        m_lagrange_tag[h_group_tag.data[n]] = h_lagrange.data[n];
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
 void ForceDistanceConstraint::computeConstraintForces(unsigned int timestep)
     {
     ArrayHandle<double> h_lagrange(m_lagrange, access_location::host, access_mode::read);
@@ -629,5 +902,7 @@ void export_ForceDistanceConstraint(py::module& m)
     py::class_< ForceDistanceConstraint, MolecularForceCompute, std::shared_ptr<ForceDistanceConstraint> >(m, "ForceDistanceConstraint")
         .def(py::init< std::shared_ptr<SystemDefinition> >())
         .def("setRelativeTolerance", &ForceDistanceConstraint::setRelativeTolerance)
+        .def("setIterativeSolver", &ForceDistanceConstraint::setIterativeSolver)
+        .def("setSolverTolerance", &ForceDistanceConstraint::setSolverTolerance)
     ;
     }
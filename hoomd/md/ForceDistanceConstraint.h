@@ -24,6 +24,7 @@
 
 #include <Eigen/Dense>
 #include <Eigen/SparseLU>
+#include <Eigen/IterativeLinearSolvers>
 
 /*! Implements a pairwise distance constraint using the algorithm of
 
@@ -31,6 +32,11 @@
     [2] M. Yoneya, “A Generalized Non-iterative Matrix Method for Constraint Molecular Dynamics Simulations,” J. Comput. Phys., vol. 172, no. 1, pp. 188–197, Sep. 2001.
 
     See Integrator for detailed documentation on constraint force implementation.
+
+    By default, the constraint matrix is assembled densely and solved with a sparse LU factorization. On the CPU,
+    setIterativeSolver() instead assembles only the nonzero couplings between constraints that share a particle and
+    solves with a BiCGSTAB iteration started from the Lagrange multipliers of the previous step. The LU
+    factorization is used as a fallback when the iteration does not converge.
     \ingroup computes
 */
 class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
@@ -54,6 +60,15 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
             m_rel_tol = rel_tol;
             }
 
+        //! Select the solver for the constraint equation
+        void setIterativeSolver(bool iterative);
+
+        //! Set the relative residual tolerance of the iterative solver
+        void setSolverTolerance(Scalar tol)
+            {
+            m_solver_tol = tol;
+            }
+
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
@@ -81,6 +96,16 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
         bool m_constraint_reorder;         //!< True if groups have changed
         bool m_constraints_added_removed;  //!< True if global constraint topology has changed
 
+        bool m_iterative;                  //!< True if the constraint equation is solved iteratively
+        double m_solver_tol;               //!< Relative residual tolerance of the iterative solver
+        bool m_coupling_changed;           //!< True if the sparse rows need to be rebuilt
+        std::vector<uint2> m_constraint_idx;   //!< Particle indexes of each constraint
+        std::vector< vec3<Scalar> > m_constraint_r;    //!< Separation vector of each constraint
+        std::vector<double> m_lagrange_tag;    //!< Lagrange multipliers of the last step, by constraint tag
+        Eigen::SparseMatrix<double, Eigen::RowMajor> m_sparse_rows;   //!< Sparse constraint matrix for the iterative solver
+        Eigen::BiCGSTAB<Eigen::SparseMatrix<double, Eigen::RowMajor>, Eigen::DiagonalPreconditioner<double> >
+            m_iterative_solver;            //!< Iterative solver of the constraint equation
+
         Scalar m_d_max;                    //!< Maximum constraint extension
 
         //! Compute the forces
@@ -98,10 +123,20 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
         //! Solve the linear matrix-vector equation
         virtual void computeConstraintForces(unsigned int timestep);
 
+        //! Build the sparsity pattern of the constraint matrix for the iterative solver
+        void buildSparseRows();
+
+        //! Populate the sparse constraint-force equation for the iterative solver
+        void fillSparseMatrixVector(unsigned int timestep);
+
+        //! Solve the sparse constraint-force equation iteratively
+        void solveConstraintsIterative(unsigned int timestep);
+
         //! Method called when constraint order changes
         virtual void slotConstraintReorder()
             {
             m_constraint_reorder = true;
+            m_coupling_changed = true;
             }
 
         //! Method called when constraint order changes
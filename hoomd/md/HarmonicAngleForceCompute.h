@@ -5,6 +5,7 @@
 // Maintainer: dnlebard
 #include "hoomd/ForceCompute.h"
 #include "hoomd/BondedGroupData.h"
+#include "BondedGroupForces.h"
 
 #include <memory>
 
@@ -96,6 +97,7 @@ class PYBIND11_EXPORT HarmonicAngleForceCompute : public ForceCompute
         Scalar* m_t_0;  //!< r_0 parameter for multiple angle types
 
         std::shared_ptr<AngleData> m_angle_data;  //!< Angle data to use in computing angles
+        std::vector<bonded_entry_forces> m_entry_forces; //!< Group forces at the CPU table entries, kept between computes
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
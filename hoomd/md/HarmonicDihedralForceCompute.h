@@ -6,6 +6,7 @@
 
 #include "hoomd/ForceCompute.h"
 #include "hoomd/BondedGroupData.h"
+#include "BondedGroupForces.h"
 
 #include <memory>
 
@@ -100,6 +101,7 @@ class PYBIND11_EXPORT HarmonicDihedralForceCompute : public ForceCompute
         Scalar *m_phi_0; //!< phi_0 parameter for multiple dihedral types
 
         std::shared_ptr<DihedralData> m_dihedral_data;    //!< Dihedral data to use in computing dihedrals
+        std::vector<bonded_entry_forces> m_entry_forces; //!< Group forces at the CPU table entries, kept between computes
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -0,0 +1,335 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "IntegratorRESPA.h"
+#include "hoomd/VectorMath.h"
+
+namespace py = pybind11;
+
+#include <pybind11/stl_bind.h>
+PYBIND11_MAKE_OPAQUE(std::vector<std::shared_ptr<ForceCompute> >);
+
+using namespace std;
+
+/*! \file IntegratorRESPA.cc
+    \brief Contains code for the IntegratorRESPA class
+*/
+
+IntegratorRESPA::IntegratorRESPA(std::shared_ptr<SystemDefinition> sysdef, Scalar deltaT)
+    : IntegratorTwoStep(sysdef, deltaT)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing IntegratorRESPA" << endl;
+    }
+
+IntegratorRESPA::~IntegratorRESPA()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying IntegratorRESPA" << endl;
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    The levels evaluated at \a timestep begin their outer step with a kick from the forces of their last evaluation,
+    which was at the same particle positions. The innermost level is then advanced by IntegratorTwoStep::update(), and
+    the levels evaluated at \a timestep+1 end their outer step with a kick from the newly computed forces.
+*/
+void IntegratorRESPA::update(unsigned int timestep)
+    {
+    // begin the outer steps
+    for (auto& level : m_levels)
+        {
+        if (timestep % level.substeps != 0)
+            continue;
+
+        // this is a no-op unless the particles have been sorted since the last evaluation
+        for (auto& force : level.forces)
+            force->compute(timestep);
+
+        kickLevel(level, level.substeps);
+        level.begin = timestep;
+        level.open = true;
+        }
+
+    IntegratorTwoStep::update(timestep);
+
+    // end the outer steps
+    for (auto& level : m_levels)
+        {
+        if ((timestep+1) % level.substeps != 0)
+            continue;
+
+        for (auto& force : level.forces)
+            force->compute(timestep+1);
+
+        // the first outer step of a run may be shorter
+        kickLevel(level, timestep+1 - level.begin);
+        level.open = false;
+        addLevelEnergy(level);
+        }
+    }
+
+/*! \param deltaT new deltaT to set
+    \post The forces of every level are set to the outer time step of their level
+*/
+void IntegratorRESPA::setDeltaT(Scalar deltaT)
+    {
+    IntegratorTwoStep::setDeltaT(deltaT);
+
+    for (auto& level : m_levels)
+        for (auto& force : level.forces)
+            force->setDeltaT(Scalar(level.substeps)*deltaT);
+    }
+
+/*! \param timestep Current time step of the simulation
+    \post The forces of all levels are computed at \a timestep and included in the net energy and virial
+
+    A level that is not evaluated at \a timestep continues its outer step if this integrator began it in a previous
+    run. Otherwise, it begins a shortened outer step that ends at the next multiple of its substeps.
+*/
+void IntegratorRESPA::prepRun(unsigned int timestep)
+    {
+    IntegratorTwoStep::prepRun(timestep);
+
+    for (auto& level : m_levels)
+        {
+        if (level.forces.size() > 0 && m_composite_forces.size() > 0)
+            {
+            m_exec_conf->msg->error() << "integrate.respa: Rigid bodies are not supported with multiple levels"
+                << endl;
+            throw std::runtime_error("Error initializing IntegratorRESPA");
+            }
+
+        for (auto& force : level.forces)
+            {
+            // the forces may have been added to the level after setDeltaT
+            force->setDeltaT(Scalar(level.substeps)*m_deltaT);
+            force->compute(timestep);
+            }
+
+        addLevelEnergy(level);
+
+        unsigned int offset = timestep % level.substeps;
+        if (offset == 0)
+            {
+            // update() begins the outer step
+            level.open = false;
+            }
+        else if (!level.open || level.begin < timestep - offset || level.begin > timestep)
+            {
+            kickLevel(level, level.substeps - offset);
+            level.begin = timestep;
+            level.open = true;
+            }
+        }
+    }
+
+/*! \param substeps Number of time steps between evaluations of the forces of the new level
+    \returns The index of the new level
+*/
+unsigned int IntegratorRESPA::addLevel(unsigned int substeps)
+    {
+    if (substeps == 0)
+        {
+        m_exec_conf->msg->error() << "integrate.respa: The number of substeps must be positive" << endl;
+        throw std::runtime_error("Error adding level to IntegratorRESPA");
+        }
+
+    Level level;
+    level.substeps = substeps;
+    m_levels.push_back(level);
+    return (unsigned int)m_levels.size() - 1;
+    }
+
+/*! \param level Index of the level
+*/
+unsigned int IntegratorRESPA::getLevelSubsteps(unsigned int level) const
+    {
+    if (level >= m_levels.size())
+        {
+        m_exec_conf->msg->error() << "integrate.respa: Invalid level " << level << endl;
+        throw std::runtime_error("Error getting level substeps");
+        }
+
+    return m_levels[level].substeps;
+    }
+
+/*! \param level Index of the level
+*/
+std::vector< std::shared_ptr<ForceCompute> >& IntegratorRESPA::getLevelForces(unsigned int level)
+    {
+    if (level >= m_levels.size())
+        {
+        m_exec_conf->msg->error() << "integrate.respa: Invalid level " << level << endl;
+        throw std::runtime_error("Error getting level forces");
+        }
+
+    return m_levels[level].forces;
+    }
+
+#ifdef ENABLE_MPI
+/*! \param timestep Time step for which to determine the flags
+*/
+CommFlags IntegratorRESPA::determineFlags(unsigned int timestep)
+    {
+    CommFlags flags = IntegratorTwoStep::determineFlags(timestep);
+
+    for (auto& level : m_levels)
+        for (auto& force : level.forces)
+            flags |= force->getRequestedCommFlags(timestep);
+
+    return flags;
+    }
+
+/*! \param timestep Current time step
+    Only the levels that are evaluated at \a timestep are pre-computed.
+*/
+void IntegratorRESPA::computeCallback(unsigned int timestep)
+    {
+    IntegratorTwoStep::computeCallback(timestep);
+
+    for (auto& level : m_levels)
+        {
+        if (timestep % level.substeps != 0)
+            continue;
+
+        for (auto& force : level.forces)
+            force->preCompute(timestep);
+        }
+    }
+#endif
+
+bool IntegratorRESPA::getAnisotropic()
+    {
+    bool aniso = IntegratorTwoStep::getAnisotropic();
+
+    for (auto& level : m_levels)
+        for (auto& force : level.forces)
+            aniso |= force->isAnisotropic();
+
+    return aniso;
+    }
+
+/*! \param level Level to apply
+    \param steps Number of time steps in the outer step
+    \post The velocities (and angular momenta, for anisotropic methods) of the particles of all integration methods
+          are advanced by half of an outer step of \a steps time steps with the current forces of \a level
+*/
+void IntegratorRESPA::kickLevel(const Level& level, unsigned int steps)
+    {
+    if (m_prof)
+        m_prof->push("RESPA kick");
+
+    // the outer step
+    const Scalar outer_deltaT = Scalar(steps)*m_deltaT;
+
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
+    for (auto& force : level.forces)
+        {
+        ArrayHandle<Scalar4> h_force(force->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_torque(force->getTorqueArray(), access_location::host, access_mode::read);
+
+        for (auto& method : m_methods)
+            {
+            std::shared_ptr<ParticleGroup> group = method->getGroup();
+            unsigned int group_size = group->getNumMembers();
+            bool aniso = method->getAnisotropic();
+
+            for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+                {
+                unsigned int j = group->getMemberIndex(group_idx);
+
+                // v += 1/2 * a*outer_deltaT
+                Scalar minv = Scalar(1.0) / h_vel.data[j].w;
+                h_vel.data[j].x += Scalar(1.0/2.0)*h_force.data[j].x*minv*outer_deltaT;
+                h_vel.data[j].y += Scalar(1.0/2.0)*h_force.data[j].y*minv*outer_deltaT;
+                h_vel.data[j].z += Scalar(1.0/2.0)*h_force.data[j].z*minv*outer_deltaT;
+
+                if (!aniso)
+                    continue;
+
+                quat<Scalar> q(h_orientation.data[j]);
+                quat<Scalar> p(h_angmom.data[j]);
+                vec3<Scalar> t(h_torque.data[j]);
+                vec3<Scalar> I(h_inertia.data[j]);
+
+                // rotate torque into principal frame
+                t = rotate(conj(q),t);
+
+                // ignore torque component along an axis for which the moment of inertia zero
+                if (I.x < EPSILON) t.x = 0;
+                if (I.y < EPSILON) t.y = 0;
+                if (I.z < EPSILON) t.z = 0;
+
+                // advance p by half of the outer step, as in TwoStepNVE
+                p += outer_deltaT*q*t;
+
+                h_angmom.data[j] = quat_to_scalar4(p);
+                }
+            }
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param level Level to add
+    \post The energies and virials of the forces of \a level are added to the net force and virial arrays, to the
+          external energy and virial of the particle data, and to the net force sums if they are valid
+*/
+void IntegratorRESPA::addLevelEnergy(const Level& level)
+    {
+    ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    unsigned int net_virial_pitch = m_pdata->getNetVirial().getPitch();
+    unsigned int nparticles = m_pdata->getN();
+
+    double energy_sum = 0.0;
+    double virial_sum[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    bool sums_valid = m_pdata->getNetForceSums(energy_sum, virial_sum);
+
+    for (auto& force : level.forces)
+        {
+        ArrayHandle<Scalar4> h_force(force->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial(force->getVirialArray(), access_location::host, access_mode::read);
+        unsigned int virial_pitch = force->getVirialArray().getPitch();
+
+        for (unsigned int j = 0; j < nparticles; j++)
+            {
+            h_net_force.data[j].w += h_force.data[j].w;
+
+            for (unsigned int k = 0; k < 6; k++)
+                h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
+
+            if (sums_valid && (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j]))
+                {
+                energy_sum += (double)h_force.data[j].w;
+                for (unsigned int k = 0; k < 6; k++)
+                    virial_sum[k] += (double)h_virial.data[k*virial_pitch+j];
+                }
+            }
+
+        for (unsigned int k = 0; k < 6; k++)
+            m_pdata->setExternalVirial(k, m_pdata->getExternalVirial(k) + force->getExternalVirial(k));
+
+        m_pdata->setExternalEnergy(m_pdata->getExternalEnergy() + force->getExternalEnergy());
+        }
+
+    if (sums_valid)
+        m_pdata->setNetForceSums(energy_sum, virial_sum);
+    }
+
+void export_IntegratorRESPA(py::module& m)
+    {
+    py::class_<IntegratorRESPA, IntegratorTwoStep, std::shared_ptr<IntegratorRESPA> >(m, "IntegratorRESPA")
+        .def(py::init< std::shared_ptr<SystemDefinition>, Scalar >())
+        .def("addLevel", &IntegratorRESPA::addLevel)
+        .def("getLevelSubsteps", &IntegratorRESPA::getLevelSubsteps)
+        .def("getLevelForces", &IntegratorRESPA::getLevelForces, py::return_value_policy::reference_internal)
+        .def_property_readonly("num_levels", &IntegratorRESPA::getNumLevels)
+        ;
+    }
@@ -0,0 +1,103 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "IntegratorTwoStep.h"
+
+#include <deque>
+
+#pragma once
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+/// Integrates the system forward with a multiple time step (r-RESPA) scheme
+/** IntegratorRESPA is an IntegratorTwoStep whose forces are split into levels. The forces in Integrator::m_forces
+    (and the constraint forces) form the innermost level: they are evaluated every time step and integrated by the
+    integration methods with the time step deltaT, exactly as in IntegratorTwoStep. Every additional level has a
+    number of substeps n and is evaluated only every n time steps, on the time steps that are a multiple of n. Its
+    forces are applied to the particles of all integration methods as two velocity kicks of n*deltaT/2 each, one at
+    the beginning and one at the end of the outer step, following Tuckerman, Berne, and Martyna, J. Chem. Phys.
+    97, 1990 (1992). Thermostats act on the innermost level.
+
+    A run that begins within an outer step that was not begun by this integrator (at a time step that is not a
+    multiple of n) begins a shortened outer step up to the next multiple of n, with kicks of half of its length.
+
+    The net force, torque, and virial arrays hold the innermost forces only, because the integration methods compute
+    the accelerations from them. On the time steps at which a level is evaluated, its energy and virial are added to
+    the net arrays afterwards so that the thermodynamic quantities include them.
+
+    Slow levels do not act on rigid bodies, and constraint forces only correct the innermost forces.
+
+    \ingroup updaters
+*/
+class PYBIND11_EXPORT IntegratorRESPA : public IntegratorTwoStep
+    {
+    public:
+        /// Constructor
+        IntegratorRESPA(std::shared_ptr<SystemDefinition> sysdef, Scalar deltaT);
+
+        /// Destructor
+        virtual ~IntegratorRESPA();
+
+        /// Take one timestep forward
+        virtual void update(unsigned int timestep);
+
+        /// Change the timestep
+        virtual void setDeltaT(Scalar deltaT);
+
+        /// Prepare for the run
+        virtual void prepRun(unsigned int timestep);
+
+        /// Add a level of forces evaluated every substeps time steps
+        unsigned int addLevel(unsigned int substeps);
+
+        /// Get the number of levels in addition to the innermost one
+        unsigned int getNumLevels() const
+            {
+            return (unsigned int)m_levels.size();
+            }
+
+        /// Get the number of substeps of a level
+        unsigned int getLevelSubsteps(unsigned int level) const;
+
+        /// Get the list of forces of a level
+        std::vector< std::shared_ptr<ForceCompute> >& getLevelForces(unsigned int level);
+
+#ifdef ENABLE_MPI
+        /// Callback for pre-computing the forces
+        virtual void computeCallback(unsigned int timestep);
+#endif
+
+    protected:
+        /// Forces evaluated together every substeps time steps
+        struct Level
+            {
+            unsigned int substeps;                                  //!< Number of time steps per evaluation
+            std::vector< std::shared_ptr<ForceCompute> > forces;    //!< Forces of this level
+            unsigned int begin = 0;                                 //!< Time step at which the outer step began
+            bool open = false;                                      //!< True between the kicks of an outer step
+            };
+
+        /// Levels in addition to the innermost one (references to the force lists stay valid when adding levels)
+        std::deque<Level> m_levels;
+
+#ifdef ENABLE_MPI
+        /// Determine the ghost communication flags of all levels
+        virtual CommFlags determineFlags(unsigned int timestep);
+#endif
+
+        /// Determine (an-)isotropic integration mode from the forces of all levels
+        virtual bool getAnisotropic();
+
+        /// Apply half of an outer step of a level to the particles of all integration methods
+        void kickLevel(const Level& level, unsigned int steps);
+
+        /// Add the energy and virial of a level to the net arrays
+        void addLevelEnergy(const Level& level);
+    };
+
+/// Exports the IntegratorRESPA class to python
+void export_IntegratorRESPA(pybind11::module& m);
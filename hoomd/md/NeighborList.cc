@@ -13,6 +13,8 @@
 
 namespace py = pybind11;
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <stdexcept>
 
@@ -34,7 +36,15 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     : Compute(sysdef), m_typpair_idx(m_pdata->getNTypes()), m_rcut_max_max(_r_cut), m_rcut_min(_r_cut),
       m_r_buff(r_buff), m_d_max(1.0), m_filter_body(false), m_diameter_shift(false), m_storage_mode(half),
       m_rcut_changed(true), m_updates(0), m_forced_updates(0), m_dangerous_updates(0), m_force_update(true),
-      m_dist_check(true), m_has_been_updated_once(false)
+      m_sort_update(false), m_dist_check(true), m_has_been_updated_once(false), m_tune_buffer(false), m_max_buffer(1.0),
+      m_tune_period(1000), m_pending_r_buff(-1.0), m_peeking(false),
+      #ifdef ENABLE_MPI
+      m_local_sort(false),
+      #endif
+      m_tune_dither(false), m_tune_skip(true),
+      m_tune_has_step(false), m_tune_last_step(0), m_tune_last_time(0), m_tune_steps(0), m_tune_timed_steps(0),
+      m_tune_builds(0),
+      m_tune_step_time(0), m_tune_build_time(0), m_tune_max_step_time(0), m_tune_last_measured(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing Neighborlist" << endl;
 
@@ -51,6 +61,7 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_last_check_result = false;
     m_rebuild_check_delay = 0;
     m_exclusions_set = false;
+    m_filter_in_build = false;
 
     m_need_reallocate_exlist = false;
 
@@ -186,7 +197,7 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_ex_list_indexer_tag = Index2D(m_ex_list_tag.getPitch(), 1);
 
     // connect to particle sort to force rebuild
-    m_pdata->getParticleSortSignal().connect<NeighborList, &NeighborList::forceUpdate>(this);
+    m_pdata->getParticleSortSignal().connect<NeighborList, &NeighborList::slotParticleSort>(this);
 
     // connect to max particle change to resize neighborlist arrays
     m_pdata->getMaxParticleNumberChangeSignal().connect<NeighborList, &NeighborList::reallocate>(this);
@@ -234,6 +245,31 @@ void NeighborList::reallocate()
     forceUpdate();
     }
 
+/*! A reordering of the particles invalidates the list. After a sort that kept the ghost particles, the list is only
+    rebuilt, without counting as a migration request in peekUpdate(), and the positions of the last build are reordered
+    with the particles for the distance check. Any other sort forces a full update.
+*/
+void NeighborList::slotParticleSort()
+    {
+    #ifdef ENABLE_MPI
+    if (m_local_sort)
+        {
+        m_local_sort = false;
+
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::readwrite);
+        std::vector<Scalar4> last_pos(h_last_pos.data, h_last_pos.data + m_sort_tags.size());
+        for (unsigned int i = 0; i < m_sort_tags.size(); i++)
+            h_last_pos.data[h_rtag.data[m_sort_tags[i]]] = last_pos[i];
+
+        m_sort_update = true;
+        return;
+        }
+    #endif
+
+    forceUpdate();
+    }
+
 void NeighborList::reallocateTypes()
     {
     m_typpair_idx = Index2D(m_pdata->getNTypes());
@@ -292,13 +328,14 @@ NeighborList::~NeighborList()
     {
     m_exec_conf->msg->notice(5) << "Destroying Neighborlist" << endl;
 
-    m_pdata->getParticleSortSignal().disconnect<NeighborList, &NeighborList::forceUpdate>(this);
+    m_pdata->getParticleSortSignal().disconnect<NeighborList, &NeighborList::slotParticleSort>(this);
     m_pdata->getMaxParticleNumberChangeSignal().disconnect<NeighborList, &NeighborList::reallocate>(this);
     m_pdata->getGlobalParticleNumberChangeSignal().disconnect<NeighborList, &NeighborList::slotGlobalParticleNumberChange>(this);
 #ifdef ENABLE_MPI
     if (m_comm)
         {
         m_comm->getMigrateSignal().disconnect<NeighborList, &NeighborList::peekUpdate>(this);
+        m_comm->getLocalSortSignal().disconnect<NeighborList, &NeighborList::slotLocalSort>(this);
         m_comm->getCommFlagsRequestSignal().disconnect<NeighborList, &NeighborList::getRequestedCommFlags>(this);
         m_comm->getGhostLayerWidthRequestSignal().disconnect<NeighborList, &NeighborList::getGhostLayerWidth>(this);
         }
@@ -320,14 +357,38 @@ void NeighborList::compute(unsigned int timestep)
         updateRList();
         }
 
+    // time the steps for the buffer tuner from the first call in each step
+    if (m_tune_buffer && (!m_tune_has_step || timestep != m_tune_last_step))
+        {
+        int64_t now = m_tune_clock.getTime();
+        int64_t step_time = now - m_tune_last_time;
+
+        if (m_tune_has_step && timestep == m_tune_last_step + 1)
+            {
+            // skip the time between runs, which is much longer than a step
+            if (m_tune_max_step_time == 0 || step_time < m_tune_max_step_time)
+                {
+                m_tune_step_time += step_time;
+                m_tune_timed_steps++;
+                }
+            m_tune_steps++;
+            }
+        m_tune_has_step = true;
+        m_tune_last_step = timestep;
+        m_tune_last_time = now;
+
+        if (m_tune_steps >= m_tune_period)
+            tuneBuffer(timestep);
+        }
+
     // skip if we shouldn't compute this step
-    if (!shouldCompute(timestep) && !m_force_update)
+    if (!shouldCompute(timestep) && !m_force_update && !m_sort_update)
         return;
 
     if (m_prof) m_prof->push("Neighbor");
 
     // take care of some updates if things have changed since construction
-    if (m_force_update)
+    if (m_force_update || m_sort_update)
         {
         // build the head list since some sort of change (like a particle sort) happened
         buildHeadList();
@@ -335,10 +396,34 @@ void NeighborList::compute(unsigned int timestep)
         if (m_exclusions_set)
             updateExListIdx();
         }
+    else if (m_exclusions_set && m_filter_in_build && m_ex_csr_head.size() != m_pdata->getN()+1)
+        {
+        // the exclusion table must match the local particles when it is used in the build
+        updateExListIdx();
+        }
+
+    // a sort that kept the ghost particles only requires a rebuild, the distance check still refers to the
+    // positions of the last regular build, at which the ghosts were exchanged
+    bool rebuild = needsUpdating(timestep);
+    bool sort_rebuild = !rebuild && m_sort_update;
+    m_sort_update = false;
+
+    std::vector<Scalar4> last_pos;
+    if (sort_rebuild)
+        {
+        ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::read);
+        last_pos.assign(h_last_pos.data, h_last_pos.data + m_pdata->getN());
+        }
 
     // check if the list needs to be updated and update it
-    if (needsUpdating(timestep))
+    if (rebuild || sort_rebuild)
         {
+        int64_t build_start = m_tune_buffer ? m_tune_clock.getTime() : 0;
+
+        // a buffer set by the tuner takes effect in this build
+        if (m_rcut_changed)
+            updateRList();
+
         // check simulation box size is OK
         checkBoxSize();
 
@@ -360,11 +445,28 @@ void NeighborList::compute(unsigned int timestep)
                 }
             } while (overflowed);
 
-        if (m_exclusions_set)
+        if (m_exclusions_set && !m_filter_in_build)
             filterNlist();
 
-        setLastUpdatedPos();
+        if (sort_rebuild)
+            {
+            m_forced_updates += 1;
+
+            // the GPU builds record the positions themselves, restore them
+            ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::overwrite);
+            std::copy(last_pos.begin(), last_pos.end(), h_last_pos.data);
+            }
+        else
+            {
+            setLastUpdatedPos();
+            }
         m_has_been_updated_once = true;
+
+        if (m_tune_buffer)
+            {
+            m_tune_build_time += m_tune_clock.getTime() - build_start;
+            m_tune_builds++;
+            }
         }
     if (m_prof) m_prof->pop();
     }
@@ -421,6 +523,267 @@ void NeighborList::setRBuff(Scalar r_buff)
     forceUpdate();
     }
 
+/*! \param tune_buffer Set to true to tune the buffer during the run
+*/
+void NeighborList::setTuneBuffer(bool tune_buffer)
+    {
+    if (tune_buffer && !m_tune_buffer)
+        {
+        // start over with the current buffer
+        m_buffer_samples.clear();
+        m_rate.clear();
+        m_pending_r_buff = Scalar(-1.0);
+        m_tune_has_step = false;
+        m_tune_skip = true;
+        m_tune_steps = m_tune_timed_steps = m_tune_builds = 0;
+        m_tune_step_time = m_tune_build_time = m_tune_max_step_time = 0;
+        }
+    m_tune_buffer = tune_buffer;
+    }
+
+/*! \param max_buffer Largest buffer the tuner may choose
+*/
+void NeighborList::setMaxBuffer(Scalar max_buffer)
+    {
+    if (!(max_buffer > Scalar(0.0)))
+        {
+        m_exec_conf->msg->error() << "nlist: The maximum buffer must be positive" << endl;
+        throw runtime_error("Error changing NeighborList parameters");
+        }
+    m_max_buffer = max_buffer;
+    }
+
+/*! \param tune_period Number of time steps between buffer adjustments
+*/
+void NeighborList::setTunePeriod(unsigned int tune_period)
+    {
+    if (tune_period == 0)
+        {
+        m_exec_conf->msg->error() << "nlist: The buffer tuning period must be positive" << endl;
+        throw runtime_error("Error changing NeighborList parameters");
+        }
+    m_tune_period = tune_period;
+    }
+
+/*! \param timestep Current time step
+
+    Updates the largest displacement per step of each type in this period with the displacements since the last
+    build. This relies on the positions saved by setLastUpdatedPos(), so it must not be called after the particles
+    have been reordered.
+*/
+void NeighborList::measureDisplacement(unsigned int timestep)
+    {
+    if (!m_has_been_updated_once || timestep <= m_last_updated_tstep)
+        return;
+
+    m_tune_last_measured = timestep;
+    const unsigned int ntypes = m_pdata->getNTypes();
+    if (m_rate.size() != ntypes)
+        m_rate.assign(ntypes, Scalar(0.0));
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::read);
+    const BoxDim& box = m_pdata->getBox();
+
+    std::vector<Scalar> max_dsq(ntypes, Scalar(0.0));
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        {
+        const unsigned int type_i = __scalar_as_int(h_pos.data[i].w);
+        Scalar3 dx = make_scalar3(h_pos.data[i].x - h_last_pos.data[i].x,
+                                  h_pos.data[i].y - h_last_pos.data[i].y,
+                                  h_pos.data[i].z - h_last_pos.data[i].z);
+        dx = box.minImage(dx);
+        max_dsq[type_i] = std::max(max_dsq[type_i], dot(dx, dx));
+        }
+
+    const Scalar steps = Scalar(timestep - m_last_updated_tstep);
+    for (unsigned int type = 0; type < ntypes; type++)
+        m_rate[type] = std::max(m_rate[type], std::sqrt(max_dsq[type])/steps);
+    }
+
+//! Fit the time y of a part of the step as a function of the list volume x
+/*! Fits y = a + c x when the samples determine the slope well (a positive slope that is three standard errors from
+    zero and a positive intercept). Otherwise, the time is assumed proportional to the list volume, y = c x, as the
+    number of pairs in the list is.
+*/
+static void fitLinear(const std::vector<Scalar>& x, const std::vector<Scalar>& y, Scalar& a, Scalar& c)
+    {
+    const unsigned int n = x.size();
+    Scalar mean_x = 0, mean_y = 0;
+    for (unsigned int i = 0; i < n; i++)
+        {
+        mean_x += x[i]/Scalar(n);
+        mean_y += y[i]/Scalar(n);
+        }
+
+    Scalar var_x = 0, cov_xy = 0;
+    for (unsigned int i = 0; i < n; i++)
+        {
+        var_x += (x[i] - mean_x)*(x[i] - mean_x);
+        cov_xy += (x[i] - mean_x)*(y[i] - mean_y);
+        }
+
+    a = Scalar(0.0);
+    c = mean_y/mean_x;
+    if (n < 3 || var_x <= Scalar(0.0))
+        return;
+
+    Scalar slope = cov_xy/var_x;
+    Scalar intercept = mean_y - slope*mean_x;
+    Scalar residual = 0;
+    for (unsigned int i = 0; i < n; i++)
+        {
+        Scalar r = y[i] - intercept - slope*x[i];
+        residual += r*r;
+        }
+    Scalar slope_error = std::sqrt(residual/Scalar(n - 2)/var_x);
+
+    if (slope > Scalar(3.0)*slope_error && intercept > Scalar(0.0))
+        {
+        a = intercept;
+        c = slope;
+        }
+    }
+
+/*! \param timestep Current time step
+
+    Called by compute() at the end of each tuning period on all ranks. The timings and displacement rates are reduced
+    over the ranks so that all ranks choose the same buffer.
+*/
+void NeighborList::tuneBuffer(unsigned int timestep)
+    {
+    // the displacements since the last build, unless the particles were reordered
+    if (!m_force_update)
+        measureDisplacement(timestep);
+
+    const unsigned int ntypes = m_pdata->getNTypes();
+    std::vector<Scalar> rate(m_rate);
+    rate.resize(ntypes, Scalar(0.0));
+    // time per step and time of the builds in this period
+    double times[2] = {m_tune_timed_steps > 0 ? double(m_tune_step_time)/m_tune_timed_steps : 0.0,
+                       double(m_tune_build_time)};
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &rate[0], ntypes, MPI_HOOMD_SCALAR, MPI_MAX, m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, times, 2, MPI_DOUBLE, MPI_MAX, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    m_displacement_rate = rate;
+    Scalar v = Scalar(0.0);
+    for (unsigned int type = 0; type < ntypes; type++)
+        v = std::max(v, rate[type]);
+
+    Scalar r_cut = getMaxRCut();
+    if (m_diameter_shift)
+        r_cut += m_d_max - Scalar(1.0);
+
+    // the first period includes the start up of the run
+    if (!m_tune_skip && m_tune_steps > 0)
+        {
+        BufferSample sample;
+        Scalar r_list = r_cut + m_r_buff;
+        sample.volume = r_list*r_list*r_list;
+        sample.build_time = m_tune_builds > 0 ? Scalar(times[1]/m_tune_builds) : Scalar(-1.0);
+        sample.other_time = std::max(Scalar(times[0] - times[1]/m_tune_steps), Scalar(0.0));
+        m_buffer_samples.push_back(sample);
+        if (m_buffer_samples.size() > 8)
+            m_buffer_samples.erase(m_buffer_samples.begin());
+        }
+
+    m_tune_max_step_time = int64_t(10.0*times[0]);
+    m_tune_skip = false;
+    m_tune_steps = m_tune_timed_steps = m_tune_builds = 0;
+    m_tune_step_time = m_tune_build_time = 0;
+    m_rate.assign(ntypes, Scalar(0.0));
+
+    // the buffer does not change the rebuild period without the distance check
+    if (!m_dist_check || m_buffer_samples.empty())
+        return;
+
+    std::vector<Scalar> volume, build_time, other_time, build_volume;
+    for (auto& sample : m_buffer_samples)
+        {
+        volume.push_back(sample.volume);
+        other_time.push_back(sample.other_time);
+        if (sample.build_time >= Scalar(0.0))
+            {
+            build_volume.push_back(sample.volume);
+            build_time.push_back(sample.build_time);
+            }
+        }
+
+    Scalar other_a, other_c;
+    fitLinear(volume, other_time, other_a, other_c);
+    Scalar build_a = Scalar(0.0), build_c = Scalar(0.0);
+    if (build_volume.size() > 0)
+        fitLinear(build_volume, build_time, build_a, build_c);
+
+    // the list must not expire before the first check after a build
+    Scalar r_buff_min = m_max_buffer/Scalar(64.0);
+    if (m_rebuild_check_delay > 1)
+        r_buff_min = std::max(r_buff_min, Scalar(2.4)*v*Scalar(m_rebuild_check_delay));
+    r_buff_min = std::min(r_buff_min, m_max_buffer);
+
+    // predicted time per step on a grid of buffers
+    Scalar best_r_buff = m_r_buff;
+    Scalar best_time = Scalar(-1.0);
+    for (unsigned int i = 0; i <= 64; i++)
+        {
+        Scalar r_buff = r_buff_min + (m_max_buffer - r_buff_min)*Scalar(i)/Scalar(64.0);
+        Scalar r_list = r_cut + r_buff;
+        Scalar V = r_list*r_list*r_list;
+        Scalar builds_per_step = std::min(Scalar(1.0), Scalar(2.0)*v/r_buff);
+        Scalar time = (build_a + build_c*V)*builds_per_step + other_a + other_c*V;
+        if (best_time < Scalar(0.0) || time < best_time)
+            {
+            best_time = time;
+            best_r_buff = r_buff;
+            }
+        }
+
+    // limit the change per period and perturb the buffer to sample different list volumes
+    Scalar r_buff = std::min(std::max(best_r_buff, Scalar(0.8)*m_r_buff), Scalar(1.2)*m_r_buff);
+    r_buff *= m_tune_dither ? Scalar(1.05) : Scalar(0.95);
+    m_tune_dither = !m_tune_dither;
+    r_buff = std::min(std::max(r_buff, r_buff_min), m_max_buffer);
+
+    m_exec_conf->msg->notice(6) << "nlist: tuned buffer " << m_r_buff << " -> " << r_buff << " (displacement rate "
+                                << v << ")" << endl;
+    m_pending_r_buff = r_buff;
+    }
+
+/*! Only called when the distance check triggers a rebuild. With domain decomposition, the buffer must change before
+    the ghost layer is exchanged, which is when peekUpdate() triggers the migration.
+*/
+void NeighborList::applyPendingBuffer()
+    {
+    if (m_pending_r_buff < Scalar(0.0))
+        return;
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition() && !m_peeking)
+        return;
+    #endif
+
+    m_r_buff = m_pending_r_buff;
+    m_pending_r_buff = Scalar(-1.0);
+
+    // update the cutoffs and derived cell sizes, the list is rebuilt in this step anyway
+    notifyRCutMatrixChange();
+    m_force_update = false;
+    }
+
+pybind11::list NeighborList::getDisplacementRates()
+    {
+    pybind11::list result;
+    for (auto rate : m_displacement_rate)
+        result.append(rate);
+    return result;
+    }
+
 void NeighborList::updateRList()
     {
     // overwrite the new r_cut matrix
@@ -1334,6 +1697,14 @@ bool NeighborList::needsUpdating(unsigned int timestep)
             result = distanceCheck(timestep);
             }
 
+        if (result && m_tune_buffer)
+            {
+            // sample the displacements at some of the builds, they need the positions on the host
+            if (timestep >= m_tune_last_measured + m_tune_period/16)
+                measureDisplacement(timestep);
+            applyPendingBuffer();
+            }
+
         if (result)
             {
             // record update histogram - but only if the period is positive
@@ -1388,6 +1759,8 @@ void NeighborList::buildNlist(unsigned int timestep)
     }
 
 /*! Translates the exclusions set in \c m_n_ex_tag and \c m_ex_list_tag to indices in \c m_n_ex_idx and \c m_ex_list_idx
+
+    The compact exclusion table used by the CPU neighbor list builds (see ExclusionLookup) is filled at the same time.
 */
 void NeighborList::updateExListIdx()
     {
@@ -1405,8 +1778,13 @@ void NeighborList::updateExListIdx()
     ArrayHandle<unsigned int> h_n_ex_idx(m_n_ex_idx, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_ex_list_idx(m_ex_list_idx, access_location::host, access_mode::overwrite);
 
+    const unsigned int N = m_pdata->getN();
+    m_ex_mask.assign(N, 0);
+    m_ex_csr_head.resize(N+1);
+    m_ex_csr_list.clear();
+
     // translate the number and exclusions from one array to the other
-    for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+    for (unsigned int idx = 0; idx < N; idx++)
         {
         // get the tag for this index
         unsigned int tag = h_tag.data[idx];
@@ -1416,6 +1794,7 @@ void NeighborList::updateExListIdx()
         h_n_ex_idx.data[idx] = n;
 
         // construct the exclusion list
+        m_ex_csr_head[idx] = m_ex_csr_list.size();
         for (unsigned int offset = 0; offset < n; offset++)
             {
             unsigned int ex_tag = h_ex_list_tag.data[m_ex_list_indexer_tag(tag,offset)];
@@ -1423,8 +1802,16 @@ void NeighborList::updateExListIdx()
 
             // store excluded particle idx
             h_ex_list_idx.data[m_ex_list_indexer(idx, offset)] = ex_idx;
+
+            // nearby tags go into the mask, and the rest are only kept if the particle is here
+            const int dtag = int(ex_tag) - int(tag);
+            if (dtag >= -ExclusionLookup::max_tag_offset && dtag <= ExclusionLookup::max_tag_offset)
+                m_ex_mask[idx] |= 1u << ExclusionLookup::bit(dtag);
+            else if (ex_idx != NOT_LOCAL)
+                m_ex_csr_list.push_back(ex_idx);
             }
         }
+    m_ex_csr_head[N] = m_ex_csr_list.size();
 
     if (m_prof)
         m_prof->pop();
@@ -1597,6 +1984,7 @@ void NeighborList::setCommunicator(std::shared_ptr<Communicator> comm)
         // only add the migrate request on the first call
         assert(comm);
         comm->getMigrateSignal().connect<NeighborList, &NeighborList::peekUpdate>(this);
+        comm->getLocalSortSignal().connect<NeighborList, &NeighborList::slotLocalSort>(this);
         comm->getCommFlagsRequestSignal().connect<NeighborList, &NeighborList::getRequestedCommFlags>(this);
         comm->getGhostLayerWidthRequestSignal().connect<NeighborList, &NeighborList::getGhostLayerWidth>(this);
         }
@@ -1604,6 +1992,16 @@ void NeighborList::setCommunicator(std::shared_ptr<Communicator> comm)
     Compute::setCommunicator(comm);
     }
 
+/*! The ghost particles were kept by the sort, so the particles need not be migrated. Record the tags of the local
+    particles, to reorder the positions of the last build after the sort.
+*/
+void NeighborList::slotLocalSort()
+    {
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    m_sort_tags.assign(h_tag.data, h_tag.data + m_pdata->getN());
+    m_local_sort = true;
+    }
+
 //! Returns true if the particle migration criterion is fulfilled
 /*! \note The criterion for when to request particle migration is the same as the one for neighbor list
     rebuilds, which is implemented in needsUpdating().
@@ -1612,7 +2010,9 @@ bool NeighborList::peekUpdate(unsigned int timestep)
     {
     if (m_prof) m_prof->push("Neighbor");
 
+    m_peeking = true;
     bool result = needsUpdating(timestep);
+    m_peeking = false;
 
     if (m_prof) m_prof->pop();
 
@@ -1704,6 +2104,13 @@ void export_NeighborList(py::module& m)
         .def("forceUpdate", &NeighborList::forceUpdate)
         .def("estimateNNeigh", &NeighborList::estimateNNeigh)
         .def("getSmallestRebuild", &NeighborList::getSmallestRebuild)
+        .def_property("tune_buffer", &NeighborList::getTuneBuffer,
+                      &NeighborList::setTuneBuffer)
+        .def_property("max_buffer", &NeighborList::getMaxBuffer,
+                      &NeighborList::setMaxBuffer)
+        .def_property("tune_period", &NeighborList::getTunePeriod,
+                      &NeighborList::setTunePeriod)
+        .def("getDisplacementRates", &NeighborList::getDisplacementRates)
         .def("getNumUpdates", &NeighborList::getNumUpdates)
         .def("getNumExclusions", &NeighborList::getNumExclusions)
         .def("wantExclusions", &NeighborList::wantExclusions)
@@ -4,6 +4,7 @@
 
 // Maintainer: joaander
 
+#include "hoomd/ClockSource.h"
 #include "hoomd/Compute.h"
 #include "hoomd/GlobalArray.h"
 #include "hoomd/GPUVector.h"
@@ -32,6 +33,58 @@
 #include "hoomd/Communicator.h"
 #endif
 
+//! Tests if a pair of particles is excluded while the neighbor list is built on the CPU
+/*! Exclusions between particles with nearby tags (the 1-2, 1-3, and 1-4 exclusions along a
+    polymer chain, for example) are encoded as a bit mask of tag offsets for each particle.
+    Any other exclusions are stored in a compressed row (CSR) list of particle indexes.
+*/
+struct ExclusionLookup
+    {
+    //! Largest tag offset that is stored in the bit mask
+    static constexpr int max_tag_offset = 16;
+
+    //! Constructor
+    /*! \param tag_ Particle tags (by index, including ghosts)
+        \param mask_ Bit mask of excluded tag offsets by particle index
+        \param head_ Start of each particle's exclusions in \a list_
+        \param list_ Excluded particle indexes that are not in the bit mask
+    */
+    ExclusionLookup(const unsigned int *tag_,
+                    const unsigned int *mask_,
+                    const unsigned int *head_,
+                    const unsigned int *list_)
+        : tag(tag_), mask(mask_), head(head_), list(list_)
+        { }
+
+    //! Get the bit in the mask for a tag offset
+    static inline unsigned int bit(int dtag)
+        {
+        return (dtag < 0) ? (unsigned int)(dtag + max_tag_offset) : (unsigned int)(dtag + max_tag_offset - 1);
+        }
+
+    //! Check if particle \a j is excluded from the neighbors of particle \a i
+    inline bool operator()(unsigned int i, unsigned int j) const
+        {
+        const int dtag = int(tag[j]) - int(tag[i]);
+        if (dtag == 0)
+            return false;
+        else if (dtag >= -max_tag_offset && dtag <= max_tag_offset)
+            return (mask[i] >> bit(dtag)) & 1;
+
+        for (unsigned int k = head[i]; k < head[i+1]; ++k)
+            {
+            if (list[k] == j)
+                return true;
+            }
+        return false;
+        }
+
+    const unsigned int *tag;    //!< Particle tags
+    const unsigned int *mask;   //!< Bit mask of excluded tag offsets
+    const unsigned int *head;   //!< Start of each particle in the list
+    const unsigned int *list;   //!< Remaining excluded particle indexes
+    };
+
 //! Computes a Neighborlist from the particles
 /*! \b Overview:
 
@@ -92,6 +145,18 @@
     setEvery takes a dist_check parameter. When dist_check=True, the above described behavior is followed. When
     dist_check is false, the nlist is built exactly m_rebuild_check_delay steps. This is intended for use in profiling only.
 
+    <b>Buffer tuning:</b>
+
+    When setTuneBuffer() is enabled, the buffer is adjusted during the run to minimize the time per step. Over each
+    period of m_tune_period steps, compute() measures the time per step and the time spent building the list, and the
+    largest displacement per step of each particle type is measured on the host at the end of the period and at the
+    list builds. At the end of the period, tuneBuffer() fits the build time and the remaining time per step of the
+    recent periods as linear functions of the list volume (r_cut + r_buff)^3. It chooses the buffer that minimizes the
+    predicted time per step, where a list with buffer b is rebuilt every b / (2 v) steps for the largest displacement
+    rate v of any type. The buffer changes by at most 20% per period and alternates by +-5% to keep sampling different
+    list volumes. The new buffer is applied at the next rebuild triggered by the distance check, which in MPI
+    simulations happens in peekUpdate() before the ghost layer is exchanged.
+
     \b Exclusions:
 
     Exclusions are stored in \a ex_list, a data structure similar in structure to \a nlist, except this time exclusions
@@ -100,6 +165,10 @@
     through the neighbor list and removes any particles that are excluded. This allows an arbitrary number of exclusions
     to be processed without slowing the performance of the buildNlist() step itself.
 
+    The CPU neighbor lists instead skip excluded pairs while the list is built, using the compact table in
+    ExclusionLookup that updateExListIdx() also fills. Subclasses that do this set \a m_filter_in_build so that
+    the separate filterNlist() pass is not made.
+
     <b>Overflow handling:</b>
     For easy support of derived GPU classes to implement overflow detection the overflow condition is stored in the
     GlobalArray \a d_conditions.
@@ -197,6 +266,33 @@ class PYBIND11_EXPORT NeighborList : public Compute
 
         void setDistCheck(bool dist_check) {m_dist_check = dist_check;}
 
+        //! Enable or disable tuning the buffer during the run
+        void setTuneBuffer(bool tune_buffer);
+
+        //! Test if the buffer is tuned during the run
+        bool getTuneBuffer()
+            {
+            return m_tune_buffer;
+            }
+
+        //! Set the largest buffer the tuner may choose
+        void setMaxBuffer(Scalar max_buffer);
+
+        //! Get the largest buffer the tuner may choose
+        Scalar getMaxBuffer()
+            {
+            return m_max_buffer;
+            }
+
+        //! Set the number of time steps between buffer adjustments
+        void setTunePeriod(unsigned int tune_period);
+
+        //! Get the number of time steps between buffer adjustments
+        unsigned int getTunePeriod()
+            {
+            return m_tune_period;
+            }
+
         bool getDistCheck(){return m_dist_check;}
 
         //! Set the storage mode
@@ -271,6 +367,9 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Gets the shortest rebuild period this nlist has experienced since a call to resetStats
         unsigned int getSmallestRebuild();
 
+        //! Get the largest displacement per time step of each type in the last tuning period
+        pybind11::list getDisplacementRates();
+
         // @}
         //! \name Get data
         // @{
@@ -550,6 +649,20 @@ class PYBIND11_EXPORT NeighborList : public Compute
         bool m_exclusions_set;                 //!< True if any exclusions have been set
         bool m_need_reallocate_exlist;         //!< True if global exclusion list needs to be reallocated
 
+        std::vector<unsigned int> m_ex_mask;        //!< Excluded tag offsets of each particle index (see ExclusionLookup)
+        std::vector<unsigned int> m_ex_csr_head;    //!< Start of each particle index in m_ex_csr_list
+        std::vector<unsigned int> m_ex_csr_list;    //!< Excluded particle indexes that do not fit in the mask
+        bool m_filter_in_build;                     //!< True if buildNlist() skips excluded pairs itself
+
+        //! Get the exclusion table for the CPU neighbor list build
+        /*! \param tag Particle tags (by index)
+            \note This is only valid after updateExListIdx() from this class has been called.
+        */
+        ExclusionLookup getExclusionLookup(const unsigned int *tag) const
+            {
+            return ExclusionLookup(tag, m_ex_mask.data(), m_ex_csr_head.data(), m_ex_csr_list.data());
+            }
+
         //! Return true if we are supposed to do a distance check in this time step
         bool shouldCheckDistance(unsigned int timestep);
 
@@ -616,6 +729,7 @@ class PYBIND11_EXPORT NeighborList : public Compute
         int64_t m_forced_updates;       //!< Number of times the neighbor list has been forcibly updated
         int64_t m_dangerous_updates;    //!< Number of dangerous builds counted
         bool m_force_update;            //!< Flag to handle the forcing of neighborlist updates
+        bool m_sort_update;             //!< True if the list must be rebuilt after a sort that kept the ghost particles
         bool m_dist_check;              //!< Set to false to disable distance checks (nlist always built m_rebuild_check_delay steps)
         bool m_has_been_updated_once;   //!< True if the neighbor list has been updated at least once
 
@@ -626,6 +740,49 @@ class PYBIND11_EXPORT NeighborList : public Compute
         std::vector<unsigned int> m_update_periods;    //!< Steps between updates
         std::set<std::string> m_exclusions;        //!< Exclusions that have been set
 
+        //! Timings of a list volume measured by the buffer tuner
+        struct BufferSample
+            {
+            Scalar volume;      //!< (r_cut + r_buff)^3
+            Scalar build_time;  //!< Time per build (negative when there were no builds)
+            Scalar other_time;  //!< Time per step excluding the builds
+            };
+
+        bool m_tune_buffer;                         //!< True when the buffer is tuned during the run
+        Scalar m_max_buffer;                        //!< Largest buffer the tuner may choose
+        unsigned int m_tune_period;                 //!< Number of time steps between buffer adjustments
+        Scalar m_pending_r_buff;                    //!< Buffer to set at the next rebuild (negative if none)
+        bool m_peeking;                             //!< True while called from peekUpdate()
+        #ifdef ENABLE_MPI
+        bool m_local_sort;                          //!< True if the next particle sort keeps the ghost particles
+        std::vector<unsigned int> m_sort_tags;      //!< Tags of the local particles before the local sort
+        #endif
+        bool m_tune_dither;                         //!< Direction of the next +-5% perturbation
+        bool m_tune_skip;                           //!< True when the timings of this period are not used
+        ClockSource m_tune_clock;                   //!< Clock for the timings
+        bool m_tune_has_step;                       //!< True when m_tune_last_step is set
+        unsigned int m_tune_last_step;              //!< Time step of the last call to compute()
+        int64_t m_tune_last_time;                   //!< Time of the last call to compute()
+        unsigned int m_tune_steps;                  //!< Number of steps in this period
+        unsigned int m_tune_timed_steps;            //!< Number of steps timed in this period
+        unsigned int m_tune_builds;                 //!< Number of builds in this period
+        int64_t m_tune_step_time;                   //!< Total time of the steps in this period
+        int64_t m_tune_build_time;                  //!< Total time of the builds in this period
+        int64_t m_tune_max_step_time;               //!< Longer steps are not timed (0 for no limit)
+        unsigned int m_tune_last_measured;          //!< Time step of the last displacement measurement
+        std::vector<Scalar> m_rate;                 //!< Largest displacement per step by type in this period
+        std::vector<Scalar> m_displacement_rate;    //!< Largest displacement per step by type in the last period
+        std::vector<BufferSample> m_buffer_samples; //!< Timings of the recent periods
+
+        //! Measure the displacement rates since the last build
+        void measureDisplacement(unsigned int timestep);
+
+        //! Choose the buffer for the next period
+        void tuneBuffer(unsigned int timestep);
+
+        //! Set a buffer chosen by tuneBuffer() when the list is rebuilt
+        void applyPendingBuffer();
+
         //! Test if the list needs updating
         bool needsUpdating(unsigned int timestep);
 
@@ -650,6 +807,14 @@ class PYBIND11_EXPORT NeighborList : public Compute
             m_need_reallocate_exlist = true;
             }
 
+        //! Method to be called when the particles are sorted
+        void slotParticleSort();
+
+        #ifdef ENABLE_MPI
+        //! Method to be called before a sort that keeps the ghost particles
+        void slotLocalSort();
+        #endif
+
         #ifdef ENABLE_HIP
         GPUPartition m_last_gpu_partition; //!< The partition at the time of the last memory hints
         #endif
@@ -37,6 +37,9 @@ NeighborListBinned::NeighborListBinned(std::shared_ptr<SystemDefinition> sysdef,
 
     // cell sizes need update by default
     m_update_cell_size = true;
+
+    // exclusions are skipped in buildNlist()
+    m_filter_in_build = true;
     }
 
 NeighborListBinned::~NeighborListBinned()
@@ -69,9 +72,13 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
 
+    // excluded pairs are skipped as they are found
+    const ExclusionLookup is_excluded = getExclusionLookup(h_tag.data);
+
     // access the rlist data
     ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_r_listsq(m_r_listsq, access_location::host, access_mode::read);
@@ -176,6 +183,9 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
                     {
                     if (m_storage_mode == full || i < (int)cur_neigh)
                         {
+                        if (m_exclusions_set && is_excluded(i, cur_neigh))
+                            continue;
+
                         // local neighbor
                         if (cur_n_neigh < Nmax_i)
                             {
@@ -51,6 +51,9 @@ NeighborListStencil::NeighborListStencil(std::shared_ptr<SystemDefinition> sysde
     // cell sizes need update by default
     m_update_cell_size = true;
     m_needs_restencil = true;
+
+    // exclusions are skipped in buildNlist()
+    m_filter_in_build = true;
     }
 
 NeighborListStencil::~NeighborListStencil()
@@ -113,6 +116,7 @@ void NeighborListStencil::buildNlist(unsigned int timestep)
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
     Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
@@ -162,6 +166,9 @@ void NeighborListStencil::buildNlist(unsigned int timestep)
     Index3D ci = m_cl->getCellIndexer();
     Index2D cli = m_cl->getCellListIndexer();
 
+    // excluded pairs are skipped as they are found
+    const ExclusionLookup is_excluded = getExclusionLookup(h_tag.data);
+
     // for each local particle
     unsigned int nparticles = m_pdata->getN();
 
@@ -291,6 +298,9 @@ void NeighborListStencil::buildNlist(unsigned int timestep)
                     {
                     if (m_storage_mode == full || i < (int)cur_neigh)
                         {
+                        if (m_exclusions_set && is_excluded(i, cur_neigh))
+                            continue;
+
                         // local neighbor
                         if (cur_n_neigh < Nmax_i)
                             {
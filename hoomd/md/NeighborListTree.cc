@@ -32,6 +32,9 @@ NeighborListTree::NeighborListTree(std::shared_ptr<SystemDefinition> sysdef,
     m_pdata->getBoxChangeSignal().connect<NeighborListTree, &NeighborListTree::slotBoxChanged>(this);
     m_pdata->getMaxParticleNumberChangeSignal().connect<NeighborListTree, &NeighborListTree::slotMaxNumChanged>(this);
     m_pdata->getParticleSortSignal().connect<NeighborListTree, &NeighborListTree::slotRemapParticles>(this);
+
+    // exclusions are skipped in traverseTree()
+    m_filter_in_build = true;
     }
 
 NeighborListTree::~NeighborListTree()
@@ -265,9 +268,13 @@ void NeighborListTree::traverseTree()
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
 
+    // excluded pairs are skipped as they are found
+    const ExclusionLookup is_excluded = getExclusionLookup(h_tag.data);
+
     // neighborlist data
     ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
@@ -358,7 +365,8 @@ void NeighborListTree::traverseTree()
 
                                     if (dr_sq <= (r_cutsq_i + sqshift))
                                         {
-                                        if (m_storage_mode == full || i < j)
+                                        if ((m_storage_mode == full || i < j)
+                                            && !(m_exclusions_set && is_excluded(i, j)))
                                             {
                                             if (n_neigh_i < Nmax_i)
                                                 h_nlist.data[nlist_head_i + n_neigh_i] = j;
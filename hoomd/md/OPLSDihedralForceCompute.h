@@ -6,6 +6,7 @@
 
 #include "hoomd/ForceCompute.h"
 #include "hoomd/BondedGroupData.h"
+#include "BondedGroupForces.h"
 
 #include <memory>
 #include <vector>
@@ -96,6 +97,7 @@ class PYBIND11_EXPORT OPLSDihedralForceCompute : public ForceCompute
 
         //!< Dihedral data to use in computing dihedrals
         std::shared_ptr<DihedralData> m_dihedral_data;
+        std::vector<bonded_entry_forces> m_entry_forces; //!< Group forces at the CPU table entries, kept between computes
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -8,6 +8,7 @@
 #include "hoomd/ForceCompute.h"
 #include "hoomd/GPUArray.h"
 #include "hoomd/GlobalArray.h"
+#include "hoomd/managed_allocator.h"
 
 /*! \file PotentialExternal.h
     \brief Declares a class for computing an external force field
@@ -22,6 +23,24 @@
 #ifndef __POTENTIAL_EXTERNAL_H__
 #define __POTENTIAL_EXTERNAL_H__
 
+//! Update data derived from an external field
+/*! \param field Field to update
+    \param box Global simulation box
+    \param params Per-type parameters
+    \param n_types Number of particle types
+    \param d_max Maximum particle diameter (only valid when the evaluator needs the diameter)
+    \param managed True if derived data should be allocated in managed memory
+    \param force True if the field or parameters have changed since the last update
+
+    Fields are passed unchanged to the evaluator by default. Field types that cache data (such as the wall culling
+    cells of wall_type) provide an overload.
+*/
+template<class evaluator, class field_type, class param_type>
+void updateExternalField(field_type& field, const BoxDim& box, const param_type *params,
+                         unsigned int n_types, Scalar d_max, bool managed, bool force)
+    {
+    }
+
 //! Applys an external force to particles based on position
 /*! \ingroup computes
 */
@@ -52,7 +71,18 @@ class PotentialExternal: public ForceCompute
 
         GPUArray<param_type>    m_params;        //!< Array of per-type parameters
         std::string             m_log_name;               //!< Cached log name
-        GPUArray<field_type>    m_field;
+        std::vector<field_type, managed_allocator<field_type> > m_field;  //!< The field (a single element)
+        bool                    m_field_changed; //!< True if the field or parameters changed since the last update
+
+        //! Update data derived from the field before computing forces
+        void updateField()
+            {
+            Scalar d_max = evaluator::needsDiameter() ? m_pdata->getMaxDiameter() : Scalar(0.0);
+            ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
+            updateExternalField<evaluator>(m_field[0], m_pdata->getGlobalBox(), h_params.data, m_pdata->getNTypes(),
+                                           d_max, m_exec_conf->isCUDAEnabled(), m_field_changed);
+            m_field_changed = false;
+            }
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -69,6 +99,7 @@ class PotentialExternal: public ForceCompute
             // reallocate parameter array
             GPUArray<param_type> params(m_pdata->getNTypes(), m_exec_conf);
             m_params.swap(params);
+            m_field_changed = true;
             }
    };
 
@@ -79,15 +110,15 @@ class PotentialExternal: public ForceCompute
 template<class evaluator>
 PotentialExternal<evaluator>::PotentialExternal(std::shared_ptr<SystemDefinition> sysdef,
                          const std::string& log_suffix)
-    : ForceCompute(sysdef)
+    : ForceCompute(sysdef), m_field_changed(true)
     {
     m_log_name = std::string("external_") + evaluator::getName() + std::string("_energy") + log_suffix;
 
     GPUArray<param_type> params(m_pdata->getNTypes(), m_exec_conf);
     m_params.swap(params);
 
-    GPUArray<field_type> field(1, m_exec_conf);
-    m_field.swap(field);
+    m_field = std::vector<field_type, managed_allocator<field_type> >(1, field_type(),
+        managed_allocator<field_type>(m_exec_conf->isCUDAEnabled()));
 
     // connect to the ParticleData to receive notifications when the maximum number of particles changes
     m_pdata->getNumTypesChangeSignal().template connect<PotentialExternal<evaluator>, &PotentialExternal<evaluator>::slotNumTypesChange>(this);
@@ -141,6 +172,8 @@ void PotentialExternal<evaluator>::computeForces(unsigned int timestep)
 
     assert(m_pdata);
     // access the particle data arrays
+    updateField();
+
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
@@ -149,8 +182,7 @@ void PotentialExternal<evaluator>::computeForces(unsigned int timestep)
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
-    ArrayHandle<field_type> h_field(m_field, access_location::host, access_mode::read);
-    const field_type& field = *(h_field.data);
+    const field_type& field = m_field[0];
 
     const BoxDim& box = m_pdata->getGlobalBox();
     PDataFlags flags = this->m_pdata->getFlags();
@@ -230,13 +262,14 @@ void PotentialExternal<evaluator>::setParams(unsigned int type, param_type param
 
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::readwrite);
     h_params.data[type] = params;
+    m_field_changed = true;
     }
 
 template<class evaluator>
 void PotentialExternal<evaluator>::setField(field_type field)
     {
-    ArrayHandle<field_type> h_field(m_field, access_location::host, access_mode::overwrite);
-    *(h_field.data) = field;
+    m_field[0] = field;
+    m_field_changed = true;
     }
 
 //! Export this external potential to python
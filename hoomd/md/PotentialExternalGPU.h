@@ -73,6 +73,8 @@ void PotentialExternalGPU<evaluator>::computeForces(unsigned int timestep)
     // start the profile
     if (this->m_prof) this->m_prof->push(this->m_exec_conf, "PotentialExternalGPU");
 
+    this->updateField();
+
     // access the particle data
     ArrayHandle<Scalar4> d_pos(this->m_pdata->getPositions(), access_location::device, access_mode::read);
     ArrayHandle<Scalar> d_diameter(this->m_pdata->getDiameters(), access_location::device, access_mode::read);
@@ -83,7 +85,6 @@ void PotentialExternalGPU<evaluator>::computeForces(unsigned int timestep)
     ArrayHandle<Scalar4> d_force(this->m_force, access_location::device, access_mode::overwrite);
     ArrayHandle<Scalar> d_virial(this->m_virial, access_location::device, access_mode::overwrite);
     ArrayHandle<typename evaluator::param_type> d_params(this->m_params, access_location::device, access_mode::read);
-    ArrayHandle<typename evaluator::field_type> d_field(this->m_field, access_location::device, access_mode::read);
 
     // access flags
     PDataFlags flags = this->m_pdata->getFlags();
@@ -99,7 +100,7 @@ void PotentialExternalGPU<evaluator>::computeForces(unsigned int timestep)
                          box,
                          this->m_tuner->getParam()),
                          d_params.data,
-                         d_field.data);
+                         this->m_field.data());
 
     if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
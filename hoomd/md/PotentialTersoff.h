@@ -9,13 +9,21 @@
 #include <stdexcept>
 #include <memory>
 #include <fstream>
+#include <vector>
 
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/Index1D.h"
 #include "hoomd/GPUArray.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ThreadLocalArray.h"
 #include "NeighborList.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
 
 /*! \file PotentialTersoff.h
     \brief Defines the template class for standard three-body potentials
@@ -62,6 +70,10 @@
     potential evaluator class passed in. See the appropriate documentation for the evaluator for the definition of each
     element of the parameters.
 
+    On the CPU, the displacements to all neighbors of a particle are computed once into a scratch list before the
+    j and k loops. With TBB, particles are processed in parallel, and the forces and virials on neighbors are
+    accumulated in per-thread arrays that are summed up at the end.
+
     For profiling and logging, PotentialTersoff needs to know the name of the potential. For now, that will be queried from
     the evaluator. Perhaps in the future we could allow users to change that so multiple pair potentials could be logged
     independently.
@@ -108,6 +120,23 @@ class PotentialTersoff : public ForceCompute
         std::string m_prof_name;                    //!< Cached profiler name
         std::string m_log_name;                     //!< Cached log name
 
+        //! Per-neighbor quantities of the central particle, shared by the j and k loops
+        struct neighbor_entry
+            {
+            Scalar3 dx;         //!< Minimum image displacement r_i - r_j
+            Scalar rsq;         //!< Squared distance
+            unsigned int idx;   //!< Index of the neighbor
+            unsigned int type;  //!< Type of the neighbor
+            };
+
+        #ifdef ENABLE_TBB
+        ThreadLocalArray<Scalar4> m_force_thread;   //!< Per-thread forces on the neighbors
+        ThreadLocalArray<Scalar> m_virial_thread;   //!< Per-thread virials on the neighbors
+        tbb::enumerable_thread_specific< std::vector<neighbor_entry> > m_neighbors_thread; //!< Per-thread neighbor scratch
+        #else
+        std::vector<neighbor_entry> m_neighbors;    //!< Neighbor scratch of the central particle
+        #endif
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
@@ -271,642 +300,593 @@ Scalar PotentialTersoff< evaluator >::getLogValue(const std::string& quantity, u
 template< class evaluator >
 void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
     {
-    // *****  check if we need the structure of the Tersoff or the RevCross potential for evaluation
-    if (evaluator::flag_for_RevCross )
-	{
-	// ***** RevCross potential
-        // start by updating the neighborlist
-        m_nlist->compute(timestep);
-
-        // start the profile for this compute
-        if (m_prof) m_prof->push(m_prof_name);
-
-        // The three-body potentials can't handle a half neighbor list, so check now.
-        bool third_law = m_nlist->getStorageMode() == NeighborList::half;
-        if (third_law)
-            {
-            m_exec_conf->msg->error() << std::endl << "PotentialRevCross cannot handle a half neighborlist"
-                                      << std::endl;
-            throw std::runtime_error("Error computing forces in PotentialRevCross");
-            }
+    // start by updating the neighborlist
+    m_nlist->compute(timestep);
 
-        // access the neighbor list, particle data, and system box
-        ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
+    // start the profile for this compute
+    if (m_prof) m_prof->push(m_prof_name);
 
-        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    // The three-body potentials can't handle a half neighbor list, so check now.
+    bool third_law = m_nlist->getStorageMode() == NeighborList::half;
+    if (third_law)
+        {
+        std::string name = evaluator::flag_for_RevCross ? "PotentialRevCross" : "PotentialTersoff";
+        m_exec_conf->msg->error() << std::endl << name << " cannot handle a half neighborlist"
+                                  << std::endl;
+        throw std::runtime_error("Error computing forces in " + name);
+        }
 
-        //force and virial arrays
-        ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
+    // access the neighbor list, particle data, and system box
+    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
 
-        PDataFlags flags = this->m_pdata->getFlags();
-        bool compute_virial = flags[pdata_flag::pressure_tensor];
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
 
-        const BoxDim& box = m_pdata->getBox();
-        ArrayHandle<Scalar> h_ronsq(m_ronsq, access_location::host, access_mode::read);
-        ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
-        ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
+    //force and virial arrays
+    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
 
-        // need to start from a zero force, energy
-        memset(h_force.data, 0, sizeof(Scalar4)*(m_pdata->getN()+m_pdata->getNGhosts()));
-        memset(h_virial.data, 0, sizeof(Scalar)*6*m_virial_pitch);
+    PDataFlags flags = this->m_pdata->getFlags();
+    bool compute_virial = flags[pdata_flag::pressure_tensor];
 
-        // for each particle
-        for (int i = 0; i < (int)m_pdata->getN(); i++)
-            {
-            // access the particle's position and type (MEM TRANSFER: 4 scalars)
-            Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-            const unsigned int head_i = h_head_list.data[i];
-            // sanity check
-            assert(typei < m_pdata->getNTypes());
-
-            // initialize current force and potential energy of particle i to 0
-            Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
-            Scalar pei = 0.0;
-
-            Scalar virialixx(0.0);
-            Scalar virialixy(0.0);
-            Scalar virialixz(0.0);
-            Scalar virialiyy(0.0);
-            Scalar virialiyz(0.0);
-            Scalar virializz(0.0);
-
-            // loop over all of the neighbors of this particle
-            const unsigned int size = (unsigned int)h_n_neigh.data[i];
-            for (unsigned int j = 0; j < size; j++)
-                {
-                // access the index of neighbor j (MEM TRANSFER: 1 scalar)
-                unsigned int jj = h_nlist.data[head_i + j];
-                assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
+    const BoxDim& box = m_pdata->getBox();
+    ArrayHandle<Scalar> h_ronsq(m_ronsq, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
+    ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
 
-                // access the position and type of particle j
-                Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
-                unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
-                assert(typej < m_pdata->getNTypes());
+    // need to start from a zero force, energy
+    memset(h_force.data, 0, sizeof(Scalar4)*(m_pdata->getN()+m_pdata->getNGhosts()));
+    memset(h_virial.data, 0, sizeof(Scalar)*6*m_virial_pitch);
 
-                // initialize the current force and potential energy of particle j to 0
-                Scalar3 fj = make_scalar3(0.0, 0.0, 0.0);
-                Scalar pej = 0.0;
+    unsigned int ntypes = m_pdata->getNTypes();
 
-                // calculate dr_ij (MEM TRANSFER: 3 scalars / FLOPS: 3)
-                Scalar3 dxij = posi - posj;
+    // compute the displacement to all neighbors of particle i once, the j and k loops only read them
+    auto fill_neighbors = [&](unsigned int i, std::vector<neighbor_entry>& neighbors)
+        {
+        Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        const unsigned int head_i = h_head_list.data[i];
+        const unsigned int size = (unsigned int)h_n_neigh.data[i];
 
-                // apply periodic boundary conditions
-                dxij = box.minImage(dxij);
+        if (neighbors.size() < size)
+            neighbors.resize(size);
 
-                // compute rij_sq (FLOPS: 5)
-                Scalar rij_sq = dot(dxij, dxij);
+        for (unsigned int j = 0; j < size; j++)
+            {
+            // access the index of neighbor j (MEM TRANSFER: 1 scalar)
+            unsigned int jj = h_nlist.data[head_i + j];
+            assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
+
+            // access the position and type of particle j
+            Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
+            unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
+            assert(typej < m_pdata->getNTypes());
+
+            // calculate dr_ij and apply periodic boundary conditions (MEM TRANSFER: 3 scalars / FLOPS: 3)
+            Scalar3 dxij = box.minImage(posi - posj);
+
+            neighbor_entry& neigh = neighbors[j];
+            neigh.dx = dxij;
+            neigh.rsq = dot(dxij, dxij);
+            neigh.idx = jj;
+            neigh.type = typej;
+            }
+        };
 
-                // get parameters for this type pair
-                unsigned int typpair_idx = m_typpair_idx(typei, typej);
-                param_type param = h_params.data[typpair_idx];
-                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+    // ***** RevCross potential, forces on i, j and k go to force and virial with the given pitch
+    auto compute_revcross = [&](unsigned int i, const std::vector<neighbor_entry>& neighbors,
+        Scalar4 *force, Scalar *virial, unsigned int virial_pitch)
+        {
+        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        // sanity check
+        assert(typei < m_pdata->getNTypes());
+
+        // initialize current force and potential energy of particle i to 0
+        Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
+        Scalar pei = 0.0;
+
+        Scalar virialixx(0.0);
+        Scalar virialixy(0.0);
+        Scalar virialixz(0.0);
+        Scalar virialiyy(0.0);
+        Scalar virialiyz(0.0);
+        Scalar virializz(0.0);
+
+        // loop over all of the neighbors of this particle
+        const unsigned int size = (unsigned int)h_n_neigh.data[i];
+        for (unsigned int j = 0; j < size; j++)
+            {
+            unsigned int jj = neighbors[j].idx;
+            unsigned int typej = neighbors[j].type;
+            Scalar3 dxij = neighbors[j].dx;
+            Scalar rij_sq = neighbors[j].rsq;
+
+            // initialize the current force and potential energy of particle j to 0
+            Scalar3 fj = make_scalar3(0.0, 0.0, 0.0);
+            Scalar pej = 0.0;
+
+            // get parameters for this type pair
+            unsigned int typpair_idx = m_typpair_idx(typei, typej);
+            param_type param = h_params.data[typpair_idx];
+            Scalar rcutsq = h_rcutsq.data[typpair_idx];
+
+            // evaluate the base repulsive and attractive terms
+            Scalar invratio = 0.0;
+            Scalar invratio2 = 0.0;
+            evaluator eval(rij_sq, rcutsq, param);
+            bool evaluated = eval.evalRepulsiveAndAttractive(invratio, invratio2);
+
+            // Even though the i-j interaction is symmetric so in principle I could consider i>j only,
+            // I have to loop over both i-j-k and j-i-k because I search only in neighbors of of the first element
+            // (since nl are type-wise I can not even merge them because i, j and k could be different types)
+            if (evaluated)
+                {
+                // evaluate the force and energy from the ij interaction
+                Scalar force_divr = Scalar(0.0);
+                Scalar potential_eng = Scalar(0.0);
+                Scalar bij = Scalar(0.0); // not used
+                eval.evalForceij(invratio, invratio2, Scalar(0.0), Scalar(0.0), bij, force_divr, potential_eng);
 
-                // evaluate the base repulsive and attractive terms
-                Scalar invratio = 0.0;
-                Scalar invratio2 = 0.0;
-                evaluator eval(rij_sq, rcutsq, param);
-                bool evaluated = eval.evalRepulsiveAndAttractive(invratio, invratio2);
+                // add this force to particle i
+                fi += force_divr * dxij;
+                pei += potential_eng ;
 
-                // Even though the i-j interaction is symmetric so in principle I could consider i>j only,
-                // I have to loop over both i-j-k and j-i-k because I search only in neighbors of of the first element
-                // (since nl are type-wise I can not even merge them because i, j and k could be different types)
-                if (evaluated)
+                // add this force to particle j
+                fj += Scalar(-1.0) * force_divr * dxij;
+                pej += potential_eng ;
+
+                //vir contribute for i j direct interaction on particle i and j
+                if (compute_virial)
                     {
-            	//printf("\nEvaluating the pair (i,j)=(%d, %d)  from inside HOOMD CPU",i,jj);
-                    // evaluate the force and energy from the ij interaction
-                    Scalar force_divr = Scalar(0.0);
-                    Scalar potential_eng = Scalar(0.0);
-                    Scalar bij = Scalar(0.0); // not used
-                    eval.evalForceij(invratio, invratio2, Scalar(0.0), Scalar(0.0), bij, force_divr, potential_eng);
-
-                    // add this force to particle i
-                    fi += force_divr * dxij;
-                    pei += potential_eng ;
-
-                    // add this force to particle j
-                    fj += Scalar(-1.0) * force_divr * dxij;
-                    pej += potential_eng ;
-
-                    //vir contribute for i j direct interaction on particle i and j
-            	if (compute_virial)
-            	    {
-                	    virialixx += force_divr*dxij.x*dxij.x;
-                	    virialixy += force_divr*dxij.x*dxij.y;
-                	    virialixz += force_divr*dxij.x*dxij.z;
-                	    virialiyy += force_divr*dxij.y*dxij.y;
-                	    virialiyz += force_divr*dxij.y*dxij.z;
-            	    	    virializz += force_divr*dxij.z*dxij.z;
-            	    }
+                    virialixx += force_divr*dxij.x*dxij.x;
+                    virialixy += force_divr*dxij.x*dxij.y;
+                    virialixz += force_divr*dxij.x*dxij.z;
+                    virialiyy += force_divr*dxij.y*dxij.y;
+                    virialiyz += force_divr*dxij.y*dxij.z;
+                    virializz += force_divr*dxij.z*dxij.z;
+                    }
 
-                    // evaluate the force from the ik interactions
-                    for (unsigned int k = j+1; k < size; k++)                    //I want to account only a single time for each triplets
+                // evaluate the force from the ik interactions
+                for (unsigned int k = j+1; k < size; k++)                    //I want to account only a single time for each triplets
+                    {
+                    unsigned int kk = neighbors[k].idx;
+                    unsigned int typek = neighbors[k].type;
+                    Scalar3 dxik = neighbors[k].dx;
+                    Scalar rik_sq = neighbors[k].rsq;
+
+                    // access the type pair parameters for i and k
+                    typpair_idx = m_typpair_idx(typei, typek);
+                    param_type temp_param = h_params.data[typpair_idx];             // use this to control the species wich have to interact
+
+                    // check if k interacts using a temporary evaluator to analyze i-k parameters
+                    evaluator temp_eval(rij_sq, rcutsq, temp_param);
+                    temp_eval.setRik(rik_sq);
+                    bool temp_evaluated = temp_eval.areInteractive();
+
+                    // 3 Body interaction ******
+                    if (temp_evaluated)
                         {
-                        // access the index of neighbor k
-                        unsigned int kk = h_nlist.data[head_i + k];
-                        assert(kk < m_pdata->getN());
-
-                        // access the position and type of neighbor k
-                        Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                        unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                        assert(typek < m_pdata->getNTypes());
+                        eval.setRik(rik_sq);
+                        // compute the total force and energy
+                        Scalar3 fk = make_scalar3(0.0, 0.0, 0.0);
+                        Scalar3 force_divr_ij_vec = make_scalar3(0.0, 0.0, 0.0);
+                        Scalar3 force_divr_ik_vec = make_scalar3(0.0, 0.0, 0.0);
+                        bool evaluatedk = eval.evalForceik(invratio,invratio2, Scalar(0.0), Scalar(0.0), force_divr_ij_vec, force_divr_ik_vec);
+                        // k interacts with the i-j as an additional third body
+                        if(evaluatedk)
+                            {
+                            // I stored the modulus of the force in the first component
+                            Scalar force_divr_ij=force_divr_ij_vec.x;
+                            Scalar force_divr_ik=force_divr_ik_vec.x;
 
-                        // access the type pair parameters for i and k
-                        typpair_idx = m_typpair_idx(typei, typek);
-                        param_type temp_param = h_params.data[typpair_idx];             // use this to control the species wich have to interact
+                            // add the force to particle i
+                            fi += force_divr_ij * dxij + force_divr_ik * dxik;
 
-                        // compute dr_ik
-                        Scalar3 dxik = posi - posk;
-                        // apply periodic boundary conditions
-                        dxik = box.minImage(dxik);
-                        // compute rik_sq
-                        Scalar rik_sq = dot(dxik, dxik);
+                            // add the force to particle j (FLOPS: 17)
+                            fj += force_divr_ij * dxij * Scalar(-1.0);
 
-                        // check if k interacts using a temporary evaluator to analyze i-k parameters
-                        evaluator temp_eval(rij_sq, rcutsq, temp_param);
-                        temp_eval.setRik(rik_sq);
-                        bool temp_evaluated = temp_eval.areInteractive();
+                            // add the force to particle k
+                            fk += force_divr_ik * dxik * Scalar(-1.0);
 
-            	    // 3 Body interaction ******
-                        if (temp_evaluated)
-                            {
-            		eval.setRik(rik_sq);
-                            // compute the total force and energy
-                            Scalar3 fk = make_scalar3(0.0, 0.0, 0.0);
-                            Scalar3 force_divr_ij_vec = make_scalar3(0.0, 0.0, 0.0);
-                            Scalar3 force_divr_ik_vec = make_scalar3(0.0, 0.0, 0.0);
-                            bool evaluatedk = eval.evalForceik(invratio,invratio2, Scalar(0.0), Scalar(0.0), force_divr_ij_vec, force_divr_ik_vec);
-            	            // k interacts with the i-j as an additional third body
-                            if(evaluatedk)
-                            	{
-				// I stored the modulus of the force in the first component
-				Scalar force_divr_ij=force_divr_ij_vec.x;
-				Scalar force_divr_ik=force_divr_ik_vec.x;
-
-                            	// add the force to particle i
-                            	fi += force_divr_ij * dxij + force_divr_ik * dxik;
-
-                            	// add the force to particle j (FLOPS: 17)
-                            	fj += force_divr_ij * dxij * Scalar(-1.0);
-
-                            	// add the force to particle k
-                            	fk += force_divr_ik * dxik * Scalar(-1.0);
-
-                            	if (compute_virial)
-                               	{
-                            		//***look at 3 body pressure notes
-                            		//i just need a single term to account for all of the 3 body virial that i decide to store in the i particle's data
-                            		//and i just defined the diagonal component of pressure tensor, I don't know how the off diagonal terms can be included
-                            		virialixx += (force_divr_ij*dxij.x*dxij.x + force_divr_ik*dxik.x*dxik.x);
-                            		virialiyy += (force_divr_ij*dxij.y*dxij.y + force_divr_ik*dxik.y*dxik.y);
-                            		virializz += (force_divr_ij*dxij.z*dxij.z + force_divr_ik*dxik.z*dxik.z);
-                            		virialixy += (force_divr_ij*dxij.x*dxij.y + force_divr_ik*dxik.x*dxik.y);
-                              			virialixz += (force_divr_ij*dxij.x*dxij.z + force_divr_ik*dxik.x*dxik.z);
-                            			virialiyz += (force_divr_ij*dxij.y*dxij.z + force_divr_ik*dxik.y*dxik.z);
-                                   	}
-
-
-                            	// increment the force for particle k
-                            	unsigned int mem_idx = kk;
-                            	h_force.data[mem_idx].x += fk.x;
-                            	h_force.data[mem_idx].y += fk.y;
-                            	h_force.data[mem_idx].z += fk.z;
+                            if (compute_virial)
+                                {
+                                //***look at 3 body pressure notes
+                                //i just need a single term to account for all of the 3 body virial that i decide to store in the i particle's data
+                                //and i just defined the diagonal component of pressure tensor, I don't know how the off diagonal terms can be included
+                                virialixx += (force_divr_ij*dxij.x*dxij.x + force_divr_ik*dxik.x*dxik.x);
+                                virialiyy += (force_divr_ij*dxij.y*dxij.y + force_divr_ik*dxik.y*dxik.y);
+                                virializz += (force_divr_ij*dxij.z*dxij.z + force_divr_ik*dxik.z*dxik.z);
+                                virialixy += (force_divr_ij*dxij.x*dxij.y + force_divr_ik*dxik.x*dxik.y);
+                                virialixz += (force_divr_ij*dxij.x*dxij.z + force_divr_ik*dxik.x*dxik.z);
+                                virialiyz += (force_divr_ij*dxij.y*dxij.z + force_divr_ik*dxik.y*dxik.z);
                                 }
+
+                            // increment the force for particle k
+                            unsigned int mem_idx = kk;
+                            force[mem_idx].x += fk.x;
+                            force[mem_idx].y += fk.y;
+                            force[mem_idx].z += fk.z;
                             }
                         }
                     }
-
-                // increment the force and potential energy for particle j
-                unsigned int mem_idx = jj;
-                h_force.data[mem_idx].x += fj.x;
-                h_force.data[mem_idx].y += fj.y;
-                h_force.data[mem_idx].z += fj.z;
-                h_force.data[mem_idx].w += pej;
-
-                }
-
-            // finally, increment the force and potential energy for particle i
-            unsigned int mem_idx = i;
-            h_force.data[mem_idx].x += fi.x;
-            h_force.data[mem_idx].y += fi.y;
-            h_force.data[mem_idx].z += fi.z;
-            h_force.data[mem_idx].w += pei;
-
-            //imcrement vir for i
-            if (compute_virial)
-                {
-                h_virial.data[0*m_virial_pitch+mem_idx] += virialixx;
-                h_virial.data[1*m_virial_pitch+mem_idx] += virialixy;
-                h_virial.data[2*m_virial_pitch+mem_idx] += virialixz;
-                h_virial.data[3*m_virial_pitch+mem_idx] += virialiyy;
-                h_virial.data[4*m_virial_pitch+mem_idx] += virialiyz;
-                h_virial.data[5*m_virial_pitch+mem_idx] += virializz;
                 }
 
+            // increment the force and potential energy for particle j
+            unsigned int mem_idx = jj;
+            force[mem_idx].x += fj.x;
+            force[mem_idx].y += fj.y;
+            force[mem_idx].z += fj.z;
+            force[mem_idx].w += pej;
             }
-	}
-    else
-        {
-        // ****** Tersoff or SquareDensity potential
-        // start by updating the neighborlist
-        m_nlist->compute(timestep);
 
-        // start the profile for this compute
-        if (m_prof) m_prof->push(m_prof_name);
+        // finally, increment the force and potential energy for particle i
+        unsigned int mem_idx = i;
+        force[mem_idx].x += fi.x;
+        force[mem_idx].y += fi.y;
+        force[mem_idx].z += fi.z;
+        force[mem_idx].w += pei;
 
-        // The three-body potentials can't handle a half neighbor list, so check now.
-        bool third_law = m_nlist->getStorageMode() == NeighborList::half;
-        if (third_law)
+        //imcrement vir for i
+        if (compute_virial)
             {
-            m_exec_conf->msg->error() << std::endl << "PotentialTersoff cannot handle a half neighborlist"
-                                      << std::endl;
-            throw std::runtime_error("Error computing forces in PotentialTersoff");
+            virial[0*virial_pitch+mem_idx] += virialixx;
+            virial[1*virial_pitch+mem_idx] += virialixy;
+            virial[2*virial_pitch+mem_idx] += virialixz;
+            virial[3*virial_pitch+mem_idx] += virialiyy;
+            virial[4*virial_pitch+mem_idx] += virialiyz;
+            virial[5*virial_pitch+mem_idx] += virializz;
             }
+        };
 
-        // access the neighbor list, particle data, and system box
-        ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
-
-        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    // ****** Tersoff or SquareDensity potential, forces on i, j and k go to force and virial with the given pitch
+    auto compute_tersoff = [&](unsigned int i, const std::vector<neighbor_entry>& neighbors,
+        Scalar4 *force, Scalar *virial, unsigned int virial_pitch)
+        {
+        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        // sanity check
+        assert(typei < m_pdata->getNTypes());
 
+        // initialize current force and potential energy of particle i to 0
+        Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
+        Scalar pei = 0.0;
 
-        //force and virial arrays
-        ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
+        Scalar viriali_xx(0.0);
+        Scalar viriali_xy(0.0);
+        Scalar viriali_xz(0.0);
+        Scalar viriali_yy(0.0);
+        Scalar viriali_yz(0.0);
+        Scalar viriali_zz(0.0);
 
-        PDataFlags flags = this->m_pdata->getFlags();
-        bool compute_virial = flags[pdata_flag::pressure_tensor];
+        Scalar phi_ab[ntypes];
 
-        const BoxDim& box = m_pdata->getBox();
-        ArrayHandle<Scalar> h_ronsq(m_ronsq, access_location::host, access_mode::read);
-        ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
-        ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
+        // reset phi
+        for (unsigned int typ_b = 0; typ_b < ntypes; ++typ_b)
+            {
+            phi_ab[typ_b] = Scalar(0.0);
+            }
 
-        // need to start from a zero force, energy
-        memset(h_force.data, 0, sizeof(Scalar4)*(m_pdata->getN()+m_pdata->getNGhosts()));
-        memset(h_virial.data, 0, sizeof(Scalar)*6*m_virial_pitch);
+        // all neighbors of this particle
+        const unsigned int size = (unsigned int)h_n_neigh.data[i];
+        if (evaluator::hasPerParticleEnergy())
+            {
+            for (unsigned int j = 0; j < size; j++)
+                {
+                // get parameters for this type pair
+                unsigned int typpair_idx = m_typpair_idx(typei, neighbors[j].type);
+                param_type param = h_params.data[typpair_idx];
+                Scalar rcutsq = h_rcutsq.data[typpair_idx];
 
-        unsigned int ntypes = m_pdata->getNTypes();
+                // evaluate the scalar per-neighbor contribution
+                evaluator eval(neighbors[j].rsq, rcutsq, param);
+                eval.evalPhi(phi_ab[neighbors[j].type]);
+                }
 
-        // for each particle
-        for (int i = 0; i < (int)m_pdata->getN(); i++)
-            {
-            // access the particle's position and type (MEM TRANSFER: 4 scalars)
-            Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-            const unsigned int head_i = h_head_list.data[i];
-            // sanity check
-            assert(typei < m_pdata->getNTypes());
-
-            // initialize current force and potential energy of particle i to 0
-            Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
-            Scalar pei = 0.0;
-
-            Scalar viriali_xx(0.0);
-            Scalar viriali_xy(0.0);
-            Scalar viriali_xz(0.0);
-            Scalar viriali_yy(0.0);
-            Scalar viriali_yz(0.0);
-            Scalar viriali_zz(0.0);
-
-            Scalar phi_ab[ntypes];
-
-            // reset phi
+            // self-energy
             for (unsigned int typ_b = 0; typ_b < ntypes; ++typ_b)
                 {
-                phi_ab[typ_b] = Scalar(0.0);
+                unsigned int typpair_idx = m_typpair_idx(typei,typ_b);
+                param_type param = h_params.data[typpair_idx];
+                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                evaluator eval(Scalar(0.0), rcutsq, param);
+                Scalar energy(0.0);
+                eval.evalSelfEnergy(energy, phi_ab[typ_b]);
+                pei += energy;
                 }
+            }
 
-            // all neighbors of this particle
-            const unsigned int size = (unsigned int)h_n_neigh.data[i];
-            if (evaluator::hasPerParticleEnergy())
+        // loop over all of the neighbors of this particle
+        for (unsigned int j = 0; j < size; j++)
+            {
+            unsigned int jj = neighbors[j].idx;
+            unsigned int typej = neighbors[j].type;
+            Scalar3 dxij = neighbors[j].dx;
+            Scalar rij_sq = neighbors[j].rsq;
+
+            // initialize the current force and potential energy of particle j to 0
+            Scalar3 fj = make_scalar3(0.0, 0.0, 0.0);
+            Scalar pej = 0.0;
+
+            // get parameters for this type pair
+            unsigned int typpair_idx = m_typpair_idx(typei, typej);
+            param_type param = h_params.data[typpair_idx];
+            Scalar rcutsq = h_rcutsq.data[typpair_idx];
+
+            // evaluate the base repulsive and attractive terms
+            Scalar fR = 0.0;
+            Scalar fA = 0.0;
+            evaluator eval(rij_sq, rcutsq, param);
+            bool evaluated = eval.evalRepulsiveAndAttractive(fR, fA);
+
+            Scalar virialj_xx(0.0);
+            Scalar virialj_xy(0.0);
+            Scalar virialj_xz(0.0);
+            Scalar virialj_yy(0.0);
+            Scalar virialj_yz(0.0);
+            Scalar virialj_zz(0.0);
+
+            if (evaluated)
                 {
-                for (unsigned int j = 0; j < size; j++)
+                // evaluate chi
+                Scalar chi = 0.0;
+                if (evaluator::needsChi())
                     {
-                    // access the index of neighbor j (MEM TRANSFER: 1 scalar)
-                    unsigned int jj = h_nlist.data[head_i + j];
-                    assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
-
-                    // access the position and type of particle j
-                    Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
-                    unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
-                    assert(typej < m_pdata->getNTypes());
+                    for (unsigned int k = 0; k < size; k++)
+                        {
+                        unsigned int kk = neighbors[k].idx;
 
-                    // calculate dr_ij (MEM TRANSFER: 3 scalars / FLOPS: 3)
-                    Scalar3 dxij = posi - posj;
+                        // access the type pair parameters for i and k
+                        typpair_idx = m_typpair_idx(typei, neighbors[k].type);
+                        param_type temp_param = h_params.data[typpair_idx];
 
-                    // apply periodic boundary conditions
-                    dxij = box.minImage(dxij);
+                        evaluator temp_eval(rij_sq, rcutsq, temp_param);
+                        bool temp_evaluated = temp_eval.areInteractive();
 
-                    // compute rij_sq (FLOPS: 5)
-                    Scalar rij_sq = dot(dxij, dxij);
+                        if (kk != jj && temp_evaluated)
+                            {
+                            Scalar3 dxik = neighbors[k].dx;
+                            Scalar rik_sq = neighbors[k].rsq;
 
-                    // get parameters for this type pair
-                    unsigned int typpair_idx = m_typpair_idx(typei, typej);
-                    param_type param = h_params.data[typpair_idx];
-                    Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                            // compute the bond angle (if needed)
+                            Scalar cos_th = Scalar(0.0);
+                            if (evaluator::needsAngle())
+                                cos_th = dot(dxij, dxik) / fast::sqrt(rij_sq * rik_sq);
 
-                    // evaluate the scalar per-neighbor contribution
-                    evaluator eval(rij_sq, rcutsq, param);
-                    eval.evalPhi(phi_ab[typej]);
-                    }
+                            // evaluate the partial chi term
+                            eval.setRik(rik_sq);
+                            if (evaluator::needsAngle())
+                                eval.setAngle(cos_th);
 
-                // self-energy
-                for (unsigned int typ_b = 0; typ_b < ntypes; ++typ_b)
-                    {
-                    unsigned int typpair_idx = m_typpair_idx(typei,typ_b);
-                    param_type param = h_params.data[typpair_idx];
-                    Scalar rcutsq = h_rcutsq.data[typpair_idx];
-                    evaluator eval(Scalar(0.0), rcutsq, param);
-                    Scalar energy(0.0);
-                    eval.evalSelfEnergy(energy, phi_ab[typ_b]);
-                    pei += energy;
+                            eval.evalChi(chi);
+                            }
+                        }
                     }
-                }
-
-            // loop over all of the neighbors of this particle
-            for (unsigned int j = 0; j < size; j++)
-                {
-                // access the index of neighbor j (MEM TRANSFER: 1 scalar)
-                unsigned int jj = h_nlist.data[head_i + j];
-                assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
 
-                // access the position and type of particle j
-                Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
-                unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
-                assert(typej < m_pdata->getNTypes());
+                // evaluate the force and energy from the ij interaction
+                Scalar force_divr = Scalar(0.0);
+                Scalar potential_eng = Scalar(0.0);
+                Scalar bij = Scalar(0.0);
+                eval.evalForceij(fR, fA, chi, phi_ab[typej], bij, force_divr, potential_eng);
 
-                // initialize the current force and potential energy of particle j to 0
-                Scalar3 fj = make_scalar3(0.0, 0.0, 0.0);
-                Scalar pej = 0.0;
+                // add this force to particle i
+                fi += force_divr * dxij;
+                pei += potential_eng * Scalar(0.5);
 
-                // calculate dr_ij (MEM TRANSFER: 3 scalars / FLOPS: 3)
-                Scalar3 dxij = posi - posj;
-
-                // apply periodic boundary conditions
-                dxij = box.minImage(dxij);
-
-                // compute rij_sq (FLOPS: 5)
-                Scalar rij_sq = dot(dxij, dxij);
-
-                // get parameters for this type pair
-                unsigned int typpair_idx = m_typpair_idx(typei, typej);
-                param_type param = h_params.data[typpair_idx];
-                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                if (compute_virial)
+                    {
+                    Scalar force_div2r = Scalar(0.5)*force_divr;
+
+                    viriali_xx += force_div2r*dxij.x*dxij.x;
+                    viriali_xy += force_div2r*dxij.x*dxij.y;
+                    viriali_xz += force_div2r*dxij.x*dxij.z;
+                    viriali_yy += force_div2r*dxij.y*dxij.y;
+                    viriali_yz += force_div2r*dxij.y*dxij.z;
+                    viriali_zz += force_div2r*dxij.z*dxij.z;
+                    }
 
-                // evaluate the base repulsive and attractive terms
-                Scalar fR = 0.0;
-                Scalar fA = 0.0;
-                evaluator eval(rij_sq, rcutsq, param);
-                bool evaluated = eval.evalRepulsiveAndAttractive(fR, fA);
+                // add this force to particle j
+                fj += Scalar(-1.0) * force_divr * dxij;
+                pej += potential_eng * Scalar(0.5);
 
-                Scalar virialj_xx(0.0);
-                Scalar virialj_xy(0.0);
-                Scalar virialj_xz(0.0);
-                Scalar virialj_yy(0.0);
-                Scalar virialj_yz(0.0);
-                Scalar virialj_zz(0.0);
+                if (compute_virial)
+                    {
+                    Scalar force_div2r = Scalar(0.5)*force_divr;
+
+                    virialj_xx += force_div2r*dxij.x*dxij.x;
+                    virialj_xy += force_div2r*dxij.x*dxij.y;
+                    virialj_xz += force_div2r*dxij.x*dxij.z;
+                    virialj_yy += force_div2r*dxij.y*dxij.y;
+                    virialj_yz += force_div2r*dxij.y*dxij.z;
+                    virialj_zz += force_div2r*dxij.z*dxij.z;
+                    }
 
-                if (evaluated)
+                if (evaluator::hasIkForce())
                     {
-                    // evaluate chi
-                    Scalar chi = 0.0;
-                    if (evaluator::needsChi())
+                    // evaluate the force from the ik interactions
+                    for (unsigned int k = 0; k < size; k++)
                         {
-                        for (unsigned int k = 0; k < size; k++)
-                            {
-                            // access the index of neighbor k
-                            unsigned int kk = h_nlist.data[head_i + k];
-                            assert(kk < m_pdata->getN());
-
-                            // access the position and type of neighbor k
-                            Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                            unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                            assert(typek < m_pdata->getNTypes());
+                        unsigned int kk = neighbors[k].idx;
 
-                            // access the type pair parameters for i and k
-                            typpair_idx = m_typpair_idx(typei, typek);
-                            param_type temp_param = h_params.data[typpair_idx];
-
-                            evaluator temp_eval(rij_sq, rcutsq, temp_param);
-                            bool temp_evaluated = temp_eval.areInteractive();
+                        // access the type pair parameters for i and k
+                        typpair_idx = m_typpair_idx(typei, neighbors[k].type);
+                        param_type temp_param = h_params.data[typpair_idx];
 
-                            if (kk != jj && temp_evaluated)
-                                {
-                                // compute drik
-                                Scalar3 dxik = posi - posk;
+                        evaluator temp_eval(rij_sq, rcutsq, temp_param);
+                        bool temp_evaluated = temp_eval.areInteractive();
 
-                                // apply periodic boundary conditions
-                                dxik = box.minImage(dxik);
+                        if (kk != jj && temp_evaluated)
+                            {
+                            // create variable for the force on k
+                            Scalar3 fk = make_scalar3(0.0, 0.0, 0.0);
 
-                                // compute rik_sq
-                                Scalar rik_sq = dot(dxik, dxik);
+                            Scalar3 dxik = neighbors[k].dx;
+                            Scalar rik_sq = neighbors[k].rsq;
 
-                                // compute the bond angle (if needed)
-                                Scalar cos_th = Scalar(0.0);
-                                if (evaluator::needsAngle())
-                                    cos_th = dot(dxij, dxik) / fast::sqrt(rij_sq * rik_sq);
+                            // compute the bond angle (if needed)
+                            Scalar cos_th = Scalar(0.0);
+                            if (evaluator::needsAngle())
+                                cos_th = dot(dxij, dxik) / sqrt(rij_sq * rik_sq);
 
-                                // evaluate the partial chi term
-                                eval.setRik(rik_sq);
-                                if (evaluator::needsAngle())
-                                    eval.setAngle(cos_th);
+                            // set up the evaluator
+                            eval.setRik(rik_sq);
+                            if (evaluator::needsAngle())
+                                eval.setAngle(cos_th);
 
-                                eval.evalChi(chi);
+                            // compute the total force and energy
+                            Scalar3 force_divr_ij = make_scalar3(0.0, 0.0, 0.0);
+                            Scalar3 force_divr_ik = make_scalar3(0.0, 0.0, 0.0);
+                            eval.evalForceik(fR, fA, chi, bij, force_divr_ij, force_divr_ik);
+
+                            // add the force to particle i
+                            // (FLOPS: 17)
+                            fi.x += force_divr_ij.x * dxij.x + force_divr_ik.x * dxik.x;
+                            fi.y += force_divr_ij.x * dxij.y + force_divr_ik.x * dxik.y;
+                            fi.z += force_divr_ij.x * dxij.z + force_divr_ik.x * dxik.z;
+
+                            // NOTE: virial for ik forces not tested
+                            if (compute_virial)
+                                {
+                                Scalar force_div2r_ij = Scalar(0.5)*force_divr_ij.x;
+                                Scalar force_div2r_ik = Scalar(0.5)*force_divr_ik.x;
+                                viriali_xx += force_div2r_ij*dxij.x*dxij.x + force_div2r_ik*dxik.x*dxik.x;
+                                viriali_xy += force_div2r_ij*dxij.x*dxij.y + force_div2r_ik*dxik.x*dxik.y;
+                                viriali_xz += force_div2r_ij*dxij.x*dxij.z + force_div2r_ik*dxik.x*dxik.z;
+                                viriali_yy += force_div2r_ij*dxij.y*dxij.y + force_div2r_ik*dxik.y*dxik.y;
+                                viriali_yz += force_div2r_ij*dxij.y*dxij.z + force_div2r_ik*dxik.y*dxik.z;
+                                viriali_zz += force_div2r_ij*dxij.z*dxij.z + force_div2r_ik*dxik.z*dxik.z;
                                 }
-                            }
-                        }
-
-                    // evaluate the force and energy from the ij interaction
-                    Scalar force_divr = Scalar(0.0);
-                    Scalar potential_eng = Scalar(0.0);
-                    Scalar bij = Scalar(0.0);
-                    eval.evalForceij(fR, fA, chi, phi_ab[typej], bij, force_divr, potential_eng);
-
-                    // add this force to particle i
-                    fi += force_divr * dxij;
-                    pei += potential_eng * Scalar(0.5);
 
-                    if (compute_virial)
-                        {
-                        Scalar force_div2r = Scalar(0.5)*force_divr;
-
-                        viriali_xx += force_div2r*dxij.x*dxij.x;
-                        viriali_xy += force_div2r*dxij.x*dxij.y;
-                        viriali_xz += force_div2r*dxij.x*dxij.z;
-                        viriali_yy += force_div2r*dxij.y*dxij.y;
-                        viriali_yz += force_div2r*dxij.y*dxij.z;
-                        viriali_zz += force_div2r*dxij.z*dxij.z;
-                        }
-
-                    // add this force to particle j
-                    fj += Scalar(-1.0) * force_divr * dxij;
-                    pej += potential_eng * Scalar(0.5);
-
-                    if (compute_virial)
-                        {
-                        Scalar force_div2r = Scalar(0.5)*force_divr;
-
-                        virialj_xx += force_div2r*dxij.x*dxij.x;
-                        virialj_xy += force_div2r*dxij.x*dxij.y;
-                        virialj_xz += force_div2r*dxij.x*dxij.z;
-                        virialj_yy += force_div2r*dxij.y*dxij.y;
-                        virialj_yz += force_div2r*dxij.y*dxij.z;
-                        virialj_zz += force_div2r*dxij.z*dxij.z;
-                        }
+                            // add the force to particle j (FLOPS: 17)
+                            fj.x += force_divr_ij.y * dxij.x + force_divr_ik.y * dxik.x;
+                            fj.y += force_divr_ij.y * dxij.y + force_divr_ik.y * dxik.y;
+                            fj.z += force_divr_ij.y * dxij.z + force_divr_ik.y * dxik.z;
 
-                    if (evaluator::hasIkForce())
-                        {
-                        // evaluate the force from the ik interactions
-                        for (unsigned int k = 0; k < size; k++)
-                            {
-                            // access the index of neighbor k
-                            unsigned int kk = h_nlist.data[head_i + k];
-                            assert(kk < m_pdata->getN());
-
-                            // access the position and type of neighbor k
-                            Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                            unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                            assert(typek < m_pdata->getNTypes());
+                            // NOTE: virial for ik forces not tested
+                            if (compute_virial)
+                                {
+                                Scalar force_div2r_ij = Scalar(0.5)*force_divr_ij.y;
+                                Scalar force_div2r_ik = Scalar(0.5)*force_divr_ik.y;
+                                virialj_xx += force_div2r_ij*dxij.x*dxij.x + force_div2r_ik*dxik.x*dxik.x;
+                                virialj_xy += force_div2r_ij*dxij.x*dxij.y + force_div2r_ik*dxik.x*dxik.y;
+                                virialj_xz += force_div2r_ij*dxij.x*dxij.z + force_div2r_ik*dxik.x*dxik.z;
+                                virialj_yy += force_div2r_ij*dxij.y*dxij.y + force_div2r_ik*dxik.y*dxik.y;
+                                virialj_yz += force_div2r_ij*dxij.y*dxij.z + force_div2r_ik*dxik.y*dxik.z;
+                                virialj_zz += force_div2r_ij*dxij.z*dxij.z + force_div2r_ik*dxik.z*dxik.z;
+                                }
 
-                            // access the type pair parameters for i and k
-                            typpair_idx = m_typpair_idx(typei, typek);
-                            param_type temp_param = h_params.data[typpair_idx];
+                            // add the force to particle k
+                            fk.x += force_divr_ij.z * dxij.x + force_divr_ik.z * dxik.x;
+                            fk.y += force_divr_ij.z * dxij.y + force_divr_ik.z * dxik.y;
+                            fk.z += force_divr_ij.z * dxij.z + force_divr_ik.z * dxik.z;
 
-                            evaluator temp_eval(rij_sq, rcutsq, temp_param);
-                            bool temp_evaluated = temp_eval.areInteractive();
+                            // increment the force for particle k
+                            unsigned int mem_idx = kk;
+                            force[mem_idx].x += fk.x;
+                            force[mem_idx].y += fk.y;
+                            force[mem_idx].z += fk.z;
 
-                            if (kk != jj && temp_evaluated)
+                            if (compute_virial)
                                 {
-                                // create variable for the force on k
-                                Scalar3 fk = make_scalar3(0.0, 0.0, 0.0);
-
-                                // compute dr_ik
-                                Scalar3 dxik = posi - posk;
-
-                                // apply periodic boundary conditions
-                                dxik = box.minImage(dxik);
-
-                                // compute rik_sq
-                                Scalar rik_sq = dot(dxik, dxik);
-
-                                // compute the bond angle (if needed)
-                                Scalar cos_th = Scalar(0.0);
-                                if (evaluator::needsAngle())
-                                    cos_th = dot(dxij, dxik) / sqrt(rij_sq * rik_sq);
-
-                                // set up the evaluator
-                                eval.setRik(rik_sq);
-                                if (evaluator::needsAngle())
-                                    eval.setAngle(cos_th);
-
-                                // compute the total force and energy
-                                Scalar3 force_divr_ij = make_scalar3(0.0, 0.0, 0.0);
-                                Scalar3 force_divr_ik = make_scalar3(0.0, 0.0, 0.0);
-                                eval.evalForceik(fR, fA, chi, bij, force_divr_ij, force_divr_ik);
-
-                                // add the force to particle i
-                                // (FLOPS: 17)
-                                fi.x += force_divr_ij.x * dxij.x + force_divr_ik.x * dxik.x;
-                                fi.y += force_divr_ij.x * dxij.y + force_divr_ik.x * dxik.y;
-                                fi.z += force_divr_ij.x * dxij.z + force_divr_ik.x * dxik.z;
-
-                                // NOTE: virial for ik forces not tested
-                                if (compute_virial)
-                                    {
-                                    Scalar force_div2r_ij = Scalar(0.5)*force_divr_ij.x;
-                                    Scalar force_div2r_ik = Scalar(0.5)*force_divr_ik.x;
-                                    viriali_xx += force_div2r_ij*dxij.x*dxij.x + force_div2r_ik*dxik.x*dxik.x;
-                                    viriali_xy += force_div2r_ij*dxij.x*dxij.y + force_div2r_ik*dxik.x*dxik.y;
-                                    viriali_xz += force_div2r_ij*dxij.x*dxij.z + force_div2r_ik*dxik.x*dxik.z;
-                                    viriali_yy += force_div2r_ij*dxij.y*dxij.y + force_div2r_ik*dxik.y*dxik.y;
-                                    viriali_yz += force_div2r_ij*dxij.y*dxij.z + force_div2r_ik*dxik.y*dxik.z;
-                                    viriali_zz += force_div2r_ij*dxij.z*dxij.z + force_div2r_ik*dxik.z*dxik.z;
-                                    }
-
-                                // add the force to particle j (FLOPS: 17)
-                                fj.x += force_divr_ij.y * dxij.x + force_divr_ik.y * dxik.x;
-                                fj.y += force_divr_ij.y * dxij.y + force_divr_ik.y * dxik.y;
-                                fj.z += force_divr_ij.y * dxij.z + force_divr_ik.y * dxik.z;
-
-                                // NOTE: virial for ik forces not tested
-                                if (compute_virial)
-                                    {
-                                    Scalar force_div2r_ij = Scalar(0.5)*force_divr_ij.y;
-                                    Scalar force_div2r_ik = Scalar(0.5)*force_divr_ik.y;
-                                    virialj_xx += force_div2r_ij*dxij.x*dxij.x + force_div2r_ik*dxik.x*dxik.x;
-                                    virialj_xy += force_div2r_ij*dxij.x*dxij.y + force_div2r_ik*dxik.x*dxik.y;
-                                    virialj_xz += force_div2r_ij*dxij.x*dxij.z + force_div2r_ik*dxik.x*dxik.z;
-                                    virialj_yy += force_div2r_ij*dxij.y*dxij.y + force_div2r_ik*dxik.y*dxik.y;
-                                    virialj_yz += force_div2r_ij*dxij.y*dxij.z + force_div2r_ik*dxik.y*dxik.z;
-                                    virialj_zz += force_div2r_ij*dxij.z*dxij.z + force_div2r_ik*dxik.z*dxik.z;
-                                    }
-
-                                // add the force to particle k
-                                fk.x += force_divr_ij.z * dxij.x + force_divr_ik.z * dxik.x;
-                                fk.y += force_divr_ij.z * dxij.y + force_divr_ik.z * dxik.y;
-                                fk.z += force_divr_ij.z * dxij.z + force_divr_ik.z * dxik.z;
-
-                                // increment the force for particle k
-                                unsigned int mem_idx = kk;
-                                h_force.data[mem_idx].x += fk.x;
-                                h_force.data[mem_idx].y += fk.y;
-                                h_force.data[mem_idx].z += fk.z;
-
-                                if (compute_virial)
-                                    {
-                                    Scalar force_div2r_ij = Scalar(0.5)*force_divr_ij.z;
-                                    Scalar force_div2r_ik = Scalar(0.5)*force_divr_ik.z;
-                                    h_virial.data[0*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.x + force_div2r_ik*dxik.x*dxik.x;
-                                    h_virial.data[1*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.y + force_div2r_ik*dxik.x*dxik.y;
-                                    h_virial.data[2*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.z + force_div2r_ik*dxik.x*dxik.z;
-                                    h_virial.data[3*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.y + force_div2r_ik*dxik.y*dxik.y;
-                                    h_virial.data[4*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.z + force_div2r_ik*dxik.y*dxik.z;
-                                    h_virial.data[5*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.z*dxij.z + force_div2r_ik*dxik.z*dxik.z;
-                                    }
+                                Scalar force_div2r_ij = Scalar(0.5)*force_divr_ij.z;
+                                Scalar force_div2r_ik = Scalar(0.5)*force_divr_ik.z;
+                                virial[0*virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.x + force_div2r_ik*dxik.x*dxik.x;
+                                virial[1*virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.y + force_div2r_ik*dxik.x*dxik.y;
+                                virial[2*virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.z + force_div2r_ik*dxik.x*dxik.z;
+                                virial[3*virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.y + force_div2r_ik*dxik.y*dxik.y;
+                                virial[4*virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.z + force_div2r_ik*dxik.y*dxik.z;
+                                virial[5*virial_pitch+mem_idx] += force_div2r_ij*dxij.z*dxij.z + force_div2r_ik*dxik.z*dxik.z;
                                 }
                             }
                         }
                     }
-                // increment the force and potential energy for particle j
-                unsigned int mem_idx = jj;
-                h_force.data[mem_idx].x += fj.x;
-                h_force.data[mem_idx].y += fj.y;
-                h_force.data[mem_idx].z += fj.z;
-                h_force.data[mem_idx].w += pej;
+                }
+            // increment the force and potential energy for particle j
+            unsigned int mem_idx = jj;
+            force[mem_idx].x += fj.x;
+            force[mem_idx].y += fj.y;
+            force[mem_idx].z += fj.z;
+            force[mem_idx].w += pej;
 
-                if (compute_virial)
-                    {
-                    h_virial.data[0*m_virial_pitch+mem_idx] += virialj_xx;
-                    h_virial.data[1*m_virial_pitch+mem_idx] += virialj_xy;
-                    h_virial.data[2*m_virial_pitch+mem_idx] += virialj_xz;
-                    h_virial.data[3*m_virial_pitch+mem_idx] += virialj_yy;
-                    h_virial.data[4*m_virial_pitch+mem_idx] += virialj_yz;
-                    h_virial.data[5*m_virial_pitch+mem_idx] += virialj_zz;
-                    }
+            if (compute_virial)
+                {
+                virial[0*virial_pitch+mem_idx] += virialj_xx;
+                virial[1*virial_pitch+mem_idx] += virialj_xy;
+                virial[2*virial_pitch+mem_idx] += virialj_xz;
+                virial[3*virial_pitch+mem_idx] += virialj_yy;
+                virial[4*virial_pitch+mem_idx] += virialj_yz;
+                virial[5*virial_pitch+mem_idx] += virialj_zz;
+                }
+            }
+        // finally, increment the force and potential energy for particle i
+        unsigned int mem_idx = i;
+        force[mem_idx].x += fi.x;
+        force[mem_idx].y += fi.y;
+        force[mem_idx].z += fi.z;
+        force[mem_idx].w += pei;
+
+        if (compute_virial)
+            {
+            virial[0*virial_pitch+mem_idx] += viriali_xx;
+            virial[1*virial_pitch+mem_idx] += viriali_xy;
+            virial[2*virial_pitch+mem_idx] += viriali_xz;
+            virial[3*virial_pitch+mem_idx] += viriali_yy;
+            virial[4*virial_pitch+mem_idx] += viriali_yz;
+            virial[5*virial_pitch+mem_idx] += viriali_zz;
+            }
+        };
+
+    auto compute_particle = [&](unsigned int i, std::vector<neighbor_entry>& neighbors,
+        Scalar4 *force, Scalar *virial, unsigned int virial_pitch)
+        {
+        fill_neighbors(i, neighbors);
+        if (evaluator::flag_for_RevCross)
+            compute_revcross(i, neighbors, force, virial, virial_pitch);
+        else
+            compute_tersoff(i, neighbors, force, virial, virial_pitch);
+        };
+
+    #ifdef ENABLE_TBB
+    // forces on neighbors (including ghosts) are accumulated per thread and summed up afterwards
+    unsigned int n_total = m_pdata->getN() + m_pdata->getNGhosts();
+    m_force_thread.reset(n_total);
+    m_virial_thread.reset(compute_virial ? 6*n_total : 0);
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        std::vector<neighbor_entry>& neighbors = m_neighbors_thread.local();
+        Scalar4 *force = m_force_thread.local();
+        Scalar *virial = m_virial_thread.local();
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            compute_particle(i, neighbors, force, virial, n_total);
+        });
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_total),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            {
+            for (const auto& force : m_force_thread)
+                {
+                h_force.data[i].x += force[i].x;
+                h_force.data[i].y += force[i].y;
+                h_force.data[i].z += force[i].z;
+                h_force.data[i].w += force[i].w;
                 }
-            // finally, increment the force and potential energy for particle i
-            unsigned int mem_idx = i;
-            h_force.data[mem_idx].x += fi.x;
-            h_force.data[mem_idx].y += fi.y;
-            h_force.data[mem_idx].z += fi.z;
-            h_force.data[mem_idx].w += pei;
 
             if (compute_virial)
                 {
-                h_virial.data[0*m_virial_pitch+mem_idx] += viriali_xx;
-                h_virial.data[1*m_virial_pitch+mem_idx] += viriali_xy;
-                h_virial.data[2*m_virial_pitch+mem_idx] += viriali_xz;
-                h_virial.data[3*m_virial_pitch+mem_idx] += viriali_yy;
-                h_virial.data[4*m_virial_pitch+mem_idx] += viriali_yz;
-                h_virial.data[5*m_virial_pitch+mem_idx] += viriali_zz;
+                for (const auto& virial : m_virial_thread)
+                    {
+                    for (unsigned int l = 0; l < 6; ++l)
+                        h_virial.data[l*m_virial_pitch+i] += virial[l*n_total+i];
+                    }
                 }
             }
-        }
+        });
+    #else
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        compute_particle(i, m_neighbors, h_force.data, h_virial.data, m_virial_pitch);
+    #endif
 
     if (m_prof) m_prof->pop();
     }
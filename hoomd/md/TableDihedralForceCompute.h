@@ -6,6 +6,7 @@
 
 #include "hoomd/ForceCompute.h"
 #include "hoomd/BondedGroupData.h"
+#include "BondedGroupForces.h"
 #include "hoomd/Index1D.h"
 #include "hoomd/GPUArray.h"
 
@@ -101,6 +102,7 @@ class PYBIND11_EXPORT TableDihedralForceCompute : public ForceCompute
 
     protected:
         std::shared_ptr<DihedralData> m_dihedral_data;    //!< Bond data to use in computing dihedrals
+        std::vector<bonded_entry_forces> m_entry_forces; //!< Group forces at the CPU table entries, kept between computes
         unsigned int m_table_width;                 //!< Width of the tables in memory
         GPUArray<Scalar2> m_tables;                  //!< Stored V and F tables
         Index2D m_table_value;                      //!< Index table helper
@@ -141,6 +141,10 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
     // update the propagator matrix using current barostat momenta
     updatePropagator(nuxx, nuxy, nuxz, nuyy, nuyz, nuzz);
 
+    // kinetic energy sums of the half step velocities, handed to the thermo compute of the thermostat
+    double ke_tensor[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    double ke_rot = 0.0;
+
     // advance box lengths
     BoxDim global_box = m_pdata->getGlobalBox();
     Scalar3 a = global_box.getLatticeVector(0);
@@ -199,6 +203,8 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
         ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::read);
         ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
         // precompute loop invariant quantity
         Scalar xi_trans = v.variable[1];
@@ -223,6 +229,18 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
             // apply thermostat update of velocity
             v *= exp_thermo_fac;
 
+            // ignore rigid body constituent particles in the sum, as ComputeThermo does
+            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+                {
+                double mass = h_vel.data[j].w;
+                ke_tensor[0] += mass*v.x*v.x;
+                ke_tensor[1] += mass*v.x*v.y;
+                ke_tensor[2] += mass*v.x*v.z;
+                ke_tensor[3] += mass*v.y*v.y;
+                ke_tensor[4] += mass*v.y*v.z;
+                ke_tensor[5] += mass*v.z*v.z;
+                }
+
             if (! m_rescale_all)
                 {
                 r.x = m_mat_exp_r[0] * r.x + m_mat_exp_r[1] * r.y + m_mat_exp_r[2] * r.z;
@@ -270,6 +288,8 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
         ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
         ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
         for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
             {
@@ -369,11 +389,24 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
 
             h_orientation.data[j] = quat_to_scalar4(q);
             h_angmom.data[j] = quat_to_scalar4(p);
+
+            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+                {
+                quat<Scalar> s(Scalar(0.5)*conj(q)*p);
+                if (!x_zero) ke_rot += s.v.x*s.v.x/I.x;
+                if (!y_zero) ke_rot += s.v.y*s.v.y/I.y;
+                if (!z_zero) ke_rot += s.v.z*s.v.z/I.z;
+                }
             }
+
+        ke_rot /= 2.0;
         }
 
     if (! m_nph)
         {
+        // the thermostat computes the thermodynamic quantities of the half step velocities without another pass
+        m_thermo_half_step->setKineticSums(timestep, ke_tensor, m_aniso, ke_rot);
+
         // propagate thermostat variables forward
         advanceThermostat(timestep);
         }
@@ -116,11 +116,17 @@ void TwoStepNVTMTK::integrateStepOne(unsigned int timestep)
     if (m_prof)
         m_prof->push("NVT step 1");
 
+    // kinetic energy sums of the half step velocities, handed to the thermo compute
+    double ke_tensor[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    double ke_rot = 0.0;
+
     // scope array handles for proper releasing before calling the thermo compute
     {
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
         {
@@ -137,6 +143,18 @@ void TwoStepNVTMTK::integrateStepOne(unsigned int timestep)
         // rescale velocity
         v *= m_exp_thermo_fac;
 
+        // ignore rigid body constituent particles in the sum, as ComputeThermo does
+        if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+            {
+            double mass = h_vel.data[j].w;
+            ke_tensor[0] += mass*v.x*v.x;
+            ke_tensor[1] += mass*v.x*v.y;
+            ke_tensor[2] += mass*v.x*v.z;
+            ke_tensor[3] += mass*v.y*v.y;
+            ke_tensor[4] += mass*v.y*v.z;
+            ke_tensor[5] += mass*v.z*v.z;
+            }
+
         pos += m_deltaT * v;
 
         // store updated variables
@@ -175,6 +193,8 @@ void TwoStepNVTMTK::integrateStepOne(unsigned int timestep)
         ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
         ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
         for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
             {
@@ -275,9 +295,22 @@ void TwoStepNVTMTK::integrateStepOne(unsigned int timestep)
 
             h_orientation.data[j] = quat_to_scalar4(q);
             h_angmom.data[j] = quat_to_scalar4(p);
+
+            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+                {
+                quat<Scalar> s(Scalar(0.5)*conj(q)*p);
+                if (!x_zero) ke_rot += s.v.x*s.v.x/I.x;
+                if (!y_zero) ke_rot += s.v.y*s.v.y/I.y;
+                if (!z_zero) ke_rot += s.v.z*s.v.z/I.z;
+                }
             }
+
+        ke_rot /= 2.0;
         }
 
+    // the thermostat computes the thermodynamic quantities of the half step velocities without another pass
+    m_thermo->setKineticSums(timestep+1, ke_tensor, m_aniso, ke_rot);
+
     // get temperature and advance thermostat
     advanceThermostat(timestep);
 
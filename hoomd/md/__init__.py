@@ -16,7 +16,7 @@ from hoomd.md import dihedral
 from hoomd.md import external
 from hoomd.md import force
 from hoomd.md import improper
-from hoomd.md.integrate import Integrator
+from hoomd.md.integrate import Integrator, RESPAIntegrator
 from hoomd.md import nlist
 from hoomd.md import pair
 from hoomd.md import update
@@ -37,6 +37,19 @@ class ThermodynamicQuantities(_Thermo):
         compute.ThermodynamicQuantities(filter=f)
     """
 
+    # names of the C++ log quantities that provide the scalar loggables
+    _cpp_log_quantities = {
+        'kinetic_temperature': 'temperature',
+        'pressure': 'pressure',
+        'kinetic_energy': 'kinetic_energy',
+        'translational_kinetic_energy': 'translational_kinetic_energy',
+        'rotational_kinetic_energy': 'rotational_kinetic_energy',
+        'potential_energy': 'potential_energy',
+        'degrees_of_freedom': 'ndof',
+        'translational_degrees_of_freedom': 'translational_ndof',
+        'rotational_degrees_of_freedom': 'rotational_ndof',
+        'num_particles': 'num_particles'}
+
     def __init__(self, filter):
         super().__init__(filter)
 
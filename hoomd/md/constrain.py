@@ -219,20 +219,35 @@ class distance(ConstraintForce):
 
         hoomd.context.current.system.addCompute(self.cpp_force, self.force_name)
 
-    def set_params(self,rel_tol=None):
+    def set_params(self,rel_tol=None,solver=None,solver_tol=None):
         R""" Set parameters for constraint computation.
 
         Args:
             rel_tol (float): The relative tolerance with which constraint violations are detected (**optional**).
+            solver (str): Method used to solve for the constraint forces, ``'lu'`` or ``'iterative'`` (**optional**).
+            solver_tol (float): Relative residual at which the iterative solver stops (**optional**).
+
+        The default ``'lu'`` solver factorizes the constraint matrix every step. The ``'iterative'`` solver
+        (CPU only) uses BiCGSTAB starting from the constraint forces of the previous step, and falls back to LU
+        when it does not converge. It is faster for large numbers of constraints that change little between steps.
 
         Example::
 
             dist = constrain.distance()
             dist.set_params(rel_tol=0.0001)
+            dist.set_params(solver='iterative', solver_tol=1e-8)
         """
         if rel_tol is not None:
             self.cpp_force.setRelativeTolerance(float(rel_tol))
 
+        if solver is not None:
+            if solver not in ('lu', 'iterative'):
+                raise ValueError("solver must be 'lu' or 'iterative'")
+            self.cpp_force.setIterativeSolver(solver == 'iterative')
+
+        if solver_tol is not None:
+            self.cpp_force.setSolverTolerance(float(solver_tol))
+
 class rigid(ConstraintForce):
     R""" Constrain particles in rigid bodies.
 
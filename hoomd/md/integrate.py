@@ -191,3 +191,122 @@ class Integrator(_DynamicIntegrator):
         # Call attach from DynamicIntegrator which attaches forces,
         # constraint_forces, and methods, and calls super()._attach() itself.
         super()._attach()
+
+
+class RESPAIntegrator(Integrator):
+    R""" Multiple time step (r-RESPA) integration.
+
+    Args:
+        dt (float): Inner time step size (in time units).
+
+        levels (Sequence[Tuple[int, Sequence[hoomd.md.force.Force]]]): Sequence
+            of slow force levels. Each level is a pair of the number of time
+            steps between evaluations of its forces and the sequence of its
+            forces. The default value of ``None`` initializes no levels.
+
+        aniso (str or bool): Whether to integrate rotational degrees of freedom
+            (bool), default 'auto' (autodetect if there is anisotropic factor
+            from any defined active or constraint forces).
+
+        forces (Sequence[hoomd.md.force.Force]): Sequence of forces evaluated
+            every time step. The default value of ``None`` initializes an empty
+            list.
+
+        constraints (Sequence[hoomd.md.constrain.ConstraintForce]): Sequence of
+            constraint forces applied to the particles in the system.
+            The default value of ``None`` initializes an empty list.
+
+        methods (Sequence[hoomd.md.methods._Method]): Sequence of integration
+            methods. The default value of ``None`` initializes an empty list.
+
+    `RESPAIntegrator` implements the reversible reference system propagator
+    algorithm of Tuckerman, Berne, and Martyna (J. Chem. Phys. 97, 1990
+    (1992)). The forces in `forces` are evaluated every time step and
+    integrated by the integration methods in `methods` with the time step
+    `dt`, as in `Integrator`. The forces of a level with ``substeps`` steps
+    are evaluated only on the time steps that are a multiple of ``substeps``,
+    and are applied as two velocity kicks at the beginning and end of each
+    outer time step ``substeps * dt``. Assign expensive, slowly varying forces
+    (such as the long range part of the electrostatics) to a level to evaluate
+    them less often.
+
+    Thermostats act every time step. The potential energy and virial reported
+    by `hoomd.md.compute.ThermodynamicQuantities` include the forces of a
+    level only on the time steps at which the level is evaluated, so log with a
+    period that is a multiple of all ``substeps``.
+
+    Use `hoomd.md.methods.NVE`, `hoomd.md.methods.NVT`, or
+    `hoomd.md.methods.Langevin` with `RESPAIntegrator`. Levels do not act on
+    rigid bodies, and constraint forces only correct the forces evaluated
+    every time step.
+
+    Examples::
+
+        integrator = hoomd.md.RESPAIntegrator(dt=0.001, methods=[nvt],
+                                              forces=[harmonic, lj],
+                                              levels=[(4, [coulomb])])
+        sim.operations.integrator = integrator
+
+
+    Note:
+        The levels and their numbers of substeps are fixed when the integrator
+        is constructed, and `levels` is read-only. The force list of each
+        level can be modified at any time.
+
+    Attributes:
+        dt (float): Inner time step size (in time units).
+
+        levels (Tuple[Tuple[int, List[hoomd.md.force.Force]]]): The slow force
+            levels with their number of substeps and forces (read-only).
+
+        methods (List[hoomd.md.methods._Method]): List of integration methods.
+
+        forces (List[hoomd.md.force.Force]): List of forces evaluated every
+            time step.
+
+        aniso (str): Whether rotational degrees of freedom are integrated.
+
+        constraints (List[hoomd.md.constrain.ConstraintForce]): List of
+            constraint forces applied to the particles in the system.
+    """
+
+    def __init__(self, dt, levels=None, aniso='auto', forces=None,
+                 constraints=None, methods=None):
+
+        super().__init__(dt, aniso, forces, constraints, methods)
+
+        levels = [] if levels is None else levels
+        self._levels = []
+        for substeps, level_forces in levels:
+            if int(substeps) < 1:
+                raise ValueError("The number of substeps must be positive.")
+            self._levels.append(
+                (int(substeps),
+                 SyncedList(lambda x: isinstance(x, Force),
+                            to_synced_list=lambda x: x._cpp_obj,
+                            iterable=level_forces)))
+
+    def _attach(self):
+        # initialize the reflected c++ class
+        self._cpp_obj = _md.IntegratorRESPA(
+            self._simulation.state._cpp_sys_def, self.dt)
+        for substeps, level_forces in self._levels:
+            level = self._cpp_obj.addLevel(substeps)
+            level_forces._sync(self._simulation,
+                               self._cpp_obj.getLevelForces(level))
+        _DynamicIntegrator._attach(self)
+
+    @property
+    def levels(self):
+        return tuple(self._levels)
+
+    @property
+    def _children(self):
+        children = super()._children
+
+        for _, level_forces in self._levels:
+            children.extend(level_forces)
+            for child in level_forces:
+                children.extend(child._children)
+
+        return children
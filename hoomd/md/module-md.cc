@@ -32,6 +32,7 @@
 #include "HarmonicImproperForceCompute.h"
 #include "IntegrationMethodTwoStep.h"
 #include "IntegratorTwoStep.h"
+#include "IntegratorRESPA.h"
 #include "MolecularForceCompute.h"
 #include "NeighborListBinned.h"
 #include "NeighborList.h"
@@ -162,38 +163,34 @@ wall_type make_wall_field_params(py::object walls, std::shared_ptr<const Executi
     w.numCylinders = py::len(walls_cylinders);
     w.numPlanes = py::len(walls_planes);
 
-    if (w.numSpheres>MAX_N_SWALLS || w.numCylinders>MAX_N_CWALLS || w.numPlanes>MAX_N_PWALLS)
+    bool managed = m_exec_conf->isCUDAEnabled();
+    w.Spheres = ManagedArray<SphereWall>(w.numSpheres, managed);
+    w.Cylinders = ManagedArray<CylinderWall>(w.numCylinders, managed);
+    w.Planes = ManagedArray<PlaneWall>(w.numPlanes, managed);
+
+    for(unsigned int i = 0; i < w.numSpheres; i++)
         {
-        m_exec_conf->msg->error() << "A number of walls greater than the maximum number allowed was specified in a wall force." << std::endl;
-        throw std::runtime_error("Error loading wall group.");
+        Scalar     r = py::cast<Scalar>(py::object(walls_spheres[i]).attr("r"));
+        Scalar3 origin =py::cast<Scalar3>(py::object(walls_spheres[i]).attr("_origin"));
+        bool     inside =py::cast<bool>(py::object(walls_spheres[i]).attr("inside"));
+        w.Spheres[i] = SphereWall(r, origin, inside);
         }
-    else
+    for(unsigned int i = 0; i < w.numCylinders; i++)
         {
-
-        for(unsigned int i = 0; i < w.numSpheres; i++)
-            {
-            Scalar     r = py::cast<Scalar>(py::object(walls_spheres[i]).attr("r"));
-            Scalar3 origin =py::cast<Scalar3>(py::object(walls_spheres[i]).attr("_origin"));
-            bool     inside =py::cast<bool>(py::object(walls_spheres[i]).attr("inside"));
-            w.Spheres[i] = SphereWall(r, origin, inside);
-            }
-        for(unsigned int i = 0; i < w.numCylinders; i++)
-            {
-            Scalar     r = py::cast<Scalar>(py::object(walls_cylinders[i]).attr("r"));
-            Scalar3 origin =py::cast<Scalar3>(py::object(walls_cylinders[i]).attr("_origin"));
-            Scalar3 axis =py::cast<Scalar3>(py::object(walls_cylinders[i]).attr("_axis"));
-            bool     inside =py::cast<bool>(py::object(walls_cylinders[i]).attr("inside"));
-            w.Cylinders[i] = CylinderWall(r, origin, axis, inside);
-            }
-        for(unsigned int i = 0; i < w.numPlanes; i++)
-            {
-            Scalar3 origin =py::cast<Scalar3>(py::object(walls_planes[i]).attr("_origin"));
-            Scalar3 normal =py::cast<Scalar3>(py::object(walls_planes[i]).attr("_normal"));
-            bool    inside =py::cast<bool>(py::object(walls_planes[i]).attr("inside"));
-            w.Planes[i] = PlaneWall(origin, normal, inside);
-            }
-        return w;
+        Scalar     r = py::cast<Scalar>(py::object(walls_cylinders[i]).attr("r"));
+        Scalar3 origin =py::cast<Scalar3>(py::object(walls_cylinders[i]).attr("_origin"));
+        Scalar3 axis =py::cast<Scalar3>(py::object(walls_cylinders[i]).attr("_axis"));
+        bool     inside =py::cast<bool>(py::object(walls_cylinders[i]).attr("inside"));
+        w.Cylinders[i] = CylinderWall(r, origin, axis, inside);
+        }
+    for(unsigned int i = 0; i < w.numPlanes; i++)
+        {
+        Scalar3 origin =py::cast<Scalar3>(py::object(walls_planes[i]).attr("_origin"));
+        Scalar3 normal =py::cast<Scalar3>(py::object(walls_planes[i]).attr("_normal"));
+        bool    inside =py::cast<bool>(py::object(walls_planes[i]).attr("inside"));
+        w.Planes[i] = PlaneWall(origin, normal, inside);
         }
+    return w;
     }
 
 //! Exports helper function for parameters based on standard evaluators
@@ -355,6 +352,7 @@ PYBIND11_MODULE(_md, m)
 
     // updaters
     export_IntegratorTwoStep(m);
+    export_IntegratorRESPA(m);
     export_IntegrationMethodTwoStep(m);
     export_TempRescaleUpdater(m);
     export_ZeroMomentumUpdater(m);
@@ -49,6 +49,21 @@ class NList(_HOOMDBaseObject):
     `check_dist` is `False`, `NList` always rebuilds after
     `rebuild_check_delay` time steps.
 
+    .. rubric:: Buffer tuning
+
+    Set `tune_buffer` to `True` to adjust `buffer` during the run. Every
+    `tune_period` time steps, `NList` measures the time per step, the time
+    spent building the neighbor list, and the largest distance that particles
+    of each type move per time step. It fits how the build time and the rest
+    of the time per step grow with the volume of the neighbor list and sets
+    `buffer` to the value up to `max_buffer` that minimizes the predicted time
+    per step. `buffer` changes by at most 20% per period and alternates by 5%
+    around the chosen value to keep measuring the costs. The new value takes
+    effect at the next rebuild. The buffer is shared by all types, so the
+    fastest type sets the rebuild period. `current_buffer` and
+    `displacement_rate` log the chosen values. `buffer` is not tuned when
+    `check_dist` is `False`.
+
     .. rubric:: Exclusions
 
     Neighbor lists nominally include all particles within the specified cutoff
@@ -87,10 +102,15 @@ class NList(_HOOMDBaseObject):
         max_diameter (float): The maximum diameter a particle will achieve.
         rebuild_check_delay (int): How often to attempt to rebuild the neighbor
             list.
+        tune_buffer (bool): Flag to enable / disable tuning `buffer` during the
+            run.
+        max_buffer (float): The largest buffer width chosen when tuning.
+        tune_period (int): Number of time steps between buffer adjustments.
     """
 
     def __init__(self, buffer, exclusions, rebuild_check_delay,
-                 diameter_shift, check_dist, max_diameter):
+                 diameter_shift, check_dist, max_diameter, tune_buffer=False,
+                 max_buffer=1.0, tune_period=1000):
 
         validate_exclusions = OnlyFrom(
             ['bond', 'angle', 'constraint', 'dihedral', 'special_pair',
@@ -103,6 +123,9 @@ class NList(_HOOMDBaseObject):
                                check_dist=bool(check_dist),
                                diameter_shift=bool(diameter_shift),
                                max_diameter=float(max_diameter),
+                               tune_buffer=bool(tune_buffer),
+                               max_buffer=float(max_buffer),
+                               tune_period=int(tune_period),
                                _defaults={'exclusions': exclusions}
                                )
         self._param_dict.update(params)
@@ -119,6 +142,29 @@ class NList(_HOOMDBaseObject):
         else:
             return self._cpp_obj.getSmallestRebuild()
 
+    @log
+    def current_buffer(self):
+        """float: The buffer width in use.
+
+        Set by the tuner when `tune_buffer` is `True`.
+        """
+        if not self._attached:
+            return None
+        else:
+            return self._cpp_obj.buffer
+
+    @log(flag='sequence')
+    def displacement_rate(self):
+        """list[float]: Largest distance moved per time step by type.
+
+        Measured for each particle type over the previous tuning period when
+        `tune_buffer` is `True`.
+        """
+        if not self._attached:
+            return None
+        else:
+            return self._cpp_obj.getDisplacementRates()
+
     # TODO need to add tuning Updater for NList
 
 
@@ -144,6 +190,10 @@ class Cell(NList):
         max_diameter (float): The maximum diameter a particle will achieve.
         rebuild_check_delay (int): How often to attempt to rebuild the neighbor
             list.
+        tune_buffer (bool): Flag to enable / disable tuning `buffer` during the
+            run.
+        max_buffer (float): The largest buffer width chosen when tuning.
+        tune_period (int): Number of time steps between buffer adjustments.
 
     `Cell` finds neighboring particles using a fixed width cell list, allowing
     for *O(kN)* construction of the neighbor list where *k* is the number of
@@ -164,10 +214,12 @@ class Cell(NList):
 
     def __init__(self, buffer=0.4, exclusions=('bond',), rebuild_check_delay=1,
                  diameter_shift=False, check_dist=True, max_diameter=1.0,
-                 deterministic=False):
+                 deterministic=False, tune_buffer=False, max_buffer=1.0,
+                 tune_period=1000):
 
         super().__init__(buffer, exclusions, rebuild_check_delay,
-                         diameter_shift, check_dist, max_diameter)
+                         diameter_shift, check_dist, max_diameter, tune_buffer,
+                         max_buffer, tune_period)
 
         self._param_dict.update(
             ParameterDict(deterministic=bool(deterministic)))
@@ -0,0 +1,40 @@
+import pytest
+
+import hoomd
+
+
+def test_tune_buffer_attributes():
+    cell = hoomd.md.nlist.Cell(buffer=0.3, tune_buffer=True, max_buffer=0.8,
+                               tune_period=500)
+    assert cell.tune_buffer
+    assert cell.max_buffer == 0.8
+    assert cell.tune_period == 500
+    assert not hoomd.md.nlist.Cell().tune_buffer
+    assert cell.current_buffer is None
+
+
+def test_tune_buffer(simulation_factory, two_particle_snapshot_factory):
+    snap = two_particle_snapshot_factory(particle_types=['A', 'B'], d=1.2)
+    if snap.exists:
+        snap.particles.typeid[:] = [0, 1]
+        snap.particles.velocity[:] = [[0.5, 0, 0], [0, 0.1, 0]]
+    sim = simulation_factory(snap)
+
+    cell = hoomd.md.nlist.Cell(buffer=0.4, tune_buffer=True, max_buffer=0.8,
+                               tune_period=20)
+    lj = hoomd.md.pair.LJ(nlist=cell, r_cut=2.5)
+    for pair in [('A', 'A'), ('A', 'B'), ('B', 'B')]:
+        lj.params[pair] = {'sigma': 1, 'epsilon': 0.5}
+    integrator = hoomd.md.Integrator(dt=0.005)
+    integrator.forces.append(lj)
+    integrator.methods.append(hoomd.md.methods.NVE(hoomd.filter.All()))
+    sim.operations.integrator = integrator
+    sim.run(100)
+
+    assert 0 < cell.current_buffer <= 0.8
+    assert cell.buffer == cell.current_buffer
+    assert len(cell.displacement_rate) == 2
+    assert all(rate >= 0 for rate in cell.displacement_rate)
+
+    with pytest.raises(RuntimeError):
+        cell.max_buffer = 0
@@ -0,0 +1,93 @@
+import hoomd
+import pytest
+import numpy as np
+
+
+def _make_lj():
+    lj = hoomd.md.pair.LJ(nlist=hoomd.md.nlist.Cell(), r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1.0, sigma=1.0)
+    return lj
+
+
+def _make_gauss():
+    gauss = hoomd.md.pair.Gauss(nlist=hoomd.md.nlist.Cell(), r_cut=2.5)
+    gauss.params[('A', 'A')] = dict(epsilon=0.5, sigma=0.8)
+    return gauss
+
+
+def test_respa_attributes():
+    """Test attributes of the RESPA integrator before attaching."""
+    lj = _make_lj()
+    gauss = _make_gauss()
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    integrator = hoomd.md.RESPAIntegrator(0.005, methods=[nve], forces=[lj],
+                                          levels=[(4, [gauss])])
+
+    assert integrator.dt == 0.005
+    assert list(integrator.forces) == [lj]
+    assert len(integrator.levels) == 1
+    substeps, forces = integrator.levels[0]
+    assert substeps == 4
+    assert list(forces) == [gauss]
+
+    with pytest.raises(ValueError):
+        hoomd.md.RESPAIntegrator(0.005, levels=[(0, [gauss])])
+
+
+def test_respa_attributes_attached(simulation_factory,
+                                   two_particle_snapshot_factory):
+    """Test attributes of the RESPA integrator after attaching."""
+    lj = _make_lj()
+    gauss = _make_gauss()
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    integrator = hoomd.md.RESPAIntegrator(0.005, methods=[nve], forces=[lj],
+                                          levels=[(4, [])])
+
+    sim = simulation_factory(two_particle_snapshot_factory())
+    sim.operations.integrator = integrator
+    sim.operations._schedule()
+
+    assert integrator._cpp_obj.num_levels == 1
+    assert integrator._cpp_obj.getLevelSubsteps(0) == 4
+
+    # the forces of a level can be changed
+    integrator.levels[0][1].append(gauss)
+    assert list(integrator.levels[0][1]) == [gauss]
+    assert len(integrator._cpp_obj.getLevelForces(0)) == 1
+    sim.run(8)
+
+    # the levels cannot
+    with pytest.raises(AttributeError):
+        integrator.levels = [(2, [gauss])]
+    with pytest.raises(AttributeError):
+        integrator.levels.append((2, []))
+    assert len(integrator.levels) == 1
+
+
+def test_respa_single_substep(simulation_factory, lattice_snapshot_factory):
+    """Test that a level with one substep matches `hoomd.md.Integrator`."""
+    snap = lattice_snapshot_factory(n=5, a=1.2, r=0.05)
+
+    def make_sim(respa):
+        sim = simulation_factory(snap)
+        nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+        if respa:
+            integrator = hoomd.md.RESPAIntegrator(0.002, methods=[nve],
+                                                  forces=[_make_lj()],
+                                                  levels=[(1, [_make_gauss()])])
+        else:
+            integrator = hoomd.md.Integrator(0.002, methods=[nve],
+                                             forces=[_make_lj(), _make_gauss()])
+        sim.operations.integrator = integrator
+        sim.run(20)
+        return sim.state.snapshot
+
+    ref = make_sim(False)
+    new = make_sim(True)
+    if new.exists:
+        np.testing.assert_allclose(new.particles.position,
+                                   ref.particles.position, rtol=1e-5,
+                                   atol=1e-5)
+        np.testing.assert_allclose(new.particles.velocity,
+                                   ref.particles.velocity, rtol=1e-5,
+                                   atol=1e-5)
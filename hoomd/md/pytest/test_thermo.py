@@ -1,4 +1,6 @@
 import hoomd
+import hoomd.write
+import pytest
 import numpy as np
 
 """ Each entry is a quantity and its type """
@@ -142,3 +144,37 @@ def test_system_rotational_dof(simulation_factory, device):
                               2./3*thermo.translational_kinetic_energy/10.0**3,
                               (0., 0., 0., 2./10**3, 0., 0.))
 
+
+
+@pytest.mark.serial
+def test_write_binary(simulation_factory, two_particle_snapshot_factory,
+                      tmp_path):
+    """Test that write.Binary logs the quantities evaluated in C++."""
+    filt = hoomd.filter.All()
+    thermo = hoomd.md.compute.ThermodynamicQuantities(filt)
+    snap = two_particle_snapshot_factory()
+    if snap.exists:
+        snap.particles.velocity[:] = [[-2, 0, 0], [2, 1, 0]]
+    sim = simulation_factory(snap)
+    sim.always_compute_pressure = True
+
+    integrator = hoomd.md.Integrator(dt=0.0001)
+    integrator.methods.append(hoomd.md.methods.NVT(filt, tau=1, kT=1))
+    sim.operations.integrator = integrator
+
+    logger = hoomd.logging.Logger(flags=['scalar'])
+    namespaces = logger.add(thermo)
+    filename = str(tmp_path / 'thermo.bin')
+    binary = hoomd.write.Binary(filename, 1, logger, overwrite=True)
+    sim.operations.add(thermo)
+    sim.operations.writers.append(binary)
+    sim.run(3)
+    binary.flush()
+
+    data = hoomd.write.Binary.read(filename)
+    assert list(data['timestep']) == [1, 2, 3]
+    for namespace in namespaces:
+        if namespace[-1] in type(thermo)._cpp_log_quantities:
+            np.testing.assert_allclose(data['/'.join(namespace)][-1],
+                                       getattr(thermo, namespace[-1]),
+                                       rtol=1e-5)
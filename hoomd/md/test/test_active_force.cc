@@ -0,0 +1,209 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <random>
+
+#include "hoomd/filter/ParticleFilterTags.h"
+#include "hoomd/md/ActiveForceCompute.h"
+
+using namespace std;
+
+#include "hoomd/test/upp11_config.h"
+#include "hoomd/test/thread_compare.h"
+
+HOOMD_UP_MAIN();
+
+/*! \file test_active_force.cc
+    \brief Implements unit tests for ActiveForceCompute
+    \ingroup unit_tests
+*/
+
+//! Active force compute that sets the per-type vectors directly instead of through python
+class ActiveForceComputeTypes : public ActiveForceCompute
+    {
+    public:
+        using ActiveForceCompute::ActiveForceCompute;
+
+        //! Set the active force and torque of a type
+        /*! \param type Type to set
+            \param f Unit force vector (x,y,z) and magnitude (w)
+            \param t Unit torque vector (x,y,z) and magnitude (w)
+        */
+        void setTypeVectors(unsigned int type, Scalar4 f, Scalar4 t)
+            {
+            ArrayHandle<Scalar4> h_f_activeVec(m_f_activeVec, access_location::host, access_mode::readwrite);
+            ArrayHandle<Scalar4> h_t_activeVec(m_t_activeVec, access_location::host, access_mode::readwrite);
+            h_f_activeVec.data[type] = f;
+            h_t_activeVec.data[type] = t;
+            }
+    };
+
+//! Append the orientations of the first N particles to a list of results
+void append_orientations(std::vector<Scalar>& result, std::shared_ptr<ParticleData> pdata, unsigned int N)
+    {
+    ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        result.push_back(h_orientation.data[i].x);
+        result.push_back(h_orientation.data[i].y);
+        result.push_back(h_orientation.data[i].z);
+        result.push_back(h_orientation.data[i].w);
+        }
+    }
+
+//! Compare the forces, torques, and orientations of two types of active particles with the serial reference
+/*! The reference values were computed by the serial code that scaled the per-type vectors inside the particle loop.
+*/
+UP_TEST( active_force_reference )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    const unsigned int N = 6;
+    auto sysdef = std::make_shared<SystemDefinition>(N, BoxDim(10.0), 2, 0, 0, 0, 0, exec_conf);
+    auto pdata = sysdef->getParticleData();
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host,
+                                           access_mode::overwrite);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            h_pos.data[i] = make_scalar4(-2.5 + i, 0.5*i, -0.25*i, __int_as_scalar(i % 2));
+            quat<Scalar> q(Scalar(1.0 + 0.5*i), vec3<Scalar>(0.3*i, -0.2, 0.1*(N - i)));
+            h_orientation.data[i] = quat_to_scalar4(q*(Scalar(1.0)/slow::sqrt(norm2(q))));
+            }
+        }
+
+    // the last particle is not active
+    std::vector<unsigned int> tags = {0, 1, 2, 3, 4};
+    auto group = std::make_shared<ParticleGroup>(sysdef, std::make_shared<ParticleFilterTags>(tags));
+    auto active = std::make_shared<ActiveForceComputeTypes>(sysdef, group, 12, Scalar(0.5), make_scalar3(0, 0, 0),
+                                                            Scalar(0.0), Scalar(0.0), Scalar(0.0));
+    active->setTypeVectors(0, make_scalar4(1.0, 0.0, 0.0, 2.0), make_scalar4(0.0, 0.0, 1.0, 0.5));
+    active->setTypeVectors(1, make_scalar4(0.0, 0.6, 0.8, 1.5), make_scalar4(0.6, 0.0, 0.8, 0.25));
+    active->setDeltaT(Scalar(0.01));
+    active->compute(0);
+    active->compute(1);
+
+    // forces (x,y,z), torques (x,y,z), and orientations after two steps of the serial code
+
+    const Scalar3 ref_force[N] = {
+        make_scalar3(0.9042506429, 1.722573532, 0.4637576961),
+        make_scalar3(-0.7465670671, 0.01648318914, 1.300909651),
+        make_scalar3(1.838498018, 0.5846845603, 0.5273224851),
+        make_scalar3(-0.3261406688, -0.1692157993, 1.454303365),
+        make_scalar3(1.928670791, 0.327763396, 0.4156923573),
+        make_scalar3(0.0, 0.0, 0.0)};
+    const Scalar3 ref_torque[N] = {
+        make_scalar3(-0.1303781197, -0.06048959565, 0.4788972277),
+        make_scalar3(0.08575418363, -0.02027061812, 0.2339558121),
+        make_scalar3(-0.03009654624, -0.2787458544, 0.4139987277),
+        make_scalar3(0.130452318, -0.1124736292, 0.1811956828),
+        make_scalar3(-0.01925705331, -0.3450124173, 0.3613801292),
+        make_scalar3(0.0, 0.0, 0.0)};
+    const Scalar4 ref_orientation[N] = {
+        make_scalar4(0.8519722354, -0.01435168575, -0.1445572599, 0.5030313488),
+        make_scalar4(0.9054737937, 0.2214444171, -0.1494561526, 0.3297611825),
+        make_scalar4(0.9386496804, 0.2802878555, -0.08625537882, 0.1814814182),
+        make_scalar4(0.9230680506, 0.3575972855, -0.08152045315, 0.1158618621),
+        make_scalar4(0.9208805519, 0.3662604359, -0.06688171576, 0.1155817387),
+        make_scalar4(0.9175643839, 0.3932418788, -0.05243225051, 0.02621612525)};
+
+    ArrayHandle<Scalar4> h_force(active->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_torque(active->getTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        MY_CHECK_SMALL(h_force.data[i].x - ref_force[i].x, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].y - ref_force[i].y, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].z - ref_force[i].z, tol_small);
+        MY_CHECK_SMALL(h_torque.data[i].x - ref_torque[i].x, tol_small);
+        MY_CHECK_SMALL(h_torque.data[i].y - ref_torque[i].y, tol_small);
+        MY_CHECK_SMALL(h_torque.data[i].z - ref_torque[i].z, tol_small);
+        MY_CHECK_SMALL(h_orientation.data[i].x - ref_orientation[i].x, tol_small);
+        MY_CHECK_SMALL(h_orientation.data[i].y - ref_orientation[i].y, tol_small);
+        MY_CHECK_SMALL(h_orientation.data[i].z - ref_orientation[i].z, tol_small);
+        MY_CHECK_SMALL(h_orientation.data[i].w - ref_orientation[i].w, tol_small);
+        }
+    }
+
+//! Apply the active force with rotational diffusion to every other particle of a random system
+/*! \param dim Dimensionality of the system
+    \param r Radius of the spherical constraint, 0 for no constraint
+*/
+void active_threads_test(unsigned int dim, Scalar r)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    compare_threads(exec_conf, [&]()
+        {
+        const unsigned int N = 1000;
+        const Scalar L = 20.0;
+        auto sysdef = std::make_shared<SystemDefinition>(N, dim == 2 ? BoxDim(L, L, 1.0) : BoxDim(L),
+                                                         2, 0, 0, 0, 0, exec_conf);
+        sysdef->setNDimensions(dim);
+        auto pdata = sysdef->getParticleData();
+
+        // random positions and orientations, in the plane in 2D
+            {
+            std::mt19937 rng(5);
+            std::uniform_real_distribution<Scalar> u(-0.5*L, 0.5*L);
+            std::normal_distribution<Scalar> n(0.0, 1.0);
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+            ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host,
+                                               access_mode::overwrite);
+            for (unsigned int i = 0; i < N; i++)
+                {
+                h_pos.data[i] = make_scalar4(u(rng), u(rng), dim == 2 ? Scalar(0.0) : u(rng),
+                                             __int_as_scalar(i % 2));
+                quat<Scalar> q;
+                if (dim == 2)
+                    {
+                    Scalar theta = u(rng);
+                    q = quat<Scalar>(slow::cos(theta), vec3<Scalar>(0, 0, slow::sin(theta)));
+                    }
+                else
+                    {
+                    q = quat<Scalar>(n(rng), vec3<Scalar>(n(rng), n(rng), n(rng)));
+                    q = q*(Scalar(1.0)/slow::sqrt(norm2(q)));
+                    }
+                h_orientation.data[i] = quat_to_scalar4(q);
+                }
+            }
+
+        std::vector<unsigned int> tags;
+        for (unsigned int tag = 0; tag < N; tag += 2)
+            tags.push_back(tag);
+        auto group = std::make_shared<ParticleGroup>(sysdef, std::make_shared<ParticleFilterTags>(tags));
+
+        auto active = std::make_shared<ActiveForceCompute>(sysdef, group, 12, Scalar(0.5), make_scalar3(0, 0, 0),
+                                                           r, r, r);
+        active->setDeltaT(Scalar(0.01));
+        for (unsigned int timestep = 0; timestep < 5; timestep++)
+            active->compute(timestep);
+
+        std::vector<Scalar> result;
+        append_force_arrays(result, active, N);
+        append_orientations(result, pdata, N);
+        return result;
+        });
+    }
+
+//! Rotational diffusion in 3D with four threads against one thread
+UP_TEST( active_force_threads_3d )
+    {
+    active_threads_test(3, Scalar(0.0));
+    }
+
+//! Rotational diffusion in 2D with four threads against one thread
+UP_TEST( active_force_threads_2d )
+    {
+    active_threads_test(2, Scalar(0.0));
+    }
+
+//! Rotational diffusion on a spherical constraint with four threads against one thread
+UP_TEST( active_force_threads_constraint )
+    {
+    active_threads_test(3, Scalar(5.0));
+    }
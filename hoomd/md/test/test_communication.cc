@@ -17,8 +17,10 @@ HOOMD_UP_MAIN()
 #include "hoomd/Communicator.h"
 
 #include "hoomd/ConstForceCompute.h"
+#include "hoomd/SFCPackTuner.h"
 #include "hoomd/md/TwoStepNVE.h"
 #include "hoomd/md/IntegratorTwoStep.h"
+#include "hoomd/md/NeighborListTree.h"
 #include "hoomd/filter/ParticleFilterAll.h"
 
 #ifdef ENABLE_HIP
@@ -26,6 +28,8 @@ HOOMD_UP_MAIN()
 #endif
 
 #include <algorithm>
+#include <map>
+#include <random>
 
 #define TO_TRICLINIC(v) dest_box.makeCoordinates(ref_box.makeFraction(make_scalar3(v.x,v.y,v.z)))
 #define TO_POS4(v) make_scalar4(v.x,v.y,v.z,h_pos.data[rtag].w)
@@ -954,6 +958,34 @@ struct ghost_layer_width
     Scalar w;
     };
 
+//! Helper class to request ghost communication flags
+struct comm_flags_request
+    {
+    comm_flags_request(CommFlags flags)
+        {
+        f = flags;
+        }
+    CommFlags get(unsigned int timestep)
+        {
+        return f;
+        }
+    CommFlags f;
+    };
+
+//! Helper class to count the removals of the ghost particles, which precede every migration
+struct ghost_removal_counter
+    {
+    ghost_removal_counter()
+        : n(0)
+        {
+        }
+    void count()
+        {
+        n++;
+        }
+    unsigned int n;
+    };
+
 //! Test ghost particle communication
 void test_communicator_ghosts(communicator_creator comm_creator,
                               std::shared_ptr<ExecutionConfiguration> exec_conf,
@@ -3443,6 +3475,150 @@ void test_communicator_ghosts_per_type(communicator_creator comm_creator, std::s
         }
     }
 
+//! Test that the particle sort keeps the ghost particles and their send lists
+void test_communicator_local_sort(communicator_creator comm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    // create a system with random particle positions
+    const unsigned int n_particles = 1000;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n_particles, // number of particles
+                                                             BoxDim(10.0),     // box dimensions
+                                                             1,                // number of particle types
+                                                             0,                // number of bond types
+                                                             0,                // number of angle types
+                                                             0,                // number of dihedral types
+                                                             0,                // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<Scalar> uniform(-4.99, 4.99);
+    for (unsigned int i = 0; i < n_particles; ++i)
+        pdata->setPosition(i, make_scalar3(uniform(rng), uniform(rng), uniform(rng)), false);
+
+    // distribute particle data on processors
+    SnapshotParticleData<Scalar> snap(n_particles);
+    pdata->takeSnapshot(snap);
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, pdata->getBox().getL()));
+    std::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+
+    pdata->setDomainDecomposition(decomposition);
+
+    pdata->initializeFromSnapshot(snap);
+
+    // width of ghost layer
+    ghost_layer_width g(1.0);
+    comm->getGhostLayerWidthRequestSignal().connect<ghost_layer_width, &ghost_layer_width::get>(g);
+
+    CommFlags flags(0);
+    flags[comm_flag::position] = 1;
+    flags[comm_flag::tag] = 1;
+    comm_flags_request r(flags);
+    comm->getCommFlagsRequestSignal().connect<comm_flags_request, &comm_flags_request::get>(r);
+
+    // a neighbor list requests migrations by its distance check
+    const Scalar r_buff = 0.4;
+    std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, Scalar(0.5), r_buff));
+    nlist->setCommunicator(comm);
+
+    ghost_removal_counter removals;
+    pdata->getGhostParticlesRemovedSignal().connect<ghost_removal_counter, &ghost_removal_counter::count>(removals);
+
+    // migrate particles and exchange ghosts
+    comm->communicate(0);
+    nlist->compute(0);
+
+    const unsigned int N = pdata->getN();
+    const unsigned int n_ghosts = pdata->getNGhosts();
+    UP_ASSERT(n_ghosts > 0);
+
+    // remember the ghost positions by tag
+    std::map<unsigned int, Scalar3> ghost_pos;
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        for (unsigned int i = N; i < N + n_ghosts; ++i)
+            ghost_pos[h_tag.data[i]] = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        }
+
+    // sort the particles
+    std::shared_ptr<SFCPackTuner> sorter(new SFCPackTuner(sysdef, std::shared_ptr<Trigger>(new PeriodicTrigger(1))));
+    sorter->setCommunicator(comm);
+    sorter->update(1);
+
+    // the ghosts are kept at their indices
+    UP_ASSERT_EQUAL(pdata->getN(), N);
+    UP_ASSERT_EQUAL(pdata->getNGhosts(), n_ghosts);
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+        for (unsigned int i = N; i < N + n_ghosts; ++i)
+            {
+            UP_ASSERT(ghost_pos.count(h_tag.data[i]));
+            UP_ASSERT_EQUAL(h_rtag.data[h_tag.data[i]], i);
+            }
+        }
+
+    // displace the local particles, without leaving the domain or the ghost layer
+    const Scalar3 shift = make_scalar3(0.01, -0.02, 0.03);
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        for (unsigned int i = 0; i < N; ++i)
+            {
+            h_pos.data[i].x += shift.x;
+            h_pos.data[i].y += shift.y;
+            h_pos.data[i].z += shift.z;
+            }
+        }
+
+    // update the ghosts through the remapped send lists, the neighbor list rebuild after the sort does not migrate
+    removals.n = 0;
+    const unsigned int n_updates = nlist->getNumUpdates();
+    comm->communicate(2);
+    nlist->compute(2);
+
+    UP_ASSERT_EQUAL(removals.n, 0);
+    UP_ASSERT_EQUAL(nlist->getNumUpdates(), n_updates + 1);
+    UP_ASSERT_EQUAL(pdata->getNGhosts(), n_ghosts);
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        for (unsigned int i = N; i < N + n_ghosts; ++i)
+            {
+            const Scalar3& old_pos = ghost_pos[h_tag.data[i]];
+            CHECK_CLOSE(h_pos.data[i].x - old_pos.x, shift.x, tol);
+            CHECK_CLOSE(h_pos.data[i].y - old_pos.y, shift.y, tol);
+            CHECK_CLOSE(h_pos.data[i].z - old_pos.z, shift.z, tol);
+            }
+        }
+
+    // the distance check still refers to the positions before the sort, displace the particles by more than half
+    // the buffer in total, but less since the sort
+    const Scalar3 shift2 = make_scalar3(0.18, -0.05, 0.05);
+    UP_ASSERT(dot(shift2, shift2) < r_buff*r_buff/Scalar(4.0));
+    UP_ASSERT(dot(shift + shift2, shift + shift2) > r_buff*r_buff/Scalar(4.0));
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        for (unsigned int i = 0; i < N; ++i)
+            {
+            h_pos.data[i].x += shift2.x;
+            h_pos.data[i].y += shift2.y;
+            h_pos.data[i].z += shift2.z;
+            }
+        }
+
+    comm->communicate(3);
+    UP_ASSERT(removals.n > 0);
+
+    pdata->getGhostParticlesRemovedSignal().disconnect<ghost_removal_counter, &ghost_removal_counter::count>(removals);
+    }
+
 //! Communicator creator for unit tests
 std::shared_ptr<Communicator> base_class_communicator_creator(std::shared_ptr<SystemDefinition> sysdef,
                                                          std::shared_ptr<DomainDecomposition> decomposition)
@@ -3666,6 +3842,15 @@ UP_TEST( communicator_ghost_layer_per_type_test)
     test_communicator_ghosts_per_type(communicator_creator_base, exec_conf_cpu,BoxDim(2.0));
     }
 
+UP_TEST( communicator_local_sort_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    test_communicator_local_sort(communicator_creator_base, exec_conf_cpu);
+    }
+
 UP_SUITE_END();
 
 #ifdef ENABLE_HIP
@@ -3880,6 +4065,15 @@ UP_TEST( communicator_ghost_layer_per_type_test_GPU)
     test_communicator_ghosts_per_type(communicator_creator_base, exec_conf_gpu,BoxDim(2.0));
     }
 
+UP_TEST( communicator_local_sort_test_GPU)
+    {
+    if (!exec_conf_gpu)
+        exec_conf_gpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU));
+
+    communicator_creator communicator_creator_gpu = bind(gpu_communicator_creator, _1, _2);
+    test_communicator_local_sort(communicator_creator_gpu, exec_conf_gpu);
+    }
+
 UP_TEST ( communicator_compare_test)
     {
     if (!exec_conf_cpu)
@@ -0,0 +1,296 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <random>
+
+#include "hoomd/Initializers.h"
+#include "hoomd/SFCPackTuner.h"
+#include "hoomd/SnapshotSystemData.h"
+#include "hoomd/filter/ParticleFilterAll.h"
+#include "hoomd/md/AllPairPotentials.h"
+#include "hoomd/md/ComputeThermo.h"
+#include "hoomd/md/IntegratorTwoStep.h"
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/md/TwoStepNPTMTK.h"
+#include "hoomd/md/TwoStepNVTMTK.h"
+
+using namespace std;
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+/*! \file test_compute_thermo.cc
+    \brief Implements unit tests for ComputeThermo
+    \ingroup unit_tests
+*/
+
+//! ComputeThermo that records whether its last computation used the kinetic sums of an integration method
+class ComputeThermoSums : public ComputeThermo
+    {
+    public:
+        using ComputeThermo::ComputeThermo;
+
+        //! Return true if the last computation used the kinetic sums
+        bool usedKineticSums()
+            {
+            return m_used_kinetic_sums;
+            }
+
+    protected:
+        bool m_used_kinetic_sums = false;   //!< True if the last computation used the kinetic sums
+
+        virtual void computeProperties()
+            {
+            m_used_kinetic_sums = m_use_kinetic_sums;
+            ComputeThermo::computeProperties();
+            }
+    };
+
+//! Create a simple cubic lattice of LJ particles with random velocities
+/*! \param exec_conf Execution configuration
+    \param aniso Set to give the particles moments of inertia and random angular momenta
+    \param rigid Set to make particles 1 and 2 constituents of a rigid body with central particle 0
+*/
+std::shared_ptr<SystemDefinition> create_system(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                                bool aniso,
+                                                bool rigid)
+    {
+    SimpleCubicInitializer init(6, Scalar(1.2), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+
+    std::mt19937 rng(3);
+    std::normal_distribution<Scalar> v(0.0, 1.0);
+    for (unsigned int i = 0; i < snap->particle_data.size; i++)
+        {
+        snap->particle_data.vel[i] = vec3<Scalar>(v(rng), v(rng), v(rng));
+        if (aniso)
+            {
+            snap->particle_data.inertia[i] = vec3<Scalar>(1.0, 2.0, 3.0);
+            snap->particle_data.angmom[i] = quat<Scalar>(0.0, vec3<Scalar>(v(rng), v(rng), v(rng)));
+            }
+        }
+
+    if (rigid)
+        {
+        snap->particle_data.body[0] = 0;
+        snap->particle_data.body[1] = 0;
+        snap->particle_data.body[2] = 0;
+        }
+
+    auto sysdef = std::make_shared<SystemDefinition>(snap, exec_conf);
+    PDataFlags flags;
+    flags[pdata_flag::pressure_tensor] = 1;
+    flags[pdata_flag::rotational_kinetic_energy] = 1;
+    sysdef->getParticleData()->setFlags(flags);
+    return sysdef;
+    }
+
+//! Create the LJ force of a system made by create_system()
+std::shared_ptr<PotentialPairLJ> create_lj(std::shared_ptr<SystemDefinition> sysdef)
+    {
+    auto nlist = std::make_shared<NeighborListTree>(sysdef, Scalar(2.5), Scalar(0.3));
+    auto lj = std::make_shared<PotentialPairLJ>(sysdef, nlist);
+    lj->setParams(0, 0, EvaluatorPairLJ::param_type(Scalar(1.0), Scalar(1.0)));
+    lj->setRcut(0, 0, Scalar(2.5));
+    lj->setShiftMode(PotentialPairLJ::shift);
+    return lj;
+    }
+
+//! Check that the net force sums of the integrator give the same thermodynamic quantities as the net force arrays
+/*! \param thermo ComputeThermo of all particles
+    \param pdata Particle data
+    \param timestep Time step to compute \a thermo at, incremented twice since \a thermo is not recomputed at the
+           same time step
+*/
+void check_net_force_sums(std::shared_ptr<ComputeThermo> thermo,
+                          std::shared_ptr<ParticleData> pdata,
+                          unsigned int& timestep)
+    {
+    thermo->compute(timestep++);
+    Scalar pe = thermo->getPotentialEnergy();
+    Scalar pressure = thermo->getPressure();
+    PressureTensor p = thermo->getPressureTensor();
+
+    // sum over the net force arrays instead, and restore the sums afterwards
+    double energy_sum;
+    double virial_sum[6];
+    bool sums_valid = pdata->getNetForceSums(energy_sum, virial_sum);
+    pdata->invalidateNetForceSums();
+    thermo->compute(timestep++);
+    PressureTensor p_ref = thermo->getPressureTensor();
+    if (sums_valid)
+        pdata->setNetForceSums(energy_sum, virial_sum);
+
+    MY_CHECK_CLOSE(pe, thermo->getPotentialEnergy(), tol);
+    MY_CHECK_CLOSE(pressure, thermo->getPressure(), tol);
+    MY_CHECK_SMALL(p.xx - p_ref.xx, tol_small);
+    MY_CHECK_SMALL(p.xy - p_ref.xy, tol_small);
+    MY_CHECK_SMALL(p.xz - p_ref.xz, tol_small);
+    MY_CHECK_SMALL(p.yy - p_ref.yy, tol_small);
+    MY_CHECK_SMALL(p.yz - p_ref.yz, tol_small);
+    MY_CHECK_SMALL(p.zz - p_ref.zz, tol_small);
+    }
+
+//! Compare the potential energy, pressure, and virial with and without the net force sums of an NVT simulation
+UP_TEST( compute_thermo_net_force_sums )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = create_system(exec_conf, false, false);
+    auto pdata = sysdef->getParticleData();
+
+    auto group_all = std::make_shared<ParticleGroup>(sysdef, std::make_shared<ParticleFilterAll>());
+    auto lj = create_lj(sysdef);
+
+    auto thermo_nvt = std::make_shared<ComputeThermo>(sysdef, group_all);
+    auto nvt = std::make_shared<TwoStepNVTMTK>(sysdef, group_all, thermo_nvt, Scalar(0.5),
+                                               std::make_shared<VariantConstant>(1.0));
+    auto integrator = std::make_shared<IntegratorTwoStep>(sysdef, Scalar(0.002));
+    integrator->addIntegrationMethod(nvt);
+    integrator->addForceCompute(lj);
+
+    auto thermo = std::make_shared<ComputeThermo>(sysdef, group_all);
+    integrator->updateGroupDOF(group_all);
+
+    unsigned int timestep = 0;
+    unsigned int thermo_step = 0;
+    integrator->prepRun(timestep);
+    for (; timestep < 10; timestep++)
+        integrator->update(timestep);
+
+    // the integrator has summed the net forces
+    double energy_sum;
+    double virial_sum[6];
+    UP_ASSERT(pdata->getNetForceSums(energy_sum, virial_sum));
+    check_net_force_sums(thermo, pdata, thermo_step);
+
+    // after a sort
+    auto sorter = std::make_shared<SFCPackTuner>(sysdef, std::make_shared<PeriodicTrigger>(1));
+    sorter->update(timestep);
+    check_net_force_sums(thermo, pdata, thermo_step);
+    integrator->update(timestep++);
+    UP_ASSERT(pdata->getNetForceSums(energy_sum, virial_sum));
+    check_net_force_sums(thermo, pdata, thermo_step);
+
+    // after removing particles
+    pdata->removeParticle(7);
+    pdata->removeParticle(100);
+    check_net_force_sums(thermo, pdata, thermo_step);
+    integrator->updateGroupDOF(group_all);
+    integrator->update(timestep++);
+    check_net_force_sums(thermo, pdata, thermo_step);
+
+    // after adding a particle
+    unsigned int tag = pdata->addParticle(0);
+    pdata->setPosition(tag, make_scalar3(0.0, 0.0, 0.0));
+    pdata->setVelocity(tag, make_scalar3(0.5, 0.0, 0.0));
+    integrator->update(timestep++);
+    UP_ASSERT(pdata->getNetForceSums(energy_sum, virial_sum));
+    check_net_force_sums(thermo, pdata, thermo_step);
+    }
+
+//! Check that the thermostat of an integration method computes the same quantities from its kinetic sums
+/*! \param sysdef System to integrate
+    \param group Group integrated by \a method
+    \param method Integration method
+    \param thermo ComputeThermo that \a method provides the kinetic sums to
+    \param aniso Set to integrate the rotational degrees of freedom
+    \param sums_offset Time step of the sums relative to the time step of the first half step
+
+    After a few steps, the first half step of \a method provides the kinetic sums to \a thermo. Its temperature,
+    kinetic energies, and pressure tensor are compared to a ComputeThermo that makes a pass over the particles.
+*/
+void check_kinetic_sums(std::shared_ptr<SystemDefinition> sysdef,
+                        std::shared_ptr<ParticleGroup> group,
+                        std::shared_ptr<IntegrationMethodTwoStep> method,
+                        std::shared_ptr<ComputeThermoSums> thermo,
+                        bool aniso,
+                        unsigned int sums_offset)
+    {
+    auto integrator = std::make_shared<IntegratorTwoStep>(sysdef, Scalar(0.002));
+    integrator->addIntegrationMethod(method);
+    integrator->addForceCompute(create_lj(sysdef));
+    integrator->setAnisotropicMode(aniso ? "true" : "false");
+    integrator->updateGroupDOF(group);
+
+    unsigned int timestep = 0;
+    integrator->prepRun(timestep);
+    for (; timestep < 10; timestep++)
+        integrator->update(timestep);
+
+    method->integrateStepOne(timestep);
+    UP_ASSERT(thermo->usedKineticSums());
+
+    // the thermostat computed at the time step the sums are keyed to, so this does not compute again
+    thermo->compute(timestep + sums_offset);
+    UP_ASSERT(thermo->usedKineticSums());
+
+    auto thermo_ref = std::make_shared<ComputeThermo>(sysdef, group);
+    thermo_ref->compute(timestep + sums_offset);
+
+    MY_CHECK_CLOSE(thermo->getTemperature(), thermo_ref->getTemperature(), tol);
+    MY_CHECK_CLOSE(thermo->getTranslationalKineticEnergy(), thermo_ref->getTranslationalKineticEnergy(), tol);
+    if (aniso)
+        {
+        UP_ASSERT(thermo_ref->getRotationalKineticEnergy() > Scalar(0.0));
+        MY_CHECK_CLOSE(thermo->getRotationalKineticEnergy(), thermo_ref->getRotationalKineticEnergy(), tol);
+        }
+    else
+        {
+        MY_CHECK_SMALL(thermo->getRotationalKineticEnergy(), tol_small);
+        }
+
+    PressureTensor p = thermo->getPressureTensor();
+    PressureTensor p_ref = thermo_ref->getPressureTensor();
+    MY_CHECK_SMALL(p.xx - p_ref.xx, tol_small);
+    MY_CHECK_SMALL(p.xy - p_ref.xy, tol_small);
+    MY_CHECK_SMALL(p.xz - p_ref.xz, tol_small);
+    MY_CHECK_SMALL(p.yy - p_ref.yy, tol_small);
+    MY_CHECK_SMALL(p.yz - p_ref.yz, tol_small);
+    MY_CHECK_SMALL(p.zz - p_ref.zz, tol_small);
+    }
+
+//! Compare the kinetic sums of NVT, which are for the next time step, with a pass over the particles
+UP_TEST( compute_thermo_kinetic_sums_nvt )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = create_system(exec_conf, false, true);
+    auto group_all = std::make_shared<ParticleGroup>(sysdef, std::make_shared<ParticleFilterAll>());
+    auto thermo = std::make_shared<ComputeThermoSums>(sysdef, group_all);
+    auto nvt = std::make_shared<TwoStepNVTMTK>(sysdef, group_all, thermo, Scalar(0.5),
+                                               std::make_shared<VariantConstant>(1.0));
+    check_kinetic_sums(sysdef, group_all, nvt, thermo, false, 1);
+    }
+
+//! Compare the kinetic sums of NPT, which are for the current time step, with a pass over the particles
+UP_TEST( compute_thermo_kinetic_sums_npt )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = create_system(exec_conf, false, true);
+    auto group_all = std::make_shared<ParticleGroup>(sysdef, std::make_shared<ParticleFilterAll>());
+    auto thermo_half_step = std::make_shared<ComputeThermoSums>(sysdef, group_all);
+    auto thermo_full_step = std::make_shared<ComputeThermo>(sysdef, group_all);
+    std::shared_ptr<Variant> P = std::make_shared<VariantConstant>(1.0);
+    std::shared_ptr<Variant> zero = std::make_shared<VariantConstant>(0.0);
+    std::vector<std::shared_ptr<Variant>> S = {P, P, P, zero, zero, zero};
+    std::vector<bool> flags = {true, true, true, false, false, false};
+    auto npt = std::make_shared<TwoStepNPTMTK>(sysdef, group_all, thermo_half_step, thermo_full_step, Scalar(0.5),
+                                               Scalar(0.5), std::make_shared<VariantConstant>(1.0), S, "xyz", flags);
+    check_kinetic_sums(sysdef, group_all, npt, thermo_half_step, false, 0);
+    }
+
+//! Compare the kinetic sums of anisotropic NVT, including the rotational kinetic energy, with a pass over the particles
+UP_TEST( compute_thermo_kinetic_sums_aniso )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = create_system(exec_conf, true, true);
+    auto group_all = std::make_shared<ParticleGroup>(sysdef, std::make_shared<ParticleFilterAll>());
+    auto thermo = std::make_shared<ComputeThermoSums>(sysdef, group_all);
+    auto nvt = std::make_shared<TwoStepNVTMTK>(sysdef, group_all, thermo, Scalar(0.5),
+                                               std::make_shared<VariantConstant>(1.0));
+    check_kinetic_sums(sysdef, group_all, nvt, thermo, true, 1);
+    }
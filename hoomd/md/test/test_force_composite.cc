@@ -0,0 +1,176 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+
+#include <memory>
+
+#include "hoomd/md/ForceComposite.h"
+
+#include <math.h>
+#include <random>
+
+using namespace std;
+
+/*! \file test_force_composite.cc
+    \brief Implements unit tests for ForceComposite
+    \ingroup unit_tests
+*/
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+//! Place rigid bodies of two different types and check constituent positions, forces and torques
+UP_TEST( ForceComposite_update_and_forces )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    // types 0 and 1 are central particles, type 2 are constituents
+    const unsigned int n_body = 200;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n_body, BoxDim(40.0), 3, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<Scalar> uniform(-1.0, 1.0);
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_body(pdata->getBodies(), access_location::host, access_mode::readwrite);
+
+    for (unsigned int i = 0; i < n_body; ++i)
+        {
+        h_pos.data[i] = make_scalar4(Scalar(20.0)*uniform(rng), Scalar(20.0)*uniform(rng), Scalar(20.0)*uniform(rng),
+            __int_as_scalar(i % 2));
+        quat<Scalar> q(uniform(rng), vec3<Scalar>(uniform(rng), uniform(rng), uniform(rng)));
+        q = q*fast::rsqrt(norm2(q));
+        h_orientation.data[i] = quat_to_scalar4(q);
+        h_body.data[i] = i;
+        }
+    }
+
+    std::shared_ptr<ForceComposite> rigid(new ForceComposite(sysdef));
+
+    // two body types with a different number of constituents
+    std::vector<Scalar3> body_pos[2];
+    for (unsigned int type = 0; type < 2; ++type)
+        {
+        std::vector<unsigned int> types;
+        std::vector<Scalar4> orientations;
+        std::vector<Scalar> charges, diameters;
+        unsigned int len = 3 + 4*type;
+        for (unsigned int j = 0; j < len; ++j)
+            {
+            types.push_back(2);
+            body_pos[type].push_back(make_scalar3(uniform(rng), uniform(rng), uniform(rng)));
+            orientations.push_back(make_scalar4(1, 0, 0, 0));
+            charges.push_back(0.0);
+            diameters.push_back(1.0);
+            }
+        rigid->setParam(type, types, body_pos[type], orientations, charges, diameters);
+        }
+
+    rigid->validateRigidBodies(true);
+    UP_ASSERT_EQUAL(pdata->getN(), n_body/2*(1+3) + n_body/2*(1+7));
+
+    // scramble the constituent positions and let the compute restore them
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_torque(pdata->getNetTorqueArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_net_virial(pdata->getNetVirial(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body(pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        unsigned int pitch = pdata->getNetVirial().getPitch();
+
+        for (unsigned int i = 0; i < pdata->getN(); ++i)
+            {
+            bool central = h_body.data[i] == h_tag.data[i];
+            if (!central)
+                {
+                h_pos.data[i].x = 0;
+                h_pos.data[i].y = 0;
+                h_pos.data[i].z = 0;
+                }
+            h_net_force.data[i] = make_scalar4(uniform(rng), uniform(rng), uniform(rng), uniform(rng));
+            h_net_torque.data[i] = make_scalar4(uniform(rng), uniform(rng), uniform(rng), 0);
+            for (unsigned int k = 0; k < 6; ++k)
+                h_net_virial.data[k*pitch+i] = uniform(rng);
+            }
+        }
+
+    rigid->updateCompositeParticles(0);
+
+    // reference values computed directly from the body definition
+    std::vector<vec3<Scalar> > ref_force(pdata->getN(), vec3<Scalar>(0,0,0));
+    std::vector<vec3<Scalar> > ref_torque(pdata->getN(), vec3<Scalar>(0,0,0));
+    std::vector<Scalar> ref_energy(pdata->getN(), 0);
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_torque(pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+        const BoxDim& box = pdata->getBox();
+
+        for (unsigned int i = 0; i < pdata->getN(); ++i)
+            {
+            unsigned int central_tag = h_body.data[i];
+            if (central_tag == h_tag.data[i])
+                continue;
+
+            unsigned int central_idx = h_rtag.data[central_tag];
+            unsigned int type = __scalar_as_int(h_pos.data[central_idx].w);
+            quat<Scalar> q(h_orientation.data[central_idx]);
+
+            // constituents are numbered in tag order after the central particle
+            unsigned int j_in_body = h_tag.data[i] - n_body;
+            for (unsigned int t = 0; t < central_tag; ++t)
+                j_in_body -= (t % 2) ? 7 : 3;
+
+            vec3<Scalar> dr = rotate(q, vec3<Scalar>(body_pos[type][j_in_body]));
+            vec3<Scalar> expected = vec3<Scalar>(h_pos.data[central_idx]) + dr;
+            Scalar3 unwrapped = box.shift(make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z),
+                h_image.data[i] - h_image.data[central_idx]);
+            MY_CHECK_SMALL(unwrapped.x - expected.x, tol_small);
+            MY_CHECK_SMALL(unwrapped.y - expected.y, tol_small);
+            MY_CHECK_SMALL(unwrapped.z - expected.z, tol_small);
+
+            vec3<Scalar> f(h_net_force.data[i]);
+            ref_force[central_idx] += f;
+            ref_energy[central_idx] += h_net_force.data[i].w;
+            ref_torque[central_idx] += cross(dr, f) + vec3<Scalar>(h_net_torque.data[i]);
+            }
+        }
+
+    rigid->compute(0);
+
+    ArrayHandle<Scalar4> h_force(rigid->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_torque(rigid->getTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body(pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+
+    for (unsigned int i = 0; i < pdata->getN(); ++i)
+        {
+        MY_CHECK_SMALL(h_force.data[i].x - ref_force[i].x, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].y - ref_force[i].y, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].z - ref_force[i].z, tol_small);
+        MY_CHECK_SMALL(h_force.data[i].w - ref_energy[i], tol_small);
+        MY_CHECK_SMALL(h_torque.data[i].x - ref_torque[i].x, tol_small);
+        MY_CHECK_SMALL(h_torque.data[i].y - ref_torque[i].y, tol_small);
+        MY_CHECK_SMALL(h_torque.data[i].z - ref_torque[i].z, tol_small);
+
+        // the net force on constituent particles is consumed
+        if (h_body.data[i] != h_tag.data[i])
+            MY_CHECK_SMALL(h_net_force.data[i].x, tol_small);
+        }
+    }
@@ -0,0 +1,127 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+
+#include <memory>
+
+#include "hoomd/md/ForceDistanceConstraint.h"
+
+#include <math.h>
+#include <random>
+
+using namespace std;
+
+/*! \file test_force_distance_constraint.cc
+    \brief Implements unit tests for ForceDistanceConstraint
+    \ingroup unit_tests
+*/
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+//! Build a system of triangular molecules with one extra constraint sharing a vertex, so that constraints are coupled
+std::shared_ptr<SystemDefinition> build_triangles(std::shared_ptr<ExecutionConfiguration> exec_conf,
+    unsigned int n_mol)
+    {
+    const unsigned int n_per_mol = 4;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n_mol*n_per_mol, BoxDim(100.0), 1, 0, 0, 0, 0,
+        exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::shared_ptr<ConstraintData> cdata = sysdef->getConstraintData();
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<Scalar> uniform(-1.0, 1.0);
+    std::uniform_real_distribution<Scalar> uniform_mass(0.5, 2.0);
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+
+    for (unsigned int mol = 0; mol < n_mol; ++mol)
+        {
+        Scalar3 origin = make_scalar3(Scalar(-49.0) + Scalar(3.0)*(mol % 33), Scalar(3.0)*(mol/33), 0);
+        Scalar3 offset[n_per_mol] = {make_scalar3(0,0,0), make_scalar3(1,0,0), make_scalar3(0.5,0.8,0),
+            make_scalar3(-0.9,-0.3,0.2)};
+
+        for (unsigned int j = 0; j < n_per_mol; ++j)
+            {
+            unsigned int i = mol*n_per_mol + j;
+            h_pos.data[i].x = origin.x + offset[j].x;
+            h_pos.data[i].y = origin.y + offset[j].y;
+            h_pos.data[i].z = origin.z + offset[j].z;
+
+            h_vel.data[i].x = uniform(rng);
+            h_vel.data[i].y = uniform(rng);
+            h_vel.data[i].z = uniform(rng);
+            h_vel.data[i].w = uniform_mass(rng);
+            }
+        }
+    }
+
+    for (unsigned int mol = 0; mol < n_mol; ++mol)
+        {
+        unsigned int t = mol*n_per_mol;
+        cdata->addBondedGroup(Constraint(1.0, t, t+1));
+        cdata->addBondedGroup(Constraint(sqrt(0.25+0.64), t+1, t+2));
+        cdata->addBondedGroup(Constraint(sqrt(0.25+0.64), t+2, t));
+        cdata->addBondedGroup(Constraint(sqrt(0.81+0.09+0.04), t, t+3));
+        }
+
+    return sysdef;
+    }
+
+//! Compare the constraint forces of the iterative solver with the ones from sparse LU
+UP_TEST( ForceDistanceConstraint_iterative )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    std::shared_ptr<SystemDefinition> sysdef = build_triangles(exec_conf, 100);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<ForceDistanceConstraint> fc_lu(new ForceDistanceConstraint(sysdef));
+    std::shared_ptr<ForceDistanceConstraint> fc_it(new ForceDistanceConstraint(sysdef));
+    fc_lu->setDeltaT(Scalar(0.005));
+    fc_it->setDeltaT(Scalar(0.005));
+    fc_it->setIterativeSolver(true);
+    fc_it->setSolverTolerance(1e-12);
+
+    for (unsigned int step = 0; step < 3; ++step)
+        {
+        fc_lu->compute(step);
+        fc_it->compute(step);
+
+        ArrayHandle<Scalar4> h_force_lu(fc_lu->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_force_it(fc_it->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial_lu(fc_lu->getVirialArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial_it(fc_it->getVirialArray(), access_location::host, access_mode::read);
+        unsigned int pitch = fc_lu->getVirialArray().getPitch();
+
+        for (unsigned int i = 0; i < pdata->getN(); ++i)
+            {
+            MY_CHECK_SMALL(h_force_lu.data[i].x - h_force_it.data[i].x, tol_small);
+            MY_CHECK_SMALL(h_force_lu.data[i].y - h_force_it.data[i].y, tol_small);
+            MY_CHECK_SMALL(h_force_lu.data[i].z - h_force_it.data[i].z, tol_small);
+            for (unsigned int k = 0; k < 6; ++k)
+                MY_CHECK_SMALL(h_virial_lu.data[k*pitch+i] - h_virial_it.data[k*pitch+i], tol_small);
+            }
+        }
+
+    // adding a constraint changes the coupling of the iterative solver
+    sysdef->getConstraintData()->addBondedGroup(Constraint(sqrt(1.96+1.21+0.04), 2, 3));
+    fc_lu->compute(3);
+    fc_it->compute(3);
+
+    ArrayHandle<Scalar4> h_force_lu(fc_lu->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_force_it(fc_it->getForceArray(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < pdata->getN(); ++i)
+        {
+        MY_CHECK_SMALL(h_force_lu.data[i].x - h_force_it.data[i].x, tol_small);
+        MY_CHECK_SMALL(h_force_lu.data[i].y - h_force_it.data[i].y, tol_small);
+        MY_CHECK_SMALL(h_force_lu.data[i].z - h_force_it.data[i].z, tol_small);
+        }
+    }
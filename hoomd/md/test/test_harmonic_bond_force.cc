@@ -8,10 +8,12 @@
 #include <iostream>
 
 #include <functional>
+#include <random>
 
 #include "hoomd/md/AllBondPotentials.h"
 #include "hoomd/ConstForceCompute.h"
 #include "hoomd/SnapshotSystemData.h"
+#include "hoomd/SFCPackTuner.h"
 
 #include "hoomd/Initializers.h"
 
@@ -464,6 +466,81 @@ UP_TEST( PotentialBondHarmonic_basic )
     bond_force_basic_tests(bf_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! Check that the CPU bond table lists the bonds of every particle after sorting
+UP_TEST( BondData_cpu_table )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    const unsigned int N = 1000;
+    const Scalar L = 20.0;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(L), 1, 2, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::shared_ptr<BondData> bdata = sysdef->getBondData();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<Scalar> uniform(-L/Scalar(2.0), L/Scalar(2.0));
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < N; i++)
+            h_pos.data[i] = make_scalar4(uniform(rng), uniform(rng), uniform(rng), __int_as_scalar(0));
+        }
+
+    // bond each particle to a random partner, so that a particle may have any number of bonds
+    std::uniform_int_distribution<unsigned int> random_tag(0, N-1);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        unsigned int j = random_tag(rng);
+        if (j != i)
+            bdata->addBondedGroup(Bond(i % 2, i, j));
+        }
+
+    // build the table before sorting, it must be rebuilt afterwards
+    bdata->getCPUTable();
+
+    std::shared_ptr<Trigger> trigger(new PeriodicTrigger(1));
+    std::shared_ptr<SFCPackTuner> sorter(new SFCPackTuner(sysdef, trigger));
+    sorter->update(0);
+
+    // remove a bond after sorting
+    bdata->removeBondedGroup(bdata->getMembersByIndex(0).tag[0] == 0 ? 1 : 0);
+
+    ArrayHandle<BondData::members_t> h_table(bdata->getCPUTable(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_pos_table(bdata->getCPUPosTable(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_group_idx(bdata->getCPUGroupIndexTable(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_group_entry(bdata->getCPUGroupEntryTable(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_offsets(bdata->getCPUTableOffsets(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+
+    UP_ASSERT_EQUAL(bdata->getCPUTableOffsets().size(), N+1);
+    UP_ASSERT_EQUAL(h_offsets.data[0], 0);
+    UP_ASSERT_EQUAL(h_offsets.data[N], 2*bdata->getN());
+
+    std::vector<unsigned int> n_entries(bdata->getN(), 0);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        UP_ASSERT(h_offsets.data[i] <= h_offsets.data[i+1]);
+        for (unsigned int entry = h_offsets.data[i]; entry < h_offsets.data[i+1]; entry++)
+            {
+            unsigned int group = h_group_idx.data[entry];
+            UP_ASSERT(group < bdata->getN());
+            n_entries[group]++;
+
+            const BondData::members_t& bond = bdata->getMembersByIndex(group);
+            unsigned int pos = h_pos_table.data[entry];
+            UP_ASSERT(pos < 2);
+            UP_ASSERT_EQUAL(bond.tag[pos], h_tag.data[i]);
+            UP_ASSERT_EQUAL(h_table.data[entry].idx[0], h_rtag.data[bond.tag[1-pos]]);
+            UP_ASSERT_EQUAL(h_table.data[entry].idx[1], bdata->getTypeByIndex(group));
+            UP_ASSERT_EQUAL(h_group_entry.data[group*2 + pos], entry);
+            }
+        }
+
+    // every bond is listed once for each of its members
+    for (unsigned int group = 0; group < bdata->getN(); group++)
+        UP_ASSERT_EQUAL(n_entries[group], 2);
+    }
+
 #ifdef ENABLE_HIP
 //! test case for bond forces on the GPU
 UP_TEST( PotentialBondHarmonicGPU_basic )
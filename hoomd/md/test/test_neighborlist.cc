@@ -1182,6 +1182,78 @@ void neighborlist_large_ex_tests(std::shared_ptr<ExecutionConfiguration> exec_co
         }
     }
 
+//! Test that a NeighborList excludes both nearby-tag and distant-tag exclusions
+template <class NL>
+void neighborlist_chain_ex_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborList> nlist(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    auto r_cut = std::make_shared<GlobalArray<Scalar>>(nlist->getTypePairIndexer().getNumElements(),
+                                               exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+        h_r_cut.data[0] = 3.0;
+        }
+    nlist->addRCutMatrix(r_cut);
+    nlist->setStorageMode(NeighborList::full);
+
+    // chain-like exclusions to nearby tags, plus exclusions to distant tags
+    const unsigned int N = pdata->getN();
+    for (unsigned int i=0; i < N; i++)
+        {
+        if (i+1 < N) nlist->addExclusion(i,i+1);
+        if (i+3 < N) nlist->addExclusion(i,i+3);
+        if (i+16 < N) nlist->addExclusion(i,i+16);
+        if (i+17 < N) nlist->addExclusion(i,i+17);
+        if (i+500 < N) nlist->addExclusion(i,i+500);
+        }
+
+    nlist->compute(0);
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh(nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(nlist->getHeadList(), access_location::host, access_mode::read);
+    const BoxDim& box = pdata->getBox();
+    const Scalar r_listsq = Scalar(3.4*3.4);
+
+    // every pair inside the cutoff should be a neighbor exactly when it is not excluded
+    for (unsigned int i = 0; i < N; i++)
+        {
+        std::vector<unsigned int> neigh(h_nlist.data + h_head_list.data[i],
+                                        h_nlist.data + h_head_list.data[i] + h_n_neigh.data[i]);
+        unsigned int n_expected = 0;
+        for (unsigned int j = 0; j < N; j++)
+            {
+            if (i == j) continue;
+
+            Scalar3 dx = make_scalar3(h_pos.data[i].x - h_pos.data[j].x,
+                                      h_pos.data[i].y - h_pos.data[j].y,
+                                      h_pos.data[i].z - h_pos.data[j].z);
+            dx = box.minImage(dx);
+            const unsigned int dtag = (h_tag.data[i] > h_tag.data[j]) ? h_tag.data[i] - h_tag.data[j] : h_tag.data[j] - h_tag.data[i];
+            const bool excluded = (dtag == 1 || dtag == 3 || dtag == 16 || dtag == 17 || dtag == 500);
+            const bool found = std::find(neigh.begin(), neigh.end(), j) != neigh.end();
+            if (excluded)
+                {
+                UP_ASSERT(!found);
+                }
+            else if (dot(dx,dx) <= r_listsq)
+                {
+                UP_ASSERT(found);
+                ++n_expected;
+                }
+            }
+        CHECK_EQUAL_UINT(h_n_neigh.data[i], n_expected);
+        }
+    }
+
 //! Test that NeighborList can exclude particles correctly when cutoff radius is negative
 template <class NL>
 void neighborlist_cutoff_exclude_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -1449,6 +1521,11 @@ UP_TEST( NeighborListBinned_large_ex )
     {
     neighborlist_large_ex_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! chain exclusion test case for binned class
+UP_TEST( NeighborListBinned_chain_ex )
+    {
+    neighborlist_chain_ex_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! body filter test case for binned class
 UP_TEST( NeighborListBinned_body_filter)
     {
@@ -1504,6 +1581,11 @@ UP_TEST( NeighborListStencil_large_ex )
     {
     neighborlist_large_ex_tests<NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! chain exclusion test case for stencil class
+UP_TEST( NeighborListStencil_chain_ex )
+    {
+    neighborlist_chain_ex_tests<NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! body filter test case for stencil class
 UP_TEST( NeighborListStencil_body_filter)
     {
@@ -1563,6 +1645,11 @@ UP_TEST( NeighborListTree_large_ex )
     {
     neighborlist_large_ex_tests<NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! chain exclusion test case for tree class
+UP_TEST( NeighborListTree_chain_ex )
+    {
+    neighborlist_chain_ex_tests<NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! body filter test case for tree class
 UP_TEST( NeighborListTree_body_filter)
     {
@@ -1623,6 +1710,11 @@ UP_TEST( NeighborListGPUBinned_large_ex )
     {
     neighborlist_large_ex_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
+//! chain exclusion test case for GPU binned class
+UP_TEST( NeighborListGPUBinned_chain_ex )
+    {
+    neighborlist_chain_ex_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
 //! body filter test case for GPUBinned class
 UP_TEST( NeighborListGPUBinned_body_filter)
     {
@@ -1683,6 +1775,11 @@ UP_TEST( NeighborListGPUStencil_large_ex )
     {
     neighborlist_large_ex_tests<NeighborListGPUStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
+//! chain exclusion test case for GPU stencil class
+UP_TEST( NeighborListGPUStencil_chain_ex )
+    {
+    neighborlist_chain_ex_tests<NeighborListGPUStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
 //! body filter test case for GPUStencil class
 UP_TEST( NeighborListGPUStencil_body_filter)
     {
@@ -1751,6 +1848,12 @@ UP_TEST( NeighborListGPUTree_large_ex )
     std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::GPU));
     neighborlist_large_ex_tests<NeighborListGPUTree>(exec_conf);
     }
+//! chain exclusion test case for GPU tree class
+UP_TEST( NeighborListGPUTree_chain_ex )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::GPU));
+    neighborlist_chain_ex_tests<NeighborListGPUTree>(exec_conf);
+    }
 //! body filter test case for GPUTree class
 UP_TEST( NeighborListGPUTree_body_filter)
     {
@@ -0,0 +1,283 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#include <iostream>
+
+#include <memory>
+
+#include "hoomd/ConstForceCompute.h"
+#include "hoomd/filter/ParticleFilterAll.h"
+#include "hoomd/md/AllBondPotentials.h"
+#include "hoomd/md/TwoStepNVE.h"
+#include "hoomd/md/IntegratorRESPA.h"
+
+#include <math.h>
+
+using namespace std;
+
+/*! \file test_respa_integrator.cc
+    \brief Implements unit tests for IntegratorRESPA
+    \ingroup unit_tests
+*/
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+//! Integrate 2 particles with a fast and a slow constant force and compare to the analytical solution
+void respa_const_force_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(2, BoxDim(1000.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterAll());
+    std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    h_pos.data[0] = make_scalar4(0.0, 1.0, 2.0, __int_as_scalar(0));
+    h_vel.data[0] = make_scalar4(3.0, 2.0, 1.0, 1.0);
+    h_pos.data[1] = make_scalar4(10.0, 11.0, 12.0, __int_as_scalar(0));
+    h_vel.data[1] = make_scalar4(13.0, 12.0, 11.0, 2.0);
+    }
+
+    Scalar deltaT = Scalar(0.001);
+    const unsigned int substeps = 4;
+    std::shared_ptr<IntegratorRESPA> respa(new IntegratorRESPA(sysdef, deltaT));
+    respa->addIntegrationMethod(std::shared_ptr<TwoStepNVE>(new TwoStepNVE(sysdef, group_all)));
+
+    // fast force in x, slow force in y
+    std::shared_ptr<ConstForceCompute> fc1(new ConstForceCompute(sysdef, 1.5, 0.0, 0.0));
+    respa->addForceCompute(fc1);
+    std::shared_ptr<ConstForceCompute> fc2(new ConstForceCompute(sysdef, 0.0, 2.5, 0.0));
+    unsigned int level = respa->addLevel(substeps);
+    respa->getLevelForces(level).push_back(fc2);
+    UP_ASSERT_EQUAL(respa->getNumLevels(), 1);
+    UP_ASSERT_EQUAL(respa->getLevelSubsteps(level), substeps);
+
+    respa->prepRun(0);
+
+    // constant forces are integrated exactly at the end of every outer step
+    for (unsigned int i = 0; i <= 400; i++)
+        {
+        if (i % substeps == 0)
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+
+            Scalar t = Scalar(i) * deltaT;
+            MY_CHECK_CLOSE(h_pos.data[0].x, 0.0 + 3.0 * t + 1.0/2.0 * 1.5 * t*t, loose_tol);
+            MY_CHECK_CLOSE(h_vel.data[0].x, 3.0 + 1.5 * t, loose_tol);
+            MY_CHECK_CLOSE(h_pos.data[0].y, 1.0 + 2.0 * t + 1.0/2.0 * 2.5 * t*t, loose_tol);
+            MY_CHECK_CLOSE(h_vel.data[0].y, 2.0 + 2.5 * t, loose_tol);
+            MY_CHECK_CLOSE(h_pos.data[0].z, 2.0 + 1.0 * t, loose_tol);
+            MY_CHECK_CLOSE(h_vel.data[0].z, 1.0, loose_tol);
+
+            MY_CHECK_CLOSE(h_pos.data[1].x, 10.0 + 13.0 * t + 1.0/2.0 * 0.75 * t*t, loose_tol);
+            MY_CHECK_CLOSE(h_vel.data[1].x, 13.0 + 0.75 * t, loose_tol);
+            MY_CHECK_CLOSE(h_pos.data[1].y, 11.0 + 12.0 * t + 1.0/2.0 * 1.25 * t*t, loose_tol);
+            MY_CHECK_CLOSE(h_vel.data[1].y, 12.0 + 1.25 * t, loose_tol);
+            MY_CHECK_CLOSE(h_pos.data[1].z, 12.0 + 11.0 * t, loose_tol);
+            MY_CHECK_CLOSE(h_vel.data[1].z, 11.0, loose_tol);
+            }
+
+        respa->update(i);
+        }
+    }
+
+//! Check that runs beginning within an outer step integrate a slow constant force exactly
+void respa_mid_step_start_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(1, BoxDim(1000.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef,
+        std::shared_ptr<ParticleFilter>(new ParticleFilterAll())));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    h_pos.data[0] = make_scalar4(0.0, 1.0, 2.0, __int_as_scalar(0));
+    h_vel.data[0] = make_scalar4(3.0, 2.0, 1.0, 1.0);
+    }
+
+    Scalar deltaT = Scalar(0.001);
+    const unsigned int substeps = 4;
+    std::shared_ptr<IntegratorRESPA> respa(new IntegratorRESPA(sysdef, deltaT));
+    respa->addIntegrationMethod(std::shared_ptr<TwoStepNVE>(new TwoStepNVE(sysdef, group_all)));
+    std::shared_ptr<ConstForceCompute> fc(new ConstForceCompute(sysdef, 0.0, 2.5, 0.0));
+    respa->getLevelForces(respa->addLevel(substeps)).push_back(fc);
+
+    // the first run begins at a time step that is not a multiple of the substeps, and the second run continues
+    // the outer step begun by the first one
+    const unsigned int start = 1;
+    for (unsigned int i = start; i <= 401; i++)
+        {
+        if (i == start || i == 7)
+            respa->prepRun(i);
+
+        if (i % substeps == 0)
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+
+            Scalar t = Scalar(i - start) * deltaT;
+            MY_CHECK_SMALL(h_pos.data[0].x - (0.0 + 3.0 * t), 1e-4);
+            MY_CHECK_SMALL(h_pos.data[0].y - (1.0 + 2.0 * t + 1.0/2.0 * 2.5 * t*t), 1e-4);
+            MY_CHECK_SMALL(h_vel.data[0].y - (2.0 + 2.5 * t), 1e-4);
+            }
+
+        respa->update(i);
+        }
+    }
+
+//! Build a 3 particle chain with a stiff bond (type 0) and a soft bond (type 1)
+std::shared_ptr<SystemDefinition> respa_build_chain(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(3, BoxDim(100.0), 1, 2, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    h_pos.data[0] = make_scalar4(0.0, 0.0, 0.0, __int_as_scalar(0));
+    h_pos.data[1] = make_scalar4(1.1, 0.1, 0.0, __int_as_scalar(0));
+    h_pos.data[2] = make_scalar4(2.2, 0.9, 0.3, __int_as_scalar(0));
+    h_vel.data[0] = make_scalar4(0.1, -0.2, 0.3, 1.0);
+    h_vel.data[1] = make_scalar4(-0.4, 0.1, 0.0, 1.0);
+    h_vel.data[2] = make_scalar4(0.3, 0.1, -0.3, 1.0);
+    }
+
+    sysdef->getBondData()->addBondedGroup(Bond(0, 0, 1));
+    sysdef->getBondData()->addBondedGroup(Bond(1, 1, 2));
+    return sysdef;
+    }
+
+//! Total energy of the system from the velocities and the net force array
+Scalar respa_total_energy(std::shared_ptr<ParticleData> pdata)
+    {
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::read);
+
+    Scalar energy = 0.0;
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        Scalar4 v = h_vel.data[i];
+        energy += Scalar(0.5)*v.w*(v.x*v.x + v.y*v.y + v.z*v.z) + h_net_force.data[i].w;
+        }
+    return energy;
+    }
+
+//! Check that a slow level with a single substep reproduces IntegratorTwoStep
+void respa_single_substep_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef_ref = respa_build_chain(exec_conf);
+    std::shared_ptr<SystemDefinition> sysdef = respa_build_chain(exec_conf);
+    Scalar deltaT = Scalar(0.005);
+
+    std::shared_ptr<ParticleGroup> group_ref(new ParticleGroup(sysdef_ref,
+        std::shared_ptr<ParticleFilter>(new ParticleFilterAll())));
+    std::shared_ptr<IntegratorTwoStep> ref(new IntegratorTwoStep(sysdef_ref, deltaT));
+    ref->addIntegrationMethod(std::shared_ptr<TwoStepNVE>(new TwoStepNVE(sysdef_ref, group_ref)));
+    std::shared_ptr<PotentialBondHarmonic> bond_ref(new PotentialBondHarmonic(sysdef_ref));
+    bond_ref->setParams(0, harmonic_params(400.0, 1.0));
+    bond_ref->setParams(1, harmonic_params(10.0, 1.5));
+    ref->addForceCompute(bond_ref);
+
+    // the same bonds, split in two force computes on two levels
+    std::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef,
+        std::shared_ptr<ParticleFilter>(new ParticleFilterAll())));
+    std::shared_ptr<IntegratorRESPA> respa(new IntegratorRESPA(sysdef, deltaT));
+    respa->addIntegrationMethod(std::shared_ptr<TwoStepNVE>(new TwoStepNVE(sysdef, group)));
+    std::shared_ptr<PotentialBondHarmonic> bond_fast(new PotentialBondHarmonic(sysdef));
+    bond_fast->setParams(0, harmonic_params(400.0, 1.0));
+    bond_fast->setParams(1, harmonic_params(0.0, 1.5));
+    respa->addForceCompute(bond_fast);
+    std::shared_ptr<PotentialBondHarmonic> bond_slow(new PotentialBondHarmonic(sysdef));
+    bond_slow->setParams(0, harmonic_params(0.0, 1.0));
+    bond_slow->setParams(1, harmonic_params(10.0, 1.5));
+    respa->getLevelForces(respa->addLevel(1)).push_back(bond_slow);
+
+    ref->prepRun(0);
+    respa->prepRun(0);
+
+    for (unsigned int i = 0; i < 200; i++)
+        {
+        ref->update(i);
+        respa->update(i);
+        }
+
+    ArrayHandle<Scalar4> h_pos_ref(sysdef_ref->getParticleData()->getPositions(), access_location::host,
+        access_mode::read);
+    ArrayHandle<Scalar4> h_vel_ref(sysdef_ref->getParticleData()->getVelocities(), access_location::host,
+        access_mode::read);
+    ArrayHandle<Scalar4> h_pos(sysdef->getParticleData()->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(sysdef->getParticleData()->getVelocities(), access_location::host, access_mode::read);
+
+    for (unsigned int i = 0; i < 3; i++)
+        {
+        MY_CHECK_CLOSE(h_pos.data[i].x, h_pos_ref.data[i].x, tol);
+        MY_CHECK_CLOSE(h_pos.data[i].y, h_pos_ref.data[i].y, tol);
+        MY_CHECK_CLOSE(h_pos.data[i].z, h_pos_ref.data[i].z, tol);
+        MY_CHECK_CLOSE(h_vel.data[i].x, h_vel_ref.data[i].x, tol);
+        MY_CHECK_CLOSE(h_vel.data[i].y, h_vel_ref.data[i].y, tol);
+        MY_CHECK_CLOSE(h_vel.data[i].z, h_vel_ref.data[i].z, tol);
+        }
+    }
+
+//! Check energy conservation with the soft bond evaluated every 4 time steps
+void respa_energy_conservation_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef = respa_build_chain(exec_conf);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    Scalar deltaT = Scalar(0.005);
+    const unsigned int substeps = 4;
+
+    std::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef,
+        std::shared_ptr<ParticleFilter>(new ParticleFilterAll())));
+    std::shared_ptr<IntegratorRESPA> respa(new IntegratorRESPA(sysdef, deltaT));
+    respa->addIntegrationMethod(std::shared_ptr<TwoStepNVE>(new TwoStepNVE(sysdef, group)));
+    std::shared_ptr<PotentialBondHarmonic> bond_fast(new PotentialBondHarmonic(sysdef));
+    bond_fast->setParams(0, harmonic_params(400.0, 1.0));
+    bond_fast->setParams(1, harmonic_params(0.0, 1.5));
+    respa->addForceCompute(bond_fast);
+    std::shared_ptr<PotentialBondHarmonic> bond_slow(new PotentialBondHarmonic(sysdef));
+    bond_slow->setParams(0, harmonic_params(0.0, 1.0));
+    bond_slow->setParams(1, harmonic_params(10.0, 1.5));
+    respa->getLevelForces(respa->addLevel(substeps)).push_back(bond_slow);
+
+    respa->prepRun(0);
+    Scalar initial_energy = respa_total_energy(pdata);
+
+    for (unsigned int i = 0; i < 4000; i++)
+        {
+        respa->update(i);
+
+        // the net energy includes the slow level at the end of each outer step
+        if ((i+1) % substeps == 0)
+            MY_CHECK_CLOSE(respa_total_energy(pdata), initial_energy, 1.0);
+        }
+    }
+
+//! test the RESPA integrator on the CPU
+UP_TEST( respa_const_force )
+    {
+    respa_const_force_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! test runs that begin within an outer step on the CPU
+UP_TEST( respa_mid_step_start )
+    {
+    respa_mid_step_start_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! test a single substep against IntegratorTwoStep on the CPU
+UP_TEST( respa_single_substep )
+    {
+    respa_single_substep_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! test energy conservation on the CPU
+UP_TEST( respa_energy_conservation )
+    {
+    respa_energy_conservation_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
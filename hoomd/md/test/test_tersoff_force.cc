@@ -0,0 +1,198 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <random>
+
+#include "hoomd/md/PotentialTersoff.h"
+#include "hoomd/md/EvaluatorTersoff.h"
+#include "hoomd/md/EvaluatorRevCross.h"
+#include "hoomd/md/NeighborListTree.h"
+
+using namespace std;
+
+#include "hoomd/test/upp11_config.h"
+#include "hoomd/test/thread_compare.h"
+
+HOOMD_UP_MAIN();
+
+/*! \file test_tersoff_force.cc
+    \brief Implements unit tests for PotentialTersoff
+    \ingroup unit_tests
+*/
+
+//! Create a three-body potential with a full neighbor list and the same parameters for all type pairs
+template<class evaluator>
+std::shared_ptr< PotentialTersoff<evaluator> > create_triplet(std::shared_ptr<SystemDefinition> sysdef,
+                                                               const typename evaluator::param_type& params,
+                                                               Scalar r_cut)
+    {
+    auto nlist = std::make_shared<NeighborListTree>(sysdef, r_cut, Scalar(0.3));
+    auto r_cut_matrix = std::make_shared< GlobalArray<Scalar> >(nlist->getTypePairIndexer().getNumElements(),
+                                                                 sysdef->getParticleData()->getExecConf());
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut_matrix, access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < r_cut_matrix->getNumElements(); i++)
+            h_r_cut.data[i] = r_cut;
+        }
+    nlist->addRCutMatrix(r_cut_matrix);
+    nlist->setStorageMode(NeighborList::full);
+
+    auto triplet = std::make_shared< PotentialTersoff<evaluator> >(sysdef, nlist, "");
+    unsigned int ntypes = sysdef->getParticleData()->getNTypes();
+    for (unsigned int a = 0; a < ntypes; a++)
+        for (unsigned int b = a; b < ntypes; b++)
+            {
+            triplet->setParams(a, b, params);
+            triplet->setRcut(a, b, r_cut);
+            }
+    return triplet;
+    }
+
+//! Tersoff parameters used in the tests
+tersoff_params test_tersoff_params()
+    {
+    // cutoff_thickness, C1, C2, lambda1, lambda2, dimer_r, n, gamma^n, lambda3^3, c^2, d^2, m, alpha
+    return make_tersoff_params(Scalar(0.3), make_scalar2(5.0, 2.0), make_scalar2(2.0, 1.0), Scalar(1.5),
+                               Scalar(1.0), Scalar(0.5), Scalar(0.125), make_scalar3(1.0, 4.0, 1.0), Scalar(3.0));
+    }
+
+//! RevCross parameters used in the tests
+revcross_params test_revcross_params()
+    {
+    // sigma, n, epsilon, lambda3
+    return make_revcross_params(Scalar(1.0), Scalar(6.0), Scalar(1.0), Scalar(1.5));
+    }
+
+//! Create a small cluster of particles with the given nearest neighbor scale
+std::shared_ptr<SystemDefinition> create_cluster(std::shared_ptr<ExecutionConfiguration> exec_conf, Scalar scale)
+    {
+    auto sysdef = std::make_shared<SystemDefinition>(6, BoxDim(20.0), 1, 0, 0, 0, 0, exec_conf);
+    auto pdata = sysdef->getParticleData();
+    pdata->setPosition(0, make_scalar3(0.0, 0.0, 0.0)*scale);
+    pdata->setPosition(1, make_scalar3(1.0, 0.1, 0.0)*scale);
+    pdata->setPosition(2, make_scalar3(-0.2, 1.1, 0.1)*scale);
+    pdata->setPosition(3, make_scalar3(0.4, 0.5, 0.9)*scale);
+    pdata->setPosition(4, make_scalar3(1.1, 1.2, -0.3)*scale);
+    pdata->setPosition(5, make_scalar3(-0.9, -0.4, 0.6)*scale);
+    pdata->setFlags(PDataFlags().set(pdata_flag::pressure_tensor));
+    return sysdef;
+    }
+
+//! Compare the forces, energies and virials with reference values
+void check_reference(std::shared_ptr<ForceCompute> fc, const Scalar4 *ref_force, const Scalar *ref_virial_xx)
+    {
+    ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < 6; i++)
+        {
+        MY_CHECK_CLOSE(h_force.data[i].x, ref_force[i].x, tol);
+        MY_CHECK_CLOSE(h_force.data[i].y, ref_force[i].y, tol);
+        MY_CHECK_CLOSE(h_force.data[i].z, ref_force[i].z, tol);
+        MY_CHECK_CLOSE(h_force.data[i].w, ref_force[i].w, tol);
+        MY_CHECK_CLOSE(h_virial.data[i], ref_virial_xx[i], tol);
+        }
+    }
+
+//! Compare the Tersoff forces of a small cluster with reference values
+UP_TEST( tersoff_force_reference )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = create_cluster(exec_conf, Scalar(1.4));
+    auto tersoff = create_triplet<EvaluatorTersoff>(sysdef, test_tersoff_params(), Scalar(2.0));
+    tersoff->compute(0);
+
+    // reference forces (x,y,z) and energies (w)
+    const Scalar4 ref_force[6] = {
+        make_scalar4(-6.989271131, -9.552696113, -10.4499558, 6.705794351),
+        make_scalar4(13.45162026, -7.680879457, -3.483936474, 4.941872301),
+        make_scalar4(-16.37130586, 9.57256589, -0.087243214, 2.90407366),
+        make_scalar4(2.626691532, 2.600966912, 15.99453593, 4.270266316),
+        make_scalar4(12.3599681, 7.311079291, -5.367553658, 1.422024939),
+        make_scalar4(-5.077702897, -2.251036523, 3.394153216, 1.266417875)};
+    const Scalar ref_virial_xx[6] = {11.57935399, 8.886463663, 9.814709555, 3.629117832, 7.945716343, 3.193393794};
+    check_reference(tersoff, ref_force, ref_virial_xx);
+    }
+
+//! Compare the RevCross forces of a small cluster with reference values
+UP_TEST( revcross_force_reference )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    auto sysdef = create_cluster(exec_conf, Scalar(1.0));
+    auto revcross = create_triplet<EvaluatorRevCross>(sysdef, test_revcross_params(), Scalar(1.5));
+    revcross->compute(0);
+
+    // reference forces (x,y,z) and energies (w)
+    const Scalar4 ref_force[6] = {
+        make_scalar4(-18.52287346, -1.121680471, -3.404156807, -1.540713909),
+        make_scalar4(24.8522727, -2.815580916, -4.346509137, -1.039767048),
+        make_scalar4(-9.813156155, 3.207852266, -3.001279911, -1.241511483),
+        make_scalar4(0.7155841336, -0.857776133, 10.97044781, -1.462628915),
+        make_scalar4(6.389670201, 3.196739664, -2.632833567, -0.7564174314),
+        make_scalar4(-3.621497421, -1.60955441, 2.414331614, -0.4887664787)};
+    const Scalar ref_virial_xx[6] = {14.66661584, 11.90280236, 6.616951948, 2.372915145, 2.295458298, -0.4656211041};
+    check_reference(revcross, ref_force, ref_virial_xx);
+    }
+
+//! Check that the threaded computation agrees with a single thread on a larger system
+template<class evaluator>
+void triplet_threads_test(const typename evaluator::param_type& params, Scalar r_cut, Scalar spacing)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    const unsigned int n = 8;
+    const unsigned int N = n*n*n;
+    auto sysdef = std::make_shared<SystemDefinition>(N, BoxDim(n*spacing), 1, 0, 0, 0, 0, exec_conf);
+    auto pdata = sysdef->getParticleData();
+    pdata->setFlags(PDataFlags().set(pdata_flag::pressure_tensor));
+
+    // a jittered cubic lattice
+        {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<Scalar> u(-0.1*spacing, 0.1*spacing);
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        Scalar lo = -Scalar(0.5)*n*spacing + Scalar(0.5)*spacing;
+        for (unsigned int i = 0; i < N; i++)
+            {
+            h_pos.data[i] = make_scalar4(lo + spacing*(i % n) + u(rng),
+                                         lo + spacing*((i / n) % n) + u(rng),
+                                         lo + spacing*(i / (n*n)) + u(rng),
+                                         __int_as_scalar(0));
+            }
+        }
+
+    compare_threads(exec_conf, [&]()
+        {
+        auto triplet = create_triplet<evaluator>(sysdef, params, r_cut);
+        triplet->compute(0);
+
+        // every triplet has no net force, so a lost update in the scatter to j and k would leave one
+        vec3<Scalar> net_force;
+            {
+            ArrayHandle<Scalar4> h_force(triplet->getForceArray(), access_location::host, access_mode::read);
+            for (unsigned int i = 0; i < N; i++)
+                net_force += vec3<Scalar>(h_force.data[i]);
+            }
+        MY_CHECK_SMALL(net_force.x, tol_small);
+        MY_CHECK_SMALL(net_force.y, tol_small);
+        MY_CHECK_SMALL(net_force.z, tol_small);
+
+        std::vector<Scalar> result;
+        append_force_arrays(result, triplet, N);
+        return result;
+        });
+    }
+
+//! Tersoff with four threads against one thread
+UP_TEST( tersoff_force_threads )
+    {
+    triplet_threads_test<EvaluatorTersoff>(test_tersoff_params(), Scalar(2.0), Scalar(1.4));
+    }
+
+//! RevCross with four threads against one thread
+UP_TEST( revcross_force_threads )
+    {
+    triplet_threads_test<EvaluatorRevCross>(test_revcross_params(), Scalar(1.5), Scalar(1.0));
+    }
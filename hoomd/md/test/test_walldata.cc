@@ -13,6 +13,8 @@ HOOMD_UP_MAIN();
 
 
 #include "hoomd/md/WallData.h"
+#include "hoomd/md/EvaluatorWalls.h"
+#include "hoomd/md/EvaluatorPairLJ.h"
 
 #include <memory>
 #include <cstdlib>
@@ -275,3 +277,138 @@ UP_TEST( plane_wall_math )
     MY_CHECK_SMALL(vx.z, tol_small);
     MY_CHECK_SMALL(dx, tol_small);
     }
+
+//! Many walls of each geometry, well beyond the old fixed limits
+wall_type make_many_walls()
+    {
+    wall_type w;
+    w.numSpheres = 50;
+    w.numCylinders = 50;
+    w.numPlanes = 100;
+    w.Spheres = ManagedArray<SphereWall>(w.numSpheres, false);
+    w.Cylinders = ManagedArray<CylinderWall>(w.numCylinders, false);
+    w.Planes = ManagedArray<PlaneWall>(w.numPlanes, false);
+    for (unsigned int k = 0; k < w.numSpheres; ++k)
+        w.Spheres[k] = SphereWall(1.0+0.1*k, make_scalar3(-8.0+0.3*k, 2.0, -1.0), k % 2);
+    for (unsigned int k = 0; k < w.numCylinders; ++k)
+        w.Cylinders[k] = CylinderWall(0.5+0.05*k, make_scalar3(0.0, -9.0+0.35*k, 3.0), make_scalar3(1.0, 0.2*k, 0.1), true);
+    for (unsigned int k = 0; k < w.numPlanes; ++k)
+        w.Planes[k] = PlaneWall(make_scalar3(-10.0+0.2*k, 0.0, 0.0), make_scalar3(1.0, 0.01*k, 0.0), true);
+    return w;
+    }
+
+UP_TEST( wall_cell_index )
+    {
+    wall_type w = make_many_walls();
+    BoxDim box(20.0, 0.1, 0.2, 0.0);
+    Scalar r_cull = 1.5;
+    buildWallCellIndex(w, box, r_cull, false);
+
+    UP_ASSERT(w.cell_indexer.getNumElements() > 1);
+    CHECK_EQUAL_UINT(w.cell_indexer.getW(), 13);
+
+    // every wall in range of a point must be listed in the point's cell
+    unsigned int n_walls = w.numSpheres + w.numCylinders + w.numPlanes;
+    unsigned int n_listed = 0;
+    for (unsigned int i = 0; i < 1000; ++i)
+        {
+        Scalar3 f = make_scalar3(Scalar((i*37) % 1000)/Scalar(1000.0),
+                                 Scalar((i*91) % 1000)/Scalar(1000.0),
+                                 Scalar((i*53) % 1000)/Scalar(1000.0));
+        vec3<Scalar> x(box.makeCoordinates(f));
+
+        unsigned int cell = w.cell_indexer((unsigned int)(f.x*w.cell_indexer.getW()),
+                                           (unsigned int)(f.y*w.cell_indexer.getH()),
+                                           (unsigned int)(f.z*w.cell_indexer.getD()));
+        std::vector<bool> listed(n_walls, false);
+        for (unsigned int cur = w.cell_head[cell]; cur < w.cell_head[cell+1]; ++cur)
+            {
+            // walls are sorted within a cell
+            if (cur > w.cell_head[cell])
+                UP_ASSERT(w.cell_walls[cur-1] < w.cell_walls[cur]);
+            listed[w.cell_walls[cur]] = true;
+            }
+        n_listed += w.cell_head[cell+1] - w.cell_head[cell];
+
+        for (unsigned int k = 0; k < w.numSpheres; ++k)
+            if (std::abs(distWall(w.Spheres[k], x)) < r_cull)
+                UP_ASSERT(listed[k]);
+        for (unsigned int k = 0; k < w.numCylinders; ++k)
+            if (std::abs(distWall(w.Cylinders[k], x)) < r_cull)
+                UP_ASSERT(listed[w.numSpheres + k]);
+        for (unsigned int k = 0; k < w.numPlanes; ++k)
+            if (std::abs(distWall(w.Planes[k], x)) < r_cull)
+                UP_ASSERT(listed[w.numSpheres + w.numCylinders + k]);
+        }
+
+    // the culling removes most of the walls
+    UP_ASSERT(n_listed < 1000*n_walls/2);
+
+    // a negative culling distance disables the index
+    buildWallCellIndex(w, box, -1.0, false);
+    CHECK_EQUAL_UINT(w.cell_indexer.getNumElements(), 0);
+    }
+
+//! Compare the LJ wall forces and energies with culling against those without culling
+/*! \param culled Walls with a cell index
+    \param box Box to place the particles in
+    \returns The number of particles that interact with a wall
+*/
+unsigned int check_culled_walls(const wall_type& culled, const BoxDim& box)
+    {
+    typedef EvaluatorWalls<EvaluatorPairLJ> Walls;
+    Walls::param_type params = make_wall_params<EvaluatorPairLJ>(EvaluatorPairLJ::param_type(1.0, 1.0),
+                                                                  Scalar(1.5*1.5), Scalar(0.0));
+
+    wall_type all = culled;
+    buildWallCellIndex(all, box, -1.0, false);
+    UP_ASSERT(culled.cell_indexer.getNumElements() > 1);
+
+    unsigned int n_interacting = 0;
+    for (unsigned int i = 0; i < 1000; ++i)
+        {
+        Scalar3 frac = make_scalar3(Scalar((i*37) % 1000 + 0.5)/Scalar(1000.0),
+                                    Scalar((i*91) % 1000 + 0.5)/Scalar(1000.0),
+                                    Scalar((i*53) % 1000 + 0.5)/Scalar(1000.0));
+        Scalar3 pos = box.makeCoordinates(frac);
+
+        Scalar3 F_ref, F;
+        Scalar energy_ref, energy;
+        Scalar virial_ref[6], virial[6];
+        Walls(pos, box, params, all).evalForceEnergyAndVirial(F_ref, energy_ref, virial_ref);
+        Walls(pos, box, params, culled).evalForceEnergyAndVirial(F, energy, virial);
+
+        MY_CHECK_SMALL(F.x - F_ref.x, tol_small);
+        MY_CHECK_SMALL(F.y - F_ref.y, tol_small);
+        MY_CHECK_SMALL(F.z - F_ref.z, tol_small);
+        MY_CHECK_SMALL(energy - energy_ref, tol_small);
+        if (energy_ref != Scalar(0.0))
+            n_interacting++;
+        }
+    return n_interacting;
+    }
+
+UP_TEST( wall_cell_forces )
+    {
+    wall_type w = make_many_walls();
+    BoxDim box(20.0, 0.1, 0.2, 0.0);
+    typedef EvaluatorWalls<EvaluatorPairLJ> Walls;
+    Walls::param_type params = make_wall_params<EvaluatorPairLJ>(EvaluatorPairLJ::param_type(1.0, 1.0),
+                                                                  Scalar(1.5*1.5), Scalar(0.0));
+    updateExternalField<Walls>(w, box, &params, 1, Scalar(0.0), false, true);
+    UP_ASSERT(check_culled_walls(w, box) > 100);
+
+    // the cells built for the first box remain valid in a slightly larger box
+    BoxDim box_scaled(20.0*1.002, 0.1, 0.2, 0.0);
+    UP_ASSERT(wallCellsValid(w, box_scaled));
+    updateExternalField<Walls>(w, box_scaled, &params, 1, Scalar(0.0), false, false);
+    UP_ASSERT(w.cell_box == box);
+    UP_ASSERT(check_culled_walls(w, box_scaled) > 100);
+
+    // and they are rebuilt when the box has changed too much
+    BoxDim box_large(20.0*1.05, 0.1, 0.2, 0.0);
+    UP_ASSERT(!wallCellsValid(w, box_large));
+    updateExternalField<Walls>(w, box_large, &params, 1, Scalar(0.0), false, false);
+    UP_ASSERT(w.cell_box == box_large);
+    UP_ASSERT(check_culled_walls(w, box_large) > 100);
+    }
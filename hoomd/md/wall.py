@@ -41,8 +41,10 @@ class group(object):
     All wall forces use a wall group as an input so it is necessary to create a
     wall group object before any wall force can be created. Modifications
     of the created wall group may occur at any time before ```hoomd.run```
-    is invoked. Current supported geometries are spheres, cylinder, and planes. The
-    maximum number of each type of wall is 20, 20, and 60 respectively.
+    is invoked. Current supported geometries are spheres, cylinder, and planes. There
+    is no limit on the number of walls of each type. Each particle only evaluates the
+    walls within the largest non-extrapolated cutoff of its position, so the cost scales
+    with the number of nearby walls.
 
     The **inside** parameter used in each wall geometry is used to specify the
     half-space that is to be used for the force implementation. See
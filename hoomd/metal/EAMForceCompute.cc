@@ -12,6 +12,11 @@ using namespace std;
 
 #include <stdexcept>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 namespace py = pybind11;
 
 /*! \file EAMForceCompute.cc
@@ -237,6 +242,19 @@ void EAMForceCompute::loadFile(char *filename, int type_of_file)
     interpolation(nr * m_ntypes * m_ntypes, nr, dr, &h_rho, &h_drho);
     interpolation((int) (0.5 * nr * (m_ntypes + 1) * m_ntypes), nr, dr, &h_rphi, &h_drphi);
 
+    // interleave values and derivatives for the CPU code path
+    auto interleave = [](std::vector<EAMSplineKnot>& knots, unsigned int n, const Scalar4 *f, const Scalar4 *df)
+        {
+        knots.resize(n);
+        for (unsigned int m = 0; m < n; m++)
+            {
+            knots[m].v = f[m];
+            knots[m].dv = df[m];
+            }
+        };
+    interleave(m_F_knots, nrho * m_ntypes, h_F.data, h_dF.data);
+    interleave(m_rho_knots, nr * m_ntypes * m_ntypes, h_rho.data, h_drho.data);
+    interleave(m_rphi_knots, (unsigned int) (0.5 * nr * (m_ntypes + 1) * m_ntypes), h_rphi.data, h_drphi.data);
     }
 
 /*! compute cubic interpolation coefficients
@@ -336,30 +354,17 @@ void EAMForceCompute::computeForces(unsigned int timestep)
     unsigned int virial_pitch = m_virial.getPitch();
 
     // access potential table
-    ArrayHandle<Scalar4> h_F(m_F, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_dF(m_dF, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_rho(m_rho, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_drho(m_drho, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_rphi(m_rphi, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_drphi(m_drphi, access_location::host, access_mode::read);
-
-    // index and remainder
-    Scalar position;  // look up position, scalar
-    unsigned int int_position;  // look up index for position, integer
-    unsigned int idxs; // look up index in F, rho, rphi array, considering shift, integer
-    Scalar remainder;  // look up remainder in array, integer
-    Scalar4 v, dv;  // value, d(value)
+    const EAMSplineKnot *h_F = m_F_knots.data();
+    const EAMSplineKnot *h_rho = m_rho_knots.data();
+    const EAMSplineKnot *h_rphi = m_rphi_knots.data();
 
     // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
     assert(h_virial.data);
     assert(h_pos.data);
-    assert(h_F.data);
-    assert(h_dF.data);
-    assert(h_rho.data);
-    assert(h_drho.data);
-    assert(h_rphi.data);
-    assert(h_drphi.data);
+    assert(h_F);
+    assert(h_rho);
+    assert(h_rphi);
 
     // Zero data for force calculation.
     memset((void *) h_force.data, 0, sizeof(Scalar4) * m_force.getNumElements());
@@ -371,19 +376,21 @@ void EAMForceCompute::computeForces(unsigned int timestep)
     // create a temporary copy of r_cut squared
     Scalar r_cut_sq = m_r_cut * m_r_cut;
 
-    // sum up the number of forces calculated
-    int64_t n_calc = 0;
-
     // parameters for each particle
-    vector<Scalar> atomElectronDensity;
-    atomElectronDensity.resize(m_pdata->getN());
-    vector<Scalar> atomDerivativeEmbeddingFunction;
-    atomDerivativeEmbeddingFunction.resize(m_pdata->getN());
-    vector<Scalar> atomEmbeddingFunction;
-    atomEmbeddingFunction.resize(m_pdata->getN());
+    unsigned int N = m_pdata->getN();
+    m_density.assign(N, Scalar(0.0));
+    m_embed_deriv.resize(N);
+    Scalar *atomElectronDensity = m_density.data();
+    Scalar *atomDerivativeEmbeddingFunction = m_embed_deriv.data();
     unsigned int ntypes = m_pdata->getNTypes();
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    // displacements are computed once and reused in the force pass
+    if (m_pair_dr.size() < m_nlist->getNListArray().getNumElements())
+        m_pair_dr.resize(m_nlist->getNListArray().getNumElements());
+    Scalar4 *pair_dr = m_pair_dr.data();
+
+    // electron density of particle i, contributions to the neighbors of a half list go to density_k
+    auto compute_density = [&](unsigned int i, Scalar *density_k)
         {
         // access the particle's position and type
         Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
@@ -393,14 +400,13 @@ void EAMForceCompute::computeForces(unsigned int timestep)
         // sanity check
         assert(typei < m_pdata->getNTypes());
 
+        Scalar density_i(0.0);
+
         // loop over all of the neighbors of this particle
         const unsigned int size = (unsigned int) h_n_neigh.data[i];
 
         for (unsigned int j = 0; j < size; j++)
             {
-            // increment our calculation counter
-            n_calc++;
-
             // access the index of this neighbor
             unsigned int k = h_nlist.data[head_i + j];
             // sanity check
@@ -418,59 +424,63 @@ void EAMForceCompute::computeForces(unsigned int timestep)
             // apply periodic boundary conditions
             dx = box.minImage(dx);
 
-            // start computing the force
             // calculate r squared
             Scalar rsq = dot(dx, dx);
-            ;
-            // only compute the force if the particles are closer than the cut-off
-            if (rsq < r_cut_sq)
+
+            // only compute the density if the particles are closer than the cut-off
+            if (rsq >= r_cut_sq)
+                {
+                pair_dr[head_i + j] = make_scalar4(dx.x, dx.y, dx.z, Scalar(-1.0));
+                continue;
+                }
+
+            Scalar r = sqrt(rsq);
+            pair_dr[head_i + j] = make_scalar4(dx.x, dx.y, dx.z, r);
+
+            // calculate position r for rho(r)
+            Scalar position = r * rdr;
+            unsigned int int_position = (unsigned int) position;
+            int_position = min(int_position, nr - 1);
+            Scalar remainder = position - int_position;
+            // calculate P = sum{rho}
+            Scalar4 v = h_rho[int_position + nr * (typej * ntypes + typei)].v;
+            density_i += v.w + v.z * remainder + v.y * remainder * remainder
+                    + v.x * remainder * remainder * remainder;
+            // if third_law, pair it
+            if (third_law)
                 {
-                // calculate position r for rho(r)
-                position = sqrt(rsq) * rdr;
-                int_position = (unsigned int) position;
-                int_position = min(int_position, nr - 1);
-                remainder = position - int_position;
-                // calculate P = sum{rho}
-                idxs = int_position + nr * (typej * ntypes + typei);
-                v = h_rho.data[idxs];
-                atomElectronDensity[i] += v.w + v.z * remainder + v.y * remainder * remainder
+                v = h_rho[int_position + nr * (typei * ntypes + typej)].v;
+                density_k[k] += v.w + v.z * remainder + v.y * remainder * remainder
                         + v.x * remainder * remainder * remainder;
-                // if third_law, pair it
-                if (third_law)
-                    {
-                    idxs = int_position + nr * (typei * ntypes + typej);
-                    v = h_rho.data[idxs];
-                    atomElectronDensity[k] += v.w + v.z * remainder + v.y * remainder * remainder
-                            + v.x * remainder * remainder * remainder;
-                    }
                 }
             }
-        }
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        atomElectronDensity[i] += density_i;
+        };
+
+    // embedding function F(P) of particle i and its derivative
+    auto compute_embedding = [&](unsigned int i)
         {
         unsigned int typei = __scalar_as_int(h_pos.data[i].w);
         // calculate position rho for F(rho)
-        position = atomElectronDensity[i] * rdrho;
-        int_position = (unsigned int) position;
+        Scalar position = atomElectronDensity[i] * rdrho;
+        unsigned int int_position = (unsigned int) position;
         int_position = min(int_position, nrho - 1);
-        remainder = position - int_position;
+        Scalar remainder = position - int_position;
 
-        idxs = int_position + typei * nrho;
-        v = h_F.data[idxs];
-        dv = h_dF.data[idxs];
+        const EAMSplineKnot& knot = h_F[int_position + typei * nrho];
+        Scalar4 v = knot.v;
+        Scalar4 dv = knot.dv;
         // compute dF / dP
         atomDerivativeEmbeddingFunction[i] = dv.z + dv.y * remainder + dv.x * remainder * remainder;
         // compute embedded energy F(P), sum up each particle
         h_force.data[i].w += v.w + v.z * remainder + v.y * remainder * remainder
                 + v.x * remainder * remainder * remainder;
+        };
 
-        }
-
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    // force on particle i, reactions on the neighbors of a half list go to force_k
+    auto compute_force = [&](unsigned int i, Scalar4 *force_k)
         {
-        // access the particle's position and type
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
         unsigned int typei = __scalar_as_int(h_pos.data[i].w);
         const unsigned int head_i = h_head_list.data[i];
         // sanity check
@@ -489,60 +499,44 @@ void EAMForceCompute::computeForces(unsigned int timestep)
         const unsigned int size = (unsigned int) h_n_neigh.data[i];
         for (unsigned int j = 0; j < size; j++)
             {
-            // increment our calculation counter
-            n_calc++;
+            // distance computed in the density pass, negative beyond the cut-off
+            Scalar4 dr_j = pair_dr[head_i + j];
+            Scalar r = dr_j.w;
+            if (r < Scalar(0.0))
+                continue;
+            Scalar3 dx = make_scalar3(dr_j.x, dr_j.y, dr_j.z);
 
-            // access the index of this neighbor
+            // access the index and type of this neighbor
             unsigned int k = h_nlist.data[head_i + j];
-            // sanity check
-            assert(k < m_pdata->getN());
-
-            // calculate \Delta r
-            Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
-            Scalar3 dx = pi - pk;
-
-            // access the type of the neighbor particle
             unsigned int typej = __scalar_as_int(h_pos.data[k].w);
             // sanity check
             assert(typej < m_pdata->getNTypes());
 
-            // apply periodic boundary conditions
-            dx = box.minImage(dx);
-
-            // start computing the force
-            // calculate r squared
-            Scalar rsq = dot(dx, dx);
-
             // calculate position r for phi(r)
-            if (rsq >= r_cut_sq)
-                continue;
-            Scalar r = sqrt(rsq);
             Scalar inverseR = 1.0 / r;
-            position = r * rdr;
-            int_position = (unsigned int) position;
+            Scalar position = r * rdr;
+            unsigned int int_position = (unsigned int) position;
             int_position = min(int_position, nr - 1);
-            remainder = position - int_position;
+            Scalar remainder = position - int_position;
             // calculate the shift position for type ij
             int shift =
                     (typei >= typej) ?
                             (int) (0.5 * (2 * ntypes - typej - 1) * typej + typei) * nr :
                             (int) (0.5 * (2 * ntypes - typei - 1) * typei + typej) * nr;
 
-            idxs = int_position + shift;
-            v = h_rphi.data[idxs];
-            dv = h_drphi.data[idxs];
+            const EAMSplineKnot& knot = h_rphi[int_position + shift];
+            Scalar4 v = knot.v;
+            Scalar4 dv = knot.dv;
             // pair_eng = phi
             Scalar pair_eng = (v.w + v.z * remainder + v.y * remainder * remainder
                     + v.x * remainder * remainder * remainder) * inverseR;
             // derivativePhi = (phi + r * dphi/dr - phi) * 1/r = dphi / dr
             Scalar derivativePhi = (dv.z + dv.y * remainder + dv.x * remainder * remainder - pair_eng) * inverseR;
             // derivativeRhoI = drho / dr of i
-            idxs = int_position + typei * ntypes * nr + typej * nr;
-            dv = h_drho.data[idxs];
+            dv = h_rho[int_position + typei * ntypes * nr + typej * nr].dv;
             Scalar derivativeRhoI = dv.z + dv.y * remainder + dv.x * remainder * remainder;
             // derivativeRhoJ = drho / dr of j
-            idxs = int_position + typej * ntypes * nr + typei * nr;
-            dv = h_drho.data[idxs];
+            dv = h_rho[int_position + typej * ntypes * nr + typei * nr].dv;
             Scalar derivativeRhoJ = dv.z + dv.y * remainder + dv.x * remainder * remainder;
             // fullDerivativePhi = dF/dP * drho / dr for j + dF/dP * drho / dr for j + phi
             Scalar fullDerivativePhi = atomDerivativeEmbeddingFunction[i] * derivativeRhoJ
@@ -562,10 +556,10 @@ void EAMForceCompute::computeForces(unsigned int timestep)
 
             if (third_law)
                 {
-                h_force.data[k].x -= dx.x * pairForce;
-                h_force.data[k].y -= dx.y * pairForce;
-                h_force.data[k].z -= dx.z * pairForce;
-                h_force.data[k].w += pair_eng * 0.5;
+                force_k[k].x -= dx.x * pairForce;
+                force_k[k].y -= dx.y * pairForce;
+                force_k[k].z -= dx.z * pairForce;
+                force_k[k].w += pair_eng * 0.5;
                 }
             }
         h_force.data[i].x += fxi;
@@ -574,16 +568,110 @@ void EAMForceCompute::computeForces(unsigned int timestep)
         h_force.data[i].w += pei;
         for (int k = 0; k < 6; k++)
             h_virial.data[k * virial_pitch + i] += viriali[k];
-        }
+        };
 
-    int64_t flops = m_pdata->getN() * 5 + n_calc * (3 + 5 + 9 + 1 + 9 + 6 + 8);
+    #ifdef ENABLE_TBB
     if (third_law)
-        flops += n_calc * 8;
-    int64_t mem_transfer = m_pdata->getN() * (5 + 4 + 10) * sizeof(Scalar) + n_calc * (1 + 3 + 1) * sizeof(Scalar);
+        {
+        // contributions to neighbors are accumulated per thread
+        m_density_thread.reset(N);
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            Scalar *local_density = m_density_thread.local();
+            for (unsigned int i = range.begin(); i != range.end(); ++i)
+                compute_density(i, local_density);
+            });
+
+        // the density is complete once the per-thread contributions are summed up
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            for (unsigned int i = range.begin(); i != range.end(); ++i)
+                {
+                for (const auto& local_density : m_density_thread)
+                    atomElectronDensity[i] += local_density[i];
+                compute_embedding(i);
+                }
+            });
+
+        m_force_thread.reset(N);
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            Scalar4 *local_force = m_force_thread.local();
+            for (unsigned int i = range.begin(); i != range.end(); ++i)
+                compute_force(i, local_force);
+            });
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            for (unsigned int i = range.begin(); i != range.end(); ++i)
+                {
+                for (const auto& local_force : m_force_thread)
+                    {
+                    h_force.data[i].x += local_force[i].x;
+                    h_force.data[i].y += local_force[i].y;
+                    h_force.data[i].z += local_force[i].z;
+                    h_force.data[i].w += local_force[i].w;
+                    }
+                }
+            });
+        }
+    else
+        {
+        // with a full neighbor list, the density of i is complete after its own neighbors
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            for (unsigned int i = range.begin(); i != range.end(); ++i)
+                {
+                compute_density(i, atomElectronDensity);
+                compute_embedding(i);
+                }
+            });
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range)
+            {
+            for (unsigned int i = range.begin(); i != range.end(); ++i)
+                compute_force(i, h_force.data);
+            });
+        }
+    #else
+    for (unsigned int i = 0; i < N; i++)
+        {
+        compute_density(i, atomElectronDensity);
+        if (!third_law)
+            compute_embedding(i);
+        }
+
     if (third_law)
-        mem_transfer += n_calc * 10 * sizeof(Scalar);
+        {
+        for (unsigned int i = 0; i < N; i++)
+            compute_embedding(i);
+        }
+
+    for (unsigned int i = 0; i < N; i++)
+        compute_force(i, h_force.data);
+    #endif
+
     if (m_prof)
+        {
+        // sum up the number of forces calculated
+        int64_t n_calc = 0;
+        for (unsigned int i = 0; i < N; i++)
+            n_calc += 2 * h_n_neigh.data[i];
+
+        int64_t flops = m_pdata->getN() * 5 + n_calc * (3 + 5 + 9 + 1 + 9 + 6 + 8);
+        if (third_law)
+            flops += n_calc * 8;
+        int64_t mem_transfer = m_pdata->getN() * (5 + 4 + 10) * sizeof(Scalar) + n_calc * (1 + 3 + 1) * sizeof(Scalar);
+        if (third_law)
+            mem_transfer += n_calc * 10 * sizeof(Scalar);
         m_prof->pop(flops, mem_transfer);
+        }
     }
 
 void EAMForceCompute::set_neighbor_list(std::shared_ptr<NeighborList> nlist)
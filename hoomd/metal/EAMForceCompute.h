@@ -5,9 +5,11 @@
 // Previous Maintainer: Morozov
 
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ThreadLocalArray.h"
 #include "hoomd/md/NeighborList.h"
 
 #include <memory>
+#include <vector>
 
 /*! \file EAMForceCompute.h
  \brief Declares the EAMForceCompute class
@@ -22,6 +24,13 @@
 #ifndef __EAMFORCECOMPUTE_H__
 #define __EAMFORCECOMPUTE_H__
 
+//! Interpolation coefficients of a tabulated function and of its derivative at one data point
+struct EAMSplineKnot
+    {
+    Scalar4 v;   //!< value (w) and its interpolation coefficients (z, y, x)
+    Scalar4 dv;  //!< interpolation coefficients (z, y, x) of the derivative
+    };
+
 //! Computes the potential and force on each particle based on values given in a EAM potential
 /*! \b Overview
  The total potential and force is computed for each particle when compute() is called. Potentials and
@@ -42,6 +51,15 @@
  h_dF.data[100].z, h_dF.data[100].y, h_dF.data[100].x, are for interpolating derivative embedded
  function.
 
+ The CPU code path reads the same coefficients from three interleaved tables of EAMSplineKnot (m_F_knots,
+ m_rho_knots, m_rphi_knots), where the value and the derivative coefficients of a data point are adjacent in memory.
+
+ \b Threading
+ With TBB, all three stages run in parallel over particles. The first stage stores the displacement and distance of
+ every neighbor within the cut-off, which the force stage reuses. With a full neighbor list the embedding function
+ is evaluated in the same pass as the electron density. With a half neighbor list, contributions to neighbors are
+ accumulated in per-thread buffers of size N and summed up afterwards.
+
  \ingroup computes
  */
 class EAMForceCompute: public ForceCompute
@@ -93,6 +111,19 @@ protected:
     GPUArray<Scalar4> m_drphi;             //!< derivative pair wise function and its coefficients
     GPUArray<Scalar> m_dFdP;               //!< derivative F / derivative P
 
+    std::vector<EAMSplineKnot> m_F_knots;    //!< interleaved embedded function table for the CPU
+    std::vector<EAMSplineKnot> m_rho_knots;  //!< interleaved electron density table for the CPU
+    std::vector<EAMSplineKnot> m_rphi_knots; //!< interleaved pair wise function table for the CPU
+
+    std::vector<Scalar4> m_pair_dr;          //!< displacement (x,y,z) and distance (w, negative if beyond r_cut) per neighbor list entry
+    std::vector<Scalar> m_density;           //!< electron density per particle
+    std::vector<Scalar> m_embed_deriv;       //!< dF / dP per particle
+
+    #ifdef ENABLE_TBB
+    ThreadLocalArray<Scalar> m_density_thread;  //!< per-thread density contributions to neighbors (half list)
+    ThreadLocalArray<Scalar4> m_force_thread;   //!< per-thread force contributions to neighbors (half list)
+    #endif
+
     //! Actually compute the forces
     virtual void computeForces(unsigned int timestep);
 
@@ -0,0 +1,186 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <random>
+
+#include "hoomd/metal/EAMForceCompute.h"
+#include "hoomd/md/NeighborListTree.h"
+
+using namespace std;
+
+#include "hoomd/test/upp11_config.h"
+#include "hoomd/test/thread_compare.h"
+
+HOOMD_UP_MAIN();
+
+/*! \file test_eam_force.cc
+    \brief Implements unit tests for EAMForceCompute
+    \ingroup unit_tests
+*/
+
+//! Write an EAM/Alloy file for the types A and B with analytic functions
+/*! The embedding functions are -sqrt(rho) and -1.5 sqrt(rho) + 0.1 rho, the electron densities decay exponentially
+    and the pair potentials are Morse potentials.
+*/
+void write_eam_file(const std::string& filename)
+    {
+    const unsigned int nrho = 500, nr = 500;
+    const double drho = 0.01, dr = 0.01, r_cut = 4.5;
+
+    std::ofstream f(filename.c_str());
+    f << std::setprecision(12);
+    f << "test\ntest\ntest\n";
+    f << "2 A B\n";
+    f << nrho << " " << drho << " " << nr << " " << dr << " " << r_cut << "\n";
+
+    const double rho_scale[2] = {1.0, 0.8};
+    const double rho_decay[2] = {1.5, 1.2};
+    for (unsigned int t = 0; t < 2; t++)
+        {
+        f << "10 1.0 3.0 fcc\n";
+        for (unsigned int i = 0; i < nrho; i++)
+            {
+            double rho = i*drho;
+            f << (t == 0 ? -sqrt(rho) : -1.5*sqrt(rho) + 0.1*rho) << "\n";
+            }
+        for (unsigned int i = 0; i < nr; i++)
+            f << rho_scale[t]*exp(-rho_decay[t]*(i*dr - 1.0)) << "\n";
+        }
+
+    // r*phi(r) for AA, BA, BB
+    const double D[3] = {0.5, 0.4, 0.3};
+    for (unsigned int p = 0; p < 3; p++)
+        {
+        for (unsigned int i = 0; i < nr; i++)
+            {
+            double r = i*dr;
+            f << r*D[p]*(exp(-3.0*(r - 2.5)) - 2.0*exp(-1.5*(r - 2.5))) << "\n";
+            }
+        }
+    }
+
+//! Create an EAM force compute with a neighbor list in the given storage mode
+std::shared_ptr<EAMForceCompute> create_eam(std::shared_ptr<SystemDefinition> sysdef,
+                                            const std::string& filename,
+                                            NeighborList::storageMode mode)
+    {
+    std::vector<char> name(filename.begin(), filename.end());
+    name.push_back('\0');
+    auto eam = std::make_shared<EAMForceCompute>(sysdef, &name[0], 0);
+
+    auto nlist = std::make_shared<NeighborListTree>(sysdef, eam->get_r_cut(), Scalar(0.3));
+    auto r_cut = std::make_shared< GlobalArray<Scalar> >(nlist->getTypePairIndexer().getNumElements(),
+                                                          sysdef->getParticleData()->getExecConf());
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < r_cut->getNumElements(); i++)
+            h_r_cut.data[i] = eam->get_r_cut();
+        }
+    nlist->addRCutMatrix(r_cut);
+    nlist->setStorageMode(mode);
+    eam->set_neighbor_list(nlist);
+    return eam;
+    }
+
+//! Compare the forces, energies and virials of a small cluster with reference values
+UP_TEST( eam_force_reference )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    const std::string filename = "test_eam_force.eam.alloy";
+    write_eam_file(filename);
+
+    auto sysdef = std::make_shared<SystemDefinition>(5, BoxDim(20.0), 2, 0, 0, 0, 0, exec_conf);
+    auto pdata = sysdef->getParticleData();
+    pdata->setPosition(0, make_scalar3(0.0, 0.0, 0.0));
+    pdata->setPosition(1, make_scalar3(2.5, 0.0, 0.0));
+    pdata->setPosition(2, make_scalar3(0.0, 2.6, 0.0));
+    pdata->setPosition(3, make_scalar3(1.2, 1.3, 1.9));
+    pdata->setPosition(4, make_scalar3(-1.7, 0.4, -1.1));
+    pdata->setType(2, 1);
+    pdata->setType(4, 1);
+    pdata->setFlags(PDataFlags().set(pdata_flag::pressure_tensor));
+
+    // reference forces (x,y,z) and energies (w)
+    const Scalar4 ref_force[5] = {
+        make_scalar4(1.730887361, 0.3149997884, 1.114778184, -1.453974047),
+        make_scalar4(-0.785977128, 0.4376378227, 0.3193964917, -1.072646728),
+        make_scalar4(0.133661352, -1.173485523, 0.160534969, -1.330375473),
+        make_scalar4(-0.2270052263, -0.2299541132, -1.035891228, -1.266297802),
+        make_scalar4(-0.8515663587, 0.6508020255, -0.5588184167, -0.9687342094)};
+    // reference virial_xx with a half neighbor list, which assigns each pair to one particle
+    const Scalar ref_virial_xx[5] = {1.287413285, -1.171061496, -0.6891864159, -0.2168516547, 0.0};
+
+    for (auto mode : {NeighborList::half, NeighborList::full})
+        {
+        auto eam = create_eam(sysdef, filename, mode);
+        eam->compute(0);
+
+        ArrayHandle<Scalar4> h_force(eam->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial(eam->getVirialArray(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < 5; i++)
+            {
+            MY_CHECK_CLOSE(h_force.data[i].x, ref_force[i].x, tol);
+            MY_CHECK_CLOSE(h_force.data[i].y, ref_force[i].y, tol);
+            MY_CHECK_CLOSE(h_force.data[i].z, ref_force[i].z, tol);
+            MY_CHECK_CLOSE(h_force.data[i].w, ref_force[i].w, tol);
+            if (mode == NeighborList::half)
+                MY_CHECK_SMALL(h_virial.data[i] - ref_virial_xx[i], tol_small);
+            }
+        }
+
+    remove(filename.c_str());
+    }
+
+//! Check that the threaded code paths agree with a single thread on a larger system
+UP_TEST( eam_force_threads )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    const std::string filename = "test_eam_force_threads.eam.alloy";
+    write_eam_file(filename);
+
+    const unsigned int n = 8;
+    const unsigned int N = n*n*n;
+    auto sysdef = std::make_shared<SystemDefinition>(N, BoxDim(20.0), 2, 0, 0, 0, 0, exec_conf);
+    auto pdata = sysdef->getParticleData();
+    pdata->setFlags(PDataFlags().set(pdata_flag::pressure_tensor));
+
+    // a jittered cubic lattice
+        {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<Scalar> u(-0.2, 0.2);
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            h_pos.data[i] = make_scalar4(-8.75 + 2.5*(i % n) + u(rng),
+                                         -8.75 + 2.5*((i / n) % n) + u(rng),
+                                         -8.75 + 2.5*(i / (n*n)) + u(rng),
+                                         __int_as_scalar(i % 2));
+            }
+        }
+
+    for (auto mode : {NeighborList::half, NeighborList::full})
+        {
+        compare_threads(exec_conf, [&]()
+            {
+            auto eam = create_eam(sysdef, filename, mode);
+
+            // the per-thread density and derivative buffers are kept between computes, check them when reused
+            eam->compute(0);
+            eam->compute(1);
+
+            std::vector<Scalar> result;
+            append_force_arrays(result, eam, N);
+            return result;
+            });
+        }
+
+    remove(filename.c_str());
+    }
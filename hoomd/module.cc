@@ -30,6 +30,7 @@
 #include "LogPlainTXT.h"
 #include "LogMatrix.h"
 #include "LogHDF5.h"
+#include "LogBinary.h"
 #include "CallbackAnalyzer.h"
 #include "Updater.h"
 #include "PythonUpdater.h"
@@ -282,6 +283,7 @@ PYBIND11_MODULE(_hoomd, m)
     export_LogPlainTXT(m);
     export_LogMatrix(m);
     export_LogHDF5(m);
+    export_LogBinary(m);
     export_CallbackAnalyzer(m);
 
     // updaters
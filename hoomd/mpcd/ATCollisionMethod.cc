@@ -12,6 +12,11 @@
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 mpcd::ATCollisionMethod::ATCollisionMethod(std::shared_ptr<mpcd::SystemData> sysdata,
                                            unsigned int cur_timestep,
                                            unsigned int period,
@@ -64,7 +69,7 @@ void mpcd::ATCollisionMethod::drawVelocities(unsigned int timestep)
     {
     // mpcd particle data
     ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_alt_vel(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_alt_vel(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     unsigned int N_tot = N_mpcd;
 
@@ -83,15 +88,17 @@ void mpcd::ATCollisionMethod::drawVelocities(unsigned int timestep)
         }
 
     // random velocities are drawn for each particle and stored into the "alternate" arrays
+    // (the random stream is keyed on the particle tag, so the order of the draws does not matter)
     const Scalar T = (*m_T)(timestep);
-    for (unsigned int idx=0; idx < N_tot; ++idx)
+    const Scalar mpcd_mass = m_mpcd_pdata->getMass();
+    auto draw_particle = [&](unsigned int idx)
         {
         unsigned int pidx;
         unsigned int tag; Scalar mass;
         if (idx < N_mpcd)
             {
             pidx = idx;
-            mass = m_mpcd_pdata->getMass();
+            mass = mpcd_mass;
             tag = h_tag.data[idx];
             }
         else
@@ -111,20 +118,32 @@ void mpcd::ATCollisionMethod::drawVelocities(unsigned int timestep)
         // save out velocities
         if (idx < N_mpcd)
             {
-            h_alt_vel.data[pidx] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
+            h_alt_vel.data[pidx] = mpcd::make_storage_scalar4(vel.x, vel.y, vel.z, mpcd::int_as_storage(mpcd::detail::NO_CELL));
             }
         else
             {
             h_alt_vel_embed->data[pidx] = make_scalar4(vel.x, vel.y, vel.z, mass);
             }
-        }
+        };
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+            draw_particle(idx);
+        });
+    #else
+    for (unsigned int idx=0; idx < N_tot; ++idx)
+        draw_particle(idx);
+    #endif
     }
 
 void mpcd::ATCollisionMethod::applyVelocities()
     {
     // mpcd particle data
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::read);
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     unsigned int N_tot = N_mpcd;
 
@@ -145,16 +164,18 @@ void mpcd::ATCollisionMethod::applyVelocities()
     ArrayHandle<double4> h_cell_vel(m_thermo->getCellVelocities(), access_location::host, access_mode::read);
     ArrayHandle<double4> h_rand_vel(m_rand_thermo->getCellVelocities(), access_location::host, access_mode::read);
 
-    for (unsigned int idx=0; idx < N_tot; ++idx)
+    // each particle only reads its own cell averages and writes its own velocity
+    auto apply_particle = [&](unsigned int idx)
         {
         unsigned int cell, pidx;
         Scalar4 vel_rand;
         if (idx < N_mpcd)
             {
             pidx = idx;
-            const Scalar4 vel_cell = h_vel.data[idx];
-            cell = __scalar_as_int(vel_cell.w);
-            vel_rand = h_vel_alt.data[idx];
+            const mpcd::StorageScalar4 vel_cell = h_vel.data[idx];
+            cell = mpcd::storage_as_int(vel_cell.w);
+            const mpcd::StorageScalar4 vel_alt = h_vel_alt.data[idx];
+            vel_rand = make_scalar4(vel_alt.x, vel_alt.y, vel_alt.z, vel_alt.w);
             }
         else
             {
@@ -174,13 +195,25 @@ void mpcd::ATCollisionMethod::applyVelocities()
 
         if (idx < N_mpcd)
             {
-            h_vel.data[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, __int_as_scalar(cell));
+            h_vel.data[pidx] = mpcd::make_storage_scalar4(vnew.x, vnew.y, vnew.z, mpcd::int_as_storage(cell));
             }
         else
             {
             h_vel_embed->data[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, vel_rand.w);
             }
-        }
+        };
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+            apply_particle(idx);
+        });
+    #else
+    for (unsigned int idx=0; idx < N_tot; ++idx)
+        apply_particle(idx);
+    #endif
     }
 
 /*!
@@ -51,6 +51,17 @@ class PYBIND11_EXPORT ATCollisionMethod : public mpcd::CollisionMethod
         std::shared_ptr<mpcd::CellThermoCompute> m_rand_thermo; //!< Cell thermo for random velocities
         std::shared_ptr<::Variant> m_T; //!< Temperature for thermostat
 
+        //! Update the cell list for the collision
+        /*!
+         * The cell thermo is computed first so that the cell properties can be summed
+         * while the cell list is built.
+         */
+        virtual void computeCells(unsigned int timestep)
+            {
+            m_thermo->compute(timestep);
+            m_cl->compute(timestep);
+            }
+
         //! Implementation of the collision rule
         virtual void rule(unsigned int timestep);
 
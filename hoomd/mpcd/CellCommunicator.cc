@@ -51,6 +51,23 @@ mpcd::CellCommunicator::~CellCommunicator()
     m_cl->getSizeChangeSignal().disconnect<mpcd::CellCommunicator, &mpcd::CellCommunicator::slotInit>(this);
     }
 
+/*!
+ * \returns True if all sends and receives have completed (or no communication is occurring).
+ *
+ * Many MPI implementations only advance nonblocking messages during calls into the
+ * library. Calling this method periodically from the thread that called begin()
+ * lets the messages complete while other work is done, so that finalize() does
+ * not have to wait on the full transfer.
+ */
+bool mpcd::CellCommunicator::progress()
+    {
+    if (!m_communicating) return true;
+
+    int done = 0;
+    MPI_Testall(m_reqs.size(), m_reqs.data(), &done, MPI_STATUSES_IGNORE);
+    return done;
+    }
+
 namespace mpcd
 {
 namespace detail
@@ -70,6 +70,9 @@ class PYBIND11_EXPORT CellCommunicator
         template<typename T, class PackOpT>
         void finalize(const GPUArray<T>& props, const PackOpT op);
 
+        //! Progress communication of the grid without blocking
+        bool progress();
+
         //! Get the number of unique cells with communication
         unsigned int getNCells()
             {
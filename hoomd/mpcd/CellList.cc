@@ -19,7 +19,9 @@ mpcd::CellList::CellList(std::shared_ptr<SystemDefinition> sysdef,
                          std::shared_ptr<mpcd::ParticleData> mpcd_pdata)
         : Compute(sysdef), m_mpcd_pdata(mpcd_pdata),
           m_cell_size(1.0), m_cell_np_max(4), m_cell_np(m_exec_conf), m_cell_list(m_exec_conf),
-          m_embed_cell_ids(m_exec_conf), m_conditions(m_exec_conf), m_needs_compute_dim(true),
+          m_embed_cell_ids(m_exec_conf), m_conditions(m_exec_conf),
+          m_sums_requested(false), m_sums_energy(false), m_has_sums(false),
+          m_cell_momentum(m_exec_conf), m_cell_ke(m_exec_conf), m_needs_compute_dim(true),
           m_particles_sorted(false), m_virtual_change(false)
     {
     assert(m_mpcd_pdata);
@@ -60,6 +62,9 @@ void mpcd::CellList::compute(unsigned int timestep)
     {
     if (m_prof) m_prof->push(m_exec_conf, "MPCD cell list");
 
+    // sums are only valid for a build that happens during this call
+    m_has_sums = false;
+
     if (m_virtual_change)
         {
         m_virtual_change = false;
@@ -120,6 +125,7 @@ void mpcd::CellList::compute(unsigned int timestep)
         // signal to the ParticleData that the cell list cache is now valid
         m_mpcd_pdata->validateCellCache();
         }
+    m_sums_requested = false;
 
     if (m_prof) m_prof->pop(m_exec_conf);
     }
@@ -506,8 +512,8 @@ void mpcd::CellList::buildCellList()
 
     uint3 conditions = make_uint3(0,0,0);
 
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     unsigned int N_tot = N_mpcd;
 
@@ -534,18 +540,44 @@ void mpcd::CellList::buildCellList()
 
     const Scalar3 global_lo = m_pdata->getGlobalBox().getLo();
 
+    // optionally sum the cell properties in the same pass that bins the particles
+    const bool sum_props = m_sums_requested;
+    const bool sum_energy = m_sums_requested && m_sums_energy;
+    const Scalar mpcd_mass = m_mpcd_pdata->getMass();
+    std::unique_ptr< ArrayHandle<double4> > h_cell_momentum;
+    std::unique_ptr< ArrayHandle<double> > h_cell_ke;
+    std::unique_ptr< ArrayHandle<Scalar4> > h_vel_embed;
+    if (sum_props)
+        {
+        const unsigned int ncells = m_cell_indexer.getNumElements();
+        m_cell_momentum.resize(ncells);
+        h_cell_momentum.reset(new ArrayHandle<double4>(m_cell_momentum, access_location::host, access_mode::overwrite));
+        memset(h_cell_momentum->data, 0, sizeof(double4) * ncells);
+        if (sum_energy)
+            {
+            m_cell_ke.resize(ncells);
+            h_cell_ke.reset(new ArrayHandle<double>(m_cell_ke, access_location::host, access_mode::overwrite));
+            memset(h_cell_ke->data, 0, sizeof(double) * ncells);
+            }
+        if (m_embed_group)
+            {
+            h_vel_embed.reset(new ArrayHandle<Scalar4>(m_pdata->getVelocities(), access_location::host, access_mode::read));
+            }
+        }
+
     for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
         {
-        Scalar4 postype_i;
+        Scalar3 pos_i;
         if (cur_p < N_mpcd)
             {
-            postype_i = h_pos.data[cur_p];
+            const mpcd::StorageScalar4 postype_i = h_pos.data[cur_p];
+            pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
             }
         else
             {
-            postype_i = h_pos_embed->data[h_embed_member_idx->data[cur_p - N_mpcd]];
+            const Scalar4 postype_i = h_pos_embed->data[h_embed_member_idx->data[cur_p - N_mpcd]];
+            pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
             }
-        Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
 
         if (std::isnan(pos_i.x) || std::isnan(pos_i.y) || std::isnan(pos_i.z))
             {
@@ -613,7 +645,7 @@ void mpcd::CellList::buildCellList()
         // stash the current particle bin into the velocity array
         if (cur_p < N_mpcd)
             {
-            h_vel.data[cur_p].w = __int_as_scalar(bin_idx);
+            h_vel.data[cur_p].w = mpcd::int_as_storage(bin_idx);
             }
         else
             {
@@ -622,10 +654,41 @@ void mpcd::CellList::buildCellList()
 
         // increment the counter always
         ++h_cell_np.data[bin_idx];
+
+        // accumulate the momentum, mass, and kinetic energy of the cell
+        if (sum_props)
+            {
+            double3 vel_i;
+            double mass_i;
+            if (cur_p < N_mpcd)
+                {
+                const mpcd::StorageScalar4 vel_cell = h_vel.data[cur_p];
+                vel_i = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
+                mass_i = mpcd_mass;
+                }
+            else
+                {
+                const Scalar4 vel_m = h_vel_embed->data[h_embed_member_idx->data[cur_p - N_mpcd]];
+                vel_i = make_double3(vel_m.x, vel_m.y, vel_m.z);
+                mass_i = vel_m.w;
+                }
+
+            double4& momentum = h_cell_momentum->data[bin_idx];
+            momentum.x += mass_i * vel_i.x;
+            momentum.y += mass_i * vel_i.y;
+            momentum.z += mass_i * vel_i.z;
+            momentum.w += mass_i;
+
+            if (sum_energy)
+                h_cell_ke->data[bin_idx] += 0.5 * mass_i * (vel_i.x * vel_i.x + vel_i.y * vel_i.y + vel_i.z * vel_i.z);
+            }
         }
 
     // write out the conditions
     m_conditions.resetFlags(conditions);
+
+    // sums are valid if this build succeeds, and a rebuild will overwrite them otherwise
+    m_has_sums = sum_props;
     }
 
 /*!
@@ -745,8 +808,9 @@ bool mpcd::CellList::checkConditions()
         Scalar4 pos_empty_i;
         if (n < m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual())
             {
-            ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
-            pos_empty_i = h_pos.data[n];
+            ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+            const mpcd::StorageScalar4 postype = h_pos.data[n];
+            pos_empty_i = make_scalar4(postype.x, postype.y, postype.z, 0);
             if (n < m_mpcd_pdata->getN())
                 m_exec_conf->msg->errorAllRanks() << "MPCD particle is no longer in the simulation box"<<std::endl;
             else
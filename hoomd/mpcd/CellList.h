@@ -227,6 +227,41 @@ class PYBIND11_EXPORT CellList : public Compute
             return m_embed_cell_ids;
             }
 
+        //! Request that cell properties be summed while building the cell list
+        /*!
+         * \param energy If true, the kinetic energy is also summed
+         *
+         * The request only applies to the next call to compute(). If the cell list
+         * is rebuilt on the CPU during that call, the momentum, mass, and (optionally)
+         * kinetic energy of each cell are summed in the same pass over the particles
+         * that bins them, and hasCellSums() returns true until compute() is called again.
+         * Particles are summed in the order they appear in each cell, so the sums are
+         * identical to summing over the cell list after it is built.
+         */
+        void requestCellSums(bool energy)
+            {
+            m_sums_requested = true;
+            m_sums_energy = energy;
+            }
+
+        //! Check if cell sums were accumulated during the last call to compute()
+        bool hasCellSums() const
+            {
+            return m_has_sums;
+            }
+
+        //! Get the summed momentum and mass of each cell
+        const GPUArray<double4>& getCellMomentumSums() const
+            {
+            return m_cell_momentum;
+            }
+
+        //! Get the summed kinetic energy of each cell
+        const GPUArray<double>& getCellEnergySums() const
+            {
+            return m_cell_ke;
+            }
+
         //! Get the signal for dimensions changing
         /*!
          * \returns A signal that subscribers can attach to be notified that the
@@ -259,6 +294,12 @@ class PYBIND11_EXPORT CellList : public Compute
         GPUVector<unsigned int> m_embed_cell_ids;   //!< Cell ids of the embedded particles
         GPUFlags<uint3> m_conditions;               //!< Detect conditions that might fail building cell list
 
+        bool m_sums_requested;                      //!< True if cell properties should be summed on the next build
+        bool m_sums_energy;                         //!< True if the kinetic energy should be summed on the next build
+        bool m_has_sums;                            //!< True if cell properties were summed on the last build
+        GPUVector<double4> m_cell_momentum;         //!< Summed momentum and mass of each cell
+        GPUVector<double> m_cell_ke;                //!< Summed kinetic energy of each cell
+
         int3 m_origin_idx;                  //!< Origin as a global index
 
         #ifdef ENABLE_MPI
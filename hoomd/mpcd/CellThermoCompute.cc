@@ -11,6 +11,13 @@
 #include "CellThermoCompute.h"
 #include "ReductionOperators.h"
 
+#include <algorithm>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 /*!
  * \param sysdata MPCD system data
  * \param suffix Suffix for logged quantities
@@ -59,12 +66,14 @@ void mpcd::CellThermoCompute::compute(unsigned int timestep)
     if (!shouldCompute(timestep)) return;
     m_last_computed = timestep;
 
-    // cell list needs to be up to date first
-    m_cl->compute(timestep);
-
     // ensure optional flags are up to date
     updateFlags();
 
+    // cell list needs to be up to date first, and if it is rebuilt now, the cell sums can
+    // be accumulated while the particles are binned rather than in a second pass
+    m_cl->requestCellSums(m_flags[mpcd::detail::thermo_options::energy]);
+    m_cl->compute(timestep);
+
     if (m_prof) m_prof->push(m_exec_conf, "MPCD thermo");
     const unsigned int ncells = m_cl->getNCells();
     if (ncells != m_ncells_alloc)
@@ -145,17 +154,22 @@ struct CellPropertySum
      * \param embed_vel_ Embedded particle velocities
      * \param embed_idx_ Embedded particle indexes
      * \param N_mpcd_ Number of MPCD particles
+     * \param cell_momentum_ Momentum and mass summed by the cell list (NULL to sum here)
+     * \param cell_ke_ Kinetic energy summed by the cell list (NULL to sum here)
      */
     CellPropertySum(const unsigned int *cell_list_,
                     const unsigned int *cell_np_,
                     const Index2D& cli_,
-                    const Scalar4 *vel_,
+                    const mpcd::StorageScalar4 *vel_,
                     const Scalar mass_,
                     const Scalar4 *embed_vel_,
                     const unsigned int *embed_idx_,
-                    const unsigned int N_mpcd_)
+                    const unsigned int N_mpcd_,
+                    const double4 *cell_momentum_ = NULL,
+                    const double *cell_ke_ = NULL)
         : cell_list(cell_list_), cell_np(cell_np_), cli(cli_), vel(vel_), mass(mass_),
-          embed_vel(embed_vel_), embed_idx(embed_idx_), N_mpcd(N_mpcd_)
+          embed_vel(embed_vel_), embed_idx(embed_idx_), N_mpcd(N_mpcd_),
+          cell_momentum(cell_momentum_), cell_ke(cell_ke_)
         {}
 
     //! Computes the total momentum, kinetic energy, and number of particles in a cell
@@ -168,9 +182,18 @@ struct CellPropertySum
      */
     inline void compute(double4& momentum, double& ke, unsigned int& np, const unsigned int cell, const bool energy)
         {
+        np = cell_np[cell];
+
+        // use the sums accumulated while building the cell list when available
+        if (cell_momentum)
+            {
+            momentum = cell_momentum[cell];
+            ke = (energy) ? cell_ke[cell] : 0.0;
+            return;
+            }
+
         momentum = make_double4(0.0, 0.0, 0.0, 0.0);
         ke = 0.0;
-        np = cell_np[cell];
 
         for (unsigned int offset = 0; offset < np; ++offset)
             {
@@ -180,7 +203,7 @@ struct CellPropertySum
             double mass_i;
             if (cur_p < N_mpcd)
                 {
-                Scalar4 vel_cell = vel[cur_p];
+                mpcd::StorageScalar4 vel_cell = vel[cur_p];
                 vel_i = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
                 mass_i = mass;
                 }
@@ -207,11 +230,14 @@ struct CellPropertySum
     const unsigned int *cell_np;    //!< Number of particles per cell
     const Index2D cli;              //!< Cell list indexer
 
-    const Scalar4 *vel;             //!< MPCD particle velocities
+    const mpcd::StorageScalar4 *vel;    //!< MPCD particle velocities
     const Scalar mass;              //!< MPCD particle mass
     const Scalar4 *embed_vel;       //!< Embedded particle velocities
     const unsigned int *embed_idx;  //!< Embedded particle indexes
     const unsigned int N_mpcd;      //!< Number of MPCD particles
+
+    const double4 *cell_momentum;   //!< Presummed cell momentum and mass
+    const double *cell_ke;          //!< Presummed cell kinetic energy
     };
 } // end namespace detail
 } // end namespace mpcd
@@ -225,7 +251,7 @@ void mpcd::CellThermoCompute::beginOuterCellProperties()
     const Index2D& cli = m_cl->getCellListIndexer();
 
     // MPCD particle data
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
     const Scalar mpcd_mass = m_mpcd_pdata->getMass();
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
 
@@ -238,6 +264,16 @@ void mpcd::CellThermoCompute::beginOuterCellProperties()
         h_embed_member_idx.reset(new ArrayHandle<unsigned int>(m_cl->getEmbeddedGroup()->getIndexArray(), access_location::host, access_mode::read));
         }
 
+    // Cell sums from the cell list build, if they were accumulated
+    std::unique_ptr< ArrayHandle<double4> > h_cell_momentum;
+    std::unique_ptr< ArrayHandle<double> > h_cell_ke;
+    if (m_cl->hasCellSums())
+        {
+        h_cell_momentum.reset(new ArrayHandle<double4>(m_cl->getCellMomentumSums(), access_location::host, access_mode::read));
+        if (m_flags[mpcd::detail::thermo_options::energy])
+            h_cell_ke.reset(new ArrayHandle<double>(m_cl->getCellEnergySums(), access_location::host, access_mode::read));
+        }
+
     // Cell properties
     ArrayHandle<double4> h_cell_vel(m_cell_vel, access_location::host, access_mode::overwrite);
     ArrayHandle<double3> h_cell_energy(m_cell_energy, access_location::host, access_mode::overwrite);
@@ -249,7 +285,9 @@ void mpcd::CellThermoCompute::beginOuterCellProperties()
                                          mpcd_mass,
                                          (m_cl->getEmbeddedGroup()) ? h_embed_vel->data : NULL,
                                          (m_cl->getEmbeddedGroup()) ? h_embed_member_idx->data : NULL,
-                                         N_mpcd);
+                                         N_mpcd,
+                                         (h_cell_momentum) ? h_cell_momentum->data : NULL,
+                                         (h_cell_ke) ? h_cell_ke->data : NULL);
 
     // Loop over all outer cells and compute total momentum, mass, energy
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
@@ -319,7 +357,7 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
     // MPCD particle data
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     const Scalar mpcd_mass = m_mpcd_pdata->getMass();
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
 
     // Embedded particle data
     std::unique_ptr< ArrayHandle<Scalar4> > h_embed_vel;
@@ -330,6 +368,16 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
         h_embed_member_idx.reset(new ArrayHandle<unsigned int>(m_cl->getEmbeddedGroup()->getIndexArray(), access_location::host, access_mode::read));
         }
 
+    // Cell sums from the cell list build, if they were accumulated
+    std::unique_ptr< ArrayHandle<double4> > h_cell_momentum;
+    std::unique_ptr< ArrayHandle<double> > h_cell_ke;
+    if (m_cl->hasCellSums())
+        {
+        h_cell_momentum.reset(new ArrayHandle<double4>(m_cl->getCellMomentumSums(), access_location::host, access_mode::read));
+        if (m_flags[mpcd::detail::thermo_options::energy])
+            h_cell_ke.reset(new ArrayHandle<double>(m_cl->getCellEnergySums(), access_location::host, access_mode::read));
+        }
+
     // Cell properties
     ArrayHandle<double4> h_cell_vel(m_cell_vel, access_location::host, access_mode::readwrite);
     ArrayHandle<double3> h_cell_energy(m_cell_energy, access_location::host, access_mode::readwrite);
@@ -340,7 +388,9 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
                                          mpcd_mass,
                                          (m_cl->getEmbeddedGroup()) ? h_embed_vel->data : NULL,
                                          (m_cl->getEmbeddedGroup()) ? h_embed_member_idx->data : NULL,
-                                         N_mpcd);
+                                         N_mpcd,
+                                         (h_cell_momentum) ? h_cell_momentum->data : NULL,
+                                         (h_cell_ke) ? h_cell_ke->data : NULL);
 
     // determine which cells are inner
     uint3 lo, hi;
@@ -365,41 +415,85 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
 
     // iterate over all of the inner cells and compute average velocity, energy, temperature
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
-    for (unsigned int k=lo.z; k < hi.z; ++k)
+    const unsigned int ndim = m_sysdef->getNDimensions();
+    const unsigned int ny = hi.y - lo.y;
+    const unsigned int nz = hi.z - lo.z;
+
+    // each row of cells along x is independent, so the rows can be processed concurrently
+    auto compute_row = [&](unsigned int row)
         {
-        for (unsigned int j=lo.y; j < hi.y; ++j)
+        const unsigned int j = lo.y + row % ny;
+        const unsigned int k = lo.z + row / ny;
+        for (unsigned int i=lo.x; i < hi.x; ++i)
             {
-            for (unsigned int i=lo.x; i < hi.x; ++i)
-                {
-                const unsigned int cur_cell = ci(i,j,k);
+            const unsigned int cur_cell = ci(i,j,k);
 
-                // compute the cell properties
-                double4 momentum; double ke(0.0); unsigned int np(0);
-                summer.compute(momentum, ke, np, cur_cell, need_energy);
+            // compute the cell properties
+            double4 momentum; double ke(0.0); unsigned int np(0);
+            summer.compute(momentum, ke, np, cur_cell, need_energy);
 
-                const double mass = momentum.w;
-                double3 vel_cm = make_double3(0.0,0.0,0.0);
-                if (mass > 0.)
-                    {
-                    vel_cm.x = momentum.x / mass;
-                    vel_cm.y = momentum.y / mass;
-                    vel_cm.z = momentum.z / mass;
-                    }
+            const double mass = momentum.w;
+            double3 vel_cm = make_double3(0.0,0.0,0.0);
+            if (mass > 0.)
+                {
+                vel_cm.x = momentum.x / mass;
+                vel_cm.y = momentum.y / mass;
+                vel_cm.z = momentum.z / mass;
+                }
 
-                h_cell_vel.data[cur_cell] = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass);
-                if (need_energy)
+            h_cell_vel.data[cur_cell] = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass);
+            if (need_energy)
+                {
+                double temp(0.0);
+                if (np > 1)
                     {
-                    double temp(0.0);
-                    if (np > 1)
-                        {
-                        const double ke_cm = 0.5 * mass * (vel_cm.x*vel_cm.x + vel_cm.y*vel_cm.y + vel_cm.z*vel_cm.z);
-                        temp = 2. * (ke - ke_cm) / (m_sysdef->getNDimensions() * (np-1));
-                        }
-                    h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
+                    const double ke_cm = 0.5 * mass * (vel_cm.x*vel_cm.x + vel_cm.y*vel_cm.y + vel_cm.z*vel_cm.z);
+                    temp = 2. * (ke - ke_cm) / (ndim * (np-1));
                     }
-                } // i
-            } //j
-        } // k
+                h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
+                }
+            }
+        };
+
+    /*
+     * In MPI simulations, the outer cells are being communicated while this runs. The rows
+     * are processed in blocks, and the messages are progressed between blocks so that they
+     * are not left waiting until finalize. A few blocks are enough to keep the messages
+     * moving without breaking the parallel work into pieces that are too small.
+     */
+    const unsigned int num_rows = ny*nz;
+    unsigned int num_blocks = 1;
+    #ifdef ENABLE_MPI
+    if (m_use_mpi)
+        num_blocks = std::max(1u, std::min(num_rows, 8u));
+    #endif // ENABLE_MPI
+
+    for (unsigned int block = 0; block < num_blocks; ++block)
+        {
+        const unsigned int first = (block * num_rows) / num_blocks;
+        const unsigned int last = ((block+1) * num_rows) / num_blocks;
+
+        #ifdef ENABLE_TBB
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(first, last),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int row = r.begin(); row != r.end(); ++row)
+                compute_row(row);
+            });
+        #else
+        for (unsigned int row = first; row < last; ++row)
+            compute_row(row);
+        #endif
+
+        #ifdef ENABLE_MPI
+        if (m_use_mpi)
+            {
+            m_vel_comm->progress();
+            if (need_energy)
+                m_energy_comm->progress();
+            }
+        #endif // ENABLE_MPI
+        }
     }
 
 void mpcd::CellThermoCompute::computeNetProperties()
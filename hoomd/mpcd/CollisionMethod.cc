@@ -60,7 +60,7 @@ void mpcd::CollisionMethod::collide(unsigned int timestep)
     if (m_prof) m_prof->pop();
 
     // update cell list
-    m_cl->compute(timestep);
+    computeCells(timestep);
 
     rule(timestep);
     }
@@ -102,6 +102,12 @@ class PYBIND11_EXPORT CollisionMethod
         //! Check if a collision should occur and advance the timestep counter
         virtual bool shouldCollide(unsigned int timestep);
 
+        //! Update the cell list for the collision
+        virtual void computeCells(unsigned int timestep)
+            {
+            m_cl->compute(timestep);
+            }
+
         //! Call the collision rule
         virtual void rule(unsigned int timestep) {}
 
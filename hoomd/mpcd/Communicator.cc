@@ -62,10 +62,16 @@ mpcd::Communicator::Communicator(std::shared_ptr<mpcd::SystemData> system_data)
     // attach decomposition check to the box change signal
     m_mpcd_sys->getCellList()->getSizeChangeSignal().connect<mpcd::Communicator, &mpcd::Communicator::slotBoxChanged>(this);
 
-    // create new data type for the pdata_element
+    // create new data type for the pdata_element, the position and velocity use the storage precision
+    #ifdef ENABLE_MPCD_MIXED_PRECISION
+    const MPI_Datatype storage_type = MPI_FLOAT;
+    #else
+    const MPI_Datatype storage_type = MPI_HOOMD_SCALAR;
+    #endif
+    static_assert(sizeof(mpcd::StorageScalar4) == 4*sizeof(mpcd::StorageScalar), "Unexpected padding in StorageScalar4");
     const int nitems = 4;
     int blocklengths[nitems] = {4,4,1,1};
-    MPI_Datatype types[nitems] = {MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_UNSIGNED, MPI_UNSIGNED};
+    MPI_Datatype types[nitems] = {storage_type, storage_type, MPI_UNSIGNED, MPI_UNSIGNED};
     MPI_Aint offsets[nitems];
     offsets[0] = offsetof(mpcd::detail::pdata_element, pos);
     offsets[1] = offsetof(mpcd::detail::pdata_element, vel);
@@ -394,10 +400,11 @@ void mpcd::Communicator::migrateParticles(unsigned int timestep)
         for (unsigned int idx = 0; idx < n_recv; ++idx)
             {
             mpcd::detail::pdata_element& p = h_recvbuf.data[idx];
-            Scalar4& postype = p.pos;
+            Scalar3 pos = make_scalar3(p.pos.x, p.pos.y, p.pos.z);
             int3 image = make_int3(0,0,0);
 
-            wrap_box.wrap(postype,image);
+            wrap_box.wrap(pos,image);
+            p.pos.x = pos.x; p.pos.y = pos.y; p.pos.z = pos.z;
             }
         }
 
@@ -419,7 +426,7 @@ void mpcd::Communicator::setCommFlags(const BoxDim& box)
     if (m_prof) m_prof->push("comm flags");
     // mark all particles which have left the box for sending
     unsigned int N = m_mpcd_pdata->getN();
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_comm_flag(m_mpcd_pdata->getCommFlags(), access_location::host, access_mode::overwrite);
 
     // since box is orthorhombic, just use branching to compute comm flags
@@ -427,7 +434,7 @@ void mpcd::Communicator::setCommFlags(const BoxDim& box)
     const Scalar3 hi = box.getHi();
     for (unsigned int idx = 0; idx < N; ++idx)
         {
-        const Scalar4& postype = h_pos.data[idx];
+        const mpcd::StorageScalar4& postype = h_pos.data[idx];
         const Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
 
         unsigned int flags = 0;
@@ -105,8 +105,8 @@ void ConfinedStreamingMethod<Geometry>::stream(unsigned int timestep)
 
     const BoxDim& box = m_mpcd_sys->getCellList()->getCoverageBox();
 
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     const Scalar mass = m_mpcd_pdata->getMass();
 
     // acquire polymorphic pointer to the external field
@@ -114,11 +114,11 @@ void ConfinedStreamingMethod<Geometry>::stream(unsigned int timestep)
 
     for (unsigned int cur_p = 0; cur_p < m_mpcd_pdata->getN(); ++cur_p)
         {
-        const Scalar4 postype = h_pos.data[cur_p];
+        const mpcd::StorageScalar4 postype = h_pos.data[cur_p];
         Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
-        const unsigned int type = __scalar_as_int(postype.w);
+        const unsigned int type = mpcd::storage_as_int(postype.w);
 
-        const Scalar4 vel_cell = h_vel.data[cur_p];
+        const mpcd::StorageScalar4 vel_cell = h_vel.data[cur_p];
         Scalar3 vel = make_scalar3(vel_cell.x, vel_cell.y, vel_cell.z);
         // estimate next velocity based on current acceleration
         if (field)
@@ -145,8 +145,8 @@ void ConfinedStreamingMethod<Geometry>::stream(unsigned int timestep)
         int3 image = make_int3(0,0,0);
         box.wrap(pos, image);
 
-        h_pos.data[cur_p] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
-        h_vel.data[cur_p] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
+        h_pos.data[cur_p] = mpcd::make_storage_scalar4(pos.x, pos.y, pos.z, mpcd::int_as_storage(type));
+        h_vel.data[cur_p] = mpcd::make_storage_scalar4(vel.x, vel.y, vel.z, mpcd::int_as_storage(mpcd::detail::NO_CELL));
         }
 
     // particles have moved, so the cell cache is no longer valid
@@ -183,12 +183,12 @@ void ConfinedStreamingMethod<Geometry>::validate()
 template<class Geometry>
 bool ConfinedStreamingMethod<Geometry>::validateParticles()
     {
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::read);
 
     for (unsigned int idx = 0; idx < m_mpcd_pdata->getN(); ++idx)
         {
-        const Scalar4 postype = h_pos.data[idx];
+        const mpcd::StorageScalar4 postype = h_pos.data[idx];
         const Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
         if (m_geom->isOutside(pos))
             {
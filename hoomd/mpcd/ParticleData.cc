@@ -256,14 +256,14 @@ void mpcd::ParticleData::initializeFromSnapshot(const std::shared_ptr<const mpcd
             allocate(m_N);
 
         // Fill-up particle data arrays
-        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle<StorageScalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
+        ArrayHandle<StorageScalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_comm_flag(m_comm_flags, access_location::host, access_mode::overwrite);
         for (unsigned int idx = 0; idx < m_N; idx++)
             {
-            h_pos.data[idx] = make_scalar4(pos[idx].x,pos[idx].y, pos[idx].z, __int_as_scalar(type[idx]));
-            h_vel.data[idx] = make_scalar4(vel[idx].x, vel[idx].y, vel[idx].z, __int_as_scalar(mpcd::detail::NO_CELL));
+            h_pos.data[idx] = make_storage_scalar4(pos[idx].x,pos[idx].y, pos[idx].z, int_as_storage(type[idx]));
+            h_vel.data[idx] = make_storage_scalar4(vel[idx].x, vel[idx].y, vel[idx].z, int_as_storage(mpcd::detail::NO_CELL));
             h_tag.data[idx] = tag[idx];
             h_comm_flag.data[idx] = 0; // initialize with zero by default
             }
@@ -273,20 +273,20 @@ void mpcd::ParticleData::initializeFromSnapshot(const std::shared_ptr<const mpcd
         {
         allocate(snapshot->size);
 
-        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle<StorageScalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
+        ArrayHandle<StorageScalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::overwrite);
 
         for (unsigned int snap_idx = 0; snap_idx < snapshot->size; ++snap_idx)
             {
-            h_pos.data[nglobal] = make_scalar4(snapshot->position[snap_idx].x,
-                                               snapshot->position[snap_idx].y,
-                                               snapshot->position[snap_idx].z,
-                                               __int_as_scalar(snapshot->type[snap_idx]));
-            h_vel.data[nglobal] = make_scalar4(snapshot->velocity[snap_idx].x,
-                                               snapshot->velocity[snap_idx].y,
-                                               snapshot->velocity[snap_idx].z,
-                                               __int_as_scalar(mpcd::detail::NO_CELL));
+            h_pos.data[nglobal] = make_storage_scalar4(snapshot->position[snap_idx].x,
+                                                       snapshot->position[snap_idx].y,
+                                                       snapshot->position[snap_idx].z,
+                                                       int_as_storage(snapshot->type[snap_idx]));
+            h_vel.data[nglobal] = make_storage_scalar4(snapshot->velocity[snap_idx].x,
+                                                       snapshot->velocity[snap_idx].y,
+                                                       snapshot->velocity[snap_idx].z,
+                                                       int_as_storage(mpcd::detail::NO_CELL));
             h_tag.data[nglobal] = nglobal;
             nglobal++;
             }
@@ -367,20 +367,20 @@ void mpcd::ParticleData::initializeRandom(unsigned int N, const BoxDim& local_bo
 
     // allocate and fill up with random values
     allocate(m_N);
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
+    ArrayHandle<StorageScalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
+    ArrayHandle<StorageScalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::overwrite);
     double3 vel_cm = make_double3(0,0,0);
     for (unsigned int i=0; i < m_N; ++i)
         {
-        h_pos.data[i] = make_scalar4(pos_x(mt),
-                                     pos_y(mt),
-                                     (ndimensions == 3) ? pos_z(mt) : Scalar(0.0),
-                                     __int_as_scalar(0));
-        h_vel.data[i] = make_scalar4(vel(mt),
-                                     vel(mt),
-                                     (ndimensions == 3) ? vel(mt) : Scalar(0.0),
-                                     __int_as_scalar(mpcd::detail::NO_CELL));
+        h_pos.data[i] = make_storage_scalar4(pos_x(mt),
+                                             pos_y(mt),
+                                             (ndimensions == 3) ? pos_z(mt) : Scalar(0.0),
+                                             int_as_storage(0));
+        h_vel.data[i] = make_storage_scalar4(vel(mt),
+                                             vel(mt),
+                                             (ndimensions == 3) ? vel(mt) : Scalar(0.0),
+                                             int_as_storage(mpcd::detail::NO_CELL));
         h_tag.data[i] = tag_start + i;
 
         // add up total velocity
@@ -421,8 +421,8 @@ void mpcd::ParticleData::takeSnapshot(std::shared_ptr<mpcd::ParticleDataSnapshot
     {
     m_exec_conf->msg->notice(4) << "MPCD ParticleData: taking snapshot" << std::endl;
 
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::read);
+    ArrayHandle<StorageScalar4> h_pos(m_pos, access_location::host, access_mode::read);
+    ArrayHandle<StorageScalar4> h_vel(m_vel, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::read);
 
 #ifdef ENABLE_MPI
@@ -437,7 +437,7 @@ void mpcd::ParticleData::takeSnapshot(std::shared_ptr<mpcd::ParticleDataSnapshot
             {
             pos[idx] = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
             vel[idx] = make_scalar3(h_vel.data[idx].x, h_vel.data[idx].y, h_vel.data[idx].z);
-            type[idx] = __scalar_as_int(h_pos.data[idx].w);
+            type[idx] = storage_as_int(h_pos.data[idx].w);
             tag[idx] = h_tag.data[idx];
             }
 
@@ -501,15 +501,16 @@ void mpcd::ParticleData::takeSnapshot(std::shared_ptr<mpcd::ParticleDataSnapshot
             const unsigned int snap_idx = h_tag.data[idx];
 
             // make sure the position stored in the snapshot is within the boundaries
-            Scalar4 postype = h_pos.data[idx];
+            StorageScalar4 postype = h_pos.data[idx];
             Scalar3 pos_i = make_scalar3(postype.x, postype.y, postype.z);
-            const unsigned int type_i = __scalar_as_int(postype.w);
+            const unsigned int type_i = storage_as_int(postype.w);
             int3 img = make_int3(0,0,0);
             global_box.wrap(pos_i,img);
 
             // push particle into the snapshot
             snapshot->position[snap_idx] = vec3<Scalar>(pos_i);
-            snapshot->velocity[snap_idx] = vec3<Scalar>(h_vel.data[idx]);
+            const StorageScalar4 velcell = h_vel.data[idx];
+            snapshot->velocity[snap_idx] = vec3<Scalar>(velcell.x, velcell.y, velcell.z);
             snapshot->type[snap_idx] = type_i;
             }
         }
@@ -611,10 +612,10 @@ void mpcd::ParticleData::allocate(unsigned int N_max)
     m_N_max = N_max;
 
     //! Allocate the particle data
-    GPUArray<Scalar4> pos(N_max, m_exec_conf);
+    GPUArray<StorageScalar4> pos(N_max, m_exec_conf);
     m_pos.swap(pos);
 
-    GPUArray<Scalar4> vel(N_max, m_exec_conf);
+    GPUArray<StorageScalar4> vel(N_max, m_exec_conf);
     m_vel.swap(vel);
 
     GPUArray<unsigned int> tag(N_max, m_exec_conf);
@@ -629,10 +630,10 @@ void mpcd::ParticleData::allocate(unsigned int N_max)
     #endif // ENABLE_MPI
 
     // Allocate the alternate data
-    GPUArray<Scalar4> pos_alt(N_max, m_exec_conf);
+    GPUArray<StorageScalar4> pos_alt(N_max, m_exec_conf);
     m_pos_alt.swap(pos_alt);
 
-    GPUArray<Scalar4> vel_alt(N_max, m_exec_conf);
+    GPUArray<StorageScalar4> vel_alt(N_max, m_exec_conf);
     m_vel_alt.swap(vel_alt);
 
     GPUArray<unsigned int> tag_alt(N_max, m_exec_conf);
@@ -792,8 +793,8 @@ Scalar3 mpcd::ParticleData::getPosition(unsigned int idx) const
         m_exec_conf->msg->error() << "Requested MPCD particle local index " << idx << " is out of range" << endl;
         throw std::runtime_error("Error accessing MPCD particle data.");
         }
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
-    const Scalar4 postype = h_pos.data[idx];
+    ArrayHandle<StorageScalar4> h_pos(m_pos, access_location::host, access_mode::read);
+    const StorageScalar4 postype = h_pos.data[idx];
     return make_scalar3(postype.x, postype.y, postype.z);
     }
 
@@ -809,9 +810,9 @@ unsigned int mpcd::ParticleData::getType(unsigned int idx) const
         m_exec_conf->msg->error() << "Requested MPCD particle local index " << idx << " is out of range" << endl;
         throw std::runtime_error("Error accessing MPCD particle data.");
         }
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
-    const Scalar4 postype = h_pos.data[idx];
-    return __scalar_as_int(postype.w);
+    ArrayHandle<StorageScalar4> h_pos(m_pos, access_location::host, access_mode::read);
+    const StorageScalar4 postype = h_pos.data[idx];
+    return storage_as_int(postype.w);
     }
 
 /*!
@@ -826,8 +827,8 @@ Scalar3 mpcd::ParticleData::getVelocity(unsigned int idx) const
         m_exec_conf->msg->error() << "Requested MPCD particle local index " << idx << " is out of range" << endl;
         throw std::runtime_error("Error accessing MPCD particle data.");
         }
-    ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::read);
-    const Scalar4 velcell = h_vel.data[idx];
+    ArrayHandle<StorageScalar4> h_vel(m_vel, access_location::host, access_mode::read);
+    const StorageScalar4 velcell = h_vel.data[idx];
     return make_scalar3(velcell.x, velcell.y, velcell.z);
     }
 
@@ -923,8 +924,8 @@ void mpcd::ParticleData::removeParticles(GPUVector<mpcd::detail::pdata_element>&
         ArrayHandle<mpcd::detail::pdata_element> h_out(out, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_remove_idx(m_remove_ids, access_location::host, access_mode::read);
 
-        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::readwrite);
+        ArrayHandle<StorageScalar4> h_pos(m_pos, access_location::host, access_mode::readwrite);
+        ArrayHandle<StorageScalar4> h_vel(m_vel, access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
 
@@ -984,8 +985,8 @@ void mpcd::ParticleData::addParticles(const GPUVector<mpcd::detail::pdata_elemen
 
         {
         // access particle data arrays
-        ArrayHandle<Scalar4> h_pos(getPositions(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_vel(getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<StorageScalar4> h_pos(getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<StorageScalar4> h_vel(getVelocities(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
 
@@ -1088,8 +1089,8 @@ void mpcd::ParticleData::removeParticlesGPU(GPUVector<mpcd::detail::pdata_elemen
         ArrayHandle<mpcd::detail::pdata_element> d_out(out, access_location::device, access_mode::overwrite);
 
         // access particle data arrays to read from
-        ArrayHandle<Scalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
-        ArrayHandle<Scalar4> d_vel(m_vel, access_location::device, access_mode::readwrite);
+        ArrayHandle<StorageScalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
+        ArrayHandle<StorageScalar4> d_vel(m_vel, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_tag(m_tag, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_comm_flags(m_comm_flags, access_location::device, access_mode::readwrite);
 
@@ -1137,8 +1138,8 @@ void mpcd::ParticleData::addParticlesGPU(const GPUVector<mpcd::detail::pdata_ele
 
         {
         // access particle data arrays
-        ArrayHandle<Scalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
-        ArrayHandle<Scalar4> d_vel(m_vel, access_location::device, access_mode::readwrite);
+        ArrayHandle<StorageScalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
+        ArrayHandle<StorageScalar4> d_vel(m_vel, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_tag(m_tag, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_comm_flags(m_comm_flags, access_location::device, access_mode::readwrite);
 
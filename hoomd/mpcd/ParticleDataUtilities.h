@@ -19,8 +19,66 @@
  */
 
 #include "hoomd/HOOMDMath.h"
+
+// need to declare these functions with __host__ __device__ qualifiers when building in nvcc
+// HOSTDEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef __HIPCC__
+#define HOSTDEVICE __host__ __device__
+#else
+#define HOSTDEVICE
+#endif
+
 namespace mpcd
 {
+
+// In mixed precision builds, the MPCD particle positions and velocities are stored in single
+// precision to halve the memory traffic of the solvent. Arithmetic is still done in Scalar.
+#ifdef ENABLE_MPCD_MIXED_PRECISION
+//! Floating point type for storing MPCD particle data (single precision)
+typedef float StorageScalar;
+//! Floating point type with x,y,z,w elements for storing MPCD particle data (single precision)
+typedef float4 StorageScalar4;
+#else
+//! Floating point type for storing MPCD particle data (same as Scalar)
+typedef Scalar StorageScalar;
+//! Floating point type with x,y,z,w elements for storing MPCD particle data (same as Scalar4)
+typedef Scalar4 StorageScalar4;
+#endif // ENABLE_MPCD_MIXED_PRECISION
+
+//! Make a storage value for MPCD particle data
+/*!
+ * \param w Fourth component, which should already be in storage format (see int_as_storage())
+ */
+HOSTDEVICE inline StorageScalar4 make_storage_scalar4(Scalar x, Scalar y, Scalar z, StorageScalar w)
+    {
+    StorageScalar4 retval;
+    retval.x = x;
+    retval.y = y;
+    retval.z = z;
+    retval.w = w;
+    return retval;
+    }
+
+//! Stuff an integer (type or cell index) into the fourth component of stored MPCD particle data
+HOSTDEVICE inline StorageScalar int_as_storage(int a)
+    {
+    #ifdef ENABLE_MPCD_MIXED_PRECISION
+    return __int_as_float(a);
+    #else
+    return __int_as_scalar(a);
+    #endif
+    }
+
+//! Extract an integer stuffed by int_as_storage()
+HOSTDEVICE inline int storage_as_int(StorageScalar b)
+    {
+    #ifdef ENABLE_MPCD_MIXED_PRECISION
+    return __float_as_int(b);
+    #else
+    return __scalar_as_int(b);
+    #endif
+    }
+
 namespace detail
 {
 //! Sentinel value to signify that this particle is not placed in a cell
@@ -36,8 +94,8 @@ const unsigned int NO_CELL = 0xffffffff;
  */
 struct pdata_element
     {
-    Scalar4 pos;            //!< Position
-    Scalar4 vel;            //!< Velocity
+    StorageScalar4 pos;     //!< Position
+    StorageScalar4 vel;     //!< Velocity
     unsigned int tag;       //!< Global tag
     unsigned int comm_flag; //!< Communication flag
     };
@@ -46,4 +104,6 @@ struct pdata_element
 } // end namespace detail
 } // end namespace mpcd
 
+#undef HOSTDEVICE
+
 #endif // MPCD_PARTICLE_DATA_UTILITIES_H_
@@ -12,6 +12,11 @@
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 mpcd::SRDCollisionMethod::SRDCollisionMethod(std::shared_ptr<mpcd::SystemData> sysdata,
                                              unsigned int cur_timestep,
                                              unsigned int period,
@@ -19,11 +24,13 @@ mpcd::SRDCollisionMethod::SRDCollisionMethod(std::shared_ptr<mpcd::SystemData> s
                                              unsigned int seed,
                                              std::shared_ptr<mpcd::CellThermoCompute> thermo)
     : mpcd::CollisionMethod(sysdata,cur_timestep,period,phase,seed),
-      m_thermo(thermo), m_rotvec(m_exec_conf), m_angle(0.0), m_factors(m_exec_conf)
+      m_thermo(thermo), m_rotvec(m_exec_conf), m_angle(0.0), m_factors(m_exec_conf),
+      m_has_rotvec(false), m_rotvec_timestep(0), m_colliding(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing MPCD SRD collision method" << std::endl;
 
     m_thermo->getFlagsSignal().connect<mpcd::SRDCollisionMethod, &mpcd::SRDCollisionMethod::getRequestedThermoFlags>(this);
+    m_thermo->getCallbackSignal().connect<mpcd::SRDCollisionMethod, &mpcd::SRDCollisionMethod::slotDrawRotationVectors>(this);
     }
 
 
@@ -32,6 +39,7 @@ mpcd::SRDCollisionMethod::~SRDCollisionMethod()
     m_exec_conf->msg->notice(5) << "Destroying MPCD SRD collision method" << std::endl;
 
     m_thermo->getFlagsSignal().disconnect<mpcd::SRDCollisionMethod, &mpcd::SRDCollisionMethod::getRequestedThermoFlags>(this);
+    m_thermo->getCallbackSignal().disconnect<mpcd::SRDCollisionMethod, &mpcd::SRDCollisionMethod::slotDrawRotationVectors>(this);
     }
 
 void mpcd::SRDCollisionMethod::rule(unsigned int timestep)
@@ -39,21 +47,47 @@ void mpcd::SRDCollisionMethod::rule(unsigned int timestep)
     m_thermo->compute(timestep);
 
     if (m_prof) m_prof->push(m_exec_conf, "MPCD collide");
-    // resize the rotation vectors and rescale factors
-    m_rotvec.resize(m_cl->getNCells());
-    if (m_T)
+    // draw rotation vectors for each cell, unless they were already drawn during the thermo
+    const bool drawn = (m_has_rotvec && m_rotvec_timestep == timestep && m_rotvec.size() == m_cl->getNCells());
+    if (m_T || !drawn)
         {
-        m_factors.resize(m_cl->getNCells());
+        // resize the rotation vectors and rescale factors
+        m_rotvec.resize(m_cl->getNCells());
+        if (m_T)
+            {
+            m_factors.resize(m_cl->getNCells());
+            }
+        drawRotationVectors(timestep);
         }
-
-    // draw rotation vectors for each cell
-    drawRotationVectors(timestep);
+    m_has_rotvec = false;
 
     // apply collision rule
     rotate(timestep);
+    m_colliding = false;
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+/*!
+ * \param timestep Current timestep.
+ *
+ * The rotation vectors only depend on the cell and the timestep, so they can be
+ * drawn while the outer cell properties are communicated. The thermostat factors
+ * need the energies of the outer cells, so nothing is drawn early with a thermostat.
+ *
+ * The thermo is also computed on steps without a collision (e.g., for logging), where
+ * nothing is drawn. Once the collision has started, the next collision timestep has
+ * already been advanced, so peekCollide() is only checked outside of a collision.
+ */
+void mpcd::SRDCollisionMethod::slotDrawRotationVectors(unsigned int timestep)
+    {
+    if (m_T || !(m_colliding || peekCollide(timestep))) return;
+
+    m_rotvec.resize(m_cl->getNCells());
+    drawRotationVectors(timestep);
+    m_has_rotvec = true;
+    m_rotvec_timestep = timestep;
+    }
+
 void mpcd::SRDCollisionMethod::drawRotationVectors(unsigned int timestep)
     {
     // cell indexers and rotation vectors
@@ -73,56 +107,70 @@ void mpcd::SRDCollisionMethod::drawRotationVectors(unsigned int timestep)
         T_set = (*m_T)(timestep);
         }
 
-    for (unsigned int k=0; k < ci.getD(); ++k)
+    // each cell draws from its own random stream keyed on the global cell index, so the
+    // rows of cells can be processed in any order (and agree between ranks sharing a cell)
+    const unsigned int dim = m_sysdef->getNDimensions();
+    auto draw_row = [&](unsigned int row)
         {
-        for (unsigned int j=0; j < ci.getH(); ++j)
+        const unsigned int j = row % ci.getH();
+        const unsigned int k = row / ci.getH();
+        for (unsigned int i=0; i < ci.getW(); ++i)
             {
-            for (unsigned int i=0; i < ci.getW(); ++i)
-                {
-                const int3 global_cell = m_cl->getGlobalCell(make_int3(i,j,k));
-                const unsigned int global_idx = global_ci(global_cell.x, global_cell.y, global_cell.z);
-                const unsigned int idx = ci(i,j,k);
+            const int3 global_cell = m_cl->getGlobalCell(make_int3(i,j,k));
+            const unsigned int global_idx = global_ci(global_cell.x, global_cell.y, global_cell.z);
+            const unsigned int idx = ci(i,j,k);
 
-                // Initialize the PRNG using the current cell index, timestep, and seed for the hash
-                hoomd::RandomGenerator rng(hoomd::RNGIdentifier::SRDCollisionMethod, m_seed, global_idx, timestep);
+            // Initialize the PRNG using the current cell index, timestep, and seed for the hash
+            hoomd::RandomGenerator rng(hoomd::RNGIdentifier::SRDCollisionMethod, m_seed, global_idx, timestep);
 
-                // draw rotation vector off the surface of the sphere
-                double3 rotvec;
-                hoomd::SpherePointGenerator<double> sphgen;
-                sphgen(rng, rotvec);
-                h_rotvec.data[idx] = rotvec;
+            // draw rotation vector off the surface of the sphere
+            double3 rotvec;
+            hoomd::SpherePointGenerator<double> sphgen;
+            sphgen(rng, rotvec);
+            h_rotvec.data[idx] = rotvec;
 
-                if (use_thermostat)
+            if (use_thermostat)
+                {
+                const double3 cell_energy = h_cell_energy->data[idx];
+                const unsigned int np = __double_as_int(cell_energy.z);
+                double factor = 1.0;
+                if (np > 1)
                     {
-                    const double3 cell_energy = h_cell_energy->data[idx];
-                    const unsigned int np = __double_as_int(cell_energy.z);
-                    double factor = 1.0;
-                    if (np > 1)
-                        {
-                        // the total number of degrees of freedom in the cell divided by 2
-                        const double alpha = m_sysdef->getNDimensions()*(np-1)/(double)2.;
-
-                        // draw a random kinetic energy for the cell at the set temperature
-                        hoomd::GammaDistribution<double> gamma_gen(alpha,T_set);
-                        const double rand_ke = gamma_gen(rng);
-
-                        // generate the scale factor from the current temperature
-                        // (don't use the kinetic energy of this cell, since this
-                        // is total not relative to COM)
-                        const double cur_ke = alpha * cell_energy.y;
-                        factor = (cur_ke > 0.) ? fast::sqrt(rand_ke/cur_ke) : 1.;
-                        }
-                    h_factors->data[idx] = factor;
+                    // the total number of degrees of freedom in the cell divided by 2
+                    const double alpha = dim*(np-1)/(double)2.;
+
+                    // draw a random kinetic energy for the cell at the set temperature
+                    hoomd::GammaDistribution<double> gamma_gen(alpha,T_set);
+                    const double rand_ke = gamma_gen(rng);
+
+                    // generate the scale factor from the current temperature
+                    // (don't use the kinetic energy of this cell, since this
+                    // is total not relative to COM)
+                    const double cur_ke = alpha * cell_energy.y;
+                    factor = (cur_ke > 0.) ? fast::sqrt(rand_ke/cur_ke) : 1.;
                     }
+                h_factors->data[idx] = factor;
                 }
             }
-        }
+        };
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, ci.getH()*ci.getD()),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int row = r.begin(); row != r.end(); ++row)
+            draw_row(row);
+        });
+    #else
+    for (unsigned int row = 0; row < ci.getH()*ci.getD(); ++row)
+        draw_row(row);
+    #endif
     }
 
 void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
     {
     // acquire MPCD particle data
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     unsigned int N_tot = N_mpcd;
     // acquire additionally embedded particle data
@@ -154,7 +202,8 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
         h_factors.reset(new ArrayHandle<double>(m_factors, access_location::host, access_mode::read));
         }
 
-    for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
+    // each particle only reads its own cell's data and writes its own velocity
+    auto rotate_particle = [&](unsigned int cur_p)
         {
         double3 vel;
         unsigned int cell;
@@ -162,9 +211,9 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
         unsigned int idx(0); double mass(0);
         if (cur_p < N_mpcd)
             {
-            const Scalar4 vel_cell = h_vel.data[cur_p];
+            const mpcd::StorageScalar4 vel_cell = h_vel.data[cur_p];
             vel = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
-            cell = __scalar_as_int(vel_cell.w);
+            cell = mpcd::storage_as_int(vel_cell.w);
             }
         else
             {
@@ -215,13 +264,25 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
         // set the new velocity
         if (cur_p < N_mpcd)
             {
-            h_vel.data[cur_p] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, __int_as_scalar(cell));
+            h_vel.data[cur_p] = mpcd::make_storage_scalar4(new_vel.x, new_vel.y, new_vel.z, mpcd::int_as_storage(cell));
             }
         else
             {
             h_vel_embed->data[idx] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, mass);
             }
-        }
+        };
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int cur_p = r.begin(); cur_p != r.end(); ++cur_p)
+            rotate_particle(cur_p);
+        });
+    #else
+    for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
+        rotate_particle(cur_p);
+    #endif
     }
 
 /*!
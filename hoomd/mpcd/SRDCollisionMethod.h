@@ -94,12 +94,31 @@ class PYBIND11_EXPORT SRDCollisionMethod : public mpcd::CollisionMethod
         std::shared_ptr<::Variant> m_T; //!< Temperature for thermostat
         GPUVector<double> m_factors;    //!< Cell-level rescale factors
 
+        bool m_has_rotvec;                  //!< Flag if rotation vectors were drawn early
+        unsigned int m_rotvec_timestep;     //!< Timestep the early rotation vectors were drawn for
+        bool m_colliding;                   //!< Flag if a collision is in progress
+
+        //! Update the cell list for the collision
+        /*!
+         * The cell thermo is computed first so that the cell properties can be summed
+         * while the cell list is built.
+         */
+        virtual void computeCells(unsigned int timestep)
+            {
+            m_colliding = true;
+            m_thermo->compute(timestep);
+            m_cl->compute(timestep);
+            }
+
         //! Implementation of the collision rule
         virtual void rule(unsigned int timestep);
 
         //! Randomly draw cell rotation vectors
         virtual void drawRotationVectors(unsigned int timestep);
 
+        //! Draw the rotation vectors while the cell properties are communicated
+        void slotDrawRotationVectors(unsigned int timestep);
+
         //! Apply rotation matrix to velocities
         virtual void rotate(unsigned int timestep);
     };
@@ -177,6 +177,54 @@ void at_collision_method_embed_test(std::shared_ptr<ExecutionConfiguration> exec
     CHECK_CLOSE(orig_mom.z, mom.z, tol_small);
     }
 
+#ifdef ENABLE_TBB
+//! Collide a system with embedded particles using a given number of threads
+/*!
+ * \param num_threads Number of threads to collide with
+ * \param vel Velocities of the MPCD particles, then of the embedded particles, after the collisions
+ */
+void at_collision_method_run_threads(unsigned int num_threads, std::vector<Scalar3>& vel)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    exec_conf->setNumThreads(num_threads);
+
+    const BoxDim box(10.0);
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = box;
+    snap->particle_data.type_mapping.push_back("A");
+        {
+        SnapshotParticleData<Scalar>& pdata_snap = snap->particle_data;
+        pdata_snap.resize(100);
+        for (unsigned int i=0; i < pdata_snap.size; ++i)
+            {
+            pdata_snap.pos[i] = vec3<Scalar>(-4.95 + 0.1*i, 4.95 - 0.1*i, -4.95 + 0.07*i);
+            pdata_snap.vel[i] = vec3<Scalar>(0.01*i, -0.02*i, 0.5);
+            pdata_snap.mass[i] = 2.0;
+            }
+        }
+    auto sysdef = std::make_shared<SystemDefinition>(snap, exec_conf);
+    auto pdata = std::make_shared<mpcd::ParticleData>(10000, box, 1.0, 42, 3, exec_conf);
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(sysdef, pdata);
+
+    auto thermo = std::make_shared<mpcd::CellThermoCompute>(mpcd_sys);
+    auto rand_thermo = std::make_shared<mpcd::CellThermoCompute>(mpcd_sys);
+    std::shared_ptr<::Variant> T = std::make_shared<::VariantConstant>(1.5);
+    auto collide = std::make_shared<mpcd::ATCollisionMethod>(mpcd_sys, 0, 1, -1, 42, thermo, rand_thermo, T);
+    collide->setEmbeddedGroup(std::make_shared<ParticleGroup>(sysdef, std::make_shared<ParticleFilterAll>()));
+
+    for (unsigned int timestep=0; timestep < 5; ++timestep)
+        collide->collide(timestep);
+
+    vel.clear();
+    ArrayHandle<mpcd::StorageScalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    for (unsigned int i=0; i < pdata->getN(); ++i)
+        vel.push_back(make_scalar3(h_vel.data[i].x, h_vel.data[i].y, h_vel.data[i].z));
+    ArrayHandle<Scalar4> h_vel_embed(sysdef->getParticleData()->getVelocities(), access_location::host, access_mode::read);
+    for (unsigned int i=0; i < sysdef->getParticleData()->getN(); ++i)
+        vel.push_back(make_scalar3(h_vel_embed.data[i].x, h_vel_embed.data[i].y, h_vel_embed.data[i].z));
+    }
+#endif // ENABLE_TBB
+
 //! basic test case for MPCD ATCollisionMethod class
 UP_TEST( at_collision_method_basic )
     {
@@ -187,6 +235,23 @@ UP_TEST( at_collision_method_embed )
     {
     at_collision_method_embed_test<mpcd::ATCollisionMethod>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU));
     }
+#ifdef ENABLE_TBB
+//! test that the random velocities drawn per particle tag do not depend on the number of threads
+UP_TEST( at_collision_method_threads )
+    {
+    std::vector<Scalar3> ref_vel, vel;
+    at_collision_method_run_threads(1, ref_vel);
+    at_collision_method_run_threads(4, vel);
+
+    UP_ASSERT_EQUAL(vel.size(), ref_vel.size());
+    for (unsigned int i=0; i < ref_vel.size(); ++i)
+        {
+        CHECK_SMALL(vel[i].x - ref_vel[i].x, tol_small);
+        CHECK_SMALL(vel[i].y - ref_vel[i].y, tol_small);
+        CHECK_SMALL(vel[i].z - ref_vel[i].z, tol_small);
+        }
+    }
+#endif // ENABLE_TBB
 #ifdef ENABLE_HIP
 //! basic test case for MPCD ATCollisionMethodGPU class
 UP_TEST( at_collision_method_basic_gpu )
@@ -148,8 +148,8 @@ void cell_thermo_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
     // switch a particle into a different cell, and make sure the DOF are reduced accordingly
     pdata_5->setMass(1.0);
         {
-        ArrayHandle<Scalar4> h_pos(pdata_5->getPositions(), access_location::host, access_mode::readwrite);
-        h_pos.data[2] = make_scalar4(-0.5, -0.5, -0.5, 0.0);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(pdata_5->getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[2] = mpcd::make_storage_scalar4(-0.5, -0.5, -0.5, 0.0);
         }
     thermo->compute(2);
         {
@@ -312,6 +312,69 @@ void cell_thermo_embed_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         }
     }
 
+//! Test that summing during the cell list build gives the same result as summing afterwards
+void cell_thermo_fused_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(4.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // scatter particles through the box with varying velocities
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->resize(200);
+        for (unsigned int i=0; i < 200; ++i)
+            {
+            mpcd_snap->position[i] = vec3<Scalar>(-1.99 + 0.0199*i,
+                                                  -1.99 + 0.0398*(i % 100),
+                                                  1.99 - 0.0597*(i % 67));
+            mpcd_snap->velocity[i] = vec3<Scalar>(0.1*(i % 7) - 0.3,
+                                                  0.01*i - 1.0,
+                                                  0.3*(i % 11) - 1.5);
+            }
+        }
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+
+    std::shared_ptr<mpcd::CellList> cl = mpcd_sys->getCellList();
+    std::shared_ptr<mpcd::CellThermoCompute> thermo = std::make_shared<mpcd::CellThermoCompute>(mpcd_sys);
+    AllThermoRequest thermo_req(thermo);
+
+    // first compute builds the cell list, so the sums come from the build
+    thermo->compute(0);
+    UP_ASSERT(cl->hasCellSums());
+    std::vector<double4> fused_vel, fused_energy;
+        {
+        ArrayHandle<double4> h_avg_vel(thermo->getCellVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<double3> h_cell_energy(thermo->getCellEnergies(), access_location::host, access_mode::read);
+        for (unsigned int i=0; i < cl->getNCells(); ++i)
+            {
+            fused_vel.push_back(h_avg_vel.data[i]);
+            fused_energy.push_back(make_double4(h_cell_energy.data[i].x, h_cell_energy.data[i].y, h_cell_energy.data[i].z, 0.0));
+            }
+        }
+
+    // forcing the compute at the same step reuses the cell list, so the sums come from the cell list
+    thermo->forceCompute(0);
+    UP_ASSERT(!cl->hasCellSums());
+        {
+        ArrayHandle<double4> h_avg_vel(thermo->getCellVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<double3> h_cell_energy(thermo->getCellEnergies(), access_location::host, access_mode::read);
+        for (unsigned int i=0; i < cl->getNCells(); ++i)
+            {
+            // results should be bitwise identical
+            UP_ASSERT_EQUAL(h_avg_vel.data[i].x, fused_vel[i].x);
+            UP_ASSERT_EQUAL(h_avg_vel.data[i].y, fused_vel[i].y);
+            UP_ASSERT_EQUAL(h_avg_vel.data[i].z, fused_vel[i].z);
+            UP_ASSERT_EQUAL(h_avg_vel.data[i].w, fused_vel[i].w);
+            UP_ASSERT_EQUAL(h_cell_energy.data[i].x, fused_energy[i].x);
+            UP_ASSERT_EQUAL(h_cell_energy.data[i].y, fused_energy[i].y);
+            UP_ASSERT_EQUAL(__double_as_int(h_cell_energy.data[i].z), __double_as_int(fused_energy[i].z));
+            }
+        }
+    }
+
 UP_TEST( mpcd_cell_thermo_basic )
     {
     cell_thermo_basic_test<mpcd::CellThermoCompute>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
@@ -320,6 +383,10 @@ UP_TEST( mpcd_cell_thermo_embed )
     {
     cell_thermo_embed_test<mpcd::CellThermoCompute>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+UP_TEST( mpcd_cell_thermo_fused )
+    {
+    cell_thermo_fused_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 
 #ifdef ENABLE_HIP
 UP_TEST( mpcd_cell_thermo_basic_gpu )
@@ -98,7 +98,7 @@ void sorter_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         UP_ASSERT_EQUAL(h_tag.data[7], 0);
 
         // positions should be in order now
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
         CHECK_CLOSE(h_pos.data[0].x, -0.5, tol); CHECK_CLOSE(h_pos.data[0].y, -0.5, tol); CHECK_CLOSE(h_pos.data[0].z, -0.5, tol);
         CHECK_CLOSE(h_pos.data[1].x,  0.5, tol); CHECK_CLOSE(h_pos.data[1].y, -0.5, tol); CHECK_CLOSE(h_pos.data[1].z, -0.5, tol);
         CHECK_CLOSE(h_pos.data[2].x, -0.5, tol); CHECK_CLOSE(h_pos.data[2].y,  0.5, tol); CHECK_CLOSE(h_pos.data[2].z, -0.5, tol);
@@ -108,17 +108,17 @@ void sorter_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         CHECK_CLOSE(h_pos.data[6].x, -0.5, tol); CHECK_CLOSE(h_pos.data[6].y,  0.5, tol); CHECK_CLOSE(h_pos.data[6].z,  0.5, tol);
         CHECK_CLOSE(h_pos.data[7].x,  0.5, tol); CHECK_CLOSE(h_pos.data[7].y,  0.5, tol); CHECK_CLOSE(h_pos.data[7].z,  0.5, tol);
         // types were set to the actual order of things
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[0].w), 0);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[1].w), 1);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[2].w), 2);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[3].w), 3);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[4].w), 4);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[5].w), 5);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[6].w), 6);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[7].w), 7);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[0].w), 0);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[1].w), 1);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[2].w), 2);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[3].w), 3);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[4].w), 4);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[5].w), 5);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[6].w), 6);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[7].w), 7);
 
         // velocities should also be sorted
-        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
         CHECK_CLOSE(h_vel.data[0].x, 0., tol); CHECK_CLOSE(h_vel.data[0].y, -0.5, tol); CHECK_CLOSE(h_vel.data[0].z, 0.5, tol);
         CHECK_CLOSE(h_vel.data[1].x, 1., tol); CHECK_CLOSE(h_vel.data[1].y, -1.5, tol); CHECK_CLOSE(h_vel.data[1].z, 1.5, tol);
         CHECK_CLOSE(h_vel.data[2].x, 2., tol); CHECK_CLOSE(h_vel.data[2].y, -2.5, tol); CHECK_CLOSE(h_vel.data[2].z, 2.5, tol);
@@ -128,14 +128,14 @@ void sorter_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         CHECK_CLOSE(h_vel.data[6].x, 6., tol); CHECK_CLOSE(h_vel.data[6].y, -6.5, tol); CHECK_CLOSE(h_vel.data[6].z, 6.5, tol);
         CHECK_CLOSE(h_vel.data[7].x, 7., tol); CHECK_CLOSE(h_vel.data[7].y, -7.5, tol); CHECK_CLOSE(h_vel.data[7].z, 7.5, tol);
         // cells should be in the right order now too
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[0].w), 0);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[1].w), 1);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[2].w), 2);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[3].w), 3);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[4].w), 4);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[5].w), 5);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[6].w), 6);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[7].w), 7);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[0].w), 0);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[1].w), 1);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[2].w), 2);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[3].w), 3);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[4].w), 4);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[5].w), 5);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[6].w), 6);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[7].w), 7);
         }
 
     // check that the cell list has been updated as well
@@ -222,16 +222,16 @@ void sorter_virtual_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
     auto pdata = mpcd_sys->getParticleData();
     pdata->addVirtualParticles(2);
         {
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::readwrite);
 
-        h_pos.data[pdata->getN()+0] = make_scalar4(0.5,-0.5,-0.5,__int_as_scalar(1));
-        h_vel.data[pdata->getN()+0] = make_scalar4(1., -1.5, 1.5,__int_as_scalar(mpcd::detail::NO_CELL));
+        h_pos.data[pdata->getN()+0] = mpcd::make_storage_scalar4(0.5,-0.5,-0.5,mpcd::int_as_storage(1));
+        h_vel.data[pdata->getN()+0] = mpcd::make_storage_scalar4(1., -1.5, 1.5,mpcd::int_as_storage(mpcd::detail::NO_CELL));
         h_tag.data[pdata->getN()+0] = 6;
 
-        h_pos.data[pdata->getN()+1] = make_scalar4(0.5, 0.5,-0.5,__int_as_scalar(3));
-        h_vel.data[pdata->getN()+1] = make_scalar4(3., -3.5, 3.5,__int_as_scalar(mpcd::detail::NO_CELL));
+        h_pos.data[pdata->getN()+1] = mpcd::make_storage_scalar4(0.5, 0.5,-0.5,mpcd::int_as_storage(3));
+        h_vel.data[pdata->getN()+1] = mpcd::make_storage_scalar4(3., -3.5, 3.5,mpcd::int_as_storage(mpcd::detail::NO_CELL));
         h_tag.data[pdata->getN()+1] = 7;
         }
 
@@ -254,7 +254,7 @@ void sorter_virtual_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         UP_ASSERT_EQUAL(h_tag.data[7], 7);
 
         // positions should be in order now, with virtual particles at the end unsorted
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
         CHECK_CLOSE(h_pos.data[0].x, -0.5, tol); CHECK_CLOSE(h_pos.data[0].y, -0.5, tol); CHECK_CLOSE(h_pos.data[0].z, -0.5, tol);
         CHECK_CLOSE(h_pos.data[1].x, -0.5, tol); CHECK_CLOSE(h_pos.data[1].y,  0.5, tol); CHECK_CLOSE(h_pos.data[1].z, -0.5, tol);
         CHECK_CLOSE(h_pos.data[2].x, -0.5, tol); CHECK_CLOSE(h_pos.data[2].y, -0.5, tol); CHECK_CLOSE(h_pos.data[2].z,  0.5, tol);
@@ -266,18 +266,18 @@ void sorter_virtual_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         CHECK_CLOSE(h_pos.data[7].x,  0.5, tol); CHECK_CLOSE(h_pos.data[7].y,  0.5, tol); CHECK_CLOSE(h_pos.data[7].z, -0.5, tol);
 
         // types were set to the actual order of things
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[0].w), 0);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[1].w), 2);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[2].w), 4);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[3].w), 5);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[4].w), 6);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[5].w), 7);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[0].w), 0);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[1].w), 2);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[2].w), 4);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[3].w), 5);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[4].w), 6);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[5].w), 7);
         // VPs
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[6].w), 1);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[7].w), 3);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[6].w), 1);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_pos.data[7].w), 3);
 
         // velocities should also be sorted
-        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
         CHECK_CLOSE(h_vel.data[0].x, 0., tol); CHECK_CLOSE(h_vel.data[0].y, -0.5, tol); CHECK_CLOSE(h_vel.data[0].z, 0.5, tol);
         CHECK_CLOSE(h_vel.data[1].x, 2., tol); CHECK_CLOSE(h_vel.data[1].y, -2.5, tol); CHECK_CLOSE(h_vel.data[1].z, 2.5, tol);
         CHECK_CLOSE(h_vel.data[2].x, 4., tol); CHECK_CLOSE(h_vel.data[2].y, -4.5, tol); CHECK_CLOSE(h_vel.data[2].z, 4.5, tol);
@@ -288,15 +288,15 @@ void sorter_virtual_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         CHECK_CLOSE(h_vel.data[6].x, 1., tol); CHECK_CLOSE(h_vel.data[6].y, -1.5, tol); CHECK_CLOSE(h_vel.data[6].z, 1.5, tol);
         CHECK_CLOSE(h_vel.data[7].x, 3., tol); CHECK_CLOSE(h_vel.data[7].y, -3.5, tol); CHECK_CLOSE(h_vel.data[7].z, 3.5, tol);
         // cells should be in the right order now too
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[0].w), 0);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[1].w), 2);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[2].w), 4);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[3].w), 5);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[4].w), 6);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[5].w), 7);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[0].w), 0);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[1].w), 2);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[2].w), 4);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[3].w), 5);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[4].w), 6);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[5].w), 7);
         // VPs
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[6].w), 1);
-        UP_ASSERT_EQUAL(__scalar_as_int(h_vel.data[7].w), 3);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[6].w), 1);
+        UP_ASSERT_EQUAL(mpcd::storage_as_int(h_vel.data[7].w), 3);
         }
 
     // check that the cell list has been updated as well
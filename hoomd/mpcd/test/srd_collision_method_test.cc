@@ -70,7 +70,7 @@ void srd_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exe
     UP_ASSERT(!collide->peekCollide(0));
     collide->collide(0);
         {
-        ArrayHandle<Scalar4> h_vel(pdata_4->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(pdata_4->getVelocities(), access_location::host, access_mode::read);
         for (unsigned int i=0; i < pdata_4->getN(); ++i)
             {
             CHECK_CLOSE(h_vel.data[i].x, orig_vel[i].x, tol_small);
@@ -95,7 +95,7 @@ void srd_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exe
     UP_ASSERT(collide->peekCollide(1));
     collide->collide(1);
         {
-        ArrayHandle<Scalar4> h_vel(pdata_4->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(pdata_4->getVelocities(), access_location::host, access_mode::read);
         ArrayHandle<double3> h_rotvec(collide->getRotationVectors(), access_location::host, access_mode::read);
 
         for (unsigned int i=0; i < pdata_4->getN(); ++i)
@@ -115,7 +115,7 @@ void srd_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exe
                 }
 
             // all rotation vectors should be unit norm
-            const unsigned int cell = __scalar_as_int(h_vel.data[i].w);
+            const unsigned int cell = mpcd::storage_as_int(h_vel.data[i].w);
             const Scalar3 rot_vec = make_scalar3(h_rotvec.data[cell].x, h_rotvec.data[cell].y, h_rotvec.data[cell].z);
             CHECK_CLOSE(dot(rot_vec,rot_vec), 1.0, tol_small);
 
@@ -368,6 +368,53 @@ void srd_collision_method_thermostat_test(std::shared_ptr<ExecutionConfiguration
         }
     }
 
+#ifdef ENABLE_TBB
+//! Collide a thermostatted system with embedded particles using a given number of threads
+/*!
+ * \param num_threads Number of threads to collide with
+ * \param vel Velocities of the MPCD particles, then of the embedded particles, after the collisions
+ */
+void srd_collision_method_run_threads(unsigned int num_threads, std::vector<Scalar3>& vel)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    exec_conf->setNumThreads(num_threads);
+
+    const BoxDim box(10.0);
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = box;
+    snap->particle_data.type_mapping.push_back("A");
+        {
+        SnapshotParticleData<Scalar>& pdata_snap = snap->particle_data;
+        pdata_snap.resize(100);
+        for (unsigned int i=0; i < pdata_snap.size; ++i)
+            {
+            pdata_snap.pos[i] = vec3<Scalar>(-4.95 + 0.1*i, 4.95 - 0.1*i, -4.95 + 0.07*i);
+            pdata_snap.vel[i] = vec3<Scalar>(0.01*i, -0.02*i, 0.5);
+            pdata_snap.mass[i] = 2.0;
+            }
+        }
+    auto sysdef = std::make_shared<SystemDefinition>(snap, exec_conf);
+    auto pdata = std::make_shared<mpcd::ParticleData>(10000, box, 1.0, 42, 3, exec_conf);
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(sysdef, pdata);
+
+    auto thermo = std::make_shared<mpcd::CellThermoCompute>(mpcd_sys);
+    auto collide = std::make_shared<mpcd::SRDCollisionMethod>(mpcd_sys, 0, 1, -1, 827, thermo);
+    collide->setTemperature(std::make_shared<::VariantConstant>(2.0));
+    collide->setEmbeddedGroup(std::make_shared<ParticleGroup>(sysdef, std::make_shared<ParticleFilterAll>()));
+
+    for (unsigned int timestep=0; timestep < 5; ++timestep)
+        collide->collide(timestep);
+
+    vel.clear();
+    ArrayHandle<mpcd::StorageScalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    for (unsigned int i=0; i < pdata->getN(); ++i)
+        vel.push_back(make_scalar3(h_vel.data[i].x, h_vel.data[i].y, h_vel.data[i].z));
+    ArrayHandle<Scalar4> h_vel_embed(sysdef->getParticleData()->getVelocities(), access_location::host, access_mode::read);
+    for (unsigned int i=0; i < sysdef->getParticleData()->getN(); ++i)
+        vel.push_back(make_scalar3(h_vel_embed.data[i].x, h_vel_embed.data[i].y, h_vel_embed.data[i].z));
+    }
+#endif // ENABLE_TBB
+
 //! basic test case for MPCD SRDCollisionMethod class
 UP_TEST( srd_collision_method_basic )
     {
@@ -387,6 +434,23 @@ UP_TEST( srd_collision_method_thermostat )
     {
     srd_collision_method_thermostat_test<mpcd::SRDCollisionMethod>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU));
     }
+#ifdef ENABLE_TBB
+//! test that the rotation vectors, thermostat factors, and rotations do not depend on the number of threads
+UP_TEST( srd_collision_method_threads )
+    {
+    std::vector<Scalar3> ref_vel, vel;
+    srd_collision_method_run_threads(1, ref_vel);
+    srd_collision_method_run_threads(4, vel);
+
+    UP_ASSERT_EQUAL(vel.size(), ref_vel.size());
+    for (unsigned int i=0; i < ref_vel.size(); ++i)
+        {
+        CHECK_SMALL(vel[i].x - ref_vel[i].x, tol_small);
+        CHECK_SMALL(vel[i].y - ref_vel[i].y, tol_small);
+        CHECK_SMALL(vel[i].z - ref_vel[i].z, tol_small);
+        }
+    }
+#endif // ENABLE_TBB
 #ifdef ENABLE_HIP
 //! basic test case for MPCD SRDCollisionMethodGPU class
 UP_TEST( srd_collision_method_basic_gpu )
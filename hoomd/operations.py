@@ -194,14 +194,15 @@ class Operations(Collection):
         sim = self._simulation
         if not (self.integrator is None or self.integrator._attached):
             self.integrator._attach()
+        # attach the computes first, writers may use their C++ objects
+        if not self.computes._synced:
+            self.computes._sync(sim, sim._cpp_sys.computes)
         if not self.updaters._synced:
             self.updaters._sync(sim, sim._cpp_sys.updaters)
         if not self.writers._synced:
             self.writers._sync(sim, sim._cpp_sys.analyzers)
         if not self.tuners._synced:
             self.tuners._sync(sim, sim._cpp_sys.tuners)
-        if not self.computes._synced:
-            self.computes._sync(sim, sim._cpp_sys.computes)
         self._scheduled = True
 
     def _unschedule(self):
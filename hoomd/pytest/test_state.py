@@ -211,3 +211,30 @@ def test_thermalize_angular_momentum(simulation_factory,
         # too large for an allclose check.
         expected_K = (3 * snap.particles.N) / 2 * 1.5
         assert K > expected_K * 3 / 4 and K < expected_K * 4 / 3
+
+
+def test_distributed_groups(simulation_factory, lattice_snapshot_factory):
+    n = 7
+    snap = lattice_snapshot_factory(particle_types=['A', 'B'], n=n)
+    if snap.exists:
+        snap.particles.typeid[:] = numpy.arange(snap.particles.N) % 2
+
+    sim = simulation_factory(snap)
+    assert not sim.state.distributed_groups
+    sim.state.distributed_groups = True
+
+    # distributed groups select the same particles as the default groups
+    group = sim.state._get_group(hoomd.filter.Type(['B']))
+    reference = hoomd._hoomd.ParticleGroup(sim.state._cpp_sys_def,
+                                           hoomd.filter.Type(['B']))
+    assert group.isDistributed()
+    assert not reference.isDistributed()
+    assert group.getNumMembersGlobal() == n**3 // 2
+    assert group.getNumMembersGlobal() == reference.getNumMembersGlobal()
+    for i in range(group.getNumMembersGlobal()):
+        assert group.getMemberTag(i) == reference.getMemberTag(i)
+
+    # the mode cannot change once groups exist
+    with pytest.raises(RuntimeError):
+        sim.state.distributed_groups = False
+    sim.state.distributed_groups = True
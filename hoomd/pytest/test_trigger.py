@@ -4,6 +4,8 @@
 
 """Test the Trigger classes."""
 
+import math
+
 import hoomd
 import hoomd.trigger
 
@@ -220,3 +222,70 @@ def test_custom():
     assert hoomd._hoomd._test_trigger_call(c, 9)
     assert hoomd._hoomd._test_trigger_call(c, 250000000000)
     assert not hoomd._hoomd._test_trigger_call(c, 250000000001)
+
+
+def _check_next_firing_step(trigger, steps):
+    """Check that no step before next_firing_step activates the trigger."""
+    for step in steps:
+        next_step = trigger.next_firing_step(step)
+        assert next_step >= step
+        assert not any(trigger(i) for i in range(step, min(next_step, steps[-1])))
+
+
+def test_next_firing_step():
+    """Test the look ahead of the native triggers."""
+    never = 2**64 - 1
+
+    a = hoomd.trigger.Periodic(period=456, phase=18)
+    assert a.next_firing_step(18) == 18
+    assert a.next_firing_step(19) == 474
+    assert a.next_firing_step(10000000000) == 10000000218
+    _check_next_firing_step(a, range(0, 2000))
+
+    b = hoomd.trigger.Before(1000)
+    assert b.next_firing_step(10) == 10
+    assert b.next_firing_step(1000) == never
+
+    c = hoomd.trigger.On(1000)
+    assert c.next_firing_step(10) == 1000
+    assert c.next_firing_step(1000) == 1000
+    assert c.next_firing_step(1001) == never
+
+    d = hoomd.trigger.After(1000)
+    assert d.next_firing_step(10) == 1001
+    assert d.next_firing_step(2000) == 2000
+
+    e = hoomd.trigger.Or([c, hoomd.trigger.Periodic(300)])
+    assert e.next_firing_step(901) == 1000
+    assert e.next_firing_step(1001) == 1200
+
+    f = hoomd.trigger.And([a, d])
+    assert f.next_firing_step(0) == 1386
+    _check_next_firing_step(f, range(0, 2000))
+
+    g = hoomd.trigger.Not(a)
+    _check_next_firing_step(g, range(0, 2000))
+
+
+def test_custom_next_firing_step():
+    """Test look ahead in custom triggers."""
+    class CustomTrigger(hoomd.trigger.Trigger):
+
+        def __init__(self):
+            hoomd.trigger.Trigger.__init__(self)
+
+        def compute(self, timestep):
+            return (timestep**(1 / 2)).is_integer()
+
+    class LookAheadTrigger(CustomTrigger):
+
+        def next_firing_step(self, timestep):
+            return math.ceil(timestep**(1 / 2))**2
+
+    # by default, custom triggers make no prediction
+    c = CustomTrigger()
+    assert hoomd._hoomd._test_trigger_next_firing_step(c, 5) == 5
+
+    d = LookAheadTrigger()
+    assert hoomd._hoomd._test_trigger_next_firing_step(d, 5) == 9
+    assert hoomd._hoomd._test_trigger_next_firing_step(d, 16) == 16
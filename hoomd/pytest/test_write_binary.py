@@ -0,0 +1,60 @@
+import numpy as np
+import pytest
+
+import hoomd
+import hoomd.write
+
+
+@pytest.fixture
+def logger():
+    logger = hoomd.logging.Logger(flags=['scalar', 'sequence'])
+    logger[('dummy', 'loggable', 'int')] = (lambda: 42000000, 'scalar')
+    logger[('dummy', 'loggable', 'float')] = (lambda: 3.1415, 'scalar')
+    logger[('dummy', 'loggable', 'sequence')] = (lambda: [[1., 2., 3.],
+                                                          [4., 5., 6.]],
+                                                 'sequence')
+    return logger
+
+
+def test_attributes(tmp_path, logger):
+    filename = str(tmp_path / 'log.bin')
+    binary = hoomd.write.Binary(filename, 10, logger, buffer_size=7)
+    assert binary.filename == filename
+    assert binary.buffer_size == 7
+    assert not binary.overwrite
+    assert binary.logger is logger
+
+
+def test_invalid_logger():
+    logger = hoomd.logging.Logger(flags=['scalar', 'string'])
+    with pytest.raises(ValueError):
+        hoomd.write.Binary('log.bin', 10, logger)
+
+
+@pytest.mark.serial
+def test_write(simulation_factory, two_particle_snapshot_factory, tmp_path,
+               logger):
+    filename = str(tmp_path / 'log.bin')
+    sim = simulation_factory(two_particle_snapshot_factory())
+    binary = hoomd.write.Binary(filename, 1, logger, buffer_size=10,
+                                overwrite=True)
+    sim.operations.writers.append(binary)
+    sim.run(25)
+
+    # the rows of the last partial block are written on flush
+    binary.flush()
+    data = hoomd.write.Binary.read(filename)
+    assert list(data['timestep']) == list(range(1, 26))
+    assert np.all(data['dummy/loggable/int'] == 42000000)
+    assert np.allclose(data['dummy/loggable/float'], 3.1415)
+    assert data['dummy/loggable/sequence'].shape == (25, 2, 3)
+    assert np.all(data['dummy/loggable/sequence'][:, 1, 2] == 6.)
+
+    # appending continues the file and removing the writer flushes it
+    sim.operations.writers.remove(binary)
+    binary = hoomd.write.Binary(filename, 1, logger, buffer_size=10)
+    sim.operations.writers.append(binary)
+    sim.run(3)
+    sim.operations.writers.remove(binary)
+    data = hoomd.write.Binary.read(filename)
+    assert list(data['timestep']) == list(range(1, 29))
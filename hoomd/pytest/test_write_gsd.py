@@ -0,0 +1,152 @@
+import numpy as np
+import pytest
+
+import hoomd
+import hoomd.write
+
+
+def test_precision():
+    gsd = hoomd.write.GSD('traj.gsd', 10,
+                          precision=dict(position=1e-3, velocity=0.01))
+    assert gsd.precision == dict(position=1e-3, velocity=0.01)
+    assert hoomd.write.GSD('traj.gsd', 10).precision == dict()
+
+    with pytest.raises(ValueError):
+        hoomd.write.GSD('traj.gsd', 10, precision=dict(mass=1e-3))
+    with pytest.raises(ValueError):
+        hoomd.write.GSD('traj.gsd', 10, precision=dict(position=0))
+
+
+@pytest.mark.serial
+def test_quantized(simulation_factory, two_particle_snapshot_factory,
+                   tmp_path):
+    filename = str(tmp_path / 'traj.gsd')
+    snapshot = two_particle_snapshot_factory(d=1.2345)
+    snapshot.particles.velocity[:] = [[0.1234, -2.5, 0], [0, 0, 3.75]]
+    sim = simulation_factory(snapshot)
+    gsd = hoomd.write.GSD(filename, 1, dynamic=['momentum'], overwrite=True,
+                          precision=dict(position=1e-3, velocity=1e-2))
+    sim.operations.writers.append(gsd)
+    sim.run(5)
+    gsd.flush()
+
+    for frame in [0, 2, -1]:
+        position = hoomd.write.GSD.read_chunk(filename, 'particles/position',
+                                              frame)
+        np.testing.assert_allclose(position, snapshot.particles.position,
+                                   atol=0.5e-3 + 1e-6)
+        velocity = hoomd.write.GSD.read_chunk(filename, 'particles/velocity',
+                                              frame)
+        np.testing.assert_allclose(velocity, snapshot.particles.velocity,
+                                   atol=0.5e-2 + 1e-6)
+
+    # removing the writer completes the last frame
+    sim.operations.writers.remove(gsd)
+    sim_read = hoomd.Simulation(sim.device)
+    sim_read.create_state_from_gsd(filename)
+    assert sim_read.timestep == sim.timestep
+    np.testing.assert_allclose(sim_read.state.snapshot.particles.position,
+                               snapshot.particles.position,
+                               atol=0.5e-3 + 1e-6)
+
+
+def test_sparse():
+    gsd = hoomd.write.GSD('traj.gsd', 10, sparse=dict(position=0.1, angmom=0),
+                          keyframe_interval=20)
+    assert gsd.sparse == dict(position=0.1, angmom=0)
+    assert gsd.keyframe_interval == 20
+    assert hoomd.write.GSD('traj.gsd', 10).sparse == dict()
+
+    with pytest.raises(ValueError):
+        hoomd.write.GSD('traj.gsd', 10, sparse=dict(image=0))
+    with pytest.raises(ValueError):
+        hoomd.write.GSD('traj.gsd', 10, sparse=dict(position=-1))
+    with pytest.raises(ValueError):
+        hoomd.write.GSD('traj.gsd', 10, keyframe_interval=0)
+
+
+@pytest.mark.serial
+def test_sparse_frames(simulation_factory, two_particle_snapshot_factory,
+                       tmp_path):
+    filename = str(tmp_path / 'traj.gsd')
+    snapshot = two_particle_snapshot_factory(d=1.2345)
+    snapshot.particles.velocity[:] = [[0.5, 0, 0], [0, 0, 0]]
+    sim = simulation_factory(snapshot)
+    sim.operations.integrator = hoomd.md.Integrator(
+        dt=0.1, methods=[hoomd.md.methods.NVE(filter=hoomd.filter.All())])
+    gsd = hoomd.write.GSD(filename, 1, overwrite=True,
+                          sparse=dict(position=0.01), keyframe_interval=4)
+    sim.operations.writers.append(gsd)
+    sim.run(6)
+    sim.operations.writers.remove(gsd)
+
+    # only the first particle moves, frames 5 and 6 follow the key frame 4
+    for frame in range(7):
+        position = hoomd.write.GSD.read_chunk(filename, 'particles/position',
+                                              frame)
+        expected = np.array(snapshot.particles.position)
+        expected[0, 0] += 0.05 * frame
+        np.testing.assert_allclose(position, expected, atol=1e-5)
+
+
+@pytest.mark.serial
+def test_quantized_error(simulation_factory, two_particle_snapshot_factory,
+                         tmp_path):
+    filename = str(tmp_path / 'traj.gsd')
+    snapshot = two_particle_snapshot_factory(d=1.2345)
+    sim = simulation_factory(snapshot)
+    gsd = hoomd.write.GSD(filename, 1, overwrite=True,
+                          precision=dict(position=1e-30))
+    sim.operations.writers.append(gsd)
+    sim.run(1)
+
+    # the encoding error is raised when the frame is completed
+    with pytest.raises(RuntimeError):
+        gsd.flush()
+
+    # the frame is written with the float chunks
+    position = hoomd.write.GSD.read_chunk(filename, 'particles/position', -1)
+    np.testing.assert_allclose(position, snapshot.particles.position,
+                               rtol=1e-6)
+
+
+@pytest.mark.serial
+def test_quantized_schema(simulation_factory, two_particle_snapshot_factory,
+                          tmp_path):
+    gsd_hoomd = pytest.importorskip('gsd.hoomd')
+    filename = str(tmp_path / 'traj.gsd')
+    sim = simulation_factory(two_particle_snapshot_factory())
+    gsd = hoomd.write.GSD(filename, 1, overwrite=True,
+                          precision=dict(position=1e-3))
+    sim.operations.writers.append(gsd)
+    sim.run(2)
+    sim.operations.writers.remove(gsd)
+
+    # readers that do not decode the quantized chunks reject the file
+    with pytest.raises(RuntimeError):
+        gsd_hoomd.open(filename, 'rb')
+
+    # quantized frames cannot be appended to a file that other readers read
+    plain = str(tmp_path / 'plain.gsd')
+    hoomd.write.GSD.write(sim.state, plain)
+    gsd = hoomd.write.GSD(plain, 1, precision=dict(position=1e-3))
+    sim.operations.writers.append(gsd)
+    with pytest.raises(RuntimeError):
+        sim.run(1)
+
+
+@pytest.mark.serial
+def test_sparse_schema(simulation_factory, two_particle_snapshot_factory,
+                       tmp_path):
+    gsd_hoomd = pytest.importorskip('gsd.hoomd')
+    filename = str(tmp_path / 'traj.gsd')
+    sim = simulation_factory(two_particle_snapshot_factory())
+    gsd = hoomd.write.GSD(filename, 1, overwrite=True,
+                          sparse=dict(position=0.01))
+    sim.operations.writers.append(gsd)
+    sim.run(2)
+    sim.operations.writers.remove(gsd)
+
+    # readers that do not reconstruct the sparse frames reject the file
+    with pytest.raises(RuntimeError):
+        gsd_hoomd.open(filename, 'rb')
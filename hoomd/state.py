@@ -83,6 +83,7 @@ class State:
         # The first layer is to prevent user created filters with poorly implemented
         # __hash__ and __eq__ from causing cache errors.
         self._groups = defaultdict(dict)
+        self._distributed_groups = False
 
     @property
     def snapshot(self):
@@ -247,12 +248,40 @@ class State:
     def replicate(self):  # noqa: D102
         raise NotImplementedError
 
+    @property
+    def distributed_groups(self):
+        """bool: Store group membership with the particles.
+
+        When `True`, the groups of particles selected by filters mark their
+        members with per-particle flags that migrate with the particles
+        between MPI ranks, instead of storing the list of all member tags on
+        every rank. The global number of members is then computed by a
+        reduction, and the member tags are only gathered when requested. Use
+        this to reduce the memory use and communication of groups in large
+        MPI simulations. At most 32 groups may exist in this mode.
+
+        Set `distributed_groups` before adding any operations to the
+        simulation, it cannot be changed once groups have been created.
+        """
+        return self._distributed_groups
+
+    @distributed_groups.setter
+    def distributed_groups(self, value):
+        value = bool(value)
+        if value != self._distributed_groups and any(
+                len(groups) > 0 for groups in self._groups.values()):
+            raise RuntimeError(
+                "Cannot set distributed_groups after groups have been "
+                "created.")
+        self._distributed_groups = value
+
     def _get_group(self, filter_):
         cls = filter_.__class__
         if filter_ in self._groups[cls]:
             return self._groups[cls][filter_]
         else:
-            group = _hoomd.ParticleGroup(self._cpp_sys_def, filter_)
+            group = _hoomd.ParticleGroup(self._cpp_sys_def, filter_, True,
+                                         self._distributed_groups)
             self._groups[cls][filter_] = group
             return group
 
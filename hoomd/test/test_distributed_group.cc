@@ -0,0 +1,111 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#ifdef ENABLE_MPI
+
+// this has to be included after naming the test module
+#include "upp11_config.h"
+HOOMD_UP_MAIN();
+
+#include <memory>
+#include <vector>
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/Communicator.h"
+#include "hoomd/ParticleGroup.h"
+#include "hoomd/filter/ParticleFilterTags.h"
+
+/*! \file test_distributed_group.cc
+    \brief Unit tests for distributed ParticleGroups with domain decomposition
+    \ingroup unit_tests
+*/
+
+using namespace std;
+
+//! Check the local and global members of a group that selects every third tag
+void check_members(std::shared_ptr<ParticleGroup> group, std::shared_ptr<ParticleData> pdata, unsigned int N)
+    {
+    UP_ASSERT_EQUAL(group->getNumMembersGlobal(), (N+2)/3);
+
+    unsigned int n_local = 0;
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    for (unsigned int idx = 0; idx < pdata->getN(); idx++)
+        {
+        bool member = h_tag.data[idx] % 3 == 0;
+        UP_ASSERT_EQUAL(group->isMember(idx), member);
+        if (member)
+            n_local++;
+        }
+    UP_ASSERT_EQUAL(group->getNumMembers(), n_local);
+
+    for (unsigned int i = 0; i < group->getNumMembers(); i++)
+        UP_ASSERT_EQUAL(h_tag.data[group->getMemberIndex(i)] % 3, 0u);
+    }
+
+//! Check that the members of distributed groups keep their group flags when they migrate between ranks
+UP_TEST( distributed_group_migrate )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+
+    // this test needs to be run on two processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size, 2);
+
+    const unsigned int N = 100;
+    const Scalar L = 10.0;
+    auto sysdef = std::make_shared<SystemDefinition>(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf);
+    auto pdata = sysdef->getParticleData();
+
+    // a row of particles along x in each of the two domains
+    for (unsigned int tag = 0; tag < N; tag++)
+        {
+        Scalar x = -Scalar(0.45)*L + Scalar(0.9)*L*(Scalar(tag) + Scalar(0.5))/Scalar(N);
+        pdata->setPosition(tag, make_scalar3(x, 0.01*(tag % 10), 0.0), false);
+        }
+
+    // split the box along x
+    SnapshotParticleData<Scalar> snap(N);
+    pdata->takeSnapshot(snap);
+    auto decomposition = std::make_shared<DomainDecomposition>(exec_conf, pdata->getBox().getL(), 2, 1, 1);
+    auto comm = std::make_shared<Communicator>(sysdef, decomposition);
+    pdata->setDomainDecomposition(decomposition);
+    pdata->initializeFromSnapshot(snap);
+    UP_ASSERT_EQUAL(pdata->getN(), N/2);
+
+    // the selection is only applied when the group is constructed, membership afterwards is carried by the flags
+    std::vector<unsigned int> tags;
+    for (unsigned int tag = 0; tag < N; tag += 3)
+        tags.push_back(tag);
+    auto filter = std::make_shared<ParticleFilterTags>(tags);
+    auto static_group = std::make_shared<ParticleGroup>(sysdef, filter, false, true);
+    auto updated_group = std::make_shared<ParticleGroup>(sysdef, filter, true, true);
+    UP_ASSERT(static_group->isDistributed());
+    check_members(static_group, pdata, N);
+    check_members(updated_group, pdata, N);
+
+    // move the particles into the other domain, the lower domain has the particles with the higher tags after that
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        for (unsigned int idx = 0; idx < pdata->getN(); idx++)
+            h_pos.data[idx].x = -h_pos.data[idx].x;
+        }
+    comm->migrateParticles();
+    UP_ASSERT_EQUAL(pdata->getN(), N/2);
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        for (unsigned int idx = 0; idx < pdata->getN(); idx++)
+            UP_ASSERT_EQUAL(h_tag.data[idx] >= N/2, exec_conf->getRank() == 0);
+        }
+    check_members(static_group, pdata, N);
+    check_members(updated_group, pdata, N);
+
+    // the flags are also kept when the system is restored from a snapshot
+    pdata->takeSnapshot(snap);
+    pdata->initializeFromSnapshot(snap);
+    check_members(static_group, pdata, N);
+    check_members(updated_group, pdata, N);
+    }
+
+#endif //ENABLE_MPI
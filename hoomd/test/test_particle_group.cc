@@ -11,11 +11,18 @@
 */
 
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <random>
 
 #include "hoomd/ParticleData.h"
 #include "hoomd/Initializers.h"
 #include "hoomd/ParticleGroup.h"
+#include "hoomd/SFCPackTuner.h"
+#include "hoomd/filter/ParticleFilterAll.h"
+#include "hoomd/filter/ParticleFilterTags.h"
+#include "hoomd/filter/ParticleFilterType.h"
 
 using namespace std;
 
@@ -230,7 +237,7 @@ UP_TEST( ParticleGroup_type_test )
     std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
 
     // create a group of type 0 and check it
-    std::shared_ptr<ParticleFilter> selector0(new ParticleFilterType(0, 0));
+    std::shared_ptr<ParticleFilter> selector0(new ParticleFilterType({"A"}));
     ParticleGroup type0(sysdef, selector0);
     CHECK_EQUAL_UINT(type0.getNumMembers(), 4);
     CHECK_EQUAL_UINT(type0.getIndexArray().getNumElements(), 4);
@@ -241,7 +248,7 @@ UP_TEST( ParticleGroup_type_test )
     CHECK_EQUAL_UINT(type0.getMemberTag(3), 8);
 
     // create a group of type 1 and check it
-    std::shared_ptr<ParticleFilter> selector1(new ParticleFilterType(1, 1));
+    std::shared_ptr<ParticleFilter> selector1(new ParticleFilterType({"B"}));
     ParticleGroup type1(sysdef, selector1);
     CHECK_EQUAL_UINT(type1.getNumMembers(), 2);
     CHECK_EQUAL_UINT(type1.getIndexArray().getNumElements(), 2);
@@ -249,7 +256,7 @@ UP_TEST( ParticleGroup_type_test )
     CHECK_EQUAL_UINT(type1.getMemberTag(1), 6);
 
     // create a group of type 2 and check it
-    std::shared_ptr<ParticleFilter> selector2(new ParticleFilterType(2, 2));
+    std::shared_ptr<ParticleFilter> selector2(new ParticleFilterType({"C"}));
     ParticleGroup type2(sysdef, selector2);
     CHECK_EQUAL_UINT(type2.getNumMembers(), 2);
     CHECK_EQUAL_UINT(type2.getIndexArray().getNumElements(), 2);
@@ -257,7 +264,7 @@ UP_TEST( ParticleGroup_type_test )
     CHECK_EQUAL_UINT(type2.getMemberTag(1), 7);
 
     // create a group of type 3 and check it
-    std::shared_ptr<ParticleFilter> selector3(new ParticleFilterType(3, 3));
+    std::shared_ptr<ParticleFilter> selector3(new ParticleFilterType({"D"}));
     ParticleGroup type3(sysdef, selector3);
     CHECK_EQUAL_UINT(type3.getNumMembers(), 2);
     CHECK_EQUAL_UINT(type3.getIndexArray().getNumElements(), 2);
@@ -265,7 +272,7 @@ UP_TEST( ParticleGroup_type_test )
     CHECK_EQUAL_UINT(type3.getMemberTag(1), 9);
 
     // create a group of all types and check it
-    std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterType(0, 3));
+    std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterType({"A", "B", "C", "D"}));
     ParticleGroup alltypes(sysdef, selector_all);
     CHECK_EQUAL_UINT(alltypes.getNumMembers(), 10);
     CHECK_EQUAL_UINT(alltypes.getIndexArray().getNumElements(), 10);
@@ -279,9 +286,9 @@ UP_TEST( ParticleGroup_empty_test )
     std::shared_ptr<SystemDefinition> sysdef = create_sysdef();
     std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
 
-    // create a group of type 100 and check it
-    std::shared_ptr<ParticleFilter> selector100(new ParticleFilterType(100, 100));
-    ParticleGroup empty(sysdef, selector100);
+    // create a group of no types and check it
+    std::shared_ptr<ParticleFilter> selector_none(new ParticleFilterType(std::unordered_set<std::string>()));
+    ParticleGroup empty(sysdef, selector_none);
     CHECK_EQUAL_UINT(empty.getNumMembers(), 0);
     CHECK_EQUAL_UINT(empty.getIndexArray().getNumElements(), 0);
     }
@@ -387,7 +394,7 @@ UP_TEST( ParticleGroup_boolean_tests)
     std::shared_ptr<ParticleGroup> tags04(new ParticleGroup(sysdef, selector04));
 
     // create a group of type 0
-    std::shared_ptr<ParticleFilter> selector0(new ParticleFilterType(0, 0));
+    std::shared_ptr<ParticleFilter> selector0(new ParticleFilterType({"A"}));
     std::shared_ptr<ParticleGroup> type0(new ParticleGroup(sysdef, selector0));
 
     // make a union of the two groups and check it
@@ -451,3 +458,127 @@ UP_TEST( ParticleGroup_center_of_mass_tests)
     MY_CHECK_CLOSE(com.y, -3.25, tol);
     MY_CHECK_CLOSE(com.z, 3.875, tol);
     }
+
+//! Check that distributed particle groups follow their members through sorts and particle number changes
+UP_TEST( ParticleGroup_distributed_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    const unsigned int N = 1000;
+    const Scalar L = 20.0;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<Scalar> uniform(-L/Scalar(2.0), L/Scalar(2.0));
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < N; i++)
+            h_pos.data[i] = make_scalar4(uniform(rng), uniform(rng), uniform(rng), __int_as_scalar(0));
+        }
+
+    // select every third particle, and the particles with tag < 100
+    std::vector<unsigned int> tags_a, tags_b;
+    for (unsigned int i = 0; i < N; i += 3)
+        tags_a.push_back(i);
+    for (unsigned int i = 0; i < 100; i++)
+        tags_b.push_back(i);
+    std::shared_ptr<ParticleFilter> filter_a(new ParticleFilterTags(tags_a));
+    std::shared_ptr<ParticleFilter> filter_b(new ParticleFilterTags(tags_b));
+
+    // distributed groups that are updated, or static
+    std::shared_ptr<ParticleGroup> group_a(new ParticleGroup(sysdef, filter_a, true, true));
+    std::shared_ptr<ParticleGroup> static_a(new ParticleGroup(sysdef, filter_a, false, true));
+    std::shared_ptr<ParticleGroup> group_b(new ParticleGroup(sysdef, filter_b, true, true));
+    UP_ASSERT(group_a->isDistributed());
+
+    // check the members of a group against a sorted list of tags
+    auto check_members = [&](std::shared_ptr<ParticleGroup> group, const std::vector<unsigned int>& tags)
+        {
+        UP_ASSERT_EQUAL(group->getNumMembersGlobal(), tags.size());
+        UP_ASSERT_EQUAL(group->getNumMembers(), tags.size());
+        for (unsigned int i = 0; i < tags.size(); i++)
+            UP_ASSERT_EQUAL(group->getMemberTag(i), tags[i]);
+
+        // the index list is in index order
+        for (unsigned int i = 1; i < group->getNumMembers(); i++)
+            UP_ASSERT(group->getMemberIndex(i-1) < group->getMemberIndex(i));
+
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        for (unsigned int idx = 0; idx < pdata->getN(); idx++)
+            {
+            bool member = std::binary_search(tags.begin(), tags.end(), h_tag.data[idx]);
+            UP_ASSERT_EQUAL(group->isMember(idx), member);
+            }
+        };
+
+    std::shared_ptr<Trigger> trigger(new PeriodicTrigger(1));
+    std::shared_ptr<SFCPackTuner> sorter(new SFCPackTuner(sysdef, trigger));
+    sorter->update(0);
+
+    check_members(group_a, tags_a);
+    check_members(static_a, tags_a);
+    check_members(group_b, tags_b);
+
+    // the particles keep their group flags when the system is restored from a snapshot
+    SnapshotParticleData<Scalar> snap(N);
+    pdata->takeSnapshot(snap);
+    pdata->initializeFromSnapshot(snap);
+    check_members(group_a, tags_a);
+    check_members(static_a, tags_a);
+    check_members(group_b, tags_b);
+
+    // removed particles leave the groups
+    pdata->removeParticle(3);
+    pdata->removeParticle(50);
+    tags_a.erase(std::find(tags_a.begin(), tags_a.end(), 3));
+    tags_b.erase(std::find(tags_b.begin(), tags_b.end(), 3));
+    tags_b.erase(std::find(tags_b.begin(), tags_b.end(), 50));
+    check_members(group_a, tags_a);
+    check_members(static_a, tags_a);
+    check_members(group_b, tags_b);
+
+    // a recycled tag is selected again only by the groups that are updated
+    unsigned int tag = pdata->addParticle(0);
+    UP_ASSERT(tag == 3 || tag == 50);
+    sorter->update(1);
+    std::vector<unsigned int> updated_a(tags_a), updated_b(tags_b);
+    if (tag == 3)
+        updated_a.insert(std::lower_bound(updated_a.begin(), updated_a.end(), tag), tag);
+    updated_b.insert(std::lower_bound(updated_b.begin(), updated_b.end(), tag), tag);
+    check_members(group_a, updated_a);
+    check_members(static_a, tags_a);
+    check_members(group_b, updated_b);
+
+    // combinations gather the member tags of distributed groups
+    std::vector<unsigned int> tags_union, tags_difference;
+    std::set_union(updated_a.begin(), updated_a.end(), updated_b.begin(), updated_b.end(),
+        std::back_inserter(tags_union));
+    std::set_difference(updated_a.begin(), updated_a.end(), updated_b.begin(), updated_b.end(),
+        std::back_inserter(tags_difference));
+    check_members(ParticleGroup::groupUnion(group_a, group_b), tags_union);
+    check_members(ParticleGroup::groupDifference(group_a, group_b), tags_difference);
+    }
+
+//! Check that the group flags of distributed particle groups are released
+UP_TEST( ParticleGroup_distributed_flags_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(10, BoxDim(10.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleFilter> filter_all(new ParticleFilterAll());
+
+    std::vector< std::shared_ptr<ParticleGroup> > groups;
+    for (unsigned int i = 0; i < 32; i++)
+        groups.push_back(std::shared_ptr<ParticleGroup>(new ParticleGroup(sysdef, filter_all, true, true)));
+
+    // all flags are in use
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ ParticleGroup group(sysdef, filter_all, true, true); });
+
+    // the flags are released with the groups, except for the one kept by a copy
+    ParticleGroup copy(*groups[7]);
+    groups.clear();
+    UP_ASSERT_EQUAL(copy.getNumMembersGlobal(), 10);
+    for (unsigned int i = 0; i < 31; i++)
+        groups.push_back(std::shared_ptr<ParticleGroup>(new ParticleGroup(sysdef, filter_all, true, true)));
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ ParticleGroup group(sysdef, filter_all, true, true); });
+    }
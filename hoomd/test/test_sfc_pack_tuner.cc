@@ -0,0 +1,106 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file test_sfc_pack_tuner.cc
+    \brief Unit tests for SFCPackTuner
+    \ingroup unit_tests
+*/
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <random>
+
+#include "hoomd/SFCPackTuner.h"
+
+using namespace std;
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+//! Check that sorting reorders all per-particle arrays consistently
+UP_TEST( SFCPackTuner_sort_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    const unsigned int N = 1000;
+    const Scalar L = 20.0;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(L), 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<Scalar> uniform(-L/Scalar(2.0), L/Scalar(2.0));
+
+    // give every particle values that can be recovered from its tag
+    std::vector<Scalar4> pos(N);
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::overwrite);
+        ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body(pdata->getBodies(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_net_virial(pdata->getNetVirial(), access_location::host, access_mode::overwrite);
+        unsigned int pitch = pdata->getNetVirial().getPitch();
+
+        for (unsigned int i = 0; i < N; i++)
+            {
+            pos[i] = make_scalar4(uniform(rng), uniform(rng), uniform(rng), __int_as_scalar(i % 2));
+            h_pos.data[i] = pos[i];
+            h_vel.data[i] = make_scalar4(i, 2*i, 3*i, 1.0);
+            h_charge.data[i] = Scalar(i);
+            h_image.data[i] = make_int3(i, -int(i), 1);
+            h_body.data[i] = i;
+            h_orientation.data[i] = make_scalar4(1, i, 0, 0);
+            h_net_force.data[i] = make_scalar4(-Scalar(i), 0, 0, 0);
+            for (unsigned int j = 0; j < 6; j++)
+                h_net_virial.data[j*pitch+i] = Scalar(i*6+j);
+            }
+        }
+
+    std::shared_ptr<Trigger> trigger(new PeriodicTrigger(1));
+    std::shared_ptr<SFCPackTuner> sorter(new SFCPackTuner(sysdef, trigger));
+    sorter->update(0);
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body(pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_net_virial(pdata->getNetVirial(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    unsigned int pitch = pdata->getNetVirial().getPitch();
+
+    unsigned int n_moved = 0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        unsigned int tag = h_tag.data[i];
+        UP_ASSERT(tag < N);
+        UP_ASSERT_EQUAL(h_rtag.data[tag], i);
+        if (tag != i)
+            n_moved++;
+
+        UP_ASSERT_EQUAL(h_pos.data[i].x, pos[tag].x);
+        UP_ASSERT_EQUAL(h_pos.data[i].y, pos[tag].y);
+        UP_ASSERT_EQUAL(h_pos.data[i].z, pos[tag].z);
+        UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[i].w), int(tag % 2));
+        UP_ASSERT_EQUAL(h_vel.data[i].y, Scalar(2*tag));
+        UP_ASSERT_EQUAL(h_charge.data[i], Scalar(tag));
+        UP_ASSERT_EQUAL(h_image.data[i].y, -int(tag));
+        UP_ASSERT_EQUAL(h_body.data[i], tag);
+        UP_ASSERT_EQUAL(h_orientation.data[i].y, Scalar(tag));
+        UP_ASSERT_EQUAL(h_net_force.data[i].x, -Scalar(tag));
+        for (unsigned int j = 0; j < 6; j++)
+            UP_ASSERT_EQUAL(h_net_virial.data[j*pitch+i], Scalar(tag*6+j));
+        }
+
+    // random positions are far from space filling curve order
+    UP_ASSERT(n_moved > N/2);
+    }
@@ -0,0 +1,72 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file thread_compare.h
+    \brief Helpers for unit tests that compare threaded computations against a single thread
+    \note Include this file after upp11_config.h
+*/
+
+#ifndef __THREAD_COMPARE_H__
+#define __THREAD_COMPARE_H__
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/ForceCompute.h"
+
+#include <memory>
+#include <vector>
+
+//! Append the forces, torques, and virials of the first N particles to a list of results
+/*! \param result List to append to
+    \param fc Force compute to read the arrays of
+    \param N Number of particles to append
+*/
+inline void append_force_arrays(std::vector<Scalar>& result, std::shared_ptr<ForceCompute> fc, unsigned int N)
+    {
+    ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_torque(fc->getTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+    unsigned int pitch = fc->getVirialArray().getPitch();
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        result.push_back(h_force.data[i].x);
+        result.push_back(h_force.data[i].y);
+        result.push_back(h_force.data[i].z);
+        result.push_back(h_force.data[i].w);
+        result.push_back(h_torque.data[i].x);
+        result.push_back(h_torque.data[i].y);
+        result.push_back(h_torque.data[i].z);
+        for (unsigned int l = 0; l < 6; l++)
+            result.push_back(h_virial.data[l*pitch + i]);
+        }
+    }
+
+//! Check that a computation gives the same results with several threads as with a single thread
+/*! \param exec_conf Execution configuration that \a run computes with
+    \param run Callable that sets up and performs the computation, and returns its results
+    \param num_threads Number of threads to compare against a single thread
+
+    \a run is called once for each number of threads, so it must start from the same state each time. Without TBB,
+    both calls run serially.
+*/
+template<class Run>
+void compare_threads(std::shared_ptr<ExecutionConfiguration> exec_conf, Run run, unsigned int num_threads=4)
+    {
+    #ifdef ENABLE_TBB
+    exec_conf->setNumThreads(1);
+    #endif
+    std::vector<Scalar> ref = run();
+
+    #ifdef ENABLE_TBB
+    exec_conf->setNumThreads(num_threads);
+    #endif
+    std::vector<Scalar> result = run();
+
+    UP_ASSERT_EQUAL(result.size(), ref.size());
+    UP_ASSERT(ref.size() > 0);
+    for (unsigned int i = 0; i < ref.size(); i++)
+        MY_CHECK_SMALL(result[i] - ref[i], tol_small);
+    }
+
+#endif
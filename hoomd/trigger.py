@@ -24,6 +24,13 @@ Example:
 
             def compute(self, timestep):
                 return (timestep**(1 / 2)).is_integer()
+
+Custom triggers may also override `Trigger.next_firing_step` to tell the
+simulation when they will next fire. The simulation then runs the steps in
+between without calling the trigger on every step::
+
+    def next_firing_step(self, timestep):
+        return math.ceil(timestep**(1 / 2))**2
 """
 
 from hoomd import _hoomd
@@ -61,6 +68,18 @@ class Trigger(_hoomd.Trigger): # noqa D214
 
             Returns:
                 bool: `True` when the trigger is active, `False` when it is not.
+
+        next_firing_step(timestep):
+            Look ahead to the next timestep on which the trigger may fire.
+
+            Args:
+                timestep (int): The first timestep to consider.
+
+            Returns:
+                int: A timestep ``next >= timestep`` such that the trigger
+                is not active on any step in ``[timestep, next)``, or
+                ``2**64 - 1`` when it will not be active again. The default
+                implementation returns *timestep*.
     """
     pass
 
@@ -1,3 +1,4 @@
+from hoomd.write.binary import Binary
 from hoomd.write.custom_writer import CustomWriter
 from hoomd.write.gsd import GSD
 from hoomd.write.table import Table
@@ -0,0 +1,191 @@
+# Copyright (c) 2009-2020 The Regents of the University of Michigan This file is
+# part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+"""Write logged quantities to a columnar binary file."""
+
+from hoomd import _hoomd
+from hoomd.util import dict_flatten
+from hoomd.data.parameterdicts import ParameterDict
+from hoomd.logging import Logger, TypeFlags
+from hoomd.operation import Writer
+import numpy as np
+
+
+def _make_accessor(entry, matrix):
+    """Bind a logger entry to a callback that returns its current value."""
+    obj, attr = entry.obj, entry.attr
+
+    def accessor(timestep):
+        value = getattr(obj, attr)
+        if callable(value):
+            value = value()
+        if matrix:
+            return np.asarray(value, dtype=np.float64)
+        return value
+
+    return accessor
+
+
+def _cpp_log_quantity(entry):
+    """Find the C++ log quantity that provides a scalar logger entry.
+
+    Returns ``None`` when the entry must be evaluated in Python.
+    """
+    obj = entry.obj
+    quantity = getattr(type(obj), '_cpp_log_quantities', {}).get(entry.attr)
+    if quantity is None or not getattr(obj, '_attached', False):
+        return None
+    if not isinstance(obj._cpp_obj, _hoomd.Compute):
+        return None
+    return quantity
+
+
+class Binary(Writer):
+    """Write logged scalar and sequence quantities to a columnar binary file.
+
+    Args:
+        filename (str): File name to write.
+        trigger (hoomd.trigger.Trigger): Select the timesteps to write.
+        logger (hoomd.logging.Logger): The logger to query for output. Only
+            the 'scalar' and 'sequence' flags may be set on the logger.
+        buffer_size (int): Number of rows buffered in memory before they are
+            written to the file, defaults to 100.
+        overwrite (bool): When ``True``, overwite the file. When ``False``
+            append rows to ``filename`` if it exists and create the file if it
+            does not, defaults to ``False``.
+
+    `Binary` resolves the quantities in *logger* to their objects once when it
+    is attached and then evaluates them directly on each triggered time step.
+    Quantities that a C++ compute provides, such as those of
+    `hoomd.md.compute.ThermodynamicQuantities`, are evaluated in C++ without
+    calling back into Python.
+    It stores the values in memory and writes blocks of *buffer_size* rows in a
+    background thread, so that the simulation does not wait on the file system
+    and no text is formatted. Call `flush` to write the buffered rows
+    immediately. `Binary` also flushes when it is removed from the simulation.
+
+    The file starts with a plain text header that lists the columns, the
+    first of which is the time step. Each column is named after the namespace
+    of its quantity joined by ``/``. Sequence quantities are stored as
+    arrays with the shape of their first value. Use `Binary.read` to load the
+    file into numpy arrays.
+
+    Note:
+        The logged quantities are fixed when `Binary` is attached. When
+        appending to an existing file, the logged quantities must match the
+        columns of the file.
+
+    Note:
+        In MPI parallel simulations, the quantities are evaluated on all ranks
+        and the root rank writes the file.
+
+    Attributes:
+        filename (str): File name to write.
+        trigger (hoomd.trigger.Trigger): Select the timesteps to write.
+        logger (hoomd.logging.Logger): The logger to query for output.
+        buffer_size (int): Number of rows buffered in memory before they are
+            written to the file.
+        overwrite (bool): When ``True``, overwite the file.
+    """
+
+    _invalid_logger_flags = TypeFlags.any(
+        ['string', 'strings', 'object', 'particle', 'bond', 'angle',
+         'dihedral', 'improper', 'pair', 'constraint'])
+
+    def __init__(self, filename, trigger, logger, buffer_size=100,
+                 overwrite=False):
+
+        super().__init__(trigger)
+
+        if logger.flags & self._invalid_logger_flags != TypeFlags.NONE:
+            raise ValueError("Binary only supports the scalar and sequence "
+                             "logger flags.")
+
+        self._param_dict.update(
+            ParameterDict(filename=str(filename),
+                          buffer_size=int(buffer_size),
+                          overwrite=bool(overwrite)))
+        self._logger = logger
+
+    @property
+    def logger(self):
+        return self._logger
+
+    def _attach(self):
+        self._cpp_obj = _hoomd.LogBinary(
+            self._simulation.state._cpp_sys_def,
+            self.filename,
+            self.buffer_size,
+            self.overwrite)
+
+        quantities = []
+        matrix_quantities = []
+        for namespace, entry in dict_flatten(self._logger._dict).items():
+            name = '/'.join(namespace)
+            if entry.flag == TypeFlags.scalar:
+                cpp_quantity = _cpp_log_quantity(entry)
+                if cpp_quantity is not None:
+                    self._cpp_obj.registerComputeQuantity(
+                        name, entry.obj._cpp_obj, cpp_quantity)
+                else:
+                    self._cpp_obj.registerCallback(
+                        name, _make_accessor(entry, False))
+                quantities.append(name)
+            elif entry.flag == TypeFlags.sequence:
+                self._cpp_obj.registerMatrixCallback(
+                    name, _make_accessor(entry, True))
+                matrix_quantities.append(name)
+
+        self._cpp_obj.setLoggedQuantities(quantities)
+        self._cpp_obj.setLoggedMatrixQuantities(matrix_quantities)
+        super()._attach()
+
+    def flush(self):
+        """Write all buffered rows to the file."""
+        if self._attached:
+            self._cpp_obj.flush()
+
+    @staticmethod
+    def read(filename):
+        """Read a file written by `Binary`.
+
+        Args:
+            filename (str): File name to read.
+
+        Returns:
+            dict: A `numpy.ndarray` for each column indexed by the column name.
+            The first axis of each array indexes the rows.
+        """
+        with open(filename, 'rb') as f:
+            data = f.read()
+
+        end = data.index(b'end_header\n') + len(b'end_header\n')
+        columns = []
+        byte_order = '<'
+        for line in data[:end].decode().splitlines():
+            fields = line.split()
+            if fields[0] == 'byte_order':
+                byte_order = '<' if fields[1] == 'little' else '>'
+            elif fields[0] == 'column':
+                columns.append(
+                    (fields[1], fields[2], tuple(int(d) for d in fields[3:])))
+
+        blocks = {name: [] for name, _, _ in columns}
+        offset = end
+        while offset < len(data):
+            n_rows = int(np.frombuffer(data, byte_order + 'u8', 1, offset)[0])
+            offset += 8
+            for name, dtype, shape in columns:
+                dtype = np.dtype(dtype).newbyteorder(byte_order)
+                count = n_rows * int(np.prod(shape, dtype=int))
+                values = np.frombuffer(data, dtype, count, offset)
+                blocks[name].append(values.reshape((n_rows,) + shape))
+                offset += count * dtype.itemsize
+
+        result = {}
+        for name, dtype, shape in columns:
+            if len(blocks[name]) > 0:
+                result[name] = np.concatenate(blocks[name])
+            else:
+                result[name] = np.empty((0,) + shape, dtype=dtype)
+        return result
@@ -32,6 +32,17 @@ class GSD(Writer):
             frame, defaults to property.
         log (hoomd.logging.Logger): A ``Logger`` object for GSD
             logging, defaults to ``None``.
+        precision (dict[str, float]): Absolute precision of the quantized
+            quantities, by quantity name (``'position'``, ``'orientation'``,
+            or ``'velocity'``), defaults to ``None`` (no quantization). The
+            last quantized frame is only written on the next write, `flush`,
+            or when `GSD` is removed from the simulation.
+        sparse (dict[str, float]): Absolute tolerance of the quantities
+            written sparsely, by quantity name (``'position'``,
+            ``'orientation'``, ``'velocity'``, or ``'angmom'``), defaults to
+            ``None`` (no sparse frames).
+        keyframe_interval (int): Maximum number of frames between key frames
+            of quantized and sparse quantities, defaults to 100.
 
     .. note::
 
@@ -91,6 +102,69 @@ class GSD(Writer):
         * pairs/
 
 
+    .. rubric:: Quantization
+
+    Set *precision* to store ``particles/position``, ``particles/orientation``,
+    or ``particles/velocity`` with a fixed absolute precision, like the
+    precision of XTC files. `GSD` rounds each value to a multiple of the
+    precision and stores the difference to the same value in the previous
+    frame with a variable number of bytes, which takes one or two bytes per
+    value for frames written at short intervals. Every *keyframe_interval*-th
+    frame stores the rounded values directly, so that reading a frame decodes
+    at most *keyframe_interval* frames. The values are encoded in the
+    background while the simulation continues. `GSD` completes the frame on
+    the next write, when `flush` is called, or when it is removed from the
+    simulation.
+
+    .. note::
+
+        Until then, the last frame is incomplete and readers do not see it.
+        Call `flush` before reading the file while the simulation continues.
+        When a value cannot be quantized, `GSD` writes the float chunks of the
+        frame instead and raises the error on the next write, `flush`, or
+        removal.
+
+    The quantized data is stored in the chunks
+    ``quantized/particles/position``, etc. in place of the float chunks.
+    `hoomd.Simulation.create_state_from_gsd` and `GSD.read_chunk` decode them.
+
+    .. warning::
+
+        Other GSD readers, including ``gsd.hoomd`` in the ``gsd`` Python
+        package, cannot decode quantized chunks. Because the float chunks are
+        missing, they would return the values of frame 0 (or the defaults) for
+        every frame. To make them fail instead, `GSD` writes files with
+        quantized frames with the schema ``hoomd_encoded`` instead of
+        ``hoomd``. `GSD` cannot append quantized frames to an existing file
+        with the ``hoomd`` schema.
+
+    .. rubric:: Sparse frames
+
+    Set *sparse* to write only the particles whose ``particles/position``,
+    ``particles/orientation``, ``particles/velocity``, or
+    ``particles/angmom`` changed by more than the given absolute tolerance
+    in any component since the last key frame. This saves space when most
+    particles are immobile, e.g. in glassy or crystalline systems. A key frame
+    writes the full quantity. A sparse frame writes the indices of the changed
+    particles in ``sparse/particles/position/index``, their values in
+    ``sparse/particles/position/value``, and the index of the key frame in
+    ``sparse/particles/position/keyframe``. `GSD` writes a new key frame when
+    more than half of the particles changed, when the selected particles
+    change, and at least every *keyframe_interval* frames. Set the tolerance
+    to 0 to reproduce the values exactly.
+
+    `hoomd.Simulation.create_state_from_gsd` and `GSD.read_chunk` reconstruct
+    sparse frames from the key frame. Sparse frames are not written when
+    *truncate* is ``True``.
+
+    .. warning::
+
+        Other GSD readers, including ``gsd.hoomd``, do not reconstruct sparse
+        frames. Because the full chunk is missing, they would return the
+        values of frame 0 in every sparse frame. Like files with quantized
+        frames, files with sparse frames have the schema ``hoomd_encoded``,
+        which these readers reject.
+
     .. seealso::
 
         See the `GSD documentation <http://gsd.readthedocs.io/>`_ and `GitHub
@@ -129,7 +203,10 @@ class GSD(Writer):
                  overwrite=False,
                  truncate=False,
                  dynamic=None,
-                 log=None):
+                 log=None,
+                 precision=None,
+                 sparse=None,
+                 keyframe_interval=100):
 
         super().__init__(trigger)
 
@@ -149,6 +226,31 @@ class GSD(Writer):
 
         self._log = None if log is None else _GSDLogWriter(log)
 
+        precision = dict() if precision is None else dict(precision)
+        for name, value in precision.items():
+            if name not in ['position', 'orientation', 'velocity']:
+                raise ValueError("GSD: cannot quantize " + str(name))
+            if not value > 0:
+                raise ValueError("GSD: the precision of " + name
+                                 + " must be positive")
+            precision[name] = float(value)
+        self._precision = precision
+
+        sparse = dict() if sparse is None else dict(sparse)
+        for name, value in sparse.items():
+            if name not in ['position', 'orientation', 'velocity', 'angmom']:
+                raise ValueError("GSD: cannot write " + str(name)
+                                 + " sparsely")
+            if not value >= 0:
+                raise ValueError("GSD: the tolerance of " + name
+                                 + " must not be negative")
+            sparse[name] = float(value)
+        self._sparse = sparse
+
+        if int(keyframe_interval) <= 0:
+            raise ValueError("GSD: keyframe_interval must be positive")
+        self._keyframe_interval = int(keyframe_interval)
+
     def _attach(self):
         # validate dynamic property
         categories = ['attribute', 'property', 'momentum', 'topology']
@@ -174,8 +276,44 @@ class GSD(Writer):
         self._cpp_obj.setWriteMomentum('momentum' in dynamic_quantities)
         self._cpp_obj.setWriteTopology('topology' in dynamic_quantities)
         self._cpp_obj.log_writer = self.log
+        self._cpp_obj.keyframe_interval = self._keyframe_interval
+        for name, value in self._precision.items():
+            self._cpp_obj.setPrecision('particles/' + name, value)
+        for name, value in self._sparse.items():
+            self._cpp_obj.setSparse('particles/' + name, value)
         super()._attach()
 
+    def flush(self):
+        """Complete the last frame written to the file.
+
+        Only needed when *precision* is set, before reading the last frame
+        while the simulation continues.
+
+        Raises:
+            RuntimeError: The quantized chunks of the last frame could not be
+                encoded. The frame is written with the float chunks.
+        """
+        if self._attached:
+            self._cpp_obj.flush()
+
+    @staticmethod
+    def read_chunk(filename, name, frame=-1):
+        """Read a data chunk from a GSD file.
+
+        Args:
+            filename (str): File name to read.
+            name (str): Name of the chunk (e.g. ``'particles/position'``).
+            frame (int): Index of the frame to read. Negative values index
+                back from the last frame in the file.
+
+        Returns:
+            numpy.ndarray: The data in the chunk. As in the GSD
+            specification, the data is read from frame 0 when the chunk is not
+            present in *frame*. Quantized chunks are decoded and sparse chunks
+            are reconstructed.
+        """
+        return _hoomd.GSDStateReader(str(filename), frame).readChunk(name)
+
     @staticmethod
     def write(state, filename, filter=All(), log=None):
         """Write the given simulation state out to a GSD file.
@@ -213,6 +351,21 @@ class GSD(Writer):
             self._cpp_obj.log_writer = log
         self._log = log
 
+    @property
+    def precision(self):
+        """dict[str, float]: Absolute precision of the quantized quantities."""
+        return dict(self._precision)
+
+    @property
+    def sparse(self):
+        """dict[str, float]: Absolute tolerance of the sparse quantities."""
+        return dict(self._sparse)
+
+    @property
+    def keyframe_interval(self):
+        """int: Maximum number of frames between key frames."""
+        return self._keyframe_interval
+
 
 class _GSDLogWriter:
     """Helper class to store `hoomd.logging.Logger` log data to GSD file.